@@ -20,6 +20,7 @@
 
 
 #include <ns3/log.h>
+#include <ns3/trace-source-accessor.h>
 #include <cmath>
 #include "antenna-model.h"
 
@@ -45,10 +46,20 @@ AntennaModel::GetTypeId ()
   static TypeId tid = TypeId ("ns3::AntennaModel")
     .SetParent<Object> ()
     .SetGroupName("Antenna")
+    .AddTraceSource ("PatternChange",
+                     "The radiation pattern of the antenna changed",
+                     MakeTraceSourceAccessor (&AntennaModel::m_patternChangeTrace),
+                     "ns3::AntennaModel::TracedCallback")
   ;
   return tid;
 }
 
+void
+AntennaModel::NotifyPatternChange (void) const
+{
+  m_patternChangeTrace (this);
+}
+
 
 
 }
@@ -24,6 +24,7 @@
 
 #include <ns3/object.h>
 #include <ns3/angles.h>
+#include <ns3/traced-callback.h>
 
 namespace ns3 {
 
@@ -66,6 +67,28 @@ public:
    */
   virtual double GetGainDb (Angles a) = 0;
 
+  /**
+   * TracedCallback signature for a change of the radiation pattern.
+   *
+   * \param [in] model The AntennaModel.
+   */
+  typedef void (* TracedCallback)(Ptr<const AntennaModel> model);
+
+protected:
+  /**
+   * Must be invoked by subclasses when the radiation pattern changes,
+   * e.g. when the antenna is steered, to notify the listeners of the
+   * PatternChange trace.
+   */
+  void NotifyPatternChange (void) const;
+
+private:
+  /**
+   * Used to alert subscribers that the gain of the antenna in some
+   * direction has changed.
+   */
+  ns3::TracedCallback<Ptr<const AntennaModel> > m_patternChangeTrace;
+
 };
 
 
@@ -56,6 +56,8 @@ public:
   double GetBeamwidth () const;
   void SetOrientation (double orientationDegrees);
   double GetOrientation () const;
+  void SetMaxGain (double maxGain);
+  double GetMaxGain () const;
 
 private:
 
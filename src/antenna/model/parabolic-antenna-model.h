@@ -58,6 +58,8 @@ public:
   double GetBeamwidth () const;
   void SetOrientation (double orientationDegrees);
   double GetOrientation () const;
+  void SetMaxAttenuation (double maxAttenuation);
+  double GetMaxAttenuation () const;
 
 private:
 
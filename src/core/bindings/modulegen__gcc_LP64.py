@@ -2149,6 +2149,11 @@ def register_Ns3SimulatorImpl_methods(root_module, cls):
                    'void', 
                    [param('uint32_t', 'context'), param('ns3::Time const &', 'delay'), param('ns3::EventImpl *', 'event')], 
                    is_pure_virtual=True, is_virtual=True)
+    ## simulator-impl.h (module 'core'): void ns3::SimulatorImpl::SetContext(uint32_t context) [member function]
+    cls.add_method('SetContext', 
+                   'void', 
+                   [param('uint32_t', 'context')], 
+                   is_pure_virtual=True, is_virtual=True)
     ## simulator-impl.h (module 'core'): void ns3::SimulatorImpl::SetScheduler(ns3::ObjectFactory schedulerFactory) [member function]
     cls.add_method('SetScheduler', 
                    'void', 
@@ -3155,6 +3160,11 @@ def register_Ns3DefaultSimulatorImpl_methods(root_module, cls):
                    'void', 
                    [param('uint32_t', 'context'), param('ns3::Time const &', 'delay'), param('ns3::EventImpl *', 'event')], 
                    is_virtual=True)
+    ## default-simulator-impl.h (module 'core'): void ns3::DefaultSimulatorImpl::SetContext(uint32_t context) [member function]
+    cls.add_method('SetContext', 
+                   'void', 
+                   [param('uint32_t', 'context')], 
+                   is_virtual=True)
     ## default-simulator-impl.h (module 'core'): void ns3::DefaultSimulatorImpl::SetScheduler(ns3::ObjectFactory schedulerFactory) [member function]
     cls.add_method('SetScheduler', 
                    'void', 
@@ -4092,6 +4102,11 @@ def register_Ns3RealtimeSimulatorImpl_methods(root_module, cls):
     cls.add_method('SetHardLimit', 
                    'void', 
                    [param('ns3::Time', 'limit')])
+    ## realtime-simulator-impl.h (module 'core'): void ns3::RealtimeSimulatorImpl::SetContext(uint32_t context) [member function]
+    cls.add_method('SetContext', 
+                   'void', 
+                   [param('uint32_t', 'context')], 
+                   is_virtual=True)
     ## realtime-simulator-impl.h (module 'core'): void ns3::RealtimeSimulatorImpl::SetScheduler(ns3::ObjectFactory schedulerFactory) [member function]
     cls.add_method('SetScheduler', 
                    'void', 
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "checkpoint-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::CheckpointHelper implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CheckpointHelper");
+
+CheckpointHelper::CheckpointHelper ()
+  : m_maxParallel (0),
+    m_running (0),
+    m_failed (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CheckpointHelper::SetMaxParallel (uint32_t maxParallel)
+{
+  NS_LOG_FUNCTION (this << maxParallel);
+  m_maxParallel = maxParallel;
+}
+
+uint32_t
+CheckpointHelper::GetFailedCount (void) const
+{
+  return m_failed;
+}
+
+int
+CheckpointHelper::GetExitCode (uint32_t variant) const
+{
+  if (variant >= m_exitCodes.size ())
+    {
+      return -1;
+    }
+  return m_exitCodes[variant];
+}
+
+bool
+CheckpointHelper::WaitOne (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Reap a child which has already exited, if any, or else block on the
+  // oldest one still running.  Never wait for any pid (-1), which would
+  // also reap the children the caller forked on its own.
+  uint32_t oldest = m_pids.size ();
+  for (uint32_t variant = 0; variant < m_pids.size (); ++variant)
+    {
+      if (m_pids[variant] == 0)
+        {
+          continue;
+        }
+      if (oldest == m_pids.size ())
+        {
+          oldest = variant;
+        }
+      int status;
+      pid_t pid;
+      do
+        {
+          pid = waitpid (m_pids[variant], &status, WNOHANG);
+        }
+      while (pid == -1 && errno == EINTR);
+      if (pid == m_pids[variant])
+        {
+          Collect (variant, status);
+          return true;
+        }
+      if (pid == -1)
+        {
+          NS_LOG_WARN ("cannot wait for variant " << variant << ": " << std::strerror (errno));
+          Collect (variant, -1);
+          return false;
+        }
+    }
+  NS_ASSERT_MSG (oldest < m_pids.size (), "no variant running");
+  int status;
+  pid_t pid;
+  do
+    {
+      pid = waitpid (m_pids[oldest], &status, 0);
+    }
+  while (pid == -1 && errno == EINTR);
+  if (pid == -1)
+    {
+      NS_LOG_WARN ("cannot wait for variant " << oldest << ": " << std::strerror (errno));
+      Collect (oldest, -1);
+      return false;
+    }
+  Collect (oldest, status);
+  return true;
+}
+
+void
+CheckpointHelper::Collect (uint32_t variant, int status)
+{
+  NS_LOG_FUNCTION (this << variant << status);
+  m_pids[variant] = 0;
+  m_running--;
+  if (status != -1 && WIFEXITED (status))
+    {
+      m_exitCodes[variant] = WEXITSTATUS (status);
+    }
+  if (m_exitCodes[variant] != 0)
+    {
+      NS_LOG_WARN ("variant " << variant << " failed");
+      m_failed++;
+    }
+}
+
+int32_t
+CheckpointHelper::Branch (uint32_t variants)
+{
+  NS_LOG_FUNCTION (this << variants);
+  m_failed = 0;
+  m_running = 0;
+  m_pids.assign (variants, 0);
+  m_exitCodes.assign (variants, -1);
+  for (uint32_t variant = 0; variant < variants; ++variant)
+    {
+      while (m_maxParallel != 0 && m_running >= m_maxParallel)
+        {
+          if (!WaitOne ())
+            {
+              return -2;
+            }
+        }
+      // Do not let the children print the output buffered so far again.
+      std::cout.flush ();
+      std::cerr.flush ();
+      std::clog.flush ();
+      std::fflush (0);
+      pid_t pid = fork ();
+      if (pid == -1)
+        {
+          NS_FATAL_ERROR ("Cannot fork variant " << variant << ": " << std::strerror (errno));
+        }
+      if (pid == 0)
+        {
+          NS_LOG_LOGIC ("variant " << variant << " starts at " << Simulator::Now ().GetSeconds () << "s");
+          m_running = 0;
+          m_pids.clear ();
+          m_exitCodes.clear ();
+          return variant;
+        }
+      m_pids[variant] = pid;
+      m_running++;
+    }
+  while (m_running > 0)
+    {
+      if (!WaitOne ())
+        {
+          return -2;
+        }
+    }
+  return -1;
+}
+
+} // namespace ns3
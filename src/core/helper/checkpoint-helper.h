@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CHECKPOINT_HELPER_H
+#define CHECKPOINT_HELPER_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::CheckpointHelper declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Continue a warmed-up simulation several times from the same state.
+ *
+ * Pending events hold arbitrary C++ closures, so the simulation state
+ * cannot be written to a file and read back.  Instead, this helper
+ * takes an in-memory checkpoint by forking the process: every child
+ * starts with an exact copy of the pending events, of the node, device,
+ * MAC, PHY and queue state, and of the random number stream positions,
+ * and the copy-on-write pages make the fork cheap.  Each child then
+ * applies its own attribute changes (with Config::Set) and continues
+ * the simulation.
+ *
+ * \code
+ *   Simulator::Stop (Seconds (warmup));
+ *   Simulator::Run ();
+ *   CheckpointHelper checkpoint;
+ *   checkpoint.SetMaxParallel (4);
+ *   int32_t variant = checkpoint.Branch (8);
+ *   if (variant < 0)
+ *     {
+ *       // parent: all the variants have finished
+ *       return checkpoint.GetFailedCount () == 0 ? 0 : 1;
+ *     }
+ *   Config::Set ("/NodeList/0/...", ...);   // depends on variant
+ *   Simulator::Stop (Seconds (duration));
+ *   Simulator::Run ();
+ *   Simulator::Destroy ();
+ * \endcode
+ *
+ * Since all the variants start with the same random stream positions,
+ * they use common random numbers from the checkpoint on.
+ *
+ * This is only available on POSIX systems, and must not be used while
+ * other threads (for example the real time simulator) are running.
+ */
+class CheckpointHelper
+{
+public:
+  CheckpointHelper ();
+
+  /**
+   * Limit the number of variants running at the same time.
+   *
+   * \param [in] maxParallel The maximum number of child processes;
+   *             zero (the default) means no limit.
+   */
+  void SetMaxParallel (uint32_t maxParallel);
+
+  /**
+   * Fork one process per variant from the current simulation state.
+   *
+   * Only the processes forked by this call are waited for; other
+   * children of the calling process are left alone.
+   *
+   * \param [in] variants The number of variants.
+   * \returns In a child process, the index of its variant, in
+   *          [0, variants).  In the calling process, -1 once all the
+   *          children have exited, or -2 if waiting for a child
+   *          failed, in which case no further variant is forked and
+   *          the children still running are not waited for.
+   */
+  int32_t Branch (uint32_t variants);
+
+  /**
+   * \returns The number of variants which did not exit successfully
+   *          in the last call to Branch, including the ones which
+   *          could not be waited for.
+   */
+  uint32_t GetFailedCount (void) const;
+
+  /**
+   * \param [in] variant The index of a variant of the last call to Branch.
+   * \returns The exit code of the variant, or -1 if it was killed by a
+   *          signal or its result was not collected.
+   */
+  int GetExitCode (uint32_t variant) const;
+
+private:
+  /**
+   * Wait for one of the children of the last call to Branch to exit,
+   * and record its result.
+   *
+   * \returns false if waiting failed.
+   */
+  bool WaitOne (void);
+  /**
+   * Record the result of a child process.
+   *
+   * \param [in] variant The index of the variant.
+   * \param [in] status The status returned by waitpid, or -1 if the
+   *             child could not be waited for.
+   */
+  void Collect (uint32_t variant, int status);
+
+  uint32_t m_maxParallel;  //!< Maximum number of concurrent children
+  uint32_t m_running;      //!< Number of children not reaped yet
+  uint32_t m_failed;       //!< Number of children which failed
+  std::vector<pid_t> m_pids;  //!< Pid of each variant, 0 once reaped
+  std::vector<int> m_exitCodes;  //!< Exit code of each variant, -1 if unknown
+};
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_HELPER_H */
@@ -252,6 +252,12 @@ CalendarScheduler::Remove (const Event &ev)
   NS_ASSERT (false);
 }
 
+bool
+CalendarScheduler::IsRemoveEfficient (void) const
+{
+  return true;
+}
+
 void
 CalendarScheduler::ResizeUp (void)
 {
@@ -73,6 +73,7 @@ public:
   virtual Scheduler::Event PeekNext (void) const;
   virtual Scheduler::Event RemoveNext (void);
   virtual void Remove (const Scheduler::Event &ev);
+  virtual bool IsRemoveEfficient (void) const;
 
 private:
   /** Double the number of buckets if necessary. */
@@ -27,6 +27,7 @@
 #include "log.h"
 
 #include <sstream>
+#include <map>
 
 /**
  * \file
@@ -148,565 +149,562 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 
 } // namespace Config
 
-
-/** Helper to test if an array entry matches a config path specification. */
-class ArrayMatcher
+/**
+ * Convert a string to an \c uint32_t.
+ *
+ * \param [in] str The string.
+ * \param [in] value The location to store the \c uint32_t.
+ * \returns \c true if the string could be converted.
+ */
+static bool
+StringToUint32 (std::string str, uint32_t *value)
 {
-public:
-  /**
-   * Construct from a Config path specification.
-   *
-   * \param [in] element The Config path specification.
-   */
-  ArrayMatcher (std::string element);
-  /**
-   * Test if a specific index matches the Config Path.
-   *
-   * \param [in] i The index.
-   * \returns \c true if the index matches the Config Path.
-   */
-  bool Matches (uint32_t i) const;
-private:
-  /**
-   * Convert a string to an \c uint32_t.
-   *
-   * \param [in] str The string.
-   * \param [in] value The location to store the \c uint32_t.
-   * \returns \c true if the string could be converted.
-   */
-  bool StringToUint32 (std::string str, uint32_t *value) const;
-  /** The Config path element. */
-  std::string m_element;
-};
+  NS_LOG_FUNCTION (str << value);
+  std::istringstream iss;
+  iss.str (str);
+  iss >> (*value);
+  return !iss.bad () && !iss.fail ();
+}
 
+namespace Config {
 
-ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+Path::Path ()
+  : m_hasSlash (false)
 {
-  NS_LOG_FUNCTION (this << element);
+  NS_LOG_FUNCTION (this);
+  m_prefixes.push_back ("/");
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+
+Path::Path (std::string path)
+  : m_path (path)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << path);
+
+  std::string::size_type slash = path.find_last_of ("/");
+  m_hasSlash = (slash != std::string::npos);
+  if (m_hasSlash)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_leaf = path.substr (slash + 1, path.size () - (slash + 1));
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+
+  // ensure that we start and end with a '/'
+  if (path.find ("/") != 0)
+    {
+      path = "/" + path;
+    }
+  if (path.find_last_of ("/") != (path.size () - 1))
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
+      path = path + "/";
+    }
+
+  m_prefixes.push_back ("/");
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = path.find ("/", start)) != std::string::npos)
+    {
+      Token token;
+      token.item = path.substr (start, next - start);
+      token.isGetObject = (token.item.find ("$") == 0);
+      token.hasTid = false;
+      token.anyIndex = false;
+      if (token.isGetObject)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
+          // TypeIds are all registered by the time paths are used, but a
+          // Path built during static initialization may come first.
+          std::string tidString = token.item.substr (1, token.item.size () - 1);
+          token.hasTid = TypeId::LookupByNameFailSafe (tidString, &token.tid);
         }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
+      else
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
+          CompileIndex (token.item, &token);
         }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      m_tokens.push_back (token);
+      m_prefixes.push_back (path.substr (0, next + 1));
+      start = next + 1;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+}
+
+std::string
+Path::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_path;
+}
+
+void
+Path::CompileIndex (std::string element, Token *token)
+{
+  NS_LOG_FUNCTION (element << token);
+  if (element == "*")
+    {
+      token->anyIndex = true;
+      return;
+    }
+  std::string::size_type tmp = element.find ("|");
+  if (tmp != std::string::npos)
+    {
+      CompileIndex (element.substr (0, tmp - 0), token);
+      CompileIndex (element.substr (tmp + 1, element.size () - (tmp + 1)), token);
+      return;
+    }
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
-      if (StringToUint32 (lowerBound, &min) && 
+      if (StringToUint32 (lowerBound, &min) &&
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          token->indices.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-      return true;
+      token->indices.push_back (std::make_pair (value, value));
     }
-  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-  return false;
 }
 
 bool
-ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
+Path::Token::Matches (uint32_t i) const
 {
-  NS_LOG_FUNCTION (this << str << value);
-  std::istringstream iss;
-  iss.str (str);
-  iss >> (*value);
-  return !iss.bad () && !iss.fail ();
+  if (anyIndex)
+    {
+      return true;
+    }
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = indices.begin ();
+       j != indices.end (); ++j)
+    {
+      if (i >= j->first && i <= j->second)
+        {
+          return true;
+        }
+    }
+  return false;
 }
 
+} // namespace Config
+
 /**
- * Abstract class to parse Config paths into object references.
+ * One partial match of a Config path: an object, or an object container
+ * whose index is the next path element.
  */
-class Resolver
+struct ResolvedNode
+{
+  /** The object reached, or 0 at the root of the "/Names" name space. */
+  Ptr<Object> object;
+  /** The object container reached, if any. */
+  Ptr<ObjectPtrContainerValue> container;
+  /** The path resolved so far, starting and ending with a '/'. */
+  std::string context;
+};
+
+/** Config system implementation class. */
+class ConfigImpl : public Singleton<ConfigImpl>
 {
 public:
+  /** Resolved partial matches, keyed by canonical path prefix. */
+  typedef std::map<std::string, std::vector<ResolvedNode> > ResolutionCache;
+
+  /** \copydoc Config::Set() */
+  void Set (std::string path, const AttributeValue &value);
+  /** \copydoc Config::ConnectWithoutContext() */
+  void ConnectWithoutContext (std::string path, const CallbackBase &cb);
+  /** \copydoc Config::Connect() */
+  void Connect (std::string path, const CallbackBase &cb);
+  /** \copydoc Config::DisconnectWithoutContext() */
+  void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
+  /** \copydoc Config::Disconnect() */
+  void Disconnect (std::string path, const CallbackBase &cb);
+  /** \copydoc Config::LookupMatches() */
+  Config::MatchContainer LookupMatches (std::string path);
+
   /**
-   * Construct from a base Config path.
+   * Find the objects matching all the elements of a path.
    *
-   * \param [in] path The Config path.
+   * \param [in] path The parsed Config path.
+   * \param [in] cache The cache of resolved prefixes to use and fill, or 0.
+   * \returns The matching objects.
    */
-  Resolver (std::string path);
-  /** Destructor. */
-  virtual ~Resolver ();
-
+  Config::MatchContainer LookupMatches (const Config::Path &path, ResolutionCache *cache);
   /**
-   * Parse the stored Config path into an object reference,
-   * beginning at the indicated root object.
+   * Find the objects matching all but the leaf element of a path.
    *
-   * \param [in] root The object corresponding to the current position in
-   *                  in the Config path.
+   * \param [in] path The parsed Config path.
+   * \param [in] cache The cache of resolved prefixes to use and fill, or 0.
+   * \returns The objects holding the leaf attribute or trace source.
    */
-  void Resolve (Ptr<Object> root);
-  
-private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
+  Config::MatchContainer LookupLeafOwners (const Config::Path &path, ResolutionCache *cache);
   /**
-   * Parse the next element in the Config path.
-   *
-   * \param [in] path The remaining portion of the Config path.
-   * \param [in] root The object corresponding to the current positon
-   *                  in the Config path.
+   * \copydoc Config::Path::Set()
+   * \param [in] path The parsed Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void Set (const Config::Path &path, const AttributeValue &value);
   /**
-   * Parse an index on the Config path.
-   *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \copydoc Config::Path::Connect()
+   * \param [in] path The parsed Config path.
+   * \param [in] cache The cache of resolved prefixes to use and fill, or 0.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void Connect (const Config::Path &path, const CallbackBase &cb, ResolutionCache *cache);
   /**
-   * Handle one object found on the path.
-   *
-   * \param [in] object The current object on the Config path.
+   * \copydoc Config::Path::ConnectWithoutContext()
+   * \param [in] path The parsed Config path.
+   * \param [in] cache The cache of resolved prefixes to use and fill, or 0.
    */
-  void DoResolveOne (Ptr<Object> object);
+  void ConnectWithoutContext (const Config::Path &path, const CallbackBase &cb, ResolutionCache *cache);
+
+  /** \copydoc Config::RegisterRootNamespaceObject() */
+  void RegisterRootNamespaceObject (Ptr<Object> obj);
+  /** \copydoc Config::UnregisterRootNamespaceObject() */
+  void UnregisterRootNamespaceObject (Ptr<Object> obj);
+
+  /** \copydoc Config::GetRootNamespaceObjectN() */
+  uint32_t GetRootNamespaceObjectN (void) const;
+  /** \copydoc Config::GetRootNamespaceObject() */
+  Ptr<Object> GetRootNamespaceObject (uint32_t i) const;
+
+private:
   /**
-   * Get the current Config path.
+   * Resolve the first elements of a path.
    *
-   * \returns The current Config path.
+   * \param [in] path The parsed Config path.
+   * \param [in] n The number of elements to resolve.
+   * \param [in] cache The cache of resolved prefixes to use and fill, or 0.
+   * \returns The objects matching the first \p n elements.
    */
-  std::string GetResolvedPath (void) const;
+  Config::MatchContainer Resolve (const Config::Path &path, uint32_t n, ResolutionCache *cache);
   /**
-   * Handle one found object.
+   * Match one path element against one partial match.
    *
-   * \param [in] object The found object.
-   * \param [in] path The matching Config path context.
+   * \param [in] node The partial match.
+   * \param [in] token The next path element.
+   * \param [in,out] next The list to append the new partial matches to.
    */
-  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
+  void Expand (const ResolvedNode &node, const Config::Path::Token &token,
+               std::vector<ResolvedNode> *next) const;
+
+  /** Container type to hold the root Config path tokens. */
+  typedef std::vector<Ptr<Object> > Roots;
 
-  /** Current list of path tokens. */
-  std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The list of Config path roots. */
+  Roots m_roots;
 };
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Config::MatchContainer
+ConfigImpl::Resolve (const Config::Path &path, uint32_t n, ResolutionCache *cache)
 {
-  NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
-}
-Resolver::~Resolver ()
-{
-  NS_LOG_FUNCTION (this);
-}
-void
-Resolver::Canonicalize (void)
-{
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << path.GetPath () << n << cache);
+  NS_ASSERT (n <= path.m_tokens.size ());
 
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
+  std::vector<ResolvedNode> frontier;
+  uint32_t start = 0;
+  if (cache != 0)
     {
-      // no slash at start
-      m_path = "/" + m_path;
+      for (uint32_t k = n; k > 0; k--)
+        {
+          ResolutionCache::const_iterator i = cache->find (path.m_prefixes[k]);
+          if (i != cache->end ())
+            {
+              frontier = i->second;
+              start = k;
+              break;
+            }
+        }
     }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
+  if (start == 0)
     {
-      // no slash at end
-      m_path = m_path + "/";
+      for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
+        {
+          ResolvedNode root;
+          root.object = *i;
+          root.context = "/";
+          frontier.push_back (root);
+        }
+      //
+      // A zero object stands for the root of the "/Names" namespace; it is
+      // always consulted last.
+      //
+      ResolvedNode names;
+      names.context = "/";
+      frontier.push_back (names);
     }
-}
-
-void 
-Resolver::Resolve (Ptr<Object> root)
-{
-  NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
-}
-
-std::string
-Resolver::GetResolvedPath (void) const
-{
-  NS_LOG_FUNCTION (this);
-
-  std::string fullPath = "/";
-  for (std::vector<std::string>::const_iterator i = m_workStack.begin (); i != m_workStack.end (); i++)
+  for (uint32_t k = start; k < n && !frontier.empty (); k++)
     {
-      fullPath += *i + "/";
+      std::vector<ResolvedNode> next;
+      for (std::vector<ResolvedNode>::const_iterator i = frontier.begin (); i != frontier.end (); i++)
+        {
+          Expand (*i, path.m_tokens[k], &next);
+        }
+      frontier.swap (next);
+      if (cache != 0)
+        {
+          (*cache)[path.m_prefixes[k + 1]] = frontier;
+        }
     }
-  return fullPath;
-}
 
-void 
-Resolver::DoResolveOne (Ptr<Object> object)
-{
-  NS_LOG_FUNCTION (this << object);
-
-  NS_LOG_DEBUG ("resolved="<<GetResolvedPath ());
-  DoOne (object, GetResolvedPath ());
+  std::vector<Ptr<Object> > objects;
+  std::vector<std::string> contexts;
+  for (std::vector<ResolvedNode>::const_iterator i = frontier.begin (); i != frontier.end (); i++)
+    {
+      if (i->container == 0 && i->object != 0)
+        {
+          NS_LOG_DEBUG ("resolved=" << i->context);
+          objects.push_back (i->object);
+          contexts.push_back (i->context);
+        }
+    }
+  return Config::MatchContainer (objects, contexts, path.GetPath ());
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+ConfigImpl::Expand (const ResolvedNode &node, const Config::Path::Token &token,
+                    std::vector<ResolvedNode> *next) const
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << node.context << token.item);
 
-  if (next == std::string::npos)
+  if (node.container != 0)
     {
-      //
-      // If root is zero, we're beginning to see if we can use the object name 
-      // service to resolve this path.  It is impossible to have a object name 
-      // associated with the root of the object name service since that root
-      // is not an object.  This path must be referring to something in another
-      // namespace and it will have been found already since the name service
-      // is always consulted last.
-      // 
-      if (root)
+      ResolvedNode child;
+      if (!token.anyIndex && token.indices.size () == 1
+          && token.indices[0].first == token.indices[0].second)
         {
-          DoResolveOne (root);
+          // a single index: no need to scan the whole container
+          child.object = node.container->Get (token.indices[0].first);
+          if (child.object != 0)
+            {
+              std::ostringstream oss;
+              oss << token.indices[0].first;
+              child.context = node.context + oss.str () + "/";
+              next->push_back (child);
+            }
+          return;
+        }
+      for (ObjectPtrContainerValue::Iterator it = node.container->Begin (); it != node.container->End (); ++it)
+        {
+          if (token.Matches ((*it).first))
+            {
+              std::ostringstream oss;
+              oss << (*it).first;
+              child.object = (*it).second;
+              child.context = node.context + oss.str () + "/";
+              next->push_back (child);
+            }
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
   //
-  // If root is zero, we're beginning to see if we can use the object name 
-  // service to resolve this path.  In this case, we must see the name space 
-  // "/Names" on the front of this path.  There is no object associated with 
-  // the root of the "/Names" namespace, so we just ignore it and move on to 
-  // the next segment.
+  // At the root of the "/Names" namespace there is no object, so we just
+  // skip the "Names" segment and move on to the next one.
   //
-  if (root == 0)
+  if (node.object == 0 && token.item == "Names")
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
-        {
-          m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
-          m_workStack.pop_back ();
-          return;
-        }
+      ResolvedNode child;
+      child.context = node.context + token.item + "/";
+      next->push_back (child);
+      return;
     }
 
   //
-  // We have an item (possibly a segment of a namespace path.  Check to see if
-  // we can determine that this segment refers to a named object.  If root is
-  // zero, this means to look in the root of the "/Names" name space, otherwise
-  // it refers to a name space context (level).
+  // Check to see if this element refers to a named object.  If the object
+  // is zero, this means to look in the root of the "/Names" name space,
+  // otherwise it refers to a name space context (level).
   //
-  Ptr<Object> namedObject = Names::Find<Object> (root, item);
+  Ptr<Object> namedObject = Names::Find<Object> (node.object, token.item);
   if (namedObject)
     {
-      NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
-      m_workStack.pop_back ();
+      NS_LOG_DEBUG ("Name system resolved item = " << token.item << " to " << namedObject);
+      ResolvedNode child;
+      child.object = namedObject;
+      child.context = node.context + token.item + "/";
+      next->push_back (child);
       return;
     }
 
   //
-  // We're done with the object name service hooks, so proceed down the path
-  // of types and attributes; but only if root is nonzero.  If root is zero
-  // and we find ourselves here, we are trying to check in the namespace for
-  // a path that is not in the "/Names" namespace.  We will have previously
-  // found any matches, so we just bail out.
+  // A path which is not in the "/Names" namespace has been matched from the
+  // other roots already.
   //
-  if (root == 0)
+  if (node.object == 0)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+
+  if (token.isGetObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
-      Ptr<Object> object = root->GetObject<Object> (tid);
+      NS_LOG_DEBUG ("GetObject=" << token.item << " on path=" << node.context);
+      TypeId tid = token.tid;
+      if (!token.hasTid)
+        {
+          tid = TypeId::LookupByName (token.item.substr (1, token.item.size () - 1));
+        }
+      Ptr<Object> object = node.object->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject (" << token.item << ") failed on path=" << node.context);
           return;
         }
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
-      m_workStack.pop_back ();
-    }
-  else 
-    {
-      // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-      
-      do
+      ResolvedNode child;
+      child.object = object;
+      child.context = node.context + token.item + "/";
+      next->push_back (child);
+      return;
+    }
+
+  // this is a normal attribute.
+  TypeId tid;
+  TypeId nextTid = node.object->GetInstanceTypeId ();
+  bool foundMatch = false;
+  do
+    {
+      tid = nextTid;
+
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          struct TypeId::AttributeInformation info;
+          info = tid.GetAttribute (i);
+          if (info.name != token.item && token.item != "*")
+            {
+              continue;
+            }
+          // attempt to cast to a pointer checker.
+          const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
+          if (ptr != 0)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << node.context);
+              PointerValue ptr;
+              node.object->GetAttribute (info.name, ptr);
+              Ptr<Object> object = ptr.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\"" << token.item <<
+                                "\" exists on path=\"" << node.context << "\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              ResolvedNode child;
+              child.object = object;
+              child.context = node.context + info.name + "/";
+              next->push_back (child);
             }
-
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
-      
-      if (!foundMatch)
-        {
-          NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
-          return;
+          // attempt to cast to an object vector.
+          const ObjectPtrContainerChecker *vectorChecker =
+            dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
+          if (vectorChecker != 0)
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << node.context);
+              foundMatch = true;
+              ResolvedNode child;
+              child.container = Create<ObjectPtrContainerValue> ();
+              node.object->GetAttribute (info.name, *child.container);
+              child.context = node.context + info.name + "/";
+              next->push_back (child);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
         }
+
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+
+  if (!foundMatch)
+    {
+      NS_LOG_DEBUG ("Requested item=" << token.item << " does not exist on path=" << node.context);
     }
 }
 
-void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Config::MatchContainer
+ConfigImpl::LookupMatches (const Config::Path &path, ResolutionCache *cache)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
-    {
-      return;
-    }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  NS_LOG_FUNCTION (this << path.GetPath () << cache);
+  return Resolve (path, path.m_tokens.size (), cache);
+}
 
-  ArrayMatcher matcher = ArrayMatcher (item);
-  ObjectPtrContainerValue::Iterator it;
-  for (it = container.Begin (); it != container.End (); ++it)
+Config::MatchContainer
+ConfigImpl::LookupLeafOwners (const Config::Path &path, ResolutionCache *cache)
+{
+  NS_LOG_FUNCTION (this << path.GetPath () << cache);
+  NS_ASSERT (path.m_hasSlash);
+  uint32_t n = path.m_tokens.size ();
+  if (!path.m_leaf.empty ())
     {
-      if (matcher.Matches ((*it).first))
-        {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
-        }
+      n--;
     }
+  return Resolve (path, n, cache);
 }
 
-/** Config system implementation class. */
-class ConfigImpl : public Singleton<ConfigImpl>
+void
+ConfigImpl::Set (const Config::Path &path, const AttributeValue &value)
 {
-public:
-  /** \copydoc Config::Set() */
-  void Set (std::string path, const AttributeValue &value);
-  /** \copydoc Config::ConnectWithoutContext() */
-  void ConnectWithoutContext (std::string path, const CallbackBase &cb);
-  /** \copydoc Config::Connect() */
-  void Connect (std::string path, const CallbackBase &cb);
-  /** \copydoc Config::DisconnectWithoutContext() */
-  void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
-  /** \copydoc Config::Disconnect() */
-  void Disconnect (std::string path, const CallbackBase &cb);
-  /** \copydoc Config::LookupMatches() */
-  Config::MatchContainer LookupMatches (std::string path);
-
-  /** \copydoc Config::RegisterRootNamespaceObject() */
-  void RegisterRootNamespaceObject (Ptr<Object> obj);
-  /** \copydoc Config::UnregisterRootNamespaceObject() */
-  void UnregisterRootNamespaceObject (Ptr<Object> obj);
-
-  /** \copydoc Config::GetRootNamespaceObjectN() */
-  uint32_t GetRootNamespaceObjectN (void) const;
-  /** \copydoc Config::GetRootNamespaceObject() */
-  Ptr<Object> GetRootNamespaceObject (uint32_t i) const;
-
-private:
-  /**
-   * Break a Config path into the leading path and the last leaf token.
-   * \param [in] path The Config path.
-   * \param [in,out] root The leading part of the \p path,
-   *   up to the final slash.
-   * \param [in,out] leaf The trailing part of the \p path.
-   */
-  void ParsePath (std::string path, std::string *root, std::string *leaf) const;
-
-  /** Container type to hold the root Config path tokens. */
-  typedef std::vector<Ptr<Object> > Roots;
-
-  /** The list of Config path roots. */
-  Roots m_roots;
-};
-
-void 
-ConfigImpl::ParsePath (std::string path, std::string *root, std::string *leaf) const
+  NS_LOG_FUNCTION (this << path.GetPath () << &value);
+  Config::MatchContainer container = LookupLeafOwners (path, 0);
+  container.Set (path.m_leaf, value);
+}
+void
+ConfigImpl::Connect (const Config::Path &path, const CallbackBase &cb, ResolutionCache *cache)
 {
-  NS_LOG_FUNCTION (this << path << root << leaf);
-
-  std::string::size_type slash = path.find_last_of ("/");
-  NS_ASSERT (slash != std::string::npos);
-  *root = path.substr (0, slash);
-  *leaf = path.substr (slash+1, path.size ()-(slash+1));
-  NS_LOG_FUNCTION (path << *root << *leaf);
+  NS_LOG_FUNCTION (this << path.GetPath () << &cb << cache);
+  Config::MatchContainer container = LookupLeafOwners (path, cache);
+  container.Connect (path.m_leaf, cb);
+}
+void
+ConfigImpl::ConnectWithoutContext (const Config::Path &path, const CallbackBase &cb, ResolutionCache *cache)
+{
+  NS_LOG_FUNCTION (this << path.GetPath () << &cb << cache);
+  Config::MatchContainer container = LookupLeafOwners (path, cache);
+  container.ConnectWithoutContext (path.m_leaf, cb);
 }
 
-void 
+void
 ConfigImpl::Set (std::string path, const AttributeValue &value)
 {
   NS_LOG_FUNCTION (this << path << &value);
-
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.Set (leaf, value);
+  Set (Config::Path (path), value);
 }
-void 
+void
 ConfigImpl::ConnectWithoutContext (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << path << &cb);
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.ConnectWithoutContext (leaf, cb);
+  ConnectWithoutContext (Config::Path (path), cb, 0);
 }
-void 
+void
 ConfigImpl::DisconnectWithoutContext (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << path << &cb);
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.DisconnectWithoutContext (leaf, cb);
+  Config::Path compiled (path);
+  Config::MatchContainer container = LookupLeafOwners (compiled, 0);
+  container.DisconnectWithoutContext (compiled.m_leaf, cb);
 }
-void 
+void
 ConfigImpl::Connect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << path << &cb);
-
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.Connect (leaf, cb);
+  Connect (Config::Path (path), cb, 0);
 }
-void 
+void
 ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << path << &cb);
-
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.Disconnect (leaf, cb);
+  Config::Path compiled (path);
+  Config::MatchContainer container = LookupLeafOwners (compiled, 0);
+  container.Disconnect (compiled.m_leaf, cb);
 }
 
-Config::MatchContainer 
+Config::MatchContainer
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
-  class LookupMatchesResolver : public Resolver 
-  {
-  public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
-    {}
-    virtual void DoOne (Ptr<Object> object, std::string path) {
-      m_objects.push_back (object);
-      m_contexts.push_back (path);
-    }
-    std::vector<Ptr<Object> > m_objects;
-    std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
-  for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
-    {
-      resolver.Resolve (*i);
-    }
-
-  //
-  // See if we can do something with the object name service.  Starting with
-  // the root pointer zeroed indicates to the resolver that it should start
-  // looking at the root of the "/Names" namespace during this go.
-  //
-  resolver.Resolve (0);
-
-  return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, path);
+  return LookupMatches (Config::Path (path), 0);
 }
 
 void 
@@ -849,6 +847,112 @@ Config::MatchContainer LookupMatches (std::string path)
   return ConfigImpl::Get ()->LookupMatches (path);
 }
 
+void
+Path::Set (const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << m_path << &value);
+  ConfigImpl::Get ()->Set (*this, value);
+}
+
+void
+Path::Connect (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << m_path << &cb);
+  ConfigImpl::Get ()->Connect (*this, cb, 0);
+}
+
+void
+Path::ConnectWithoutContext (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << m_path << &cb);
+  ConfigImpl::Get ()->ConnectWithoutContext (*this, cb, 0);
+}
+
+MatchContainer
+Path::LookupMatches (void) const
+{
+  NS_LOG_FUNCTION (this << m_path);
+  return ConfigImpl::Get ()->LookupMatches (*this, 0);
+}
+
+struct BulkConnector::Request
+{
+  Path path;         //!< The trace source path.
+  CallbackBase cb;   //!< The sink.
+  bool withContext;  //!< \c true for Connect, \c false for ConnectWithoutContext.
+};
+
+BulkConnector::BulkConnector ()
+{
+  NS_LOG_FUNCTION (this);
+}
+BulkConnector::~BulkConnector ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_requests.empty (), "BulkConnector destroyed with connections which were never committed");
+  for (std::vector<Request *>::iterator i = m_requests.begin (); i != m_requests.end (); i++)
+    {
+      delete *i;
+    }
+}
+void
+BulkConnector::Connect (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+  Connect (Path (path), cb);
+}
+void
+BulkConnector::Connect (const Path &path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path.GetPath () << &cb);
+  Request *request = new Request;
+  request->path = path;
+  request->cb = cb;
+  request->withContext = true;
+  m_requests.push_back (request);
+}
+void
+BulkConnector::ConnectWithoutContext (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+  ConnectWithoutContext (Path (path), cb);
+}
+void
+BulkConnector::ConnectWithoutContext (const Path &path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path.GetPath () << &cb);
+  Request *request = new Request;
+  request->path = path;
+  request->cb = cb;
+  request->withContext = false;
+  m_requests.push_back (request);
+}
+uint32_t
+BulkConnector::GetN (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_requests.size ();
+}
+void
+BulkConnector::Commit (void)
+{
+  NS_LOG_FUNCTION (this);
+  ConfigImpl::ResolutionCache cache;
+  for (std::vector<Request *>::iterator i = m_requests.begin (); i != m_requests.end (); i++)
+    {
+      if ((*i)->withContext)
+        {
+          ConfigImpl::Get ()->Connect ((*i)->path, (*i)->cb, &cache);
+        }
+      else
+        {
+          ConfigImpl::Get ()->ConnectWithoutContext ((*i)->path, (*i)->cb, &cache);
+        }
+      delete *i;
+    }
+  m_requests.clear ();
+}
+
 void RegisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (obj);
@@ -21,8 +21,10 @@
 #define CONFIG_H
 
 #include "ptr.h"
+#include "type-id.h"
 #include <string>
 #include <vector>
+#include <utility>
 
 /**
  * \file
@@ -35,6 +37,7 @@ namespace ns3 {
 class AttributeValue;
 class Object;
 class CallbackBase;
+class ConfigImpl;
 
 /**
  * \ingroup core
@@ -250,6 +253,168 @@ private:
   std::string m_path;
 };
 
+/**
+ * \ingroup config
+ * \brief A Config path parsed once, so that it can be resolved many times.
+ *
+ * The path is split into its elements when the Path is built: attribute
+ * names, array index matchers and the TypeId of \c $ elements are all
+ * ready to use, so resolving the same path again, or through a
+ * BulkConnector, does no string parsing.
+ *
+ * \code
+ *   Config::Path path ("/NodeList/[0-99]/DeviceList/0/$ns3::WifiNetDevice/Mac/Ssid");
+ *   path.Set (SsidValue (Ssid ("a")));
+ * \endcode
+ */
+class Path
+{
+public:
+  Path ();
+  /**
+   * Parse a Config path.
+   *
+   * \param [in] path The Config path.
+   */
+  explicit Path (std::string path);
+
+  /**
+   * \returns The Config path as given to the constructor.
+   */
+  std::string GetPath (void) const;
+
+  /**
+   * \param [in] value The value to set in all matching attributes.
+   *
+   * Same as Config::Set.
+   */
+  void Set (const AttributeValue &value) const;
+  /**
+   * \param [in] cb The callback to connect to the matching trace sources.
+   *
+   * Same as Config::Connect.
+   */
+  void Connect (const CallbackBase &cb) const;
+  /**
+   * \param [in] cb The callback to connect to the matching trace sources.
+   *
+   * Same as Config::ConnectWithoutContext.
+   */
+  void ConnectWithoutContext (const CallbackBase &cb) const;
+  /**
+   * \returns A container which contains all the objects which match
+   *          the path.
+   *
+   * Same as Config::LookupMatches.
+   */
+  MatchContainer LookupMatches (void) const;
+
+private:
+  friend class ns3::ConfigImpl;
+
+  /** One parsed element of the path. */
+  struct Token
+  {
+    std::string item;     //!< The element as written.
+    bool isGetObject;     //!< \c true for \c $TypeId elements.
+    bool hasTid;          //!< \c true if \c tid could be looked up.
+    TypeId tid;           //!< The TypeId of a \c $TypeId element.
+    bool anyIndex;        //!< \c true if the element is \c *.
+    /** Inclusive index ranges matched by the element. */
+    std::vector<std::pair<uint32_t, uint32_t> > indices;
+    /**
+     * \param [in] i An array index.
+     * \returns \c true if the element matches the index \p i.
+     */
+    bool Matches (uint32_t i) const;
+  };
+
+  /**
+   * Add the index ranges matched by an array element to a token.
+   *
+   * \param [in] element The array element, e.g. \c 3, \c [2-5] or \c 1|7.
+   * \param [in,out] token The token to update.
+   */
+  static void CompileIndex (std::string element, Token *token);
+
+  std::string m_path;                   //!< The path as given.
+  std::string m_leaf;                   //!< The trailing attribute or trace source name.
+  bool m_hasSlash;                      //!< \c true if the path has a leaf separator.
+  std::vector<Token> m_tokens;          //!< The elements of the path, leaf included.
+  std::vector<std::string> m_prefixes;  //!< Canonical path of the first i elements.
+};
+
+/**
+ * \ingroup config
+ * \brief Connect many trace sinks with a single resolution pass.
+ *
+ * Connections are queued and made by Commit.  While committing, each
+ * resolved path prefix is cached, so that paths sharing a prefix (for
+ * example \c /NodeList/<i>/DeviceList/<j>/ for every trace source of a
+ * device) only walk the object tree once.  The object tree must not
+ * change between the calls and Commit.
+ */
+class BulkConnector
+{
+public:
+  BulkConnector ();
+  ~BulkConnector ();
+
+  /**
+   * Queue a Config::Connect.
+   *
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   */
+  void Connect (std::string path, const CallbackBase &cb);
+  /**
+   * Queue a Config::Connect.
+   *
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   */
+  void Connect (const Path &path, const CallbackBase &cb);
+  /**
+   * Queue a Config::ConnectWithoutContext.
+   *
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   */
+  void ConnectWithoutContext (std::string path, const CallbackBase &cb);
+  /**
+   * Queue a Config::ConnectWithoutContext.
+   *
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   */
+  void ConnectWithoutContext (const Path &path, const CallbackBase &cb);
+  /**
+   * \returns The number of connections waiting for Commit.
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Make all the queued connections, in the order they were queued.
+   */
+  void Commit (void);
+
+private:
+  /** A queued connection. */
+  struct Request;
+  /**
+   * Copy constructor, not implemented.
+   * \param [in] o The object to copy.
+   */
+  BulkConnector (const BulkConnector &o);
+  /**
+   * Assignment operator, not implemented.
+   * \param [in] o The object to copy.
+   * \returns The object.
+   */
+  BulkConnector &operator = (const BulkConnector &o);
+
+  std::vector<Request *> m_requests;  //!< The queued connections.
+};
+
 /**
  * \ingroup config
  * \param [in] path The path to perform a match against
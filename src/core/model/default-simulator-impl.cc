@@ -22,13 +22,21 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 #include "pointer.h"
+#include "boolean.h"
+#include "uinteger.h"
+#include "string.h"
+#include "enum.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
 
 
 /**
@@ -53,6 +61,40 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("EnableProfiling",
+                   "Record per event type counts and handler wall clock "
+                   "time, scheduler costs and allocation counts, and "
+                   "report them at Simulator::Destroy.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::SetProfiling,
+                                        &DefaultSimulatorImpl::GetProfiling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ProfileOutput",
+                   "The file the profile is written to; "
+                   "if empty, the profile is written to std::clog.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profileOutput),
+                   MakeStringChecker ())
+    .AddAttribute ("ProfileFormat",
+                   "The format of the profile.",
+                   EnumValue (EventProfiler::RANKED),
+                   MakeEnumAccessor (&DefaultSimulatorImpl::m_profileFormat),
+                   MakeEnumChecker (EventProfiler::RANKED, "Ranked",
+                                    EventProfiler::FOLDED, "Folded"))
+    .AddAttribute ("RemoveCancelledEvents",
+                   "Remove cancelled events from the event list right away "
+                   "when the scheduler supports an efficient Remove, "
+                   "instead of leaving them until their timestamp is reached.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::m_removeCancelled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CompactionThreshold",
+                   "Purge the cancelled events left in the event list when "
+                   "there are at least this many of them and they make up "
+                   "at least half of the list.  Zero disables compaction.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::m_compactionThreshold),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -72,6 +114,13 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
   m_eventsWithContextEmpty = true;
+  m_profiling = false;
+  m_profileFormat = EventProfiler::RANKED;
+  m_removeCancelled = true;
+  m_compactionThreshold = 1000;
+  m_cancelledEvents = 0;
+  m_removedOnCancel = 0;
+  m_compactions = 0;
   m_main = SystemThread::Self();
 }
 
@@ -108,6 +157,64 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  if (EventProfiler::IsEnabled ())
+    {
+      WriteProfile ();
+      EventProfiler::SetEnabled (false);
+      EventProfiler::Reset ();
+    }
+}
+
+void
+DefaultSimulatorImpl::SetProfiling (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  if (enable == m_profiling)
+    {
+      return;
+    }
+  m_profiling = enable;
+  EventProfiler::SetEnabled (enable);
+}
+
+bool
+DefaultSimulatorImpl::GetProfiling (void) const
+{
+  return EventProfiler::IsEnabled ();
+}
+
+void
+DefaultSimulatorImpl::WriteProfile (void) const
+{
+  NS_LOG_FUNCTION (this);
+  EventProfiler::Format format = static_cast<EventProfiler::Format> (m_profileFormat);
+  if (m_profileOutput.empty ())
+    {
+      EventProfiler::Report (std::clog, format);
+      return;
+    }
+  std::ofstream os (m_profileOutput.c_str ());
+  if (!os.is_open ())
+    {
+      NS_LOG_ERROR ("Cannot open profile output file " << m_profileOutput);
+      return;
+    }
+  EventProfiler::Report (os, format);
+}
+
+void
+DefaultSimulatorImpl::InsertEvent (const Scheduler::Event &ev)
+{
+  if (EventProfiler::IsEnabled ())
+    {
+      uint64_t start = EventProfiler::GetTimestamp ();
+      m_events->Insert (ev);
+      EventProfiler::RecordInsert (EventProfiler::GetTimestamp () - start);
+    }
+  else
+    {
+      m_events->Insert (ev);
+    }
 }
 
 void
@@ -137,16 +244,41 @@ DefaultSimulatorImpl::GetSystemId (void) const
 void
 DefaultSimulatorImpl::ProcessOneEvent (void)
 {
+  bool profile = EventProfiler::IsEnabled ();
+  uint64_t start = 0;
+  if (profile)
+    {
+      start = EventProfiler::GetTimestamp ();
+    }
+
   Scheduler::Event next = m_events->RemoveNext ();
 
+  bool cancelled = false;
+  if (profile)
+    {
+      uint64_t now = EventProfiler::GetTimestamp ();
+      EventProfiler::RecordSchedulerRemove (now - start);
+      start = now;
+      cancelled = next.impl->IsCancelled ();
+    }
+
   NS_ASSERT (next.key.m_ts >= m_currentTs);
   m_unscheduledEvents--;
+  if (m_cancelledEvents != 0 && next.impl->IsCancelled ())
+    {
+      m_cancelledEvents--;
+    }
 
   NS_LOG_LOGIC ("handle " << next.key.m_ts);
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
   next.impl->Invoke ();
+  if (profile)
+    {
+      EventProfiler::RecordEvent (next.impl, cancelled,
+                                  EventProfiler::GetTimestamp () - start);
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -184,7 +316,7 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
        ev.key.m_uid = m_uid;
        m_uid++;
        m_unscheduledEvents++;
-       m_events->Insert (ev);
+       InsertEvent (ev);
     }
 }
 
@@ -241,7 +373,7 @@ DefaultSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
   ev.key.m_uid = m_uid;
   m_uid++;
   m_unscheduledEvents++;
-  m_events->Insert (ev);
+  InsertEvent (ev);
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -260,7 +392,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       ev.key.m_uid = m_uid;
       m_uid++;
       m_unscheduledEvents++;
-      m_events->Insert (ev);
+      InsertEvent (ev);
     }
   else
     {
@@ -289,7 +421,7 @@ DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
   ev.key.m_uid = m_uid;
   m_uid++;
   m_unscheduledEvents++;
-  m_events->Insert (ev);
+  InsertEvent (ev);
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -349,7 +481,17 @@ DefaultSimulatorImpl::Remove (const EventId &id)
   event.key.m_ts = id.GetTs ();
   event.key.m_context = id.GetContext ();
   event.key.m_uid = id.GetUid ();
-  m_events->Remove (event);
+  if (EventProfiler::IsEnabled ())
+    {
+      uint64_t start = EventProfiler::GetTimestamp ();
+      m_events->Remove (event);
+      EventProfiler::RecordSchedulerRemove (EventProfiler::GetTimestamp () - start);
+      EventProfiler::RecordRemove (event.impl);
+    }
+  else
+    {
+      m_events->Remove (event);
+    }
   event.impl->Cancel ();
   // whenever we remove an event from the event list, we have to unref it.
   event.impl->Unref ();
@@ -360,12 +502,86 @@ DefaultSimulatorImpl::Remove (const EventId &id)
 void
 DefaultSimulatorImpl::Cancel (const EventId &id)
 {
-  if (!IsExpired (id))
+  if (IsExpired (id))
+    {
+      return;
+    }
+  if (id.GetUid () == 2)
     {
+      // destroy events.
       id.PeekEventImpl ()->Cancel ();
+      return;
+    }
+  if (m_removeCancelled && m_events->IsRemoveEfficient ())
+    {
+      Remove (id);
+      m_removedOnCancel++;
+      return;
+    }
+  id.PeekEventImpl ()->Cancel ();
+  m_cancelledEvents++;
+  if (m_compactionThreshold != 0
+      && m_cancelledEvents >= m_compactionThreshold
+      && 2 * m_cancelledEvents >= static_cast<uint32_t> (m_unscheduledEvents))
+    {
+      Compact ();
     }
 }
 
+void
+DefaultSimulatorImpl::Compact (void)
+{
+  NS_LOG_FUNCTION (this << m_cancelledEvents << m_unscheduledEvents);
+  std::vector<Scheduler::Event> live;
+  live.reserve (m_unscheduledEvents - m_cancelledEvents);
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      if (next.impl->IsCancelled ())
+        {
+          next.impl->Unref ();
+          m_unscheduledEvents--;
+        }
+      else
+        {
+          live.push_back (next);
+        }
+    }
+  // Events come out sorted, which is the cheapest insertion order
+  // for the heap-based schedulers.
+  for (std::vector<Scheduler::Event>::const_iterator i = live.begin ();
+       i != live.end (); ++i)
+    {
+      m_events->Insert (*i);
+    }
+  m_cancelledEvents = 0;
+  m_compactions++;
+}
+
+uint32_t
+DefaultSimulatorImpl::GetEventCount (void) const
+{
+  return m_unscheduledEvents;
+}
+
+uint32_t
+DefaultSimulatorImpl::GetCancelledEventCount (void) const
+{
+  return m_cancelledEvents;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetRemovedOnCancelCount (void) const
+{
+  return m_removedOnCancel;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetCompactionCount (void) const
+{
+  return m_compactions;
+}
+
 bool
 DefaultSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -414,4 +630,10 @@ DefaultSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+void
+DefaultSimulatorImpl::SetContext (uint32_t context)
+{
+  m_currentContext = context;
+}
+
 } // namespace ns3
@@ -30,6 +30,7 @@
 #include "ptr.h"
 
 #include <list>
+#include <string>
 
 /**
  * \file
@@ -77,6 +78,26 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual void SetContext (uint32_t context);
+
+  /**
+   * \returns the number of events in the event list, including the
+   *          cancelled events which have not been purged yet.
+   */
+  uint32_t GetEventCount (void) const;
+  /**
+   * \returns the number of cancelled events still in the event list.
+   */
+  uint32_t GetCancelledEventCount (void) const;
+  /**
+   * \returns the number of cancelled events which were removed from
+   *          the event list when they were cancelled.
+   */
+  uint64_t GetRemovedOnCancelCount (void) const;
+  /**
+   * \returns the number of times the event list was compacted.
+   */
+  uint64_t GetCompactionCount (void) const;
 
 private:
   virtual void DoDispose (void);
@@ -85,6 +106,37 @@ private:
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
   void ProcessEventsWithContext (void);
+  /**
+   * Insert an event in the event list, timing the insertion
+   * when profiling.
+   *
+   * \param [in] ev The event to insert.
+   */
+  void InsertEvent (const Scheduler::Event &ev);
+
+  /**
+   * Enable or disable the EventProfiler.
+   *
+   * The profiler is only touched when the attribute changes, so that
+   * constructing the simulator with the default value doesn't disable
+   * a profiler enabled directly with EventProfiler::SetEnabled.
+   *
+   * \param [in] enable Whether to profile.
+   */
+  void SetProfiling (bool enable);
+  /**
+   * \returns true if the EventProfiler is enabled.
+   */
+  bool GetProfiling (void) const;
+  /** Write the EventProfiler report to #m_profileOutput. */
+  void WriteProfile (void) const;
+  /**
+   * Purge all the cancelled events from the event list.
+   *
+   * Used for schedulers which cannot remove events efficiently, when
+   * cancelled events come to dominate the event list.
+   */
+  void Compact (void);
  
   /** Wrap an event with its execution context. */
   struct EventWithContext {
@@ -132,6 +184,24 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** The value of the EnableProfiling attribute. */
+  bool m_profiling;
+  /** File the event profile is written to, std::clog if empty. */
+  std::string m_profileOutput;
+  /** The EventProfiler::Format of the event profile. */
+  int m_profileFormat;
+
+  /** Remove cancelled events when the scheduler can do so efficiently. */
+  bool m_removeCancelled;
+  /** Minimum number of cancelled events which triggers a compaction. */
+  uint32_t m_compactionThreshold;
+  /** Number of cancelled events still in the event list. */
+  uint32_t m_cancelledEvents;
+  /** Number of events removed from the event list when cancelled. */
+  uint64_t m_removedOnCancel;
+  /** Number of event list compactions. */
+  uint64_t m_compactions;
 };
 
 } // namespace ns3
@@ -0,0 +1,380 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <map>
+#include <algorithm>
+#include <iomanip>
+#include <typeinfo>
+#include <cstdlib>
+#include <time.h>
+
+#if (__GNUC__ >= 3)
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+bool EventProfiler::m_enabled = false;
+
+namespace {
+
+/** Counters kept for each event type while recording. */
+struct EventRecord
+{
+  EventRecord ()
+    : count (0),
+      cancelled (0),
+      removed (0),
+      wallNs (0)
+  {}
+  uint64_t count;     //!< Number of events invoked
+  uint64_t cancelled; //!< Number of cancelled events popped
+  uint64_t removed;   //!< Number of events removed
+  uint64_t wallNs;    //!< Time spent in handlers
+};
+
+/** Counters for one scheduler operation. */
+struct OperationRecord
+{
+  OperationRecord ()
+    : count (0),
+      wallNs (0)
+  {}
+  uint64_t count;  //!< Number of calls
+  uint64_t wallNs; //!< Total duration of the calls
+};
+
+/**
+ * All the profiler state.
+ *
+ * Event types are keyed by the address of their std::type_info name,
+ * so the fast path does no string manipulation; records which end up
+ * with the same demangled name are merged when a report is built.
+ */
+struct ProfilerData
+{
+  std::map<const char *, EventRecord> events;    //!< Per event type counters
+  std::map<const char *, uint64_t> allocations;  //!< Allocation counters
+  OperationRecord inserts;                       //!< Scheduler::Insert
+  OperationRecord removes;                       //!< Scheduler::Remove*
+};
+
+/**
+ * \returns the profiler state.
+ */
+ProfilerData &
+GetData (void)
+{
+  static ProfilerData data;
+  return data;
+}
+
+/**
+ * Get a readable name for an event type.
+ *
+ * Events built by MakeEvent are local classes of the MakeEvent
+ * template, so we keep only the template arguments, which name the
+ * target function type and the object type.
+ *
+ * \param [in] mangled The std::type_info name.
+ * \returns The simplified, demangled name.
+ */
+std::string
+GetEventTypeName (const char *mangled)
+{
+  std::string name = mangled;
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, NULL, NULL, &status);
+  if (status == 0 && demangled != 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+  const std::string prefix = "ns3::MakeEvent<";
+  if (name.compare (0, prefix.size (), prefix) == 0)
+    {
+      std::string::size_type i = prefix.size ();
+      int depth = 1;
+      for (; i < name.size () && depth > 0; ++i)
+        {
+          if (name[i] == '<')
+            {
+              depth++;
+            }
+          else if (name[i] == '>')
+            {
+              depth--;
+            }
+        }
+      name = name.substr (prefix.size (), i - 1 - prefix.size ());
+    }
+  return name;
+}
+
+/**
+ * Sort EventStats by decreasing wall clock time, then by count.
+ *
+ * \param [in] a The left operand.
+ * \param [in] b The right operand.
+ * \returns true if a should be reported before b.
+ */
+bool
+CompareEventStats (const EventProfiler::EventStats &a,
+                   const EventProfiler::EventStats &b)
+{
+  if (a.wallNs != b.wallNs)
+    {
+      return a.wallNs > b.wallNs;
+    }
+  return a.count > b.count;
+}
+
+/**
+ * Sort AllocationStats by decreasing count.
+ *
+ * \param [in] a The left operand.
+ * \param [in] b The right operand.
+ * \returns true if a should be reported before b.
+ */
+bool
+CompareAllocationStats (const EventProfiler::AllocationStats &a,
+                        const EventProfiler::AllocationStats &b)
+{
+  return a.count > b.count;
+}
+
+} // unnamed namespace
+
+void
+EventProfiler::SetEnabled (bool enabled)
+{
+  NS_LOG_FUNCTION (enabled);
+  m_enabled = enabled;
+}
+
+void
+EventProfiler::Reset (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  ProfilerData &data = GetData ();
+  data.events.clear ();
+  data.allocations.clear ();
+  data.inserts = OperationRecord ();
+  data.removes = OperationRecord ();
+}
+
+uint64_t
+EventProfiler::GetTimestamp (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t> (ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void
+EventProfiler::RecordEvent (const EventImpl *event, bool cancelled, uint64_t wallNs)
+{
+  EventRecord &record = GetData ().events[typeid (*event).name ()];
+  if (cancelled)
+    {
+      record.cancelled++;
+    }
+  else
+    {
+      record.count++;
+      record.wallNs += wallNs;
+    }
+}
+
+void
+EventProfiler::RecordRemove (const EventImpl *event)
+{
+  GetData ().events[typeid (*event).name ()].removed++;
+}
+
+void
+EventProfiler::RecordInsert (uint64_t wallNs)
+{
+  OperationRecord &record = GetData ().inserts;
+  record.count++;
+  record.wallNs += wallNs;
+}
+
+void
+EventProfiler::RecordSchedulerRemove (uint64_t wallNs)
+{
+  OperationRecord &record = GetData ().removes;
+  record.count++;
+  record.wallNs += wallNs;
+}
+
+void
+EventProfiler::RecordAllocation (const char *name)
+{
+  GetData ().allocations[name]++;
+}
+
+std::vector<EventProfiler::EventStats>
+EventProfiler::GetEventStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::map<std::string, EventStats> merged;
+  ProfilerData &data = GetData ();
+  for (std::map<const char *, EventRecord>::const_iterator i = data.events.begin ();
+       i != data.events.end (); ++i)
+    {
+      std::string name = GetEventTypeName (i->first);
+      std::map<std::string, EventStats>::iterator j = merged.find (name);
+      if (j == merged.end ())
+        {
+          EventStats stats;
+          stats.name = name;
+          stats.count = 0;
+          stats.cancelled = 0;
+          stats.removed = 0;
+          stats.wallNs = 0;
+          j = merged.insert (std::make_pair (name, stats)).first;
+        }
+      j->second.count += i->second.count;
+      j->second.cancelled += i->second.cancelled;
+      j->second.removed += i->second.removed;
+      j->second.wallNs += i->second.wallNs;
+    }
+  std::vector<EventStats> stats;
+  for (std::map<std::string, EventStats>::const_iterator i = merged.begin ();
+       i != merged.end (); ++i)
+    {
+      stats.push_back (i->second);
+    }
+  std::stable_sort (stats.begin (), stats.end (), &CompareEventStats);
+  return stats;
+}
+
+std::vector<EventProfiler::AllocationStats>
+EventProfiler::GetAllocationStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::map<std::string, uint64_t> merged;
+  ProfilerData &data = GetData ();
+  for (std::map<const char *, uint64_t>::const_iterator i = data.allocations.begin ();
+       i != data.allocations.end (); ++i)
+    {
+      merged[i->first] += i->second;
+    }
+  std::vector<AllocationStats> stats;
+  for (std::map<std::string, uint64_t>::const_iterator i = merged.begin ();
+       i != merged.end (); ++i)
+    {
+      AllocationStats s;
+      s.name = i->first;
+      s.count = i->second;
+      stats.push_back (s);
+    }
+  std::stable_sort (stats.begin (), stats.end (), &CompareAllocationStats);
+  return stats;
+}
+
+void
+EventProfiler::Report (std::ostream &os, enum Format format)
+{
+  NS_LOG_FUNCTION (&os << format);
+  std::vector<EventStats> events = GetEventStats ();
+
+  if (format == FOLDED)
+    {
+      for (std::vector<EventStats>::const_iterator i = events.begin ();
+           i != events.end (); ++i)
+        {
+          if (i->wallNs == 0)
+            {
+              continue;
+            }
+          std::string name = i->name;
+          std::replace (name.begin (), name.end (), ';', ',');
+          os << "ns3::Simulator::Run;" << name << " " << i->wallNs << std::endl;
+        }
+      return;
+    }
+
+  uint64_t totalCount = 0;
+  uint64_t totalCancelled = 0;
+  uint64_t totalNs = 0;
+  for (std::vector<EventStats>::const_iterator i = events.begin ();
+       i != events.end (); ++i)
+    {
+      totalCount += i->count;
+      totalCancelled += i->cancelled;
+      totalNs += i->wallNs;
+    }
+  ProfilerData &data = GetData ();
+  std::ios_base::fmtflags flags = os.flags ();
+  os << std::fixed << std::setprecision (1);
+  os << "Event profile: " << totalCount << " events invoked, "
+     << totalCancelled << " cancelled events popped, "
+     << totalNs / 1e6 << " ms in handlers" << std::endl;
+  os << std::setw (6) << "rank"
+     << std::setw (12) << "events"
+     << std::setw (12) << "cancelled"
+     << std::setw (10) << "cancel%"
+     << std::setw (10) << "removed"
+     << std::setw (12) << "total(ms)"
+     << std::setw (10) << "mean(ns)"
+     << std::setw (8) << "time%"
+     << "  event type" << std::endl;
+  uint32_t rank = 1;
+  for (std::vector<EventStats>::const_iterator i = events.begin ();
+       i != events.end (); ++i, ++rank)
+    {
+      uint64_t scheduled = i->count + i->cancelled + i->removed;
+      os << std::setw (6) << rank
+         << std::setw (12) << i->count
+         << std::setw (12) << i->cancelled
+         << std::setw (10) << (scheduled ? 100.0 * (i->cancelled + i->removed) / scheduled : 0.0)
+         << std::setw (10) << i->removed
+         << std::setw (12) << i->wallNs / 1e6
+         << std::setw (10) << (i->count ? double (i->wallNs) / i->count : 0.0)
+         << std::setw (8) << (totalNs ? 100.0 * i->wallNs / totalNs : 0.0)
+         << "  " << i->name << std::endl;
+    }
+  os << "Scheduler: " << data.inserts.count << " inserts ("
+     << (data.inserts.count ? double (data.inserts.wallNs) / data.inserts.count : 0.0)
+     << " ns mean), " << data.removes.count << " removes ("
+     << (data.removes.count ? double (data.removes.wallNs) / data.removes.count : 0.0)
+     << " ns mean)" << std::endl;
+  std::vector<AllocationStats> allocations = GetAllocationStats ();
+  for (std::vector<AllocationStats>::const_iterator i = allocations.begin ();
+       i != allocations.end (); ++i)
+    {
+      os << "Allocations: " << i->name << " " << i->count << std::endl;
+    }
+  os.flags (flags);
+}
+
+} // namespace ns3
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ * \brief Collect per event type execution statistics.
+ *
+ * The profiler records, for each kind of event run by the simulator,
+ * the number of events invoked, the number of cancelled events found
+ * in the event list, and the wall clock time spent in the event
+ * handlers.  Events are classified by the dynamic type of their
+ * EventImpl, which for events built by MakeEvent encodes the target
+ * method signature and the object type.  It also records the cost of
+ * the scheduler Insert and Remove operations, and keeps simple
+ * allocation counters which other modules (Packet, Buffer) feed.
+ *
+ * All the recording functions must only be called when IsEnabled()
+ * returns true: that test is a single load of a static flag, which is
+ * what keeps the instrumentation essentially free when profiling is
+ * disabled.
+ *
+ * The profiler is normally driven by the DefaultSimulatorImpl
+ * attributes EnableProfiling, ProfileOutput and ProfileFormat; the
+ * report is written when Simulator::Destroy is called.
+ */
+class EventProfiler
+{
+public:
+  /** Report formats. */
+  enum Format
+  {
+    RANKED, /**< Human readable table, sorted by wall clock time. */
+    FOLDED  /**< Folded stacks, suitable as flamegraph.pl input. */
+  };
+
+  /** Statistics for one event type. */
+  struct EventStats
+  {
+    std::string name;     //!< Event type name
+    uint64_t count;       //!< Number of events invoked
+    uint64_t cancelled;   //!< Number of cancelled events popped from the scheduler
+    uint64_t removed;     //!< Number of events removed with Simulator::Remove
+    uint64_t wallNs;      //!< Wall clock time spent in the handlers, in ns
+  };
+
+  /** Statistics for one allocation counter. */
+  struct AllocationStats
+  {
+    std::string name;     //!< Counter name
+    uint64_t count;       //!< Number of allocations
+  };
+
+  /**
+   * \returns true if the profiler is currently recording.
+   */
+  static inline bool IsEnabled (void)
+  {
+    return m_enabled;
+  }
+  /**
+   * Start or stop recording.
+   *
+   * \param [in] enabled Whether to record.
+   */
+  static void SetEnabled (bool enabled);
+  /** Forget all the statistics collected so far. */
+  static void Reset (void);
+
+  /**
+   * \returns a monotonic wall clock timestamp, in nanoseconds.
+   */
+  static uint64_t GetTimestamp (void);
+
+  /**
+   * Record the execution of an event.
+   *
+   * \param [in] event The event.
+   * \param [in] cancelled Whether the event had been cancelled,
+   *             in which case it was not invoked.
+   * \param [in] wallNs The time spent invoking the event.
+   */
+  static void RecordEvent (const EventImpl *event, bool cancelled, uint64_t wallNs);
+  /**
+   * Record the removal of an event with Simulator::Remove.
+   *
+   * \param [in] event The event.
+   */
+  static void RecordRemove (const EventImpl *event);
+  /**
+   * Record a Scheduler::Insert.
+   *
+   * \param [in] wallNs The duration of the call.
+   */
+  static void RecordInsert (uint64_t wallNs);
+  /**
+   * Record a Scheduler::RemoveNext or Scheduler::Remove.
+   *
+   * \param [in] wallNs The duration of the call.
+   */
+  static void RecordSchedulerRemove (uint64_t wallNs);
+  /**
+   * Increment an allocation counter.
+   *
+   * \param [in] name The counter name.  This must be a string
+   *             literal, or at least outlive the profiler.
+   */
+  static void RecordAllocation (const char *name);
+
+  /**
+   * \returns the per event type statistics, sorted by decreasing wall
+   *          clock time.
+   */
+  static std::vector<EventStats> GetEventStats (void);
+  /**
+   * \returns the allocation counters, sorted by decreasing count.
+   */
+  static std::vector<AllocationStats> GetAllocationStats (void);
+
+  /**
+   * Write a report of the statistics collected so far.
+   *
+   * \param [in,out] os The output stream.
+   * \param [in] format The report format.
+   */
+  static void Report (std::ostream &os, enum Format format = RANKED);
+
+private:
+  static bool m_enabled; //!< Whether the profiler is recording.
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
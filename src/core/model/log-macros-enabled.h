@@ -153,7 +153,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (level))                              \
+      if (((level) & NS3_LOG_MAX_LEVEL) && g_log.IsEnabled (level)) \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -177,7 +177,8 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if ((ns3::LOG_FUNCTION & NS3_LOG_MAX_LEVEL)               \
+          && g_log.IsEnabled (ns3::LOG_FUNCTION))               \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -214,7 +215,8 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if ((ns3::LOG_FUNCTION & NS3_LOG_MAX_LEVEL)               \
+          && g_log.IsEnabled (ns3::LOG_FUNCTION))               \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -165,6 +165,22 @@ void LogComponentDisableAll (enum LogLevel level);
 } // namespace ns3
 
 
+#ifndef NS3_LOG_MAX_LEVEL
+/**
+ * The log levels compiled in the current translation unit.
+ *
+ * The logging macros of the levels outside this mask compile to
+ * nothing, whatever the levels enabled at run time.  waf sets it for
+ * the files of the log components given to
+ * \code
+ *   ./waf configure --log-max-level="*=warn:MacLow=all"
+ * \endcode
+ * so that the logs of some components stay available while the others
+ * cost nothing.
+ */
+#define NS3_LOG_MAX_LEVEL ns3::LOG_LEVEL_ALL
+#endif
+
 /**
  * Define a Log component with a specific name.
  *
@@ -199,7 +215,8 @@ void LogComponentDisableAll (enum LogLevel level);
  * \param [in] name The log component name.
  */
 #define NS_LOG_COMPONENT_DEFINE(name)                           \
-  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__)
+  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__, \
+    (ns3::LogLevel) (ns3::LOG_ALL & ~(NS3_LOG_MAX_LEVEL)))
 
 /**
  * Define a logging component with a mask.
@@ -210,7 +227,8 @@ void LogComponentDisableAll (enum LogLevel level);
  * \param [in] mask The default mask.
  */
 #define NS_LOG_COMPONENT_DEFINE_MASK(name, mask)                \
-  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__, mask)
+  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__, \
+    (ns3::LogLevel) ((mask) | (ns3::LOG_ALL & ~(NS3_LOG_MAX_LEVEL))))
 
 /**
  * Use \ref NS_LOG to output a message of level LOG_ERROR.
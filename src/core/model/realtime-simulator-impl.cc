@@ -820,6 +820,13 @@ RealtimeSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+void
+RealtimeSimulatorImpl::SetContext (uint32_t context)
+{
+  CriticalSection cs (m_mutex);
+  m_currentContext = context;
+}
+
 void 
 RealtimeSimulatorImpl::SetSynchronizationMode (enum SynchronizationMode mode)
 {
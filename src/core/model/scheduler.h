@@ -135,6 +135,17 @@ public:
    * \param [in] ev The event to remove
    */
   virtual void Remove (const Event &ev) = 0;
+  /**
+   * Test if Remove is cheap enough to be used for every cancelled event.
+   *
+   * Simulator implementations use this to decide whether to remove
+   * cancelled events right away, or to leave them in the event list
+   * and compact it from time to time.
+   *
+   * \returns \c true if Remove costs no more than O(log n),
+   *          \c false (the default) otherwise.
+   */
+  virtual bool IsRemoveEfficient (void) const;
 };
 
 /**
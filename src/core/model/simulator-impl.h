@@ -99,6 +99,13 @@ public:
   virtual uint32_t GetSystemId () const = 0; 
   /** \copydoc Simulator::GetContext */
   virtual uint32_t GetContext (void) const = 0;
+  /**
+   * Change the context of the event being executed.
+   *
+   * \param [in] context The new current context.
+   * \see ScopedContext
+   */
+  virtual void SetContext (uint32_t context) = 0;
 };
 
 } // namespace ns3
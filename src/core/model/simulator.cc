@@ -393,6 +393,17 @@ Simulator::GetImplementation (void)
   return GetImpl ();
 }
 
+ScopedContext::ScopedContext (uint32_t context)
+  : m_previous (GetImpl ()->GetContext ())
+{
+  GetImpl ()->SetContext (context);
+}
+
+ScopedContext::~ScopedContext ()
+{
+  GetImpl ()->SetContext (m_previous);
+}
+
 
 
 } // namespace ns3
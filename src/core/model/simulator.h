@@ -1203,6 +1203,54 @@ private:
  */
 Time Now (void);
 
+/**
+ * @ingroup simulator
+ * @brief Execute a part of an event in the context of another node.
+ *
+ * The constructor makes the given context the current one, and the
+ * destructor restores the previous one.  In between, the log messages
+ * and the events scheduled with Simulator::Schedule or
+ * Simulator::ScheduleNow are in the given context.  This lets a single
+ * event act on behalf of several nodes:
+ * @code
+ *   for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+ *     {
+ *       ScopedContext context ((*i)->GetId ());
+ *       Update (*i);
+ *     }
+ * @endcode
+ *
+ * It must only be used by the simulation thread, while an event
+ * is being executed.
+ */
+class ScopedContext
+{
+public:
+  /**
+   * Switch to a context.
+   *
+   * @param [in] context The current context until the end of the scope.
+   */
+  ScopedContext (uint32_t context);
+  /** Restore the previous context. */
+  ~ScopedContext ();
+
+private:
+  /**
+   * Copy constructor, not implemented.
+   * @param [in] o The ScopedContext to copy.
+   */
+  ScopedContext (const ScopedContext &o);
+  /**
+   * Assignment operator, not implemented.
+   * @param [in] o The ScopedContext to copy.
+   * @returns This ScopedContext.
+   */
+  ScopedContext &operator = (const ScopedContext &o);
+
+  uint32_t m_previous;  //!< The context to restore.
+};
+
 } // namespace ns3
 
 
@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/checkpoint-helper.h"
+#include "ns3/test.h"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+class CheckpointHelperTestCase : public TestCase
+{
+public:
+  CheckpointHelperTestCase ();
+  virtual void DoRun (void);
+};
+
+CheckpointHelperTestCase::CheckpointHelperTestCase ()
+  : TestCase ("Collect the result of each variant, and only of the variants")
+{
+}
+
+void
+CheckpointHelperTestCase::DoRun (void)
+{
+  // A child which the helper must not reap.
+  pid_t other = fork ();
+  if (other == 0)
+    {
+      _exit (7);
+    }
+  NS_TEST_ASSERT_MSG_NE (other, -1, "cannot fork");
+
+  CheckpointHelper checkpoint;
+  checkpoint.SetMaxParallel (2);
+  int32_t variant = checkpoint.Branch (5);
+  if (variant >= 0)
+    {
+      // The later variants exit first.
+      usleep ((5 - variant) * 10000);
+      _exit (variant);
+    }
+  NS_TEST_EXPECT_MSG_EQ (variant, -1, "waiting for a variant failed");
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (checkpoint.GetExitCode (i), (int) i, "wrong result of variant " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (checkpoint.GetFailedCount (), 4, "wrong number of failed variants");
+  NS_TEST_EXPECT_MSG_EQ (checkpoint.GetExitCode (5), -1, "result of a missing variant");
+
+  int status;
+  pid_t pid = waitpid (other, &status, 0);
+  NS_TEST_ASSERT_MSG_EQ (pid, other, "other child reaped by the helper");
+  NS_TEST_EXPECT_MSG_EQ (WIFEXITED (status), true, "other child did not exit");
+  NS_TEST_EXPECT_MSG_EQ (WEXITSTATUS (status), 7, "wrong exit code of the other child");
+}
+
+class CheckpointHelperTestSuite : public TestSuite
+{
+public:
+  CheckpointHelperTestSuite ();
+};
+
+CheckpointHelperTestSuite::CheckpointHelperTestSuite ()
+  : TestSuite ("checkpoint-helper", UNIT)
+{
+  AddTestCase (new CheckpointHelperTestCase, TestCase::QUICK);
+}
+
+static CheckpointHelperTestSuite checkpointHelperTestSuite;
@@ -669,6 +669,95 @@ ObjectVectorTraceConfigTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodeB/NodesB/1/Source", "Trace 1 did not provide expected context");
 }
 
+// ===========================================================================
+// Test that parsed paths and bulk connections match the same trace sources,
+// with the same contexts, as the string based functions.
+// ===========================================================================
+class BulkConnectConfigTestCase : public TestCase
+{
+public:
+  BulkConnectConfigTestCase ();
+  virtual ~BulkConnectConfigTestCase () {}
+
+  void Trace (int16_t oldValue, int16_t newValue) { m_count++; }
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue) { m_paths.push_back (path); }
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_count;
+  std::vector<std::string> m_paths;
+};
+
+BulkConnectConfigTestCase::BulkConnectConfigTestCase ()
+  : TestCase ("Check that compiled paths and bulk connections work")
+{
+}
+
+void
+BulkConnectConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+  m_count = 0;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+  root->SetNodeB (b);
+  std::vector<Ptr<ConfigTestObject> > objs;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs.push_back (CreateObject<ConfigTestObject> ());
+      b->AddNodeA (objs[i]);
+    }
+
+  //
+  // A parsed path can be used several times.
+  //
+  Config::Path path ("/NodeB/NodesA/1|3/A");
+  path.Set (IntegerValue (-5));
+  objs[1]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -5, "Object Attribute \"A\" not set as expected");
+  objs[2]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+  path.Set (IntegerValue (-6));
+  objs[3]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -6, "Object Attribute \"A\" not set as expected");
+
+  Config::MatchContainer matches = Config::Path ("/NodeB/NodesA/[1-2]").LookupMatches ();
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Wrong number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (1), "/NodeB/NodesA/2/", "Wrong matched path");
+
+  //
+  // Paths sharing a prefix, resolved together.
+  //
+  Config::BulkConnector bulk;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      std::ostringstream oss;
+      oss << "/NodeB/NodesA/" << i << "/Source";
+      bulk.Connect (oss.str (), MakeCallback (&BulkConnectConfigTestCase::TraceWithPath, this));
+    }
+  bulk.ConnectWithoutContext (Config::Path ("/NodeB/NodesA/*/Source"),
+                              MakeCallback (&BulkConnectConfigTestCase::Trace, this));
+  NS_TEST_ASSERT_MSG_EQ (bulk.GetN (), 5, "Wrong number of queued connections");
+  objs[0]->SetAttribute ("Source", IntegerValue (-1));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 0, "Connected before Commit");
+  bulk.Commit ();
+  NS_TEST_ASSERT_MSG_EQ (bulk.GetN (), 0, "Connections still queued after Commit");
+
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs[i]->SetAttribute ("Source", IntegerValue (i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_count, 4, "Trace without context did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 4, "Trace with context did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[0], "/NodeB/NodesA/0/Source", "Trace 0 did not provide expected context");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[3], "/NodeB/NodesA/3/Source", "Trace 3 did not provide expected context");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // Test for the ability to search attributes of parent classes
 // when Resolver searches for attributes in a derived class object.
@@ -737,6 +826,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new BulkConnectConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
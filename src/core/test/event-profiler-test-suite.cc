@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/event-profiler.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+class EventProfilerTestCase : public TestCase
+{
+public:
+  EventProfilerTestCase ();
+  virtual void DoRun (void);
+  void Handler (void);
+  /**
+   * Find the statistics of an event type.
+   * \param stats The statistics.
+   * \param name A substring of the event type name.
+   * \returns The index of the matching entry, or stats.size ().
+   */
+  static uint32_t Find (const std::vector<EventProfiler::EventStats> &stats,
+                        std::string name);
+  uint32_t m_handled;
+};
+
+static void
+EventProfilerFunction (void)
+{
+}
+
+EventProfilerTestCase::EventProfilerTestCase ()
+  : TestCase ("Check event counts and cancellations recorded by the event profiler")
+{
+}
+
+void
+EventProfilerTestCase::Handler (void)
+{
+  m_handled++;
+}
+
+uint32_t
+EventProfilerTestCase::Find (const std::vector<EventProfiler::EventStats> &stats,
+                             std::string name)
+{
+  for (uint32_t i = 0; i < stats.size (); ++i)
+    {
+      if (stats[i].name.find (name) != std::string::npos)
+        {
+          return i;
+        }
+    }
+  return stats.size ();
+}
+
+void
+EventProfilerTestCase::DoRun (void)
+{
+  m_handled = 0;
+  // keep the cancelled event in the event list until its timestamp
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::RemoveCancelledEvents", BooleanValue (false));
+  EventProfiler::Reset ();
+  EventProfiler::SetEnabled (true);
+
+  Simulator::Schedule (MicroSeconds (1), &EventProfilerTestCase::Handler, this);
+  Simulator::Schedule (MicroSeconds (2), &EventProfilerTestCase::Handler, this);
+  Simulator::Schedule (MicroSeconds (3), &EventProfilerTestCase::Handler, this);
+  Simulator::Schedule (MicroSeconds (1), &EventProfilerFunction);
+  EventId cancelled = Simulator::Schedule (MicroSeconds (2), &EventProfilerFunction);
+  Simulator::Cancel (cancelled);
+  EventId removed = Simulator::Schedule (MicroSeconds (2), &EventProfilerFunction);
+  Simulator::Remove (removed);
+  Simulator::Run ();
+
+  std::vector<EventProfiler::EventStats> stats = EventProfiler::GetEventStats ();
+  uint32_t member = Find (stats, "EventProfilerTestCase");
+  NS_TEST_ASSERT_MSG_LT (member, stats.size (), "Member event type not found");
+  NS_TEST_EXPECT_MSG_EQ (stats[member].count, 3, "Wrong member event count");
+  NS_TEST_EXPECT_MSG_EQ (stats[member].cancelled, 0, "Wrong member cancellation count");
+  uint32_t function = Find (stats, "void (*)()");
+  NS_TEST_ASSERT_MSG_LT (function, stats.size (), "Function event type not found");
+  NS_TEST_EXPECT_MSG_EQ (stats[function].count, 1, "Wrong function event count");
+  NS_TEST_EXPECT_MSG_EQ (stats[function].cancelled, 1, "Wrong function cancellation count");
+  NS_TEST_EXPECT_MSG_EQ (stats[function].removed, 1, "Wrong function removal count");
+  NS_TEST_EXPECT_MSG_EQ (m_handled, 3, "Profiling changed the events run");
+
+  std::ostringstream folded;
+  EventProfiler::Report (folded, EventProfiler::FOLDED);
+  NS_TEST_EXPECT_MSG_NE (folded.str ().find ("ns3::Simulator::Run;"), std::string::npos,
+                         "Missing folded stack");
+
+  EventProfiler::SetEnabled (false);
+  EventProfiler::Reset ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::RemoveCancelledEvents", BooleanValue (true));
+}
+
+static class EventProfilerTestSuite : public TestSuite
+{
+public:
+  EventProfilerTestSuite ()
+    : TestSuite ("event-profiler", UNIT)
+  {
+    AddTestCase (new EventProfilerTestCase (), TestCase::QUICK);
+  }
+} g_eventProfilerTestSuite;
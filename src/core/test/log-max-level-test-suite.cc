@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Compile this file as if waf had been configured with
+// --log-max-level="LogMaxLevelTestSuite=warn"
+#undef NS3_LOG_MAX_LEVEL
+#define NS3_LOG_MAX_LEVEL ns3::LOG_LEVEL_WARN
+
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LogMaxLevelTestSuite");
+
+/// Number of logging arguments evaluated
+static int g_evaluated = 0;
+
+/**
+ * \returns zero, counting the calls
+ */
+static int
+Evaluate (void)
+{
+  g_evaluated++;
+  return 0;
+}
+
+class LogMaxLevelTestCase : public TestCase
+{
+public:
+  LogMaxLevelTestCase ();
+  virtual ~LogMaxLevelTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LogMaxLevelTestCase::LogMaxLevelTestCase (void)
+  : TestCase ("Check that the levels above the maximum are compiled out")
+{
+}
+
+void
+LogMaxLevelTestCase::DoRun (void)
+{
+  LogComponentEnable ("LogMaxLevelTestSuite", LOG_LEVEL_ALL);
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsEnabled (LOG_WARN), true, "Compiled level not enabled");
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsEnabled (LOG_DEBUG), false, "Compiled out level enabled");
+  NS_TEST_EXPECT_MSG_EQ (g_log.IsEnabled (LOG_FUNCTION), false, "Compiled out level enabled");
+
+  std::ostringstream oss;
+  std::streambuf *clog = std::clog.rdbuf (oss.rdbuf ());
+  g_evaluated = 0;
+  NS_LOG_FUNCTION (Evaluate ());
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_DEBUG ("debug " << Evaluate ());
+  NS_LOG_INFO ("info " << Evaluate ());
+  NS_LOG_LOGIC ("logic " << Evaluate ());
+  int compiledOut = g_evaluated;
+  NS_LOG_WARN ("warn " << Evaluate ());
+  NS_LOG_ERROR ("error " << Evaluate ());
+  std::clog.rdbuf (clog);
+  LogComponentDisable ("LogMaxLevelTestSuite", LOG_LEVEL_ALL);
+
+  NS_TEST_EXPECT_MSG_EQ (compiledOut, 0, "Arguments of compiled out levels were evaluated");
+#ifdef NS3_LOG_ENABLE
+  NS_TEST_EXPECT_MSG_EQ (g_evaluated, 2, "Arguments of compiled levels were not evaluated");
+  NS_TEST_EXPECT_MSG_EQ ((oss.str ().find ("warn 0") != std::string::npos), true, "Missing warning");
+  NS_TEST_EXPECT_MSG_EQ ((oss.str ().find ("debug") == std::string::npos), true, "Unexpected debug message");
+#else
+  NS_TEST_EXPECT_MSG_EQ (g_evaluated, 0, "Arguments evaluated without logging");
+#endif
+}
+
+class LogMaxLevelTestSuite : public TestSuite
+{
+public:
+  LogMaxLevelTestSuite ();
+};
+
+LogMaxLevelTestSuite::LogMaxLevelTestSuite ()
+  : TestSuite ("log-max-level", UNIT)
+{
+  AddTestCase (new LogMaxLevelTestCase, TestCase::QUICK);
+}
+
+static LogMaxLevelTestSuite logMaxLevelTestSuite;
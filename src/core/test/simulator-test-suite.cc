@@ -19,11 +19,15 @@
  */
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/uinteger.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 
+#include <vector>
+
 using namespace ns3;
 
 class SimulatorEventsTestCase : public TestCase
@@ -168,6 +172,125 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SimulatorCancelTestCase : public TestCase
+{
+public:
+  SimulatorCancelTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Event (void);
+  uint32_t m_count;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorCancelTestCase::SimulatorCancelTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that cancelled events are purged from the event list with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorCancelTestCase::Event (void)
+{
+  m_count++;
+}
+
+void
+SimulatorCancelTestCase::DoRun (void)
+{
+  m_count = 0;
+  Simulator::SetScheduler (m_schedulerFactory);
+  Ptr<DefaultSimulatorImpl> impl = DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl == 0)
+    {
+      // Only DefaultSimulatorImpl purges cancelled events.
+      Simulator::Destroy ();
+      return;
+    }
+  impl->SetAttribute ("CompactionThreshold", UintegerValue (10));
+  bool efficient = m_schedulerFactory.Create<Scheduler> ()->IsRemoveEfficient ();
+
+  std::vector<EventId> ids;
+  for (uint32_t i = 0; i < 40; ++i)
+    {
+      ids.push_back (Simulator::Schedule (MicroSeconds (i + 1), &SimulatorCancelTestCase::Event, this));
+    }
+  NS_TEST_EXPECT_MSG_EQ (impl->GetEventCount (), 40, "Wrong number of scheduled events");
+  for (uint32_t i = 0; i < 30; ++i)
+    {
+      ids[i].Cancel ();
+      NS_TEST_EXPECT_MSG_EQ (ids[i].IsExpired (), true, "Cancelled event should be expired");
+    }
+  if (efficient)
+    {
+      NS_TEST_EXPECT_MSG_EQ (impl->GetRemovedOnCancelCount (), 30, "Cancelled events were not removed");
+      NS_TEST_EXPECT_MSG_EQ (impl->GetCompactionCount (), 0, "Unexpected compaction");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (impl->GetRemovedOnCancelCount (), 0, "Unexpected removal");
+      NS_TEST_EXPECT_MSG_GT (impl->GetCompactionCount (), 0, "The event list was not compacted");
+    }
+  NS_TEST_EXPECT_MSG_LT (impl->GetCancelledEventCount (), 10, "Too many cancelled events left");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetEventCount () - impl->GetCancelledEventCount (), 10,
+                         "Wrong number of live events");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_count, 10, "Wrong number of events run");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetEventCount (), 0, "Event list should be empty");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetCancelledEventCount (), 0, "Cancelled events left behind");
+  Simulator::Destroy ();
+}
+
+class SimulatorContextTestCase : public TestCase
+{
+public:
+  SimulatorContextTestCase ();
+  virtual void DoRun (void);
+  void Switch (void);
+  void Record (void);
+  std::vector<uint32_t> m_contexts;
+};
+
+SimulatorContextTestCase::SimulatorContextTestCase ()
+  : TestCase ("Check that ScopedContext switches the context within an event")
+{
+}
+
+void
+SimulatorContextTestCase::Switch (void)
+{
+  m_contexts.push_back (Simulator::GetContext ());
+  for (uint32_t context = 1; context < 3; ++context)
+    {
+      ScopedContext scope (context);
+      m_contexts.push_back (Simulator::GetContext ());
+      Simulator::Schedule (MicroSeconds (1), &SimulatorContextTestCase::Record, this);
+    }
+  m_contexts.push_back (Simulator::GetContext ());
+  Simulator::Schedule (MicroSeconds (2), &SimulatorContextTestCase::Record, this);
+}
+
+void
+SimulatorContextTestCase::Record (void)
+{
+  m_contexts.push_back (Simulator::GetContext ());
+}
+
+void
+SimulatorContextTestCase::DoRun (void)
+{
+  Simulator::ScheduleWithContext (7, MicroSeconds (1), &SimulatorContextTestCase::Switch, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  uint32_t expected[] = { 7, 1, 2, 7, 1, 2, 7 };
+  NS_TEST_ASSERT_MSG_EQ (m_contexts.size (), 7, "Wrong number of contexts recorded");
+  for (uint32_t i = 0; i < 7; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_contexts[i], expected[i], "Wrong context " << i);
+    }
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -475,5 +598,16 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (ListScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+
+    AddTestCase (new SimulatorContextTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -29,6 +29,7 @@
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/node.h"
 #include "ns3/node-list.h"
+#include "ns3/string.h"
 
 
 namespace ns3 {
@@ -40,6 +41,11 @@ FlowMonitorHelper::FlowMonitorHelper ()
 
 FlowMonitorHelper::~FlowMonitorHelper ()
 {
+  if (m_streamWriter)
+    {
+      m_streamWriter->Dispose ();
+      m_streamWriter = 0;
+    }
   if (m_flowMonitor)
     {
       m_flowMonitor->Dispose ();
@@ -174,5 +180,19 @@ FlowMonitorHelper::SerializeToXmlFile (std::string fileName, bool enableHistogra
     }
 }
 
+Ptr<FlowStatsStreamWriter>
+FlowMonitorHelper::EnableStreaming (std::string fileName, Time interval)
+{
+  if (!m_streamWriter)
+    {
+      m_streamWriter = CreateObject<FlowStatsStreamWriter> ();
+      m_streamWriter->SetAttribute ("FileName", StringValue (fileName));
+      m_streamWriter->SetAttribute ("Interval", TimeValue (interval));
+      m_streamWriter->SetFlowMonitor (GetMonitor ());
+      m_streamWriter->Start ();
+    }
+  return m_streamWriter;
+}
+
 
 } // namespace ns3
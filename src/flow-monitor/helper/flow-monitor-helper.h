@@ -24,6 +24,7 @@
 #include "ns3/object-factory.h"
 #include "ns3/flow-monitor.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-stats-stream.h"
 #include <string>
 
 namespace ns3 {
@@ -112,6 +113,20 @@ public:
    */
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  /**
+   * \brief Periodically append the flow statistics to a binary file
+   *
+   * The statistics of the flows active in each interval are written
+   * as they are collected, see FlowStatsStreamWriter.  The last block
+   * is written by Simulator::Destroy, unless the returned writer is
+   * stopped before.
+   *
+   * \param fileName name or path of the output file that will be created
+   * \param interval the interval between two blocks of statistics
+   * \returns the FlowStatsStreamWriter object
+   */
+  Ptr<FlowStatsStreamWriter> EnableStreaming (std::string fileName, Time interval);
+
 private:
   /**
    * \brief Copy constructor
@@ -131,6 +146,7 @@ private:
   Ptr<FlowMonitor> m_flowMonitor;        //!< the FlowMonitor object
   Ptr<FlowClassifier> m_flowClassifier4; //!< the FlowClassifier object for IPv4
   Ptr<FlowClassifier> m_flowClassifier6; //!< the FlowClassifier object for IPv6
+  Ptr<FlowStatsStreamWriter> m_streamWriter; //!< the streaming exporter, if any
 };
 
 } // namespace ns3
@@ -0,0 +1,251 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef FLOW_HASH_TABLE_H
+#define FLOW_HASH_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/// \ingroup flow-monitor
+/// \brief Mix the bits of a 64-bit value (splitmix64 finalizer).
+/// \param x the value to mix
+/// \returns a well distributed hash of x
+inline uint64_t
+FlowHashMix (uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/// \ingroup flow-monitor
+/// \brief Hash functor for 64-bit integer keys.
+struct FlowHashUint64
+{
+  /// \param x the key
+  /// \returns the hash of the key
+  uint64_t operator () (uint64_t x) const
+  {
+    return FlowHashMix (x);
+  }
+};
+
+/// \ingroup flow-monitor
+/// \brief Open addressing hash table used on the FlowMonitor fast paths.
+///
+/// The table uses linear probing over a power of two number of slots,
+/// kept at most half full, and backward shift deletion, so lookups
+/// never have to skip tombstones and touch very few cache lines.  It
+/// is meant for small, trivially copyable keys and values: entries are
+/// moved around on insertion and deletion, so pointers returned by
+/// Find and Insert are only valid until the next Insert or Erase.
+///
+/// \tparam Key the key type, which must be default constructible and
+///         comparable with operator ==
+/// \tparam Value the mapped type, which must be default constructible
+/// \tparam Hash a functor returning a uint64_t hash of a Key
+template <typename Key, typename Value, typename Hash>
+class FlowHashTable
+{
+public:
+  FlowHashTable ();
+
+  /// \param key the key to look for
+  /// \returns a pointer to the value mapped to key, or 0 if none
+  Value * Find (const Key &key);
+  /// \param key the key to look for
+  /// \returns a pointer to the value mapped to key, or 0 if none
+  const Value * Find (const Key &key) const;
+  /// Find the value mapped to a key, inserting a default constructed
+  /// value if there is none.
+  /// \param key the key
+  /// \param inserted set to true if the key was not in the table
+  /// \returns the value mapped to key
+  Value & Insert (const Key &key, bool *inserted);
+  /// \param key the key to remove
+  /// \returns true if the key was in the table
+  bool Erase (const Key &key);
+  /// \returns the number of entries in the table
+  uint32_t GetSize (void) const;
+  /// Remove all the entries and release the storage
+  void Clear (void);
+
+private:
+  /// A table slot
+  struct Slot
+  {
+    Key key;     //!< the key
+    Value value; //!< the mapped value
+    bool used;   //!< whether the slot holds an entry
+  };
+
+  /// \param key the key
+  /// \returns the slot where key is, or the free slot where it belongs
+  uint32_t Lookup (const Key &key) const;
+  /// Double the number of slots and rehash all the entries
+  void Grow (void);
+
+  std::vector<Slot> m_slots; //!< the slots
+  uint32_t m_size;           //!< number of entries
+  uint32_t m_mask;           //!< number of slots minus one
+  Hash m_hash;               //!< the hash functor
+};
+
+template <typename Key, typename Value, typename Hash>
+FlowHashTable<Key, Value, Hash>::FlowHashTable ()
+  : m_size (0),
+    m_mask (0)
+{
+}
+
+template <typename Key, typename Value, typename Hash>
+uint32_t
+FlowHashTable<Key, Value, Hash>::Lookup (const Key &key) const
+{
+  uint32_t i = static_cast<uint32_t> (m_hash (key)) & m_mask;
+  while (m_slots[i].used && !(m_slots[i].key == key))
+    {
+      i = (i + 1) & m_mask;
+    }
+  return i;
+}
+
+template <typename Key, typename Value, typename Hash>
+Value *
+FlowHashTable<Key, Value, Hash>::Find (const Key &key)
+{
+  if (m_size == 0)
+    {
+      return 0;
+    }
+  Slot &slot = m_slots[Lookup (key)];
+  return slot.used ? &slot.value : 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+const Value *
+FlowHashTable<Key, Value, Hash>::Find (const Key &key) const
+{
+  if (m_size == 0)
+    {
+      return 0;
+    }
+  const Slot &slot = m_slots[Lookup (key)];
+  return slot.used ? &slot.value : 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+Value &
+FlowHashTable<Key, Value, Hash>::Insert (const Key &key, bool *inserted)
+{
+  if (2 * (m_size + 1) > m_slots.size ())
+    {
+      Grow ();
+    }
+  Slot &slot = m_slots[Lookup (key)];
+  *inserted = !slot.used;
+  if (!slot.used)
+    {
+      slot.used = true;
+      slot.key = key;
+      slot.value = Value ();
+      m_size++;
+    }
+  return slot.value;
+}
+
+template <typename Key, typename Value, typename Hash>
+bool
+FlowHashTable<Key, Value, Hash>::Erase (const Key &key)
+{
+  if (m_size == 0)
+    {
+      return false;
+    }
+  uint32_t i = Lookup (key);
+  if (!m_slots[i].used)
+    {
+      return false;
+    }
+  // Backward shift: move up the following entries of the cluster
+  // which would not be reachable anymore from their home slot.
+  uint32_t j = i;
+  while (true)
+    {
+      j = (j + 1) & m_mask;
+      if (!m_slots[j].used)
+        {
+          break;
+        }
+      uint32_t home = static_cast<uint32_t> (m_hash (m_slots[j].key)) & m_mask;
+      if (((j - home) & m_mask) >= ((j - i) & m_mask))
+        {
+          m_slots[i] = m_slots[j];
+          i = j;
+        }
+    }
+  m_slots[i].used = false;
+  m_slots[i].value = Value ();
+  m_size--;
+  return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+uint32_t
+FlowHashTable<Key, Value, Hash>::GetSize (void) const
+{
+  return m_size;
+}
+
+template <typename Key, typename Value, typename Hash>
+void
+FlowHashTable<Key, Value, Hash>::Clear (void)
+{
+  std::vector<Slot> empty;
+  m_slots.swap (empty);
+  m_size = 0;
+  m_mask = 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+void
+FlowHashTable<Key, Value, Hash>::Grow (void)
+{
+  std::vector<Slot> old;
+  old.swap (m_slots);
+  uint32_t capacity = old.empty () ? 16 : 2 * old.size ();
+  Slot empty = Slot ();
+  empty.used = false;
+  m_slots.resize (capacity, empty);
+  m_mask = capacity - 1;
+  for (typename std::vector<Slot>::const_iterator i = old.begin (); i != old.end (); ++i)
+    {
+      if (i->used)
+        {
+          m_slots[Lookup (i->key)] = *i;
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif /* FLOW_HASH_TABLE_H */
@@ -22,6 +22,7 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include <fstream>
 #include <sstream>
 
@@ -35,6 +36,8 @@ NS_LOG_COMPONENT_DEFINE ("FlowMonitor");
 
 NS_OBJECT_ENSURE_REGISTERED (FlowMonitor);
 
+const uint32_t FlowMonitor::NO_PACKET;
+
 
 TypeId 
 FlowMonitor::GetTypeId (void)
@@ -72,6 +75,16 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("QuantileSketches", ("Estimate the delay and jitter percentiles of each flow.  "
+                                        "Unlike the histograms, the estimates keep the same relative "
+                                        "accuracy whatever the range of the values."),
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FlowMonitor::m_quantileSketches),
+                   MakeBooleanChecker ())
+    .AddAttribute ("QuantileAccuracy", ("The relative accuracy of the delay and jitter percentiles."),
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&FlowMonitor::m_quantileAccuracy),
+                   MakeDoubleChecker <double> (1e-6, 0.5))
   ;
   return tid;
 }
@@ -83,7 +96,12 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_trackedPacketsFree (NO_PACKET),
+    m_expiryHead (NO_PACKET),
+    m_expiryTail (NO_PACKET),
+    m_enabled (false),
+    m_quantileSketches (false),
+    m_quantileAccuracy (0.01)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
@@ -126,6 +144,11 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
       ref.jitterHistogram.SetDefaultBinWidth (m_jitterBinWidth);
       ref.packetSizeHistogram.SetDefaultBinWidth (m_packetSizeBinWidth);
       ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
+      if (m_quantileSketches)
+        {
+          ref.delayQuantiles = QuantileSketch (m_quantileAccuracy);
+          ref.jitterQuantiles = QuantileSketch (m_quantileAccuracy);
+        }
       return ref;
     }
   else
@@ -143,7 +166,7 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  TrackedPacket &tracked = m_trackedPackets[AddTrackedPacket (flowId, packetId)];
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
@@ -170,19 +193,20 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
-  if (tracked == m_trackedPackets.end ())
+  uint32_t index = FindTrackedPacket (flowId, packetId);
+  if (index == NO_PACKET)
     {
       NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
                                                              << ") but not known to be transmitted.");
       return;
     }
 
-  tracked->second.timesForwarded++;
-  tracked->second.lastSeenTime = Simulator::Now ();
+  TrackedPacket &tracked = m_trackedPackets[index];
+  tracked.timesForwarded++;
+  tracked.lastSeenTime = Simulator::Now ();
+  TouchTrackedPacket (index);
 
-  Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
+  Time delay = (Simulator::Now () - tracked.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 }
 
@@ -194,8 +218,8 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked == m_trackedPackets.end ())
+  uint32_t index = FindTrackedPacket (flowId, packetId);
+  if (index == NO_PACKET)
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
                                                              << ") but not known to be transmitted.");
@@ -203,12 +227,17 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     }
 
   Time now = Simulator::Now ();
-  Time delay = (now - tracked->second.firstSeenTime);
+  const TrackedPacket &tracked = m_trackedPackets[index];
+  Time delay = (now - tracked.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 
   FlowStats &stats = GetStatsForFlow (flowId);
   stats.delaySum += delay;
   stats.delayHistogram.AddValue (delay.GetSeconds ());
+  if (m_quantileSketches)
+    {
+      stats.delayQuantiles.Add (delay.GetSeconds ());
+    }
   if (stats.rxPackets > 0 )
     {
       Time jitter = stats.lastDelay - delay;
@@ -222,6 +251,10 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
           stats.jitterSum -= jitter;
           stats.jitterHistogram.AddValue (-jitter.GetSeconds ());
         }
+      if (m_quantileSketches)
+        {
+          stats.jitterQuantiles.Add (Abs (jitter).GetSeconds ());
+        }
     }
   stats.lastDelay = delay;
 
@@ -242,12 +275,12 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
         }
     }
   stats.timeLastRxPacket = now;
-  stats.timesForwarded += tracked->second.timesForwarded;
+  stats.timesForwarded += tracked.timesForwarded;
 
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  RemoveTrackedPacket (index); // we don't need to track this packet anymore
 }
 
 void
@@ -272,14 +305,14 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked != m_trackedPackets.end ())
+  uint32_t index = FindTrackedPacket (flowId, packetId);
+  if (index != NO_PACKET)
     {
       // we don't need to track this packet anymore
       // FIXME: this will not necessarily be true with broadcast/multicast
       NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
-      m_trackedPackets.erase (tracked);
+      RemoveTrackedPacket (index);
     }
 }
 
@@ -295,23 +328,22 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
-  for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+  // The expiry list is sorted by lastSeenTime, so only the packets
+  // that are actually lost are visited.
+  while (m_expiryHead != NO_PACKET)
     {
-      if (now - iter->second.lastSeenTime >= maxDelay)
+      const TrackedPacket &tracked = m_trackedPackets[m_expiryHead];
+      if (now - tracked.lastSeenTime < maxDelay)
         {
-          // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
-
-          // we won't track it anymore
-          m_trackedPackets.erase (iter++);
-        }
-      else
-        {
-          iter++;
+          break;
         }
+      // packet is considered lost, add it to the loss statistics
+      FlowStatsContainerI flow = m_flowStats.find (tracked.flowId);
+      NS_ASSERT (flow != m_flowStats.end ());
+      flow->second.lostPackets++;
+
+      // we won't track it anymore
+      RemoveTrackedPacket (m_expiryHead);
     }
 }
 
@@ -328,6 +360,101 @@ FlowMonitor::PeriodicCheckForLostPackets ()
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+uint32_t
+FlowMonitor::FindTrackedPacket (FlowId flowId, FlowPacketId packetId) const
+{
+  uint64_t key = (static_cast<uint64_t> (flowId) << 32) | packetId;
+  const uint32_t *index = m_trackedPacketTable.Find (key);
+  return index ? *index : NO_PACKET;
+}
+
+uint32_t
+FlowMonitor::AddTrackedPacket (FlowId flowId, FlowPacketId packetId)
+{
+  uint64_t key = (static_cast<uint64_t> (flowId) << 32) | packetId;
+  bool inserted;
+  uint32_t &slot = m_trackedPacketTable.Insert (key, &inserted);
+  if (!inserted)
+    {
+      TouchTrackedPacket (slot);
+      return slot;
+    }
+  uint32_t index;
+  if (m_trackedPacketsFree != NO_PACKET)
+    {
+      index = m_trackedPacketsFree;
+      m_trackedPacketsFree = m_trackedPackets[index].next;
+    }
+  else
+    {
+      index = m_trackedPackets.size ();
+      m_trackedPackets.push_back (TrackedPacket ());
+    }
+  slot = index;
+  TrackedPacket &tracked = m_trackedPackets[index];
+  tracked.flowId = flowId;
+  tracked.packetId = packetId;
+  tracked.prev = m_expiryTail;
+  tracked.next = NO_PACKET;
+  if (m_expiryTail != NO_PACKET)
+    {
+      m_trackedPackets[m_expiryTail].next = index;
+    }
+  else
+    {
+      m_expiryHead = index;
+    }
+  m_expiryTail = index;
+  return index;
+}
+
+void
+FlowMonitor::RemoveTrackedPacket (uint32_t index)
+{
+  TrackedPacket &tracked = m_trackedPackets[index];
+  m_trackedPacketTable.Erase ((static_cast<uint64_t> (tracked.flowId) << 32) | tracked.packetId);
+  UnlinkTrackedPacket (index);
+  tracked.next = m_trackedPacketsFree;
+  m_trackedPacketsFree = index;
+}
+
+void
+FlowMonitor::TouchTrackedPacket (uint32_t index)
+{
+  if (index == m_expiryTail)
+    {
+      return;
+    }
+  UnlinkTrackedPacket (index);
+  TrackedPacket &tracked = m_trackedPackets[index];
+  tracked.prev = m_expiryTail;
+  tracked.next = NO_PACKET;
+  m_trackedPackets[m_expiryTail].next = index;
+  m_expiryTail = index;
+}
+
+void
+FlowMonitor::UnlinkTrackedPacket (uint32_t index)
+{
+  TrackedPacket &tracked = m_trackedPackets[index];
+  if (tracked.prev != NO_PACKET)
+    {
+      m_trackedPackets[tracked.prev].next = tracked.next;
+    }
+  else
+    {
+      m_expiryHead = tracked.next;
+    }
+  if (tracked.next != NO_PACKET)
+    {
+      m_trackedPackets[tracked.next].prev = tracked.prev;
+    }
+  else
+    {
+      m_expiryTail = tracked.prev;
+    }
+}
+
 void
 FlowMonitor::NotifyConstructionCompleted ()
 {
@@ -455,6 +582,11 @@ FlowMonitor::SerializeToXmlStream (std::ostream &os, int indent, bool enableHist
           flowI->second.packetSizeHistogram.SerializeToXmlStream (os, indent, "packetSizeHistogram");
           flowI->second.flowInterruptionsHistogram.SerializeToXmlStream (os, indent, "flowInterruptionsHistogram");
         }
+      if (m_quantileSketches)
+        {
+          flowI->second.delayQuantiles.SerializeToXmlStream (os, indent, "delayQuantiles");
+          flowI->second.jitterQuantiles.SerializeToXmlStream (os, indent, "jitterQuantiles");
+        }
       indent -= 2;
 
       INDENT (indent); os << "</Flow>\n";
@@ -29,6 +29,8 @@
 #include "ns3/flow-probe.h"
 #include "ns3/flow-classifier.h"
 #include "ns3/histogram.h"
+#include "ns3/quantile-sketch.h"
+#include "ns3/flow-hash-table.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 
@@ -135,6 +137,13 @@ public:
     /// comment in attribute packetsDropped.
     std::vector<uint64_t> bytesDropped; // bytesDropped[reasonCode] => number of dropped bytes
     Histogram flowInterruptionsHistogram; //!< histogram of durations of flow interruptions
+
+    /// Percentiles of the packet delays, in seconds.  Only filled if
+    /// the QuantileSketches attribute is true.
+    QuantileSketch delayQuantiles;
+    /// Percentiles of the packet jitters, in seconds.  Only filled if
+    /// the QuantileSketches attribute is true.
+    QuantileSketch jitterQuantiles;
   };
 
   // --- basic methods ---
@@ -265,19 +274,33 @@ protected:
 private:
 
   /// Structure to represent a single tracked packet data
+  ///
+  /// Tracked packets live in a pool and are linked, in increasing
+  /// order of lastSeenTime, into the expiry list.  Since lastSeenTime
+  /// is only ever set to the current time, moving a packet to the tail
+  /// of the list whenever it is seen keeps the list sorted, so the
+  /// packets that may be lost are always at its head.
   struct TrackedPacket
   {
     Time firstSeenTime; //!< absolute time when the packet was first seen by a probe
     Time lastSeenTime; //!< absolute time when the packet was last seen by a probe
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+    FlowId flowId; //!< flow of the packet
+    FlowPacketId packetId; //!< identifier of the packet within its flow
+    uint32_t prev; //!< previous packet in the expiry list
+    uint32_t next; //!< next packet in the expiry list, or in the free list
   };
 
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
 
-  /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
-  TrackedPacketMap m_trackedPackets; //!< Tracked packets
+  /// (FlowId,PacketId) --> index of the TrackedPacket in the pool
+  typedef FlowHashTable<uint64_t, uint32_t, FlowHashUint64> TrackedPacketTable;
+  TrackedPacketTable m_trackedPacketTable; //!< Tracked packets index
+  std::vector<TrackedPacket> m_trackedPackets; //!< Tracked packets pool
+  uint32_t m_trackedPacketsFree; //!< First unused entry of the pool
+  uint32_t m_expiryHead; //!< Least recently seen tracked packet
+  uint32_t m_expiryTail; //!< Most recently seen tracked packet
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
@@ -292,6 +315,8 @@ private:
   double m_packetSizeBinWidth;  //!< packet size bin width (for histograms)
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
+  bool m_quantileSketches;  //!< Estimate the delay and jitter percentiles
+  double m_quantileAccuracy; //!< Relative accuracy of the percentiles
 
   /// Get the stats for a given flow
   /// \param flowId the Flow identification
@@ -300,6 +325,28 @@ private:
 
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns the index of the tracked packet, or NO_PACKET
+  uint32_t FindTrackedPacket (FlowId flowId, FlowPacketId packetId) const;
+  /// Start tracking a packet, or restart if it is already tracked
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns the index of the tracked packet
+  uint32_t AddTrackedPacket (FlowId flowId, FlowPacketId packetId);
+  /// Stop tracking a packet
+  /// \param index the index of the tracked packet
+  void RemoveTrackedPacket (uint32_t index);
+  /// Move a tracked packet to the tail of the expiry list
+  /// \param index the index of the tracked packet
+  void TouchTrackedPacket (uint32_t index);
+  /// Unlink a tracked packet from the expiry list
+  /// \param index the index of the tracked packet
+  void UnlinkTrackedPacket (uint32_t index);
+
+  /// Invalid tracked packet index
+  static const uint32_t NO_PACKET = 0xffffffff;
 };
 
 
@@ -0,0 +1,366 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "flow-stats-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/log.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowStatsStream");
+
+NS_OBJECT_ENSURE_REGISTERED (FlowStatsStreamWriter);
+
+const char FlowStatsStream::MAGIC[8] = { 'N', 'S', '3', 'F', 'L', 'O', 'W', 'S' };
+const uint32_t FlowStatsStream::VERSION;
+const uint32_t FlowStatsStream::BLOCK_MAGIC;
+const uint32_t FlowStatsStream::N_COLUMNS_64;
+const uint32_t FlowStatsStream::N_COLUMNS_32;
+
+uint32_t
+FlowStatsStream::GetBlockSize (uint32_t nFlows)
+{
+  uint32_t size = sizeof (BlockHeader) + nFlows * (8 * N_COLUMNS_64 + 4 * N_COLUMNS_32);
+  return (size + 7) & ~7U;
+}
+
+
+TypeId
+FlowStatsStreamWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FlowStatsStreamWriter")
+    .SetParent<Object> ()
+    .SetGroupName ("FlowMonitor")
+    .AddConstructor<FlowStatsStreamWriter> ()
+    .AddAttribute ("FileName", "The name of the output file.",
+                   StringValue ("flowmon-stream.bin"),
+                   MakeStringAccessor (&FlowStatsStreamWriter::m_fileName),
+                   MakeStringChecker ())
+    .AddAttribute ("Interval", "The interval between two blocks of statistics.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&FlowStatsStreamWriter::m_interval),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+FlowStatsStreamWriter::FlowStatsStreamWriter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FlowStatsStreamWriter::~FlowStatsStreamWriter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FlowStatsStreamWriter::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the simulator may be gone, so the last block is not written here
+  m_event.Cancel ();
+  m_destroyEvent.Cancel ();
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+  m_monitor = 0;
+  Object::DoDispose ();
+}
+
+void
+FlowStatsStreamWriter::SetFlowMonitor (Ptr<FlowMonitor> monitor)
+{
+  NS_LOG_FUNCTION (this << monitor);
+  m_monitor = monitor;
+}
+
+void
+FlowStatsStreamWriter::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_monitor != 0, "No FlowMonitor to export");
+  if (m_file.is_open ())
+    {
+      return;
+    }
+  m_file.open (m_fileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_file.is_open ())
+    {
+      NS_FATAL_ERROR ("Can't open " << m_fileName);
+    }
+  FlowStatsStream::FileHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.magic, FlowStatsStream::MAGIC, sizeof (header.magic));
+  header.version = FlowStatsStream::VERSION;
+  header.headerSize = sizeof (header);
+  header.interval = m_interval.GetNanoSeconds ();
+  m_file.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  m_file.flush ();
+
+  m_lastBlock = Simulator::Now ();
+  m_snapshots.clear ();
+  m_event = Simulator::Schedule (m_interval, &FlowStatsStreamWriter::PeriodicWrite, this);
+  // the writer is kept alive until the last block is written
+  m_destroyEvent = Simulator::ScheduleDestroy (&FlowStatsStreamWriter::Stop,
+                                               Ptr<FlowStatsStreamWriter> (this));
+}
+
+void
+FlowStatsStreamWriter::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  m_event.Cancel ();
+  m_destroyEvent.Cancel ();
+  WriteBlock ();
+  m_file.close ();
+}
+
+void
+FlowStatsStreamWriter::PeriodicWrite (void)
+{
+  NS_LOG_FUNCTION (this);
+  WriteBlock ();
+  m_event = Simulator::Schedule (m_interval, &FlowStatsStreamWriter::PeriodicWrite, this);
+}
+
+void
+FlowStatsStreamWriter::WriteBlock (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  m_columns64.clear ();
+  m_columns32.clear ();
+  m_columns64.reserve (FlowStatsStream::N_COLUMNS_64 * stats.size ());
+  m_columns32.reserve (FlowStatsStream::N_COLUMNS_32 * stats.size ());
+
+  // Gather the increments row by row, the columns are laid out below.
+  for (FlowMonitor::FlowStatsContainerCI i = stats.begin (); i != stats.end (); ++i)
+    {
+      const FlowMonitor::FlowStats &s = i->second;
+      Snapshot &last = m_snapshots[i->first];
+      if (last.txPackets == s.txPackets && last.rxPackets == s.rxPackets
+          && last.lostPackets == s.lostPackets && last.txBytes == s.txBytes)
+        {
+          continue;
+        }
+      int64_t delaySum = s.delaySum.GetNanoSeconds ();
+      int64_t jitterSum = s.jitterSum.GetNanoSeconds ();
+      m_columns64.push_back (s.txBytes - last.txBytes);
+      m_columns64.push_back (s.rxBytes - last.rxBytes);
+      m_columns64.push_back (delaySum - last.delaySum);
+      m_columns64.push_back (jitterSum - last.jitterSum);
+      m_columns32.push_back (i->first);
+      m_columns32.push_back (s.txPackets - last.txPackets);
+      m_columns32.push_back (s.rxPackets - last.rxPackets);
+      m_columns32.push_back (s.lostPackets - last.lostPackets);
+      m_columns32.push_back (s.timesForwarded - last.timesForwarded);
+      last.txBytes = s.txBytes;
+      last.rxBytes = s.rxBytes;
+      last.delaySum = delaySum;
+      last.jitterSum = jitterSum;
+      last.txPackets = s.txPackets;
+      last.rxPackets = s.rxPackets;
+      last.lostPackets = s.lostPackets;
+      last.timesForwarded = s.timesForwarded;
+    }
+
+  uint32_t nFlows = m_columns32.size () / FlowStatsStream::N_COLUMNS_32;
+  FlowStatsStream::BlockHeader header;
+  std::memset (&header, 0, sizeof (header));
+  header.magic = FlowStatsStream::BLOCK_MAGIC;
+  header.nFlows = nFlows;
+  header.start = m_lastBlock.GetNanoSeconds ();
+  header.end = Simulator::Now ().GetNanoSeconds ();
+  header.blockSize = FlowStatsStream::GetBlockSize (nFlows);
+  m_lastBlock = Simulator::Now ();
+
+  std::vector<uint8_t> block (header.blockSize, 0);
+  std::memcpy (&block[0], &header, sizeof (header));
+  uint64_t *col64 = reinterpret_cast<uint64_t *> (&block[sizeof (header)]);
+  for (uint32_t c = 0; c < FlowStatsStream::N_COLUMNS_64; c++)
+    {
+      for (uint32_t f = 0; f < nFlows; f++)
+        {
+          *col64++ = m_columns64[f * FlowStatsStream::N_COLUMNS_64 + c];
+        }
+    }
+  uint32_t *col32 = reinterpret_cast<uint32_t *> (col64);
+  for (uint32_t c = 0; c < FlowStatsStream::N_COLUMNS_32; c++)
+    {
+      for (uint32_t f = 0; f < nFlows; f++)
+        {
+          *col32++ = m_columns32[f * FlowStatsStream::N_COLUMNS_32 + c];
+        }
+    }
+  m_file.write (reinterpret_cast<const char *> (&block[0]), block.size ());
+  m_file.flush ();
+  NS_LOG_DEBUG ("Wrote block of " << nFlows << " flows, " << block.size () << " bytes");
+}
+
+
+FlowStatsStreamReader::FlowStatsStreamReader ()
+  : m_data (0),
+    m_size (0)
+{
+}
+
+FlowStatsStreamReader::~FlowStatsStreamReader ()
+{
+  Close ();
+}
+
+bool
+FlowStatsStreamReader::Open (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  Close ();
+  m_fileName = fileName;
+  return Map ();
+}
+
+bool
+FlowStatsStreamReader::Refresh (void)
+{
+  NS_LOG_FUNCTION (this);
+  Unmap ();
+  return Map ();
+}
+
+void
+FlowStatsStreamReader::Close (void)
+{
+  Unmap ();
+  m_fileName.clear ();
+}
+
+void
+FlowStatsStreamReader::Unmap (void)
+{
+  if (m_data != 0)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+    }
+  m_data = 0;
+  m_size = 0;
+  m_blocks.clear ();
+}
+
+bool
+FlowStatsStreamReader::Map (void)
+{
+  int fd = open (m_fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Can't open " << m_fileName);
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) < 0 || st.st_size < static_cast<off_t> (sizeof (FlowStatsStream::FileHeader)))
+    {
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      return false;
+    }
+  m_data = static_cast<const uint8_t *> (data);
+  m_size = st.st_size;
+
+  const FlowStatsStream::FileHeader *header =
+    reinterpret_cast<const FlowStatsStream::FileHeader *> (m_data);
+  if (std::memcmp (header->magic, FlowStatsStream::MAGIC, sizeof (header->magic)) != 0
+      || header->version != FlowStatsStream::VERSION)
+    {
+      NS_LOG_WARN (m_fileName << " is not a flow statistics stream");
+      Unmap ();
+      return false;
+    }
+  m_interval = NanoSeconds (header->interval);
+
+  uint64_t offset = header->headerSize;
+  while (offset + sizeof (FlowStatsStream::BlockHeader) <= m_size)
+    {
+      const FlowStatsStream::BlockHeader *bh =
+        reinterpret_cast<const FlowStatsStream::BlockHeader *> (m_data + offset);
+      if (bh->magic != FlowStatsStream::BLOCK_MAGIC
+          || bh->blockSize != FlowStatsStream::GetBlockSize (bh->nFlows)
+          || offset + bh->blockSize > m_size)
+        {
+          // a block being written, or a truncated file
+          break;
+        }
+      Block block;
+      block.start = NanoSeconds (bh->start);
+      block.end = NanoSeconds (bh->end);
+      block.nFlows = bh->nFlows;
+      const uint8_t *p = m_data + offset + sizeof (FlowStatsStream::BlockHeader);
+      const uint64_t *col64 = reinterpret_cast<const uint64_t *> (p);
+      block.txBytes = col64;
+      block.rxBytes = col64 + bh->nFlows;
+      block.delaySum = reinterpret_cast<const int64_t *> (col64 + 2 * bh->nFlows);
+      block.jitterSum = reinterpret_cast<const int64_t *> (col64 + 3 * bh->nFlows);
+      const uint32_t *col32 = reinterpret_cast<const uint32_t *> (col64 + 4 * bh->nFlows);
+      block.flowId = col32;
+      block.txPackets = col32 + bh->nFlows;
+      block.rxPackets = col32 + 2 * bh->nFlows;
+      block.lostPackets = col32 + 3 * bh->nFlows;
+      block.timesForwarded = col32 + 4 * bh->nFlows;
+      m_blocks.push_back (block);
+      offset += bh->blockSize;
+    }
+  return true;
+}
+
+Time
+FlowStatsStreamReader::GetInterval (void) const
+{
+  return m_interval;
+}
+
+uint32_t
+FlowStatsStreamReader::GetNBlocks (void) const
+{
+  return m_blocks.size ();
+}
+
+const FlowStatsStreamReader::Block &
+FlowStatsStreamReader::GetBlock (uint32_t i) const
+{
+  NS_ASSERT (i < m_blocks.size ());
+  return m_blocks[i];
+}
+
+} // namespace ns3
@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef FLOW_STATS_STREAM_H
+#define FLOW_STATS_STREAM_H
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/flow-monitor.h"
+
+namespace ns3 {
+
+/// \ingroup flow-monitor
+/// \brief Layout of the files written by FlowStatsStreamWriter.
+///
+/// A stream file starts with a FileHeader, followed by one block per
+/// interval.  A block is a BlockHeader followed by the columns of the
+/// interval, each holding one value per flow active in the interval:
+/// first the 64-bit columns (txBytes, rxBytes, delaySum, jitterSum,
+/// the times in nanoseconds), then the 32-bit columns (flowId,
+/// txPackets, rxPackets, lostPackets, timesForwarded), padded to a
+/// multiple of 8 bytes.  All the counters are the increments over the
+/// interval.  Values are in host byte order; every block is written
+/// whole and flushed, so a reader can map the file while it grows.
+struct FlowStatsStream
+{
+  /// File magic
+  static const char MAGIC[8];
+  /// Current format version
+  static const uint32_t VERSION = 1;
+  /// Block magic ("FSBK")
+  static const uint32_t BLOCK_MAGIC = 0x4b425346;
+  /// Number of 64-bit columns in a block
+  static const uint32_t N_COLUMNS_64 = 4;
+  /// Number of 32-bit columns in a block
+  static const uint32_t N_COLUMNS_32 = 5;
+
+  /// Header at the start of a stream file
+  struct FileHeader
+  {
+    char magic[8];      //!< MAGIC
+    uint32_t version;   //!< VERSION
+    uint32_t headerSize; //!< sizeof (FileHeader)
+    int64_t interval;   //!< Nominal interval between blocks, in ns
+    int64_t reserved;   //!< Zero
+  };
+
+  /// Header at the start of a block
+  struct BlockHeader
+  {
+    uint32_t magic;     //!< BLOCK_MAGIC
+    uint32_t nFlows;    //!< Number of values in each column
+    int64_t start;      //!< Start of the interval, in ns
+    int64_t end;        //!< End of the interval, in ns
+    uint32_t blockSize; //!< Size of the block, header included
+    uint32_t reserved;  //!< Zero
+  };
+
+  /// \param nFlows the number of flows in a block
+  /// \returns the size of the block, header included
+  static uint32_t GetBlockSize (uint32_t nFlows);
+};
+
+/// \ingroup flow-monitor
+/// \brief Periodically append FlowMonitor interval statistics to a file.
+///
+/// Instead of waiting for the end of the simulation to serialize the
+/// whole FlowMonitor state to XML, the writer appends, every Interval,
+/// one column-oriented block with the per-flow increments since the
+/// previous block (see FlowStatsStream).  Only the flows which changed
+/// during the interval are written.  The histograms are not exported.
+///
+/// A last, possibly shorter, block is written when the writer is
+/// stopped, by Stop or else by Simulator::Destroy.  Disposing of the
+/// writer only closes the file.  The file can be read with
+/// FlowStatsStreamReader or the flowmon-dump-stream utility.
+class FlowStatsStreamWriter : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  FlowStatsStreamWriter ();
+  virtual ~FlowStatsStreamWriter ();
+
+  /// \param monitor the FlowMonitor to export
+  void SetFlowMonitor (Ptr<FlowMonitor> monitor);
+  /// Open the file and start writing blocks, every Interval from now
+  /// until Stop or Simulator::Destroy
+  void Start (void);
+  /// Write the last block and close the file
+  void Stop (void);
+  /// Write a block with the changes since the last block right now
+  void WriteBlock (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Counters of a flow at the time of the last block
+  struct Snapshot
+  {
+    uint64_t txBytes;         //!< Transmitted bytes
+    uint64_t rxBytes;         //!< Received bytes
+    int64_t delaySum;         //!< Sum of the delays, in ns
+    int64_t jitterSum;        //!< Sum of the jitters, in ns
+    uint32_t txPackets;       //!< Transmitted packets
+    uint32_t rxPackets;       //!< Received packets
+    uint32_t lostPackets;     //!< Lost packets
+    uint32_t timesForwarded;  //!< Forwarding count
+  };
+
+  /// Write a block and schedule the next one
+  void PeriodicWrite (void);
+
+  Ptr<FlowMonitor> m_monitor;   //!< The exported FlowMonitor
+  std::string m_fileName;       //!< Output file name
+  Time m_interval;              //!< Interval between blocks
+  std::ofstream m_file;         //!< Output file
+  EventId m_event;              //!< Next periodic write
+  EventId m_destroyEvent;       //!< Stop at Simulator::Destroy
+  Time m_lastBlock;             //!< End of the last block written
+  std::map<FlowId, Snapshot> m_snapshots; //!< Counters at the last block
+  std::vector<uint64_t> m_columns64; //!< Scratch space for the 64-bit columns
+  std::vector<uint32_t> m_columns32; //!< Scratch space for the 32-bit columns
+};
+
+/// \ingroup flow-monitor
+/// \brief Memory-mapped reader for the files written by FlowStatsStreamWriter.
+///
+/// The columns of each block are exposed in place, without copies.
+/// The file may still be growing: Refresh maps it again and picks up
+/// the blocks completed since the last call.
+class FlowStatsStreamReader
+{
+public:
+  /// One interval of statistics; the column pointers point into the
+  /// mapped file and stay valid until the next Refresh or Close.
+  struct Block
+  {
+    Time start;                     //!< Start of the interval
+    Time end;                       //!< End of the interval
+    uint32_t nFlows;                //!< Number of values in each column
+    const uint64_t *txBytes;        //!< Transmitted bytes
+    const uint64_t *rxBytes;        //!< Received bytes
+    const int64_t *delaySum;        //!< Sum of the delays, in ns
+    const int64_t *jitterSum;       //!< Sum of the jitters, in ns
+    const uint32_t *flowId;         //!< Flow identifiers
+    const uint32_t *txPackets;      //!< Transmitted packets
+    const uint32_t *rxPackets;      //!< Received packets
+    const uint32_t *lostPackets;    //!< Lost packets
+    const uint32_t *timesForwarded; //!< Forwarding count
+  };
+
+  FlowStatsStreamReader ();
+  ~FlowStatsStreamReader ();
+
+  /// \param fileName the file to read
+  /// \returns true if the file could be mapped and has a valid header
+  bool Open (std::string fileName);
+  /// Map the file again to pick up the blocks appended since the last call
+  /// \returns true if the file is still valid
+  bool Refresh (void);
+  /// Unmap the file
+  void Close (void);
+
+  /// \returns the nominal interval between blocks
+  Time GetInterval (void) const;
+  /// \returns the number of complete blocks
+  uint32_t GetNBlocks (void) const;
+  /// \param i the block index
+  /// \returns the block
+  const Block & GetBlock (uint32_t i) const;
+
+private:
+  /// Defined and not implemented to avoid misuse
+  FlowStatsStreamReader (const FlowStatsStreamReader &);
+  /// Defined and not implemented to avoid misuse
+  /// \returns
+  FlowStatsStreamReader & operator = (const FlowStatsStreamReader &);
+
+  /// Map the file and index its blocks
+  /// \returns true on success
+  bool Map (void);
+  /// Unmap the file, but keep its name
+  void Unmap (void);
+
+  std::string m_fileName;     //!< The file name
+  const uint8_t *m_data;      //!< The mapped file
+  uint64_t m_size;            //!< Size of the mapping
+  Time m_interval;            //!< Nominal interval
+  std::vector<Block> m_blocks; //!< The complete blocks
+};
+
+} // namespace ns3
+
+#endif /* FLOW_STATS_STREAM_H */
@@ -99,6 +99,16 @@ Ipv4FlowClassifier::Ipv4FlowClassifier ()
 {
 }
 
+uint64_t
+Ipv4FlowClassifier::FiveTupleHash::operator () (const FiveTuple &tuple) const
+{
+  uint64_t x = (static_cast<uint64_t> (tuple.sourceAddress.Get ()) << 32)
+    | tuple.destinationAddress.Get ();
+  uint64_t y = (static_cast<uint64_t> (tuple.protocol) << 32)
+    | (static_cast<uint64_t> (tuple.sourcePort) << 16) | tuple.destinationPort;
+  return FlowHashMix (x ^ FlowHashMix (y));
+}
+
 bool
 Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
                               uint32_t *out_flowId, uint32_t *out_packetId)
@@ -147,23 +157,23 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationPort = dstPort;
 
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
-    = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
+  bool inserted;
+  FlowState &flow = m_flowMap.Insert (tuple, &inserted);
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
-  if (insert.second)
+  if (inserted)
     {
-      FlowId newFlowId = GetNewFlowId ();
-      insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
+      flow.flowId = GetNewFlowId ();
+      flow.lastPacketId = 0;
+      m_flowIdMap[flow.flowId] = tuple;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      flow.lastPacketId++;
     }
 
-  *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_flowId = flow.flowId;
+  *out_packetId = flow.lastPacketId;
 
   return true;
 }
@@ -172,13 +182,10 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  std::map<FlowId, FiveTuple>::const_iterator iter = m_flowIdMap.find (flowId);
+  if (iter != m_flowIdMap.end ())
     {
-      if (iter->second == flowId)
-        {
-          return iter->first;
-        }
+      return iter->second;
     }
   NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
   FiveTuple retval = { Ipv4Address::GetZero (), Ipv4Address::GetZero (), 0, 0, 0 };
@@ -193,16 +200,16 @@ Ipv4FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
   INDENT (indent); os << "<Ipv4FlowClassifier>\n";
 
   indent += 2;
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  for (std::map<FlowId, FiveTuple>::const_iterator
+       iter = m_flowIdMap.begin (); iter != m_flowIdMap.end (); iter++)
     {
       INDENT (indent);
-      os << "<Flow flowId=\"" << iter->second << "\""
-         << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-         << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-         << " protocol=\"" << int(iter->first.protocol) << "\""
-         << " sourcePort=\"" << iter->first.sourcePort << "\""
-         << " destinationPort=\"" << iter->first.destinationPort << "\""
+      os << "<Flow flowId=\"" << iter->first << "\""
+         << " sourceAddress=\"" << iter->second.sourceAddress << "\""
+         << " destinationAddress=\"" << iter->second.destinationAddress << "\""
+         << " protocol=\"" << int(iter->second.protocol) << "\""
+         << " sourcePort=\"" << iter->second.sourcePort << "\""
+         << " destinationPort=\"" << iter->second.destinationPort << "\""
          << " />\n";
     }
 
@@ -26,6 +26,7 @@
 
 #include "ns3/ipv4-header.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-hash-table.h"
 
 namespace ns3 {
 
@@ -73,10 +74,25 @@ public:
 
 private:
 
+  /// Hash functor for FiveTuple
+  struct FiveTupleHash
+  {
+    /// \param tuple the five-tuple
+    /// \returns the hash of the five-tuple
+    uint64_t operator () (const FiveTuple &tuple) const;
+  };
+
+  /// State of a known flow
+  struct FlowState
+  {
+    FlowId flowId;             //!< Flow identifier
+    FlowPacketId lastPacketId; //!< Identifier given to the last packet
+  };
+
   /// Map to Flows Identifiers to FlowIds
-  std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+  FlowHashTable<FiveTuple, FlowState, FiveTupleHash> m_flowMap;
+  /// Map to FlowIds to Flows Identifiers, for FindFlow and serialization
+  std::map<FlowId, FiveTuple> m_flowIdMap;
 
 };
 
@@ -100,6 +100,30 @@ Ipv6FlowClassifier::Ipv6FlowClassifier ()
 {
 }
 
+uint64_t
+Ipv6FlowClassifier::FiveTupleHash::operator () (const FiveTuple &tuple) const
+{
+  uint8_t src[16];
+  uint8_t dst[16];
+  tuple.sourceAddress.GetBytes (src);
+  tuple.destinationAddress.GetBytes (dst);
+  uint64_t h = (static_cast<uint64_t> (tuple.protocol) << 32)
+    | (static_cast<uint64_t> (tuple.sourcePort) << 16) | tuple.destinationPort;
+  for (uint32_t i = 0; i < 16; i += 8)
+    {
+      uint64_t a = 0;
+      uint64_t b = 0;
+      for (uint32_t j = 0; j < 8; j++)
+        {
+          a = (a << 8) | src[i + j];
+          b = (b << 8) | dst[i + j];
+        }
+      h = FlowHashMix (h ^ a);
+      h = FlowHashMix (h ^ b);
+    }
+  return h;
+}
+
 bool
 Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPayload,
                               uint32_t *out_flowId, uint32_t *out_packetId)
@@ -148,23 +172,23 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationPort = dstPort;
 
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
-    = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
+  bool inserted;
+  FlowState &flow = m_flowMap.Insert (tuple, &inserted);
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
-  if (insert.second)
+  if (inserted)
     {
-      FlowId newFlowId = GetNewFlowId ();
-      insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
+      flow.flowId = GetNewFlowId ();
+      flow.lastPacketId = 0;
+      m_flowIdMap[flow.flowId] = tuple;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      flow.lastPacketId++;
     }
 
-  *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_flowId = flow.flowId;
+  *out_packetId = flow.lastPacketId;
 
   return true;
 }
@@ -173,13 +197,10 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  std::map<FlowId, FiveTuple>::const_iterator iter = m_flowIdMap.find (flowId);
+  if (iter != m_flowIdMap.end ())
     {
-      if (iter->second == flowId)
-        {
-          return iter->first;
-        }
+      return iter->second;
     }
   NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
   FiveTuple retval = { Ipv6Address::GetZero (), Ipv6Address::GetZero (), 0, 0, 0 };
@@ -194,16 +215,16 @@ Ipv6FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
   INDENT (indent); os << "<Ipv6FlowClassifier>\n";
 
   indent += 2;
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  for (std::map<FlowId, FiveTuple>::const_iterator
+       iter = m_flowIdMap.begin (); iter != m_flowIdMap.end (); iter++)
     {
       INDENT (indent);
-      os << "<Flow flowId=\"" << iter->second << "\""
-         << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-         << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-         << " protocol=\"" << int(iter->first.protocol) << "\""
-         << " sourcePort=\"" << iter->first.sourcePort << "\""
-         << " destinationPort=\"" << iter->first.destinationPort << "\""
+      os << "<Flow flowId=\"" << iter->first << "\""
+         << " sourceAddress=\"" << iter->second.sourceAddress << "\""
+         << " destinationAddress=\"" << iter->second.destinationAddress << "\""
+         << " protocol=\"" << int(iter->second.protocol) << "\""
+         << " sourcePort=\"" << iter->second.sourcePort << "\""
+         << " destinationPort=\"" << iter->second.destinationPort << "\""
          << " />\n";
     }
 
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <map>
+
+#include "ns3/flow-hash-table.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/// Hash functor which makes every key collide
+struct CollidingHash
+{
+  uint64_t operator () (uint64_t x) const
+  {
+    return x & 3;
+  }
+};
+
+class FlowHashTableTestCase : public ns3::TestCase {
+public:
+  FlowHashTableTestCase ();
+  virtual void DoRun (void);
+};
+
+FlowHashTableTestCase::FlowHashTableTestCase ()
+  : ns3::TestCase ("FlowHashTable against std::map")
+{
+}
+
+void
+FlowHashTableTestCase::DoRun (void)
+{
+  FlowHashTable<uint64_t, uint32_t, CollidingHash> table;
+  std::map<uint64_t, uint32_t> reference;
+  uint64_t state = 1;
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      uint64_t key = (state >> 33) % 500;
+      if ((state >> 20) & 1)
+        {
+          bool inserted;
+          uint32_t &value = table.Insert (key, &inserted);
+          NS_TEST_ASSERT_MSG_EQ (inserted, (reference.find (key) == reference.end ()), "Wrong insertion status");
+          value = i;
+          reference[key] = i;
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (table.Erase (key), (reference.erase (key) == 1), "Wrong erase status");
+        }
+      NS_TEST_ASSERT_MSG_EQ (table.GetSize (), reference.size (), "Wrong size");
+    }
+  for (uint64_t key = 0; key < 500; key++)
+    {
+      std::map<uint64_t, uint32_t>::const_iterator i = reference.find (key);
+      const uint32_t *value = table.Find (key);
+      NS_TEST_ASSERT_MSG_EQ ((value != 0), (i != reference.end ()), "Wrong lookup for key " << key);
+      if (value != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (*value, i->second, "Wrong value for key " << key);
+        }
+    }
+  table.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 0, "Table not empty after Clear");
+  NS_TEST_EXPECT_MSG_EQ ((table.Find (0) == 0), true, "Key found after Clear");
+}
+
+
+/// Probe which only exists to report packets to the monitor
+class DummyFlowProbe : public FlowProbe
+{
+public:
+  DummyFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+class FlowMonitorLossTestCase : public ns3::TestCase {
+public:
+  FlowMonitorLossTestCase ();
+  virtual void DoRun (void);
+private:
+  void Send (uint32_t packetId);
+  void Forward (uint32_t packetId);
+  void Receive (uint32_t packetId);
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<FlowProbe> m_probe;
+};
+
+FlowMonitorLossTestCase::FlowMonitorLossTestCase ()
+  : ns3::TestCase ("FlowMonitor loss detection")
+{
+}
+
+void
+FlowMonitorLossTestCase::Send (uint32_t packetId)
+{
+  m_monitor->ReportFirstTx (m_probe, 1, packetId, 100);
+}
+
+void
+FlowMonitorLossTestCase::Forward (uint32_t packetId)
+{
+  m_monitor->ReportForwarding (m_probe, 1, packetId, 100);
+}
+
+void
+FlowMonitorLossTestCase::Receive (uint32_t packetId)
+{
+  m_monitor->ReportLastRx (m_probe, 1, packetId, 100);
+}
+
+void
+FlowMonitorLossTestCase::DoRun (void)
+{
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (2)));
+  m_probe = Create<DummyFlowProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+
+  // packet 0 is received, 1 and 2 are lost, 3 is forwarded late enough
+  // to be still in flight at the end, 4 is sent late.
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Simulator::Schedule (Seconds (0.1 * i), &FlowMonitorLossTestCase::Send, this, i);
+    }
+  Simulator::Schedule (Seconds (0.5), &FlowMonitorLossTestCase::Receive, this, 0);
+  Simulator::Schedule (Seconds (1.0), &FlowMonitorLossTestCase::Forward, this, 3);
+  Simulator::Schedule (Seconds (2.5), &FlowMonitorLossTestCase::Forward, this, 3);
+  Simulator::Schedule (Seconds (2.9), &FlowMonitorLossTestCase::Send, this, 4);
+  Simulator::Stop (Seconds (3.5));
+  Simulator::Run ();
+
+  m_monitor->CheckForLostPackets ();
+  const FlowMonitor::FlowStats &stats = m_monitor->GetFlowStats ().find (1)->second;
+  NS_TEST_EXPECT_MSG_EQ (stats.txPackets, 5, "Wrong number of transmitted packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.rxPackets, 1, "Wrong number of received packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.lostPackets, 2, "Wrong number of lost packets");
+
+  // the packets still in flight are lost after the maximum delay
+  m_monitor->CheckForLostPackets (Seconds (0));
+  NS_TEST_EXPECT_MSG_EQ (stats.lostPackets, 4, "Wrong number of lost packets");
+
+  Simulator::Destroy ();
+  m_probe = 0;
+  m_monitor = 0;
+}
+
+static class FlowHashTableTestSuite : public TestSuite
+{
+public:
+  FlowHashTableTestSuite ()
+    : TestSuite ("flow-hash-table", UNIT)
+  {
+    AddTestCase (new FlowHashTableTestCase (), TestCase::QUICK);
+    AddTestCase (new FlowMonitorLossTestCase (), TestCase::QUICK);
+  }
+} g_flowHashTableTestSuite;
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/flow-stats-stream.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/flow-probe.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+namespace {
+
+/// Probe which only exists to report packets to the monitor
+class StreamTestProbe : public FlowProbe
+{
+public:
+  StreamTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+} // unnamed namespace
+
+class FlowStatsStreamTestCase : public ns3::TestCase {
+public:
+  FlowStatsStreamTestCase ();
+  virtual void DoRun (void);
+private:
+  void Send (uint32_t flowId, uint32_t packetId);
+  void Receive (uint32_t flowId, uint32_t packetId);
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<FlowProbe> m_probe;
+};
+
+FlowStatsStreamTestCase::FlowStatsStreamTestCase ()
+  : ns3::TestCase ("Write and read back a flow statistics stream")
+{
+}
+
+void
+FlowStatsStreamTestCase::Send (uint32_t flowId, uint32_t packetId)
+{
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, 100 * flowId);
+}
+
+void
+FlowStatsStreamTestCase::Receive (uint32_t flowId, uint32_t packetId)
+{
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, 100 * flowId);
+}
+
+void
+FlowStatsStreamTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("flow-stats-stream.bin");
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_probe = Create<StreamTestProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+  Ptr<FlowStatsStreamWriter> writer = CreateObject<FlowStatsStreamWriter> ();
+  writer->SetAttribute ("FileName", StringValue (fileName));
+  writer->SetAttribute ("Interval", TimeValue (Seconds (1)));
+  writer->SetFlowMonitor (m_monitor);
+  writer->Start ();
+
+  // flow 1 is active in the first two intervals, flow 2 in the second
+  // only; nothing happens in the third, which is cut short.
+  Simulator::Schedule (MilliSeconds (200), &FlowStatsStreamTestCase::Send, this, 1, 0);
+  Simulator::Schedule (MilliSeconds (300), &FlowStatsStreamTestCase::Receive, this, 1, 0);
+  Simulator::Schedule (MilliSeconds (1200), &FlowStatsStreamTestCase::Send, this, 1, 1);
+  Simulator::Schedule (MilliSeconds (1400), &FlowStatsStreamTestCase::Send, this, 2, 0);
+  Simulator::Schedule (MilliSeconds (1500), &FlowStatsStreamTestCase::Receive, this, 2, 0);
+  Simulator::Stop (MilliSeconds (2500));
+  Simulator::Run ();
+
+  FlowStatsStreamReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (fileName), true, "Can't open the stream");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetInterval (), Seconds (1), "Wrong interval");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNBlocks (), 2, "Wrong number of blocks while running");
+
+  writer->Stop ();
+  NS_TEST_ASSERT_MSG_EQ (reader.Refresh (), true, "Can't refresh the stream");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNBlocks (), 3, "Wrong number of blocks");
+
+  const FlowStatsStreamReader::Block &b0 = reader.GetBlock (0);
+  NS_TEST_EXPECT_MSG_EQ (b0.start, Seconds (0), "Wrong block start");
+  NS_TEST_EXPECT_MSG_EQ (b0.end, Seconds (1), "Wrong block end");
+  NS_TEST_ASSERT_MSG_EQ (b0.nFlows, 1, "Wrong number of flows");
+  NS_TEST_EXPECT_MSG_EQ (b0.flowId[0], 1, "Wrong flow");
+  NS_TEST_EXPECT_MSG_EQ (b0.txPackets[0], 1, "Wrong tx packets");
+  NS_TEST_EXPECT_MSG_EQ (b0.rxPackets[0], 1, "Wrong rx packets");
+  NS_TEST_EXPECT_MSG_EQ (b0.rxBytes[0], 100, "Wrong rx bytes");
+  NS_TEST_EXPECT_MSG_EQ (b0.delaySum[0], MilliSeconds (100).GetNanoSeconds (), "Wrong delay");
+
+  const FlowStatsStreamReader::Block &b1 = reader.GetBlock (1);
+  NS_TEST_ASSERT_MSG_EQ (b1.nFlows, 2, "Wrong number of flows");
+  NS_TEST_EXPECT_MSG_EQ (b1.flowId[0], 1, "Wrong flow");
+  NS_TEST_EXPECT_MSG_EQ (b1.txPackets[0], 1, "Wrong tx packets");
+  NS_TEST_EXPECT_MSG_EQ (b1.rxPackets[0], 0, "Wrong rx packets");
+  NS_TEST_EXPECT_MSG_EQ (b1.flowId[1], 2, "Wrong flow");
+  NS_TEST_EXPECT_MSG_EQ (b1.txBytes[1], 200, "Wrong tx bytes");
+  NS_TEST_EXPECT_MSG_EQ (b1.rxPackets[1], 1, "Wrong rx packets");
+
+  const FlowStatsStreamReader::Block &b2 = reader.GetBlock (2);
+  NS_TEST_EXPECT_MSG_EQ (b2.end, MilliSeconds (2500), "Wrong block end");
+  NS_TEST_EXPECT_MSG_EQ (b2.nFlows, 0, "Wrong number of flows");
+
+  reader.Close ();
+  Simulator::Destroy ();
+  m_probe = 0;
+  m_monitor = 0;
+}
+
+class FlowStatsStreamHelperTestCase : public ns3::TestCase {
+public:
+  FlowStatsStreamHelperTestCase ();
+  virtual void DoRun (void);
+private:
+  void Send (uint32_t flowId, uint32_t packetId);
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<FlowProbe> m_probe;
+};
+
+FlowStatsStreamHelperTestCase::FlowStatsStreamHelperTestCase ()
+  : ns3::TestCase ("Write the last block of a stream at Simulator::Destroy")
+{
+}
+
+void
+FlowStatsStreamHelperTestCase::Send (uint32_t flowId, uint32_t packetId)
+{
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, 100 * flowId);
+}
+
+void
+FlowStatsStreamHelperTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("flow-stats-stream-helper.bin");
+  FlowMonitorHelper *helper = new FlowMonitorHelper;
+  m_monitor = helper->GetMonitor ();
+  m_probe = Create<StreamTestProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+  helper->EnableStreaming (fileName, Seconds (1));
+
+  Simulator::Schedule (MilliSeconds (200), &FlowStatsStreamHelperTestCase::Send, this, 1, 0);
+  Simulator::Schedule (MilliSeconds (1200), &FlowStatsStreamHelperTestCase::Send, this, 1, 1);
+  Simulator::Stop (MilliSeconds (1500));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_probe = 0;
+  m_monitor = 0;
+  // the helper outlives the simulator, as in most programs
+  delete helper;
+
+  FlowStatsStreamReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (fileName), true, "Can't open the stream");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNBlocks (), 2, "Wrong number of blocks");
+  const FlowStatsStreamReader::Block &b1 = reader.GetBlock (1);
+  NS_TEST_EXPECT_MSG_EQ (b1.start, Seconds (1), "Wrong block start");
+  NS_TEST_EXPECT_MSG_EQ (b1.end, MilliSeconds (1500), "Wrong block end");
+  NS_TEST_ASSERT_MSG_EQ (b1.nFlows, 1, "Wrong number of flows");
+  NS_TEST_EXPECT_MSG_EQ (b1.txPackets[0], 1, "Wrong tx packets");
+  reader.Close ();
+}
+
+static class FlowStatsStreamTestSuite : public TestSuite
+{
+public:
+  FlowStatsStreamTestSuite ()
+    : TestSuite ("flow-stats-stream", UNIT)
+  {
+    AddTestCase (new FlowStatsStreamTestCase (), TestCase::QUICK);
+    AddTestCase (new FlowStatsStreamHelperTestCase (), TestCase::QUICK);
+  }
+} g_flowStatsStreamTestSuite;
@@ -34,6 +34,7 @@
 #include <ns3/lte-enb-net-device.h>
 #include <ns3/lte-enb-phy.h>
 #include <ns3/lte-ue-phy.h>
+#include <ns3/lte-tti-driver.h>
 #include <ns3/lte-spectrum-phy.h>
 #include <ns3/lte-chunk-processor.h>
 #include <ns3/multi-model-spectrum-channel.h>
@@ -78,6 +79,7 @@ LteHelper::LteHelper (void)
   m_enbAntennaModelFactory.SetTypeId (IsotropicAntennaModel::GetTypeId ());
   m_ueNetDeviceFactory.SetTypeId (LteUeNetDevice::GetTypeId ());
   m_ueAntennaModelFactory.SetTypeId (IsotropicAntennaModel::GetTypeId ());
+  m_ttiDriver = CreateObject<LteTtiDriver> ();
   m_channelFactory.SetTypeId (MultiModelSpectrumChannel::GetTypeId ());
 }
 
@@ -200,6 +202,13 @@ TypeId LteHelper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteHelper::m_usePdschForCqiGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("UseTtiDriver",
+                   "If true, the subframes of all the eNB and UE PHYs installed by this "
+                   "helper are started by a single LteTtiDriver event per TTI. "
+                   "If false, each PHY schedules its own subframes.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteHelper::m_useTtiDriver),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -210,6 +219,7 @@ LteHelper::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_downlinkChannel = 0;
   m_uplinkChannel = 0;
+  m_ttiDriver = 0;
   Object::DoDispose ();
 }
 
@@ -534,6 +544,11 @@ LteHelper::InstallSingleEnbDevice (Ptr<Node> n)
   dlPhy->SetDevice (dev);
   ulPhy->SetDevice (dev);
 
+  if (m_useTtiDriver)
+    {
+      phy->SetTtiDriver (m_ttiDriver);
+    }
+
   n->AddDevice (dev);
   ulPhy->SetLtePhyRxDataEndOkCallback (MakeCallback (&LteEnbPhy::PhyPduReceived, phy));
   ulPhy->SetLtePhyRxCtrlEndOkCallback (MakeCallback (&LteEnbPhy::ReceiveLteControlMessageList, phy));
@@ -692,6 +707,11 @@ LteHelper::InstallSingleUeDevice (Ptr<Node> n)
   phy->SetDevice (dev);
   dlPhy->SetDevice (dev);
   ulPhy->SetDevice (dev);
+
+  if (m_useTtiDriver)
+    {
+      phy->SetTtiDriver (m_ttiDriver);
+    }
   nas->SetDevice (dev);
 
   n->AddDevice (dev);
@@ -45,6 +45,7 @@ class LteUePhy;
 class LteEnbPhy;
 class SpectrumChannel;
 class EpcHelper;
+class LteTtiDriver;
 class PropagationLossModel;
 class SpectrumPropagationLossModel;
 
@@ -731,6 +732,13 @@ private:
    * DL-CQI will be calculated from PDCCH as signal and PDCCH as interference.
    */
   bool m_usePdschForCqiGeneration;
+  /**
+   * The `UseTtiDriver` attribute. If true, the subframes of all the eNB and
+   * UE PHYs installed by this helper are started by #m_ttiDriver.
+   */
+  bool m_useTtiDriver;
+  /// The driver of the subframes of the PHYs, if `UseTtiDriver` is true.
+  Ptr<LteTtiDriver> m_ttiDriver;
 
 }; // end of `class LteHelper`
 
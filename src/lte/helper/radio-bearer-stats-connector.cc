@@ -151,22 +151,25 @@ RadioBearerStatsConnector::EnsureConnected ()
   NS_LOG_FUNCTION (this);
   if (!m_connected)
     {
-      Config::Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/NewUeContext",
-		       MakeBoundCallback (&RadioBearerStatsConnector::NotifyNewUeContextEnb, this));
-      Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/RandomAccessSuccessful",
-		       MakeBoundCallback (&RadioBearerStatsConnector::NotifyRandomAccessSuccessfulUe, this));
-      Config::Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/ConnectionReconfiguration",
-		       MakeBoundCallback (&RadioBearerStatsConnector::NotifyConnectionReconfigurationEnb, this));
-      Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/ConnectionReconfiguration",
-		       MakeBoundCallback (&RadioBearerStatsConnector::NotifyConnectionReconfigurationUe, this));
-      Config::Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverStart",
-		       MakeBoundCallback (&RadioBearerStatsConnector::NotifyHandoverStartEnb, this));
-      Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/HandoverStart",
-		       MakeBoundCallback (&RadioBearerStatsConnector::NotifyHandoverStartUe, this));
-      Config::Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverEndOk",
-		       MakeBoundCallback (&RadioBearerStatsConnector::NotifyHandoverEndOkEnb, this));
-      Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
-		       MakeBoundCallback (&RadioBearerStatsConnector::NotifyHandoverEndOkUe, this));
+      // all the paths share the /NodeList/*/DeviceList/* prefix
+      Config::BulkConnector bulk;
+      bulk.Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/NewUeContext",
+                    MakeBoundCallback (&RadioBearerStatsConnector::NotifyNewUeContextEnb, this));
+      bulk.Connect ("/NodeList/*/DeviceList/*/LteUeRrc/RandomAccessSuccessful",
+                    MakeBoundCallback (&RadioBearerStatsConnector::NotifyRandomAccessSuccessfulUe, this));
+      bulk.Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/ConnectionReconfiguration",
+                    MakeBoundCallback (&RadioBearerStatsConnector::NotifyConnectionReconfigurationEnb, this));
+      bulk.Connect ("/NodeList/*/DeviceList/*/LteUeRrc/ConnectionReconfiguration",
+                    MakeBoundCallback (&RadioBearerStatsConnector::NotifyConnectionReconfigurationUe, this));
+      bulk.Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverStart",
+                    MakeBoundCallback (&RadioBearerStatsConnector::NotifyHandoverStartEnb, this));
+      bulk.Connect ("/NodeList/*/DeviceList/*/LteUeRrc/HandoverStart",
+                    MakeBoundCallback (&RadioBearerStatsConnector::NotifyHandoverStartUe, this));
+      bulk.Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverEndOk",
+                    MakeBoundCallback (&RadioBearerStatsConnector::NotifyHandoverEndOkEnb, this));
+      bulk.Connect ("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
+                    MakeBoundCallback (&RadioBearerStatsConnector::NotifyHandoverEndOkUe, this));
+      bulk.Commit ();
       m_connected = true;
     }
 }
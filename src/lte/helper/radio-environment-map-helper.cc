@@ -37,9 +37,24 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/node-list.h>
+#include <ns3/building-list.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
 
 #include <fstream>
 #include <limits>
+#include <cmath>
+#include <cstring>
 
 namespace ns3 {
 
@@ -47,6 +62,9 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
+const char RadioEnvironmentMapHelper::BINARY_MAGIC[8] = { 'N', 'S', '3', 'R', 'E', 'M', 'G', 'R' };
+const uint32_t RadioEnvironmentMapHelper::BINARY_VERSION;
+
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
 {
 }
@@ -62,6 +80,9 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_transmitters.clear ();
+  m_threads.clear ();
+  m_propagationLoss = 0;
 }
 
 TypeId
@@ -144,6 +165,27 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("Direct",
+                   "If true, the map is computed from the eNB antennas and the "
+                   "PropagationLossModel of the channel, assuming that every eNB "
+                   "transmits on all its RBs, instead of listening to the "
+                   "signals sent on the channel",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_direct),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "The number of threads computing a direct map. Only use more "
+                   "than one thread with a PropagationLossModel that has no "
+                   "state nor random variables; with buildings, one thread is used",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1, 1024))
+    .AddAttribute ("BinaryOutput",
+                   "If true, the map is saved as a binary grid of SINR values "
+                   "instead of text",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_binaryOutput),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -181,7 +223,7 @@ void
 RadioEnvironmentMapHelper::Install ()
 {
   NS_LOG_FUNCTION (this);
-  if (!m_rem.empty ())
+  if (!m_rem.empty () || !m_sinr.empty ())
     {
       NS_FATAL_ERROR ("only one REM supported per instance of RadioEnvironmentMapHelper");
     }
@@ -193,12 +235,26 @@ RadioEnvironmentMapHelper::Install ()
   m_channel = match.Get (0)->GetObject<SpectrumChannel> ();
   NS_ABORT_MSG_IF (m_channel == 0, "object at " << m_channelPath << "is not of type SpectrumChannel");
 
-  m_outFile.open (m_outputFile.c_str ());
+  if (m_binaryOutput)
+    {
+      m_outFile.open (m_outputFile.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+  else
+    {
+      m_outFile.open (m_outputFile.c_str ());
+    }
   if (!m_outFile.is_open ())
     {
       NS_FATAL_ERROR ("Can't open file " << (m_outputFile));
       return;
     }
+
+  if (m_direct)
+    {
+      // let the eNBs be configured before looking at them
+      Simulator::ScheduleNow (&RadioEnvironmentMapHelper::DirectInstall, this);
+      return;
+    }
   
   double startDelay = 0.0026;
 
@@ -331,11 +387,18 @@ RadioEnvironmentMapHelper::PrintAndReset ()
                     << pos.y << "\t" 
                     << pos.z << "\t" 
                     << it->phy->GetSinr (m_noisePower));
-      m_outFile << pos.x << "\t" 
-                << pos.y << "\t" 
-                << pos.z << "\t" 
-                << it->phy->GetSinr (m_noisePower)
-                << std::endl;
+      if (m_binaryOutput)
+        {
+          m_sinr.push_back (it->phy->GetSinr (m_noisePower));
+        }
+      else
+        {
+          m_outFile << pos.x << "\t" 
+                    << pos.y << "\t" 
+                    << pos.z << "\t" 
+                    << it->phy->GetSinr (m_noisePower)
+                    << std::endl;
+        }
       it->phy->Reset ();
     }
 }
@@ -344,6 +407,10 @@ void
 RadioEnvironmentMapHelper::Finalize ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_binaryOutput || m_direct)
+    {
+      WriteMap ();
+    }
   m_outFile.close ();
   if (m_stopWhenDone)
     {
@@ -351,5 +418,185 @@ RadioEnvironmentMapHelper::Finalize ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::DirectInstall ()
+{
+  NS_LOG_FUNCTION (this);
+  m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
+  m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+  m_propagationLoss = m_channel->GetPropagationLossModel ();
+  Ptr<const SpectrumModel> rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+
+  for (NodeList::Iterator nit = NodeList::Begin (); nit != NodeList::End (); ++nit)
+    {
+      for (uint32_t i = 0; i < (*nit)->GetNDevices (); ++i)
+        {
+          Ptr<LteEnbNetDevice> enbDev = (*nit)->GetDevice (i)->GetObject<LteEnbNetDevice> ();
+          if (enbDev == 0)
+            {
+              continue;
+            }
+          Ptr<LteEnbPhy> enbPhy = enbDev->GetPhy ();
+          Ptr<LteSpectrumPhy> dlPhy = enbPhy->GetDownlinkSpectrumPhy ();
+          if (dlPhy->GetChannel () != m_channel || dlPhy->GetMobility () == 0)
+            {
+              continue;
+            }
+          std::vector<int> activeRbs;
+          for (int rb = 0; rb < enbDev->GetDlBandwidth (); ++rb)
+            {
+              activeRbs.push_back (rb);
+            }
+          Ptr<SpectrumValue> txPsd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (enbDev->GetDlEarfcn (),
+                                                                                           enbDev->GetDlBandwidth (),
+                                                                                           enbPhy->GetTxPower (),
+                                                                                           activeRbs);
+          if (txPsd->GetSpectrumModelUid () != rxSpectrumModel->GetUid ())
+            {
+              SpectrumConverter converter (txPsd->GetSpectrumModel (), rxSpectrumModel);
+              txPsd = converter.Convert (txPsd);
+            }
+          RemTransmitter t;
+          t.position = dlPhy->GetMobility ()->GetPosition ();
+          t.antenna = dlPhy->GetRxAntenna ();
+          t.power = (m_rbId >= 0) ? (*txPsd)[m_rbId] * 180000 : Integral (*txPsd);
+          NS_LOG_LOGIC ("eNB at " << t.position << " received power " << t.power << " W");
+          m_transmitters.push_back (t);
+        }
+    }
+
+  uint32_t numThreads = m_numThreads;
+#ifndef HAVE_PTHREAD_H
+  numThreads = 1;
+#endif
+  if (numThreads > 1 && BuildingList::GetNBuildings () > 0)
+    {
+      NS_LOG_WARN ("buildings are not thread-safe, computing the map in one thread");
+      numThreads = 1;
+    }
+  if (numThreads > m_xRes)
+    {
+      numThreads = m_xRes;
+    }
+
+  // all the objects are created here, the threads only move them
+  m_threads.resize (numThreads);
+  for (uint32_t i = 0; i < numThreads; ++i)
+    {
+      RemThread &thread = m_threads[i];
+      thread.helper = this;
+      thread.index = i;
+      thread.rxMobility = CreateObject<ConstantPositionMobilityModel> ();
+      thread.rxMobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+      for (std::vector<RemTransmitter>::const_iterator it = m_transmitters.begin ();
+           it != m_transmitters.end (); ++it)
+        {
+          Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+          txMobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+          txMobility->SetPosition (it->position);
+          BuildingsHelper::MakeConsistent (txMobility);
+          thread.txMobility.push_back (txMobility);
+        }
+    }
+
+  m_sinr.assign (m_xRes * m_yRes, 0);
+  if (numThreads == 1)
+    {
+      ComputeRows (0);
+    }
+#ifdef HAVE_PTHREAD_H
+  else
+    {
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t i = 0; i < numThreads; ++i)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&RemThread::Run, &m_threads[i])));
+          threads.back ()->Start ();
+        }
+      for (uint32_t i = 0; i < numThreads; ++i)
+        {
+          threads[i]->Join ();
+        }
+    }
+#endif
+  m_threads.clear ();
+  Finalize ();
+}
+
+void
+RadioEnvironmentMapHelper::ComputeRows (uint32_t thread)
+{
+  RemThread &state = m_threads[thread];
+  for (uint32_t i = thread; i < m_xRes; i += m_threads.size ())
+    {
+      for (uint32_t j = 0; j < m_yRes; ++j)
+        {
+          Vector pos (m_xMin + i * m_xStep, m_yMin + j * m_yStep, m_z);
+          state.rxMobility->SetPosition (pos);
+          BuildingsHelper::MakeConsistent (state.rxMobility);
+          // as RemSpectrumPhy, which has no antenna, with the losses
+          // of MultiModelSpectrumChannel::StartTx
+          double sumPower = 0;
+          double referenceSignalPower = 0;
+          for (uint32_t k = 0; k < m_transmitters.size (); ++k)
+            {
+              const RemTransmitter &t = m_transmitters[k];
+              double gainDb = 0;
+              if (t.antenna != 0)
+                {
+                  gainDb += t.antenna->GetGainDb (Angles (pos, t.position));
+                }
+              if (m_propagationLoss != 0)
+                {
+                  gainDb += m_propagationLoss->CalcRxPower (0, state.txMobility[k], state.rxMobility);
+                }
+              double power = t.power * std::pow (10.0, gainDb / 10.0);
+              sumPower += power;
+              if (power > referenceSignalPower)
+                {
+                  referenceSignalPower = power;
+                }
+            }
+          m_sinr[i * m_yRes + j] = referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+        }
+    }
+}
+
+void
+RadioEnvironmentMapHelper::WriteMap ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_binaryOutput)
+    {
+      BinaryHeader header;
+      std::memset (&header, 0, sizeof (header));
+      std::memcpy (header.magic, BINARY_MAGIC, sizeof (header.magic));
+      header.version = BINARY_VERSION;
+      header.headerSize = sizeof (header);
+      header.xRes = m_xRes;
+      header.yRes = m_yRes;
+      header.xMin = m_xMin;
+      header.xMax = m_xMax;
+      header.yMin = m_yMin;
+      header.yMax = m_yMax;
+      header.z = m_z;
+      NS_ASSERT_MSG (m_sinr.size () == (size_t) m_xRes * m_yRes, "the map has " << m_sinr.size () << " points");
+      m_outFile.write (reinterpret_cast<const char *> (&header), sizeof (header));
+      m_outFile.write (reinterpret_cast<const char *> (&m_sinr[0]), sizeof (double) * m_sinr.size ());
+      return;
+    }
+  for (uint32_t i = 0; i < m_xRes; ++i)
+    {
+      for (uint32_t j = 0; j < m_yRes; ++j)
+        {
+          m_outFile << m_xMin + i * m_xStep << "\t"
+                    << m_yMin + j * m_yStep << "\t"
+                    << m_z << "\t"
+                    << m_sinr[i * m_yRes + j]
+                    << std::endl;
+        }
+    }
+}
+
 
 } // namespace ns3
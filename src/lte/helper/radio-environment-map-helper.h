@@ -24,7 +24,9 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +37,8 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class AntennaModel;
+class PropagationLossModel;
 
 /** 
  * \ingroup lte
@@ -42,6 +46,14 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is made by listening to the signals sent on the
+ * channel by RemSpectrumPhy instances moved across the map, one batch
+ * of MaxPointsPerIteration points after the other.  When the Direct
+ * attribute is true, the received power of each eNB is instead
+ * computed at every point from the eNB antenna and the
+ * PropagationLossModel of the channel, in NumThreads threads, without
+ * creating PHYs nor scheduling events.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -75,6 +87,30 @@ public:
    */
   void Install ();
 
+  /// Magic at the start of a binary map ("NS3REMGR")
+  static const char BINARY_MAGIC[8];
+  /// Current version of the binary map format
+  static const uint32_t BINARY_VERSION = 1;
+
+  /**
+   * Header at the start of a binary map.  The header is followed by
+   * xRes * yRes doubles with the linear SINR of the points, in host
+   * byte order, in the order of the text map: y varies first.
+   */
+  struct BinaryHeader
+  {
+    char magic[8];       //!< BINARY_MAGIC
+    uint32_t version;    //!< BINARY_VERSION
+    uint32_t headerSize; //!< sizeof (BinaryHeader)
+    uint32_t xRes;       //!< number of points along the x axis
+    uint32_t yRes;       //!< number of points along the y axis
+    double xMin;         //!< x coordinate of the first point
+    double xMax;         //!< x coordinate of the last point
+    double yMin;         //!< y coordinate of the first point
+    double yMax;         //!< y coordinate of the last point
+    double z;            //!< z coordinate of the points
+  };
+
 private:
 
   /**
@@ -108,6 +144,42 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /// Compute the whole map without PHYs, in m_numThreads threads.
+  void DirectInstall ();
+
+  /**
+   * Compute the points of the rows thread, thread + m_numThreads, ...
+   * of the map.
+   *
+   * \param thread the index of the calling thread
+   */
+  void ComputeRows (uint32_t thread);
+
+  /// Write the SINR of the points to the text or binary output file.
+  void WriteMap ();
+
+  /// an eNB seen by the points of a direct map
+  struct RemTransmitter
+  {
+    Vector position;              ///< position of the eNB
+    Ptr<AntennaModel> antenna;    ///< antenna of the eNB, or 0
+    double power;                 ///< power received without loss, in W
+  };
+
+  /// the objects used by one thread of a direct map
+  struct RemThread
+  {
+    RadioEnvironmentMapHelper *helper;  ///< the helper
+    uint32_t index;                     ///< index of the thread
+    Ptr<MobilityModel> rxMobility;      ///< position of the current point
+    std::vector<Ptr<MobilityModel> > txMobility;  ///< position of each eNB
+    /// Compute the rows of the thread
+    void Run (void)
+    {
+      helper->ComputeRows (index);
+    }
+  };
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +224,19 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_direct;          ///< The `Direct` attribute.
+  uint32_t m_numThreads;  ///< The `NumThreads` attribute.
+  bool m_binaryOutput;    ///< The `BinaryOutput` attribute.
+
+  /// SINR of the points, when the map is direct or binary.
+  std::vector<double> m_sinr;
+  /// eNBs of a direct map.
+  std::vector<RemTransmitter> m_transmitters;
+  /// threads of a direct map.
+  std::vector<RemThread> m_threads;
+  /// propagation loss model of the channel.
+  Ptr<PropagationLossModel> m_propagationLoss;
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
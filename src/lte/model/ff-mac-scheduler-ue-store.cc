@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ff-mac-scheduler-ue-store.h"
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FfMacSchedulerUeStore");
+
+FfMacSchedulerUeStore::FfMacSchedulerUeStore ()
+  : m_rbgNum (0)
+{
+}
+
+void
+FfMacSchedulerUeStore::Clear (uint16_t rbgNum)
+{
+  NS_LOG_FUNCTION (this << rbgNum);
+  m_rbgNum = rbgNum;
+  m_rnti.clear ();
+  m_eligible.clear ();
+  m_layers.clear ();
+  m_lcActive.clear ();
+  m_averagedThroughput.clear ();
+  m_metric.clear ();
+}
+
+uint32_t
+FfMacSchedulerUeStore::AddUe (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  NS_ASSERT_MSG (m_rnti.empty () || m_rnti.back () < rnti, "UEs not added in increasing RNTI order");
+  m_rnti.push_back (rnti);
+  m_eligible.push_back (false);
+  m_layers.push_back (1);
+  m_lcActive.push_back (0);
+  m_averagedThroughput.push_back (1.0);
+  return m_rnti.size () - 1;
+}
+
+void
+FfMacSchedulerUeStore::ResetMetrics (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_metric.assign (m_rbgNum * m_rnti.size (), 0.0);
+}
+
+uint32_t
+FfMacSchedulerUeStore::GetNUes (void) const
+{
+  return m_rnti.size ();
+}
+
+int32_t
+FfMacSchedulerUeStore::GetIndex (uint16_t rnti) const
+{
+  std::vector<uint16_t>::const_iterator it = std::lower_bound (m_rnti.begin (), m_rnti.end (), rnti);
+  if ((it == m_rnti.end ()) || (*it != rnti))
+    {
+      return -1;
+    }
+  return it - m_rnti.begin ();
+}
+
+uint16_t
+FfMacSchedulerUeStore::GetRnti (uint32_t ue) const
+{
+  return m_rnti[ue];
+}
+
+void
+FfMacSchedulerUeStore::SetEligible (uint32_t ue, bool eligible)
+{
+  m_eligible[ue] = eligible;
+}
+
+bool
+FfMacSchedulerUeStore::IsEligible (uint32_t ue) const
+{
+  return m_eligible[ue];
+}
+
+void
+FfMacSchedulerUeStore::SetLayers (uint32_t ue, uint8_t layers)
+{
+  m_layers[ue] = layers;
+}
+
+uint8_t
+FfMacSchedulerUeStore::GetLayers (uint32_t ue) const
+{
+  return m_layers[ue];
+}
+
+void
+FfMacSchedulerUeStore::SetLcActive (uint32_t ue, uint16_t lcActive)
+{
+  m_lcActive[ue] = lcActive;
+}
+
+uint16_t
+FfMacSchedulerUeStore::GetLcActive (uint32_t ue) const
+{
+  return m_lcActive[ue];
+}
+
+void
+FfMacSchedulerUeStore::SetAveragedThroughput (uint32_t ue, double throughput)
+{
+  m_averagedThroughput[ue] = throughput;
+}
+
+double
+FfMacSchedulerUeStore::GetAveragedThroughput (uint32_t ue) const
+{
+  return m_averagedThroughput[ue];
+}
+
+void
+FfMacSchedulerUeStore::SetMetric (uint16_t rbg, uint32_t ue, double metric)
+{
+  NS_ASSERT (rbg < m_rbgNum && ue < m_rnti.size ());
+  m_metric[rbg * m_rnti.size () + ue] = metric;
+}
+
+double
+FfMacSchedulerUeStore::GetMetric (uint16_t rbg, uint32_t ue) const
+{
+  NS_ASSERT (rbg < m_rbgNum && ue < m_rnti.size ());
+  return m_metric[rbg * m_rnti.size () + ue];
+}
+
+int32_t
+FfMacSchedulerUeStore::GetBestUe (uint16_t rbg) const
+{
+  NS_ASSERT (rbg < m_rbgNum);
+  uint32_t nUes = m_rnti.size ();
+  if (nUes == 0)
+    {
+      return -1;
+    }
+  const double *metric = &m_metric[rbg * nUes];
+  double bestMetric = 0.0;
+  int32_t bestUe = -1;
+  for (uint32_t ue = 0; ue < nUes; ue++)
+    {
+      if (metric[ue] > bestMetric)
+        {
+          bestMetric = metric[ue];
+          bestUe = ue;
+        }
+    }
+  return bestUe;
+}
+
+} // namespace ns3
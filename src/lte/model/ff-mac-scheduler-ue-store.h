@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_SCHEDULER_UE_STORE_H
+#define FF_MAC_SCHEDULER_UE_STORE_H
+
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ * \brief Dense state of the UEs considered by a scheduler in a TTI
+ *
+ * The UEs are stored at dense indexes in increasing RNTI order, which
+ * is the order in which the schedulers walk their per-RNTI maps. Each
+ * field of the UEs is kept in its own array, and the metric of each
+ * (RBG, UE) pair in a RBG-major matrix, so that the selection of the
+ * UE of a RBG is a linear scan of contiguous memory instead of a
+ * number of map lookups per UE.
+ *
+ * The store is filled at the beginning of a TTI from the state of the
+ * scheduler, and keeps its memory from a TTI to the next.
+ */
+class FfMacSchedulerUeStore
+{
+public:
+  FfMacSchedulerUeStore ();
+
+  /**
+   * \brief remove all the UEs
+   * \param rbgNum the number of RBGs of the metric matrix
+   */
+  void Clear (uint16_t rbgNum);
+
+  /**
+   * \brief add a UE, in increasing RNTI order
+   *
+   * The UE is not eligible, has no active LC, a single layer and a unit
+   * averaged throughput.
+   *
+   * \param rnti the RNTI of the UE
+   * \return the index of the UE
+   */
+  uint32_t AddUe (uint16_t rnti);
+
+  /**
+   * \brief set the metric of all the (RBG, UE) pairs to zero
+   *
+   * To be called once all the UEs have been added.
+   */
+  void ResetMetrics (void);
+
+  /**
+   * \return the number of UEs
+   */
+  uint32_t GetNUes (void) const;
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \return the index of the UE, or -1 if the UE is not in the store
+   */
+  int32_t GetIndex (uint16_t rnti) const;
+
+  /**
+   * \param ue the index of a UE
+   * \return the RNTI of the UE
+   */
+  uint16_t GetRnti (uint32_t ue) const;
+
+  /**
+   * \param ue the index of a UE
+   * \param eligible whether the UE can be allocated new RBGs in this TTI
+   */
+  void SetEligible (uint32_t ue, bool eligible);
+
+  /**
+   * \param ue the index of a UE
+   * \return whether the UE can be allocated new RBGs in this TTI
+   */
+  bool IsEligible (uint32_t ue) const;
+
+  /**
+   * \param ue the index of a UE
+   * \param layers the number of layers of the transmission mode of the UE
+   */
+  void SetLayers (uint32_t ue, uint8_t layers);
+
+  /**
+   * \param ue the index of a UE
+   * \return the number of layers of the transmission mode of the UE
+   */
+  uint8_t GetLayers (uint32_t ue) const;
+
+  /**
+   * \param ue the index of a UE
+   * \param lcActive the number of LCs of the UE with data to transmit
+   */
+  void SetLcActive (uint32_t ue, uint16_t lcActive);
+
+  /**
+   * \param ue the index of a UE
+   * \return the number of LCs of the UE with data to transmit
+   */
+  uint16_t GetLcActive (uint32_t ue) const;
+
+  /**
+   * \param ue the index of a UE
+   * \param throughput the averaged throughput of the UE
+   */
+  void SetAveragedThroughput (uint32_t ue, double throughput);
+
+  /**
+   * \param ue the index of a UE
+   * \return the averaged throughput of the UE
+   */
+  double GetAveragedThroughput (uint32_t ue) const;
+
+  /**
+   * \param rbg the index of a RBG
+   * \param ue the index of a UE
+   * \param metric the metric of the UE on the RBG, not positive if the UE
+   * can't be allocated the RBG
+   */
+  void SetMetric (uint16_t rbg, uint32_t ue, double metric);
+
+  /**
+   * \param rbg the index of a RBG
+   * \param ue the index of a UE
+   * \return the metric of the UE on the RBG
+   */
+  double GetMetric (uint16_t rbg, uint32_t ue) const;
+
+  /**
+   * \param rbg the index of a RBG
+   * \return the index of the UE with the highest positive metric on the
+   * RBG (the first one in case of ties), or -1 if no UE has a positive
+   * metric
+   */
+  int32_t GetBestUe (uint16_t rbg) const;
+
+private:
+  uint16_t m_rbgNum;                       //!< number of RBGs
+  std::vector<uint16_t> m_rnti;            //!< RNTI of the UEs, in increasing order
+  std::vector<uint8_t> m_eligible;         //!< whether the UEs can be allocated new RBGs
+  std::vector<uint8_t> m_layers;           //!< number of layers of the UEs
+  std::vector<uint16_t> m_lcActive;        //!< number of active LCs of the UEs
+  std::vector<double> m_averagedThroughput; //!< averaged throughput of the UEs
+  std::vector<double> m_metric;            //!< metric of the (RBG, UE) pairs, RBG-major
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_SCHEDULER_UE_STORE_H */
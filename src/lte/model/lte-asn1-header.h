@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -69,13 +70,48 @@ protected:
   mutable uint8_t m_numSerializationPendingBits; //!< number of pending bits
   mutable bool m_isDataSerialized; //!< true if data is serialized
   mutable Buffer m_serializationResult; //!< serialization result
+  /**
+   * Complete octets of the serialization in progress, copied to
+   * m_serializationResult once the serialization is finalized. Its
+   * memory is kept from a serialization to the next one.
+   */
+  mutable std::vector<uint8_t> m_serializationOctets;
+
+  /**
+   * Discard the result of a previous serialization, before serializing
+   * the information elements again
+   */
+  void ClearSerialization () const;
 
   /**
-   * Function to write in m_serializationResult, after resizing its size
+   * Function to write an octet at the end of the serialization
    * \param octet bits to write
    */
   void WriteOctet (uint8_t octet) const;
 
+  /**
+   * Write bits at the end of the serialization, most significant first,
+   * packing them into octets a word at a time
+   * \param value the bits to write, in the least significant bits
+   * \param numBits number of bits to write (at most 32)
+   */
+  void WriteBits (uint32_t value, int numBits) const;
+
+  /**
+   * Read bits of the serialization, most significant first
+   * \param value the bits read, in the least significant bits
+   * \param numBits number of bits to read (at most 32)
+   * \param bIterator buffer iterator
+   * \returns the modified buffer iterator
+   */
+  Buffer::Iterator ReadBits (uint32_t *value, int numBits, Buffer::Iterator bIterator);
+
+  /**
+   * \param range the number of values of a constrained integer
+   * \returns the number of bits of the integer (Clause 11.5.6 ITU-T X.691)
+   */
+  static int GetRequiredBits (int range);
+
   // Serialization functions
 
   /**
@@ -50,7 +50,6 @@ void
 LteChunkProcessor::Start ()
 {
   NS_LOG_FUNCTION (this);
-  m_sumValues = 0;
   m_totDuration = MicroSeconds (0);
 }
 
@@ -59,11 +58,15 @@ void
 LteChunkProcessor::EvaluateChunk (const SpectrumValue& sinr, Time duration)
 {
   NS_LOG_FUNCTION (this << sinr << duration);
-  if (m_sumValues == 0)
+  if (m_totDuration.IsZero ())
     {
-      m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
+      // first chunk: overwrite the sum of the previous calculation
+      Scale (m_sumValues, sinr, duration.GetSeconds ());
+    }
+  else
+    {
+      AddScaled (m_sumValues, sinr, duration.GetSeconds ());
     }
-  (*m_sumValues) += sinr * duration.GetSeconds ();
   m_totDuration += duration;
 }
 
@@ -73,10 +76,11 @@ LteChunkProcessor::End ()
   NS_LOG_FUNCTION (this);
   if (m_totDuration.GetSeconds () > 0)
     {
+      m_sumValues /= m_totDuration.GetSeconds ();
       std::vector<LteChunkProcessorCallback>::iterator it;
       for (it = m_lteChunkProcessorCallbacks.begin (); it != m_lteChunkProcessorCallbacks.end (); it++)
         {
-          (*it)((*m_sumValues) / m_totDuration.GetSeconds ());
+          (*it)(m_sumValues);
         }
     }
   else
@@ -30,11 +30,10 @@
 #include <ns3/ptr.h>
 #include <ns3/nstime.h>
 #include <ns3/object.h>
+#include <ns3/spectrum-value.h>
 
 namespace ns3 {
 
-class SpectrumValue;
-
 typedef Callback< void, const SpectrumValue& > LteChunkProcessorCallback;
 
 /** 
@@ -68,7 +67,8 @@ public:
   /**
     * \brief Collect SpectrumValue and duration of signal
     *
-    * Passed values are collected in m_sumValues and m_totDuration variables.
+    * Passed values are collected in m_sumValues and m_totDuration variables,
+    * without allocating anything once the first chunk has been seen.
     */
   virtual void EvaluateChunk (const SpectrumValue& sinr, Time duration);
 
@@ -82,8 +82,8 @@ public:
   virtual void End ();
 
 private:
-  Ptr<SpectrumValue> m_sumValues;
-  Time m_totDuration;
+  SpectrumValue m_sumValues; //!< sum of the values weighted by their duration, reused across calculations
+  Time m_totDuration;        //!< total duration of the chunks
 
   std::vector<LteChunkProcessorCallback> m_lteChunkProcessorCallbacks;
 };
@@ -29,6 +29,7 @@
 
 
 #include "lte-enb-phy.h"
+#include "lte-tti-driver.h"
 #include "lte-ue-phy.h"
 #include "lte-net-device.h"
 #include "lte-spectrum-value-helper.h"
@@ -260,7 +261,11 @@ LteEnbPhy::DoInitialize ()
           haveNodeId = true;
         }
     }
-  if (haveNodeId)
+  if (m_ttiDriver != 0)
+    {
+      m_ttiDriver->AddEnbPhy (this);
+    }
+  else if (haveNodeId)
     {
       Simulator::ScheduleWithContext (nodeId, Seconds (0), &LteEnbPhy::StartFrame, this);
     }
@@ -758,12 +763,29 @@ LteEnbPhy::StartSubFrame (void)
   // trigger the MAC
   m_enbPhySapUser->SubframeIndication (m_nrFrames, m_nrSubFrames);
 
-  Simulator::Schedule (Seconds (GetTti ()),
-                       &LteEnbPhy::EndSubFrame,
-                       this);
+  if (m_ttiDriver == 0)
+    {
+      Simulator::Schedule (Seconds (GetTti ()),
+                           &LteEnbPhy::EndSubFrame,
+                           this);
+    }
 
 }
 
+void
+LteEnbPhy::StartNextSubFrame (void)
+{
+  NS_LOG_FUNCTION (this);
+  if ((m_nrFrames == 0) || (m_nrSubFrames == 10))
+    {
+      StartFrame ();
+    }
+  else
+    {
+      StartSubFrame ();
+    }
+}
+
 void
 LteEnbPhy::SendControlChannels (std::list<Ptr<LteControlMessage> > ctrlMsgList)
 {
@@ -257,6 +257,13 @@ public:
    * \brief End a LTE frame
    */
   void EndFrame (void);
+  /**
+   * \brief Start the next LTE sub frame, and the next frame if needed
+   *
+   * Used by LteTtiDriver in place of the EndSubFrame and EndFrame
+   * events.
+   */
+  void StartNextSubFrame (void);
 
   /**
    * \brief PhySpectrum received a new PHY-PDU
@@ -24,16 +24,22 @@
 
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include <ns3/boolean.h>
+
+#include <algorithm>
 
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("LteInterference");
 
+NS_OBJECT_ENSURE_REGISTERED (LteInterference);
+
 LteInterference::LteInterference ()
   : m_receiving (false),
     m_lastSignalId (0),
-    m_lastSignalIdBeforeReset (0)
+    m_lastSignalIdBeforeReset (0),
+    m_coalesceSignals (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -50,6 +56,11 @@ LteInterference::DoDispose ()
   m_rsPowerChunkProcessorList.clear ();
   m_sinrChunkProcessorList.clear ();
   m_interfChunkProcessorList.clear ();
+  for (std::vector<EndingSignals>::iterator it = m_endingSignals.begin (); it != m_endingSignals.end (); ++it)
+    {
+      it->event.Cancel ();
+    }
+  m_endingSignals.clear ();
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
@@ -63,6 +74,14 @@ LteInterference::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::LteInterference")
     .SetParent<Object> ()
     .SetGroupName("Lte")
+    .AddAttribute ("CoalesceSignals",
+                   "If true, the signals ending at the same time are subtracted "
+                   "from the total power by a single event. The resulting SINR may "
+                   "differ from the one of the signal by signal subtraction by "
+                   "rounding errors only.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteInterference::m_coalesceSignals),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -136,6 +155,35 @@ LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
 {
   NS_LOG_FUNCTION (this << *spd << duration);
   DoAddSignal (spd);
+  if (m_coalesceSignals)
+    {
+      Time endTime = Now () + duration;
+      uint32_t free = m_endingSignals.size ();
+      for (uint32_t i = 0; i < m_endingSignals.size (); ++i)
+        {
+          EndingSignals &ending = m_endingSignals[i];
+          if (!ending.event.IsRunning ())
+            {
+              free = std::min (free, i);
+            }
+          else if (ending.endTime == endTime)
+            {
+              NS_LOG_LOGIC ("coalescing with the signals ending at " << endTime);
+              ending.psd += (*spd);
+              return;
+            }
+        }
+      if (free == m_endingSignals.size ())
+        {
+          m_endingSignals.push_back (EndingSignals ());
+        }
+      EndingSignals &ending = m_endingSignals[free];
+      ending.endTime = endTime;
+      // reuses the memory of the previous signals
+      ending.psd = (*spd);
+      ending.event = Simulator::Schedule (duration, &LteInterference::DoSubtractEndingSignals, this, free);
+      return;
+    }
   uint32_t signalId = ++m_lastSignalId;
   if (signalId == m_lastSignalIdBeforeReset)
     {
@@ -175,6 +223,15 @@ LteInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signa
 }
 
 
+void
+LteInterference::DoSubtractEndingSignals (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  ConditionallyEvaluateChunk ();
+  (*m_allSignals) -= m_endingSignals[index].psd;
+}
+
+
 void
 LteInterference::ConditionallyEvaluateChunk ()
 {
@@ -188,17 +245,16 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      // interf = allSignals - rxSignal + noise, sinr = rxSignal / interf
+      ComputeSinr (m_sinr, m_interf, *m_rxSignal, *m_allSignals, *m_noise);
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (sinr, duration);
+          (*it)->EvaluateChunk (m_sinr, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (interf, duration);
+          (*it)->EvaluateChunk (m_interf, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
@@ -225,6 +281,10 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // record the last SignalId so that we can ignore all signals that
   // were scheduled for subtraction before m_allSignal 
   m_lastSignalIdBeforeReset = m_lastSignalId;
+  for (std::vector<EndingSignals>::iterator it = m_endingSignals.begin (); it != m_endingSignals.end (); ++it)
+    {
+      it->event.Cancel ();
+    }
 }
 
 void
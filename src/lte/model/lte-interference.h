@@ -26,8 +26,10 @@
 #include <ns3/packet.h>
 #include <ns3/nstime.h>
 #include <ns3/spectrum-value.h>
+#include <ns3/event-id.h>
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -42,6 +44,11 @@ class LteChunkProcessor;
  * This class implements a gaussian interference model, i.e., all
  * incoming signals are added to the total interference.
  *
+ * When the CoalesceSignals attribute is true, the signals ending at
+ * the same time are accumulated in a single PSD and subtracted by a
+ * single event, instead of one event per signal. The PSDs are reused
+ * from a signal to the next, so that no memory is allocated once the
+ * number of distinct end times has settled.
  */
 class LteInterference : public Object
 {
@@ -118,6 +125,20 @@ private:
   void ConditionallyEvaluateChunk ();
   void DoAddSignal  (Ptr<const SpectrumValue> spd);
   void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
+  /**
+   * subtract the sum of the signals ending now
+   *
+   * \param index the index of the sum in #m_endingSignals
+   */
+  void DoSubtractEndingSignals (uint32_t index);
+
+  /// The sum of the signals ending at the same time
+  struct EndingSignals
+  {
+    Time endTime;        ///< the end time of the signals
+    SpectrumValue psd;   ///< the sum of the PSDs of the signals
+    EventId event;       ///< the event subtracting the signals
+  };
 
 
 
@@ -135,12 +156,25 @@ private:
 
   Ptr<const SpectrumValue> m_noise;
 
+  SpectrumValue m_interf; /**< interference plus noise of the last chunk,
+                           * reused to avoid allocations
+                           */
+  SpectrumValue m_sinr;   ///< SINR of the last chunk, reused to avoid allocations
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
   uint32_t m_lastSignalId;
   uint32_t m_lastSignalIdBeforeReset;
 
+  /// whether the signals ending at the same time are subtracted at once
+  bool m_coalesceSignals;
+
+  /** the signals to be subtracted, by end time, when #m_coalesceSignals
+   * is true; the entries without a running event are free
+   */
+  std::vector<EndingSignals> m_endingSignals;
+
   /** all the processor instances that need to be notified whenever
   a new interference chunk is calculated */
   std::list<Ptr<LteChunkProcessor> > m_rsPowerChunkProcessorList;
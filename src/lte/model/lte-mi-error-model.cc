@@ -323,6 +323,119 @@ static const double cEcrTable [9][38] = {
 };
 
 
+/**
+ * A mutual information map of a modulation, whose SINR axis is uniformly
+ * spaced
+ */
+struct MiMap
+{
+  /**
+   * \param mi the MI values
+   * \param axis the SINR axis
+   * \param size the number of points
+   */
+  MiMap (const double *mi, const double *axis, uint16_t size)
+    : mi (mi),
+      axis (axis),
+      size (size),
+      // since the values in the axis are uniformly spaced, we have
+      // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+      // the scaling coefficient is always the same, so we compute it once
+      scalingCoeff ((size - 1) / (axis[size - 1] - axis[0]))
+  {
+  }
+
+  /**
+   * \param sinrLin a linear SINR
+   * \return the MI of the SINR
+   */
+  double GetMi (double sinrLin) const
+  {
+    if (sinrLin > axis[size - 1])
+      {
+        return 1;
+      }
+    double sinrIndexDouble = (sinrLin - axis[0]) * scalingCoeff + 1;
+    uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
+    NS_ASSERT_MSG (sinrIndex < size, "MI map out of data");
+    return mi[sinrIndex];
+  }
+
+  const double *mi;     //!< the MI values
+  const double *axis;   //!< the SINR axis
+  uint16_t size;        //!< the number of points
+  double scalingCoeff;  //!< the inverse of the axis step
+};
+
+static const MiMap g_miMapQpsk (MI_map_qpsk, MI_map_qpsk_axis, MI_MAP_QPSK_SIZE);
+static const MiMap g_miMap16qam (MI_map_16qam, MI_map_16qam_axis, MI_MAP_16QAM_SIZE);
+static const MiMap g_miMap64qam (MI_map_64qam, MI_map_64qam_axis, MI_MAP_64QAM_SIZE);
+
+/**
+ * \param mcs an MCS
+ * \return the index of the modulation of the MCS (0 QPSK, 1 16-QAM, 2 64-QAM)
+ */
+static uint8_t
+GetModulationIndex (uint8_t mcs)
+{
+  if (mcs <= MI_QPSK_MAX_ID)
+    {
+      return 0;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID)
+    {
+      return 1;
+    }
+  return 2;
+}
+
+/**
+ * \param modulation the index of a modulation
+ * \return the MI map of the modulation
+ */
+static const MiMap&
+GetMiMap (uint8_t modulation)
+{
+  static const MiMap* maps[3] = {&g_miMapQpsk, &g_miMap16qam, &g_miMap64qam};
+  return *maps[modulation];
+}
+
+/**
+ * The b and c parameters of the BLER curve of each CB size and ECR. The
+ * curves missing for a CB size are taken from the lowest larger CB size
+ * for removing CB size quantization errors, once for all.
+ */
+struct BlerCurveParams
+{
+  BlerCurveParams ()
+  {
+    for (int cbIndex = 0; cbIndex < 9; cbIndex++)
+      {
+        for (int ecrId = 0; ecrId <= MI_64QAM_BLER_MAX_ID; ecrId++)
+          {
+            int i = cbIndex;
+            b[cbIndex][ecrId] = bEcrTable[cbIndex][ecrId];
+            while ((i<9)&&(b[cbIndex][ecrId]<0))
+              {
+                b[cbIndex][ecrId] = bEcrTable[i++][ecrId];
+              }
+            i = cbIndex;
+            c[cbIndex][ecrId] = cEcrTable[cbIndex][ecrId];
+            while ((i<9)&&(c[cbIndex][ecrId]<0))
+              {
+                c[cbIndex][ecrId] = cEcrTable[i++][ecrId];
+              }
+          }
+      }
+  }
+
+  double b[9][38]; //!< the b parameters
+  double c[9][38]; //!< the c parameters
+};
+
+static const BlerCurveParams g_blerCurveParams;
+
+
 double 
 LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
 {
@@ -330,76 +443,13 @@ LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, ui
   
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
+  const MiMap& miMap = GetMiMap (GetModulationIndex (mcs));
   
   for (uint32_t i = 0; i < map.size (); i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
-        {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-            {
-              MI = 1;
-            }
-          else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
-        }
-      else
-        {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
-        }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
+      double sinrLin = sinr[map[i]];
+      MI = miMap.GetMi (sinrLin);
+      NS_LOG_LOGIC (" RB " << map[i] << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
       MIsum += MI;
     }
   MI = MIsum / map.size ();
@@ -424,28 +474,8 @@ LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
   cbIndex--;
   NS_LOG_LOGIC (" ECRid " << (uint16_t)ecrId << " ECR " << BlerCurvesEcrMap[ecrId] << " CB size " << cbSize << " CB size curve " << cbMiSizeTable[cbIndex]);
 
-  b = bEcrTable[cbIndex][ecrId];
-  if (b<0.0)
-    {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(b<0))
-        {
-          b = bEcrTable[i++][ecrId];
-        }
-    }
-  c = cEcrTable[cbIndex][ecrId];
-  if (c<0.0)
-    {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(c<0))
-        {
-          c = cEcrTable[i++][ecrId];
-        }
-    }
+  b = g_blerCurveParams.b[cbIndex][ecrId];
+  c = g_blerCurveParams.c[cbIndex][ecrId];
   // see IEEE802.16m EMD formula 55 of section 4.3.2.1
   double bler = 0.5*( 1 - erf((mib-b)/(sqrt(2)*c)) );
   NS_LOG_LOGIC ("MIB: " << mib << " BLER:" << bler << " b:" << b << " c:" << c);
@@ -460,30 +490,12 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
   NS_LOG_FUNCTION (sinr);
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  Values::iterator sinrIt = sinrCopy.ValuesBegin ();
+  Values::const_iterator sinrIt = sinr.ConstValuesBegin ();
   uint16_t rb = 0;
-  NS_ASSERT (sinrIt!=sinrCopy.ValuesEnd ());
-  while (sinrIt!=sinrCopy.ValuesEnd ())
+  NS_ASSERT (sinrIt!=sinr.ConstValuesEnd ());
+  while (sinrIt!=sinr.ConstValuesEnd ())
     {
-      double sinrLin = *sinrIt;
-      if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-        {
-          MI = 1;
-        }
-      else 
-        { 
-          // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-          // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-          static const double scalingCoeffQpsk = 
-            (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-          double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-          uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-          NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-          MI = MI_map_qpsk[sinrIndex];
-        }
+      MI = g_miMapQpsk.GetMi (*sinrIt);
       MIsum += MI;
       sinrIt++;
       rb++;
@@ -546,11 +558,55 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
 
 
 TbStats_t
-LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory)
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
 
-  double tbMi = Mib(sinr, map, mcs);
+  double tbMi = Mib (sinr, map, mcs);
+  return GetTbStatsFromMi (tbMi, size, mcs, miHistory);
+}
+
+
+void
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<TbDecodificationInfo_t>& tbs, std::vector<TbStats_t>& stats)
+{
+  NS_LOG_FUNCTION (sinr << tbs.size ());
+
+  // MI of every RB, evaluated the first time a TB uses the modulation
+  std::vector<double> rbMi[3];
+  stats.resize (tbs.size ());
+  for (uint32_t tb = 0; tb < tbs.size (); tb++)
+    {
+      const std::vector<int>& map = *tbs[tb].map;
+      uint8_t modulation = GetModulationIndex (tbs[tb].mcs);
+      std::vector<double>& mi = rbMi[modulation];
+      if (mi.empty ())
+        {
+          const MiMap& miMap = GetMiMap (modulation);
+          mi.reserve (sinr.GetSpectrumModel ()->GetNumBands ());
+          for (Values::const_iterator it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); ++it)
+            {
+              mi.push_back (miMap.GetMi (*it));
+            }
+        }
+      // sum in the order of Mib, for the same result
+      double miSum = 0.0;
+      for (uint32_t i = 0; i < map.size (); i++)
+        {
+          miSum += mi[map[i]];
+        }
+      double tbMi = miSum / map.size ();
+      NS_LOG_LOGIC (" TB " << tb << " MCS " << (uint16_t)tbs[tb].mcs << " MI " << tbMi);
+      stats[tb] = GetTbStatsFromMi (tbMi, tbs[tb].size, tbs[tb].mcs, *tbs[tb].miHistory);
+    }
+}
+
+
+TbStats_t
+LteMiErrorModel::GetTbStatsFromMi (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
+{
+  NS_LOG_FUNCTION (tbMi << (uint32_t) size << (uint32_t) mcs);
+
   double MI = 0.0;
   double Reff = 0.0;
   NS_ASSERT (mcs < 29);
@@ -61,6 +61,18 @@ struct TbStats_t
   double tbler;
   double mi;
 };
+
+/**
+ * The parameters of a TB to be evaluated by the batched
+ * LteMiErrorModel::GetTbDecodificationStats
+ */
+struct TbDecodificationInfo_t
+{
+  const std::vector<int>* map;             //!< the actives RBs for the TB
+  uint16_t size;                           //!< the size in bytes of the TB
+  uint8_t mcs;                             //!< the MCS of the TB
+  const HarqProcessInfoList_t* miHistory;  //!< MI of past transmissions (in case of retx)
+};
   
 
 
@@ -98,7 +110,21 @@ public:
    * \param miHistory  MI of past transmissions (in case of retx)
    * \return the TB error rate and MI
    */
-  static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory);
+  static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
+
+  /**
+   * \brief run the error-model algorithm for all the TBs received with
+   * the same SINR
+   *
+   * The MI of each RB is evaluated once per modulation and shared by
+   * all the TBs, which gives the same stats as evaluating every TB on
+   * its own.
+   *
+   * \param sinr the perceived sinrs in the whole bandwidth
+   * \param tbs the TBs
+   * \param stats the TB error rate and MI of each TB, in the order of tbs
+   */
+  static void GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<TbDecodificationInfo_t>& tbs, std::vector<TbStats_t>& stats);
   
   /** 
   * \brief run the error-model algorithm for the specified PCFICH+PDCCH channels
@@ -108,9 +134,17 @@ public:
   static double GetPcfichPdcchError (const SpectrumValue& sinr);
 
 
-//private:
-
+private:
 
+  /**
+   * \brief evaluate the error rate of a TB from its MI
+   * \param tbMi the mmib of the TB
+   * \param size the size in bytes of the TB
+   * \param mcs the MCS of the TB
+   * \param miHistory  MI of past transmissions (in case of retx)
+   * \return the TB error rate and MI
+   */
+  static TbStats_t GetTbStatsFromMi (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
 
 };
 
@@ -27,6 +27,7 @@
 #include "ns3/spectrum-error-model.h"
 #include "lte-phy.h"
 #include "lte-net-device.h"
+#include "lte-tti-driver.h"
 
 namespace ns3 {
 
@@ -77,6 +78,11 @@ LtePhy::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_packetBurstQueue.clear ();
   m_controlMessagesQueue.clear ();
+  if (m_ttiDriver != 0)
+    {
+      m_ttiDriver->RemovePhy (this);
+      m_ttiDriver = 0;
+    }
   m_downlinkSpectrumPhy->Dispose ();
   m_downlinkSpectrumPhy = 0;
   m_uplinkSpectrumPhy->Dispose ();
@@ -142,6 +148,19 @@ LtePhy::GetTti (void) const
   return m_tti;
 }
 
+void
+LtePhy::SetTtiDriver (Ptr<LteTtiDriver> driver)
+{
+  NS_LOG_FUNCTION (this << driver);
+  m_ttiDriver = driver;
+}
+
+Ptr<LteTtiDriver>
+LtePhy::GetTtiDriver (void) const
+{
+  return m_ttiDriver;
+}
+
 
 uint16_t
 LtePhy::GetSrsPeriodicity (uint16_t srcCi) const
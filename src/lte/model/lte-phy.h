@@ -40,6 +40,7 @@ namespace ns3 {
 class PacketBurst;
 class LteNetDevice;
 class LteControlMessage;
+class LteTtiDriver;
 
 
 
@@ -129,6 +130,21 @@ public:
    */
   double GetTti (void) const;
 
+  /**
+   * \brief Let a LteTtiDriver start the subframes of this PHY
+   *
+   * To be called before the PHY is initialized. By default, the PHY
+   * schedules its own subframes.
+   *
+   * \param driver the driver
+   */
+  void SetTtiDriver (Ptr<LteTtiDriver> driver);
+
+  /**
+   * \return the driver starting the subframes of this PHY, if any
+   */
+  Ptr<LteTtiDriver> GetTtiDriver (void) const;
+
   /** 
    * 
    * \param cellId the Cell Identifier
@@ -291,6 +307,12 @@ protected:
    */
   uint16_t m_cellId;
 
+  /**
+   * The driver starting the subframes of this PHY, or null if the PHY
+   * schedules its own subframes.
+   */
+  Ptr<LteTtiDriver> m_ttiDriver;
+
 }; // end of `class LtePhy`
 
 
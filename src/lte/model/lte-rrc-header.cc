@@ -3923,7 +3923,7 @@ RrcConnectionRequestHeader::Print (std::ostream &os) const
 void
 RrcConnectionRequestHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   SerializeUlCcchMessage (1);
 
@@ -4052,7 +4052,7 @@ RrcConnectionSetupHeader::Print (std::ostream &os) const
 void
 RrcConnectionSetupHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   SerializeDlCcchMessage (3);
 
@@ -4223,7 +4223,7 @@ RrcConnectionSetupCompleteHeader::~RrcConnectionSetupCompleteHeader ()
 void
 RrcConnectionSetupCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (4);
@@ -4329,7 +4329,7 @@ RrcConnectionReconfigurationCompleteHeader::~RrcConnectionReconfigurationComplet
 void
 RrcConnectionReconfigurationCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (2);
@@ -4420,7 +4420,7 @@ RrcConnectionReconfigurationHeader::~RrcConnectionReconfigurationHeader ()
 void
 RrcConnectionReconfigurationHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   SerializeDlDcchMessage (4);
 
@@ -5101,7 +5101,7 @@ HandoverPreparationInfoHeader::HandoverPreparationInfoHeader ()
 void
 HandoverPreparationInfoHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   // Serialize HandoverPreparationInformation sequence:
   // no default or optional fields. Extension marker not present.
@@ -5337,7 +5337,7 @@ RrcConnectionReestablishmentRequestHeader::~RrcConnectionReestablishmentRequestH
 void
 RrcConnectionReestablishmentRequestHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   SerializeUlCcchMessage (0);
 
@@ -5503,7 +5503,7 @@ RrcConnectionReestablishmentHeader::~RrcConnectionReestablishmentHeader ()
 void
 RrcConnectionReestablishmentHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   SerializeDlCcchMessage (0);
 
@@ -5631,7 +5631,7 @@ RrcConnectionReestablishmentCompleteHeader::RrcConnectionReestablishmentComplete
 void
 RrcConnectionReestablishmentCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (3);
@@ -5733,7 +5733,7 @@ RrcConnectionReestablishmentRejectHeader::~RrcConnectionReestablishmentRejectHea
 void
 RrcConnectionReestablishmentRejectHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   // Serialize CCCH message
   SerializeDlCcchMessage (1);
@@ -5818,7 +5818,7 @@ RrcConnectionReleaseHeader::~RrcConnectionReleaseHeader ()
 void
 RrcConnectionReleaseHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   // Serialize DCCH message
   SerializeDlDcchMessage (5);
@@ -5943,7 +5943,7 @@ RrcConnectionRejectHeader::~RrcConnectionRejectHeader ()
 void
 RrcConnectionRejectHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   // Serialize CCCH message
   SerializeDlCcchMessage (2);
@@ -6051,7 +6051,7 @@ MeasurementReportHeader::~MeasurementReportHeader ()
 void
 MeasurementReportHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  ClearSerialization ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (1);
@@ -6214,7 +6214,9 @@ RrcUlDcchMessage::Print (std::ostream &os) const
 void
 RrcUlDcchMessage::PreSerialize () const
 {
+  ClearSerialization ();
   SerializeUlDcchMessage (m_messageType);
+  FinalizeSerialization ();
 }
 
 Buffer::Iterator
@@ -6275,7 +6277,9 @@ RrcDlDcchMessage::Print (std::ostream &os) const
 void
 RrcDlDcchMessage::PreSerialize () const
 {
+  ClearSerialization ();
   SerializeDlDcchMessage (m_messageType);
+  FinalizeSerialization ();
 }
 
 Buffer::Iterator
@@ -6336,7 +6340,9 @@ RrcUlCcchMessage::Print (std::ostream &os) const
 void
 RrcUlCcchMessage::PreSerialize () const
 {
+  ClearSerialization ();
   SerializeUlCcchMessage (m_messageType);
+  FinalizeSerialization ();
 }
 
 Buffer::Iterator
@@ -6397,7 +6403,9 @@ RrcDlCcchMessage::Print (std::ostream &os) const
 void
 RrcDlCcchMessage::PreSerialize () const
 {
+  ClearSerialization ();
   SerializeDlCcchMessage (m_messageType);
+  FinalizeSerialization ();
 }
 
 Buffer::Iterator
@@ -948,26 +948,43 @@ LteSpectrumPhy::EndRxData ()
   NS_ASSERT (m_transmissionMode < m_txModeGain.size ());
   m_sinrPerceived *= m_txModeGain.at (m_transmissionMode);
   
-  while (itTb!=m_expectedTbs.end ())
+  if ((m_dataErrorModelEnabled)&&(m_rxPacketBurstList.size ()>0)) // avoid to check for errors when there is no actual data transmitted
     {
-      if ((m_dataErrorModelEnabled)&&(m_rxPacketBurstList.size ()>0)) // avoid to check for errors when there is no actual data transmitted
+      // evaluate all the TBs at once, since they share the same SINR
+      std::vector<HarqProcessInfoList_t> harqInfoLists (m_expectedTbs.size ());
+      std::vector<TbDecodificationInfo_t> tbs;
+      tbs.reserve (m_expectedTbs.size ());
+      for (uint32_t i = 0; itTb!=m_expectedTbs.end (); itTb++, i++)
         {
           // retrieve HARQ info
-          HarqProcessInfoList_t harqInfoList;
           if ((*itTb).second.ndi == 0)
             {
               // TB retxed: retrieve HARQ history
               uint16_t ulHarqId = 0;
               if ((*itTb).second.downlink)
                 {
-                  harqInfoList = m_harqPhyModule->GetHarqProcessInfoDl ((*itTb).second.harqProcessId, (*itTb).first.m_layer);
+                  harqInfoLists[i] = m_harqPhyModule->GetHarqProcessInfoDl ((*itTb).second.harqProcessId, (*itTb).first.m_layer);
                 }
               else
                 {
-                  harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl ((*itTb).first.m_rnti, ulHarqId);
+                  harqInfoLists[i] = m_harqPhyModule->GetHarqProcessInfoUl ((*itTb).first.m_rnti, ulHarqId);
                 }
             }
-          TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (m_sinrPerceived, (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
+          TbDecodificationInfo_t tb;
+          tb.map = &(*itTb).second.rbBitmap;
+          tb.size = (*itTb).second.size;
+          tb.mcs = (*itTb).second.mcs;
+          tb.miHistory = &harqInfoLists[i];
+          tbs.push_back (tb);
+        }
+      std::vector<TbStats_t> tbStatsList;
+      LteMiErrorModel::GetTbDecodificationStats (m_sinrPerceived, tbs, tbStatsList);
+
+      itTb = m_expectedTbs.begin ();
+      for (uint32_t i = 0; itTb!=m_expectedTbs.end (); itTb++, i++)
+        {
+          const HarqProcessInfoList_t& harqInfoList = harqInfoLists[i];
+          const TbStats_t& tbStats = tbStatsList[i];
           (*itTb).second.mi = tbStats.mi;
           (*itTb).second.corrupt = m_random->GetValue () > tbStats.tbler ? false : true;
           NS_LOG_DEBUG (this << "RNTI " << (*itTb).first.m_rnti << " size " << (*itTb).second.size << " mcs " << (uint32_t)(*itTb).second.mcs << " bitmap " << (*itTb).second.rbBitmap.size () << " layer " << (uint16_t)(*itTb).first.m_layer << " TBLER " << tbStats.tbler << " corrupted " << (*itTb).second.corrupt);
@@ -995,9 +1012,7 @@ LteSpectrumPhy::EndRxData ()
               params.m_rv = harqInfoList.size ();
               m_ulPhyReception (params);
             }
-       }
-      
-      itTb++;
+        }
     }
     std::map <uint16_t, DlInfoListElement_s> harqDlInfoMap;
     for (std::list<Ptr<PacketBurst> >::const_iterator i = m_rxPacketBurstList.begin (); 
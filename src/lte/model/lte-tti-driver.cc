@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-tti-driver.h"
+#include "lte-enb-phy.h"
+#include "lte-ue-phy.h"
+#include "lte-net-device.h"
+#include <ns3/node.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteTtiDriver");
+
+NS_OBJECT_ENSURE_REGISTERED (LteTtiDriver);
+
+LteTtiDriver::LteTtiDriver ()
+  : m_tti (0),
+    m_running (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteTtiDriver::~LteTtiDriver ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+LteTtiDriver::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteTtiDriver")
+    .SetParent<Object> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteTtiDriver> ()
+  ;
+  return tid;
+}
+
+void
+LteTtiDriver::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nextSubFrameEvent.Cancel ();
+  m_enbPhys.clear ();
+  m_uePhys.clear ();
+  m_ueFrameNo.clear ();
+  m_ueSubframeNo.clear ();
+  Object::DoDispose ();
+}
+
+void
+LteTtiDriver::AddEnbPhy (Ptr<LteEnbPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  Start (phy->GetTti ());
+  m_enbPhys.push_back (phy);
+}
+
+void
+LteTtiDriver::AddUePhy (Ptr<LteUePhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  Start (phy->GetTti ());
+  m_uePhys.push_back (phy);
+  m_ueFrameNo.push_back (1);
+  m_ueSubframeNo.push_back (1);
+}
+
+void
+LteTtiDriver::RemovePhy (Ptr<LtePhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  for (uint32_t i = 0; i < m_enbPhys.size (); i++)
+    {
+      if (m_enbPhys[i] == phy)
+        {
+          m_enbPhys.erase (m_enbPhys.begin () + i);
+          return;
+        }
+    }
+  for (uint32_t i = 0; i < m_uePhys.size (); i++)
+    {
+      if (m_uePhys[i] == phy)
+        {
+          m_uePhys.erase (m_uePhys.begin () + i);
+          m_ueFrameNo.erase (m_ueFrameNo.begin () + i);
+          m_ueSubframeNo.erase (m_ueSubframeNo.begin () + i);
+          return;
+        }
+    }
+}
+
+uint32_t
+LteTtiDriver::GetNPhys (void) const
+{
+  return m_enbPhys.size () + m_uePhys.size ();
+}
+
+void
+LteTtiDriver::Start (double tti)
+{
+  NS_LOG_FUNCTION (this << tti);
+  if (m_running)
+    {
+      NS_ASSERT_MSG (tti == m_tti, "PHYs with different TTIs can't share a LteTtiDriver");
+      return;
+    }
+  m_tti = tti;
+  m_running = true;
+  // the driver holds a reference to itself until the first subframe
+  Simulator::ScheduleWithContext (0xffffffff, Seconds (0), &LteTtiDriver::StartSubFrames, Ptr<LteTtiDriver> (this));
+}
+
+uint32_t
+LteTtiDriver::GetContext (Ptr<LtePhy> phy)
+{
+  Ptr<LteNetDevice> device = phy->GetDevice ();
+  if (device == 0 || device->GetNode () == 0)
+    {
+      return Simulator::GetContext ();
+    }
+  return device->GetNode ()->GetId ();
+}
+
+void
+LteTtiDriver::StartSubFrames (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_enbPhys.empty () && m_uePhys.empty ())
+    {
+      NS_LOG_LOGIC ("no PHY left, stopping");
+      m_running = false;
+      return;
+    }
+
+  for (uint32_t i = 0; i < m_enbPhys.size (); i++)
+    {
+      ScopedContext context (GetContext (m_enbPhys[i]));
+      m_enbPhys[i]->StartNextSubFrame ();
+    }
+
+  for (uint32_t i = 0; i < m_uePhys.size (); i++)
+    {
+      ScopedContext context (GetContext (m_uePhys[i]));
+      m_uePhys[i]->SubframeIndication (m_ueFrameNo[i], m_ueSubframeNo[i]);
+      if (++m_ueSubframeNo[i] > 10)
+        {
+          ++m_ueFrameNo[i];
+          m_ueSubframeNo[i] = 1;
+        }
+    }
+
+  m_nextSubFrameEvent = Simulator::Schedule (Seconds (m_tti), &LteTtiDriver::StartSubFrames, this);
+}
+
+} // namespace ns3
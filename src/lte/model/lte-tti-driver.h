@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_TTI_DRIVER_H
+#define LTE_TTI_DRIVER_H
+
+#include <ns3/object.h>
+#include <ns3/event-id.h>
+#include <vector>
+
+namespace ns3 {
+
+class LtePhy;
+class LteEnbPhy;
+class LteUePhy;
+
+/**
+ * \ingroup lte
+ * \brief Start the subframes of a set of eNB and UE PHYs with a single event
+ *
+ * By default each LteEnbPhy and LteUePhy schedules its own events to
+ * start its subframes, that is a few events per PHY and per TTI. The PHYs
+ * registered to a LteTtiDriver instead don't schedule these events: the
+ * driver schedules a single event per TTI, which starts the subframe of
+ * all the eNB PHYs and then of all the UE PHYs, each group in the order
+ * of registration. Each subframe is started within a ScopedContext of the
+ * node of its PHY, so that the logs and the events scheduled by the PHY
+ * and the upper layers are in the context of the node, as without a
+ * driver.
+ *
+ * The PHYs register themselves when they are initialized, if they have
+ * been given a driver with LtePhy::SetTtiDriver. The first subframe of a
+ * PHY starts at the time of its initialization if the driver is not
+ * running yet, or else at the next subframe of the driver; the frame and
+ * subframe numbers of each PHY still start from 1 as without a driver.
+ */
+class LteTtiDriver : public Object
+{
+public:
+  LteTtiDriver ();
+  virtual ~LteTtiDriver ();
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+  virtual void DoDispose (void);
+
+  /**
+   * \brief start the subframes of an eNB PHY
+   * \param phy the eNB PHY
+   */
+  void AddEnbPhy (Ptr<LteEnbPhy> phy);
+
+  /**
+   * \brief start the subframes of a UE PHY
+   * \param phy the UE PHY
+   */
+  void AddUePhy (Ptr<LteUePhy> phy);
+
+  /**
+   * \brief stop the subframes of a PHY
+   * \param phy the PHY, previously added with AddEnbPhy or AddUePhy
+   */
+  void RemovePhy (Ptr<LtePhy> phy);
+
+  /**
+   * \return the number of eNB and UE PHYs driven
+   */
+  uint32_t GetNPhys (void) const;
+
+private:
+  /**
+   * \brief schedule the first subframe, if not yet scheduled
+   * \param tti the TTI of the PHY being added
+   */
+  void Start (double tti);
+
+  /**
+   * \param phy a PHY
+   * \return the id of the node of the PHY, the context of its subframes
+   */
+  static uint32_t GetContext (Ptr<LtePhy> phy);
+
+  /**
+   * \brief start a subframe of all the PHYs, and schedule the next one
+   */
+  void StartSubFrames (void);
+
+  /// The eNB PHYs, in order of registration
+  std::vector<Ptr<LteEnbPhy> > m_enbPhys;
+  /// The UE PHYs, in order of registration
+  std::vector<Ptr<LteUePhy> > m_uePhys;
+  /// The number of the next frame of each UE PHY
+  std::vector<uint32_t> m_ueFrameNo;
+  /// The number of the next subframe of each UE PHY
+  std::vector<uint32_t> m_ueSubframeNo;
+  /// The TTI, the same for all the PHYs
+  double m_tti;
+  /// Whether the first subframe has been scheduled
+  bool m_running;
+  /// The event of the next subframe
+  EventId m_nextSubFrameEvent;
+
+}; // end of `class LteTtiDriver`
+
+} // namespace ns3
+
+#endif /* LTE_TTI_DRIVER_H */
@@ -28,6 +28,7 @@
 #include <ns3/simulator.h>
 #include <ns3/double.h>
 #include "lte-ue-phy.h"
+#include "lte-tti-driver.h"
 #include "lte-enb-phy.h"
 #include "lte-net-device.h"
 #include "lte-ue-net-device.h"
@@ -313,7 +314,11 @@ LteUePhy::DoInitialize ()
           haveNodeId = true;
         }
     }
-  if (haveNodeId)
+  if (m_ttiDriver != 0)
+    {
+      m_ttiDriver->AddUePhy (this);
+    }
+  else if (haveNodeId)
     {
       Simulator::ScheduleWithContext (nodeId, Seconds (0), &LteUePhy::SubframeIndication, this, 1, 1);
     }
@@ -1150,6 +1155,11 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   m_uePhySapUser->SubframeIndication (frameNo, subframeNo);
 
   m_subframeNo = subframeNo;
+  if (m_ttiDriver != 0)
+    {
+      // the driver starts the next subframe
+      return;
+    }
   ++subframeNo;
   if (subframeNo > 10)
     {
@@ -514,29 +514,6 @@ PfFfMacScheduler::GetRbgSize (int dlbandwidth)
 }
 
 
-int
-PfFfMacScheduler::LcActivePerFlow (uint16_t rnti)
-{
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
-}
-
-
 uint8_t
 PfFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
@@ -1076,116 +1053,152 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
 
 
-  for (int i = 0; i < rbgNum; i++)
+  // collect the state of the UEs once per TTI in dense arrays, so that
+  // the evaluation of the RBGs doesn't look it up per RBG
+  m_ueStore.Clear (rbgNum);
+  std::map <uint16_t, pfsFlowPerf_t>::iterator itFlow;
+  for (itFlow = m_flowStatsDl.begin (); itFlow != m_flowStatsDl.end (); itFlow++)
     {
-      NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
-      if (rbgMap.at (i) == false)
+      uint32_t ue = m_ueStore.AddUe ((*itFlow).first);
+      m_ueStore.SetAveragedThroughput (ue, (*itFlow).second.lastAveragedThroughput);
+    }
+  m_ueStore.ResetMetrics ();
+  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itLc;
+  for (itLc = m_rlcBufferReq.begin (); itLc != m_rlcBufferReq.end (); itLc++)
+    {
+      if (((*itLc).second.m_rlcTransmissionQueueSize > 0)
+          || ((*itLc).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*itLc).second.m_rlcStatusPduSize > 0))
         {
-          std::map <uint16_t, pfsFlowPerf_t>::iterator it;
-          std::map <uint16_t, pfsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
-          double rcqiMax = 0.0;
-          for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+          int32_t ue = m_ueStore.GetIndex ((*itLc).first.m_rnti);
+          if (ue >= 0)
             {
-              if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
-                continue;
+              m_ueStore.SetLcActive (ue, m_ueStore.GetLcActive (ue) + 1);
+            }
+        }
+    }
+  for (uint32_t ue = 0; ue < m_ueStore.GetNUes (); ue++)
+    {
+      uint16_t rnti = m_ueStore.GetRnti (ue);
+      if (rntiAllocated.find (rnti) != rntiAllocated.end ())
+        {
+          // UE already allocated for HARQ -> drop it
+          NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)rnti);
+          continue;
+        }
+      if (!HarqProcessAvailability (rnti))
+        {
+          // UE without HARQ process available -> drop it
+          NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)rnti);
+          continue;
+        }
+      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      itTxMode = m_uesTxMode.find (rnti);
+      if (itTxMode == m_uesTxMode.end ())
+        {
+          NS_FATAL_ERROR ("No Transmission Mode info on user " << rnti);
+        }
+      m_ueStore.SetLayers (ue, TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second));
+      // only the UEs with data to transmit are allocated
+      m_ueStore.SetEligible (ue, m_ueStore.GetLcActive (ue) > 0);
+    }
 
-              std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-              if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
-                {
-                  // UE already allocated for HARQ or without HARQ process available -> drop it
-                  if (itRnti != rntiAllocated.end ())
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
-                    }
-                  if (!HarqProcessAvailability ((*it).first))
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-                    }
-                  continue;
-                }
-              std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-              itCqi = m_a30CqiRxed.find ((*it).first);
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
-              itTxMode = m_uesTxMode.find ((*it).first);
-              if (itTxMode == m_uesTxMode.end ())
-                {
-                  NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                }
-              int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  for (uint8_t k = 0; k < nLayer; k++)
-                    {
-                      sbCqi.push_back (1);  // start with lowest value
-                    }
-                }
-              else
+  // achievable rate of a layer on a RBG, for each CQI and with no CQI
+  double cqiRate[16];
+  for (uint8_t cqi = 0; cqi < 16; cqi++)
+    {
+      cqiRate[cqi] = ((m_amc->GetTbSizeFromMcs (m_amc->GetMcsFromCqi (cqi), rbgSize) / 8) / 0.001);   // = TB size / TTI
+    }
+  double noCqiRate = ((m_amc->GetTbSizeFromMcs (0, rbgSize) / 8) / 0.001);
+
+  // evaluate the relative CQI of the eligible UEs on the free RBGs
+  for (uint32_t ue = 0; ue < m_ueStore.GetNUes (); ue++)
+    {
+      if (!m_ueStore.IsEligible (ue))
+        {
+          continue;
+        }
+      uint16_t rnti = m_ueStore.GetRnti (ue);
+      uint8_t nLayer = m_ueStore.GetLayers (ue);
+      double avgThr = m_ueStore.GetAveragedThroughput (ue);
+      std::map <uint16_t,SbMeasResult_s>::iterator itCqi = m_a30CqiRxed.find (rnti);
+      for (int i = 0; i < rbgNum; i++)
+        {
+          if ((rbgMap.at (i) == true) || ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, rnti)) == false))
+            {
+              continue;
+            }
+          double achievableRate = 0.0;
+          if (itCqi == m_a30CqiRxed.end ())
+            {
+              // no CQI -> start with lowest value
+              for (uint8_t k = 0; k < nLayer; k++)
                 {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
+                  achievableRate += cqiRate[1];
                 }
+            }
+          else
+            {
+              const std::vector <uint8_t>& sbCqi = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
               uint8_t cqi1 = sbCqi.at (0);
               uint8_t cqi2 = 1;
               if (sbCqi.size () > 1)
                 {
                   cqi2 = sbCqi.at (1);
                 }
-
-              if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+              if ((cqi1 == 0)&&(cqi2 == 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+                {
+                  continue;
+                }
+              for (uint8_t k = 0; k < nLayer; k++)
                 {
-                  if (LcActivePerFlow ((*it).first) > 0)
+                  if (sbCqi.size () > k)
                     {
-                      // this UE has data to transmit
-                      double achievableRate = 0.0;
-                      uint8_t mcs = 0;
-                      for (uint8_t k = 0; k < nLayer; k++)
-                        {
-                          if (sbCqi.size () > k)
-                            {
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (k));
-                            }
-                          else
-                            {
-                              // no info on this subband -> worst MCS
-                              mcs = 0;
-                            }
-                          achievableRate += ((m_amc->GetTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
-                        }
-
-                      double rcqi = achievableRate / (*it).second.lastAveragedThroughput;
-                      NS_LOG_INFO (this << " RNTI " << (*it).first << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*it).second.lastAveragedThroughput << " RCQI " << rcqi);
-
-                      if (rcqi > rcqiMax)
-                        {
-                          rcqiMax = rcqi;
-                          itMax = it;
-                        }
+                      NS_ASSERT_MSG (sbCqi.at (k) < 16, "CQI must be in [0..15] = " << (uint16_t)sbCqi.at (k));
+                      achievableRate += cqiRate[sbCqi.at (k)];
+                    }
+                  else
+                    {
+                      // no info on this subband -> worst MCS
+                      achievableRate += noCqiRate;
                     }
-                }   // end if cqi
-            } // end for m_rlcBufferReq
+                }
+            }
+          double rcqi = achievableRate / avgThr;
+          NS_LOG_INFO (this << " RNTI " << rnti << " RBG " << i << " achievableRate " << achievableRate << " avgThr " << avgThr << " RCQI " << rcqi);
+          m_ueStore.SetMetric (i, ue, rcqi);
+        }
+    }
 
-          if (itMax == m_flowStatsDl.end ())
+  for (int i = 0; i < rbgNum; i++)
+    {
+      NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
+      if (rbgMap.at (i) == false)
+        {
+          int32_t ueMax = m_ueStore.GetBestUe (i);
+          if (ueMax < 0)
             {
               // no UE available for this RB
               NS_LOG_INFO (this << " any UE found");
             }
           else
             {
+              uint16_t rntiMax = m_ueStore.GetRnti (ueMax);
               rbgMap.at (i) = true;
               std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-              itMap = allocationMap.find ((*itMax).first);
+              itMap = allocationMap.find (rntiMax);
               if (itMap == allocationMap.end ())
                 {
                   // insert new element
                   std::vector <uint16_t> tempMap;
                   tempMap.push_back (i);
-                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > ((*itMax).first, tempMap));
+                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > (rntiMax, tempMap));
                 }
               else
                 {
                   (*itMap).second.push_back (i);
                 }
-              NS_LOG_INFO (this << " UE assigned " << (*itMax).first);
+              NS_LOG_INFO (this << " UE assigned " << rntiMax);
             }
         } // end for RBG free
     } // end for RBGs
@@ -1210,7 +1223,7 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
       newDci.m_rnti = (*itMap).first;
       newDci.m_harqProcess = UpdateHarqProcessId ((*itMap).first);
 
-      uint16_t lcActives = LcActivePerFlow ((*itMap).first);
+      uint16_t lcActives = m_ueStore.GetLcActive (m_ueStore.GetIndex ((*itMap).first));
       NS_LOG_INFO (this << "Allocate user " << newEl.m_rnti << " rbg " << lcActives);
       if (lcActives == 0)
         {
@@ -30,6 +30,7 @@
 #include <ns3/nstime.h>
 #include <ns3/lte-amc.h>
 #include <ns3/lte-ffr-sap.h>
+#include <ns3/ff-mac-scheduler-ue-store.h>
 
 // value for SINR outside the range defined by FF-API, used to indicate that there
 // is no CQI for this element
@@ -148,8 +149,6 @@ private:
 
   int GetRbgSize (int dlbandwidth);
 
-  int LcActivePerFlow (uint16_t rnti);
-
   double EstimateUlSinr (uint16_t rnti, uint16_t rb);
 
   void RefreshDlCqiMaps (void);
@@ -198,6 +197,11 @@ private:
   */
   std::map <uint16_t, pfsFlowPerf_t> m_flowStatsUl;
 
+  /*
+  * Dense state of the UEs in the DL scheduling of a TTI
+  */
+  FfMacSchedulerUeStore m_ueStore;
+
 
   /*
   * Map of UE's DL CQI P01 received
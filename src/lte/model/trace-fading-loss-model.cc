@@ -29,13 +29,193 @@
 #include "ns3/uinteger.h"
 #include <fstream>
 #include <ns3/simulator.h>
+#include <ns3/simple-ref-count.h>
+#include <ns3/abort.h>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceFadingLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel);
-  
+
+const char TraceFadingLossModel::BINARY_MAGIC[8] = { 'N', 'S', '3', 'F', 'A', 'D', 'N', 'G' };
+const uint32_t TraceFadingLossModel::BINARY_VERSION;
+
+/**
+ * Read the samples of a text trace, converted to linear scale.
+ *
+ * \param is the text trace
+ * \param rbNum the number of RB
+ * \param samplesNum the number of samples per RB
+ * \param samples the samples, RB after RB
+ * \returns true if all the samples were read
+ */
+static bool
+ReadTextTrace (std::istream &is, uint32_t rbNum, uint32_t samplesNum,
+               std::vector<double> &samples)
+{
+  samples.resize (rbNum * samplesNum);
+  for (uint32_t i = 0; i < rbNum * samplesNum; i++)
+    {
+      double sample;
+      if (!(is >> sample))
+        {
+          return false;
+        }
+      samples[i] = std::pow (10., sample / 10);
+    }
+  return true;
+}
+
+/**
+ * \ingroup lte
+ *
+ * The samples of a fading trace, shared by all the TraceFadingLossModel
+ * instances using the same trace.
+ */
+class TraceFadingData : public SimpleRefCount<TraceFadingData>
+{
+public:
+  /**
+   * \param fileName the name of the trace
+   * \param rbNum the number of RB the trace is made of
+   * \param samplesNum the number of samples per RB
+   * \returns the samples of the trace, loaded by the first caller
+   */
+  static Ptr<TraceFadingData> Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+
+  ~TraceFadingData ();
+
+  /**
+   * \param rb an RB
+   * \returns the samples of the RB, in linear scale
+   */
+  const double * GetSamples (uint32_t rb) const
+  {
+    return m_samples + rb * m_samplesNum;
+  }
+
+private:
+  /// the trace file name and dimensions
+  typedef std::pair<std::string, std::pair<uint32_t, uint32_t> > Key;
+  /// the traces in use
+  typedef std::map<Key, TraceFadingData *> Registry;
+
+  /// \param key the trace file name and dimensions
+  TraceFadingData (Key key);
+  /// \returns the traces in use
+  static Registry & GetRegistry (void);
+  /// \returns true if the file is a binary trace, now mapped
+  bool Map (void);
+  /// Parse the file as a text trace
+  void Parse (void);
+
+  Key m_key;                    //!< the trace file name and dimensions
+  uint32_t m_samplesNum;        //!< number of samples per RB
+  const double *m_samples;      //!< the samples
+  uint8_t *m_data;              //!< the mapped binary trace, or 0
+  size_t m_size;                //!< the size of the mapped binary trace
+  std::vector<double> m_parsed; //!< the samples of a text trace
+};
+
+TraceFadingData::Registry &
+TraceFadingData::GetRegistry (void)
+{
+  static Registry registry;
+  return registry;
+}
+
+Ptr<TraceFadingData>
+TraceFadingData::Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  Key key = std::make_pair (fileName, std::make_pair (rbNum, samplesNum));
+  Registry::iterator it = GetRegistry ().find (key);
+  if (it != GetRegistry ().end ())
+    {
+      NS_LOG_LOGIC ("reuse fading trace " << fileName);
+      return it->second;
+    }
+  Ptr<TraceFadingData> trace = Ptr<TraceFadingData> (new TraceFadingData (key), false);
+  GetRegistry ()[key] = PeekPointer (trace);
+  return trace;
+}
+
+TraceFadingData::TraceFadingData (Key key)
+  : m_key (key),
+    m_samplesNum (key.second.second),
+    m_samples (0),
+    m_data (0),
+    m_size (0)
+{
+  if (!Map ())
+    {
+      Parse ();
+    }
+}
+
+TraceFadingData::~TraceFadingData ()
+{
+  GetRegistry ().erase (m_key);
+  if (m_data != 0)
+    {
+      munmap (m_data, m_size);
+    }
+}
+
+bool
+TraceFadingData::Map (void)
+{
+  const std::string &fileName = m_key.first;
+  int fd = open (fileName.c_str (), O_RDONLY);
+  NS_ASSERT_MSG (fd >= 0, " Fading trace file not found");
+  struct stat st;
+  TraceFadingLossModel::BinaryHeader header;
+  if (fstat (fd, &st) < 0
+      || st.st_size < static_cast<off_t> (sizeof (header))
+      || read (fd, &header, sizeof (header)) != sizeof (header)
+      || std::memcmp (header.magic, TraceFadingLossModel::BINARY_MAGIC, sizeof (header.magic)) != 0)
+    {
+      close (fd);
+      return false;
+    }
+  uint32_t rbNum = m_key.second.first;
+  if (header.version != TraceFadingLossModel::BINARY_VERSION
+      || header.samplesNum != m_samplesNum || header.rbNum < rbNum
+      || st.st_size < static_cast<off_t> (header.headerSize + sizeof (double) * header.rbNum * header.samplesNum))
+    {
+      NS_FATAL_ERROR ("Fading trace " << fileName << " does not match "
+                      << rbNum << " RB and " << m_samplesNum << " samples");
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  NS_ABORT_MSG_IF (data == MAP_FAILED, "Can't map fading trace " << fileName);
+  NS_LOG_INFO ("mapped binary fading trace " << fileName);
+  m_data = static_cast<uint8_t *> (data);
+  m_size = st.st_size;
+  m_samples = reinterpret_cast<const double *> (m_data + header.headerSize);
+  return true;
+}
+
+void
+TraceFadingData::Parse (void)
+{
+  const std::string &fileName = m_key.first;
+  NS_LOG_INFO ("parsing text fading trace " << fileName);
+  std::ifstream ifTraceFile (fileName.c_str (), std::ifstream::in);
+  if (!ReadTextTrace (ifTraceFile, m_key.second.first, m_samplesNum, m_parsed))
+    {
+      NS_FATAL_ERROR ("Fading trace " << fileName << " has less than "
+                      << m_key.second.first << " rows of " << m_samplesNum << " samples");
+    }
+  m_samples = &m_parsed[0];
+}
+
 
 
 TraceFadingLossModel::TraceFadingLossModel ()
@@ -48,7 +228,7 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
+  m_fadingTrace = 0;
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -120,30 +300,40 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
+  m_fadingTrace = TraceFadingData::Get (m_traceFile, m_rbNum, m_samplesNum);
+  m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
+  m_lastWindowUpdate = Simulator::Now ();
+}
+
+bool
+TraceFadingLossModel::ConvertTextTrace (std::string textFile, std::string binaryFile,
+                                        uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (textFile << binaryFile << rbNum << samplesNum);
+  std::ifstream is (textFile.c_str (), std::ifstream::in);
+  std::vector<double> samples;
+  if (!ReadTextTrace (is, rbNum, samplesNum, samples))
     {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
+      NS_LOG_WARN ("Can't read " << rbNum << " rows of " << samplesNum << " samples from " << textFile);
+      return false;
     }
-
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
+  BinaryHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.magic, BINARY_MAGIC, sizeof (header.magic));
+  header.version = BINARY_VERSION;
+  header.headerSize = sizeof (header);
+  header.rbNum = rbNum;
+  header.samplesNum = samplesNum;
+  std::ofstream os (binaryFile.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  os.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  os.write (reinterpret_cast<const char *> (&samples[0]), sizeof (double) * samples.size ());
+  os.close ();
+  if (!os)
     {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
-        {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
-        }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
+      NS_LOG_WARN ("Can't write " << binaryFile);
+      return false;
     }
-  m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
-  m_lastWindowUpdate = Simulator::Now ();
+  return true;
 }
 
 
@@ -188,7 +378,7 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
         }
       ChannelRealizationId_t mobilityPair = std::make_pair (a,b);
       m_startVariableMap.insert (std::pair<ChannelRealizationId_t,Ptr<UniformRandomVariable> > (mobilityPair, startV));
-      m_windowOffsetsMap.insert (std::pair<ChannelRealizationId_t,int> (mobilityPair, startV->GetValue ()));
+      itOff = m_windowOffsetsMap.insert (std::pair<ChannelRealizationId_t,int> (mobilityPair, startV->GetValue ())).first;
     }
 
   
@@ -201,27 +391,21 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
   int subChannel = 0;
   while (vit != rxPsd->ValuesEnd ())
     {
-      NS_ASSERT (subChannel < 100);
+      NS_ASSERT (subChannel < m_rbNum);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
+          // the samples are in linear scale
+          double fading = m_fadingTrace->GetSamples (subChannel)[index];
           NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
-          double power = *vit; // in Watt/Hz
-          power = 10 * std::log10 (180000 * power); // in dB
-
-          NS_LOG_LOGIC (this << subChannel << *vit  << power << fading);
-
-          *vit = std::pow (10., ((power + fading) / 10)) / 180000; // in Watt
-
+          *vit *= fading;
           NS_LOG_LOGIC (this << subChannel << *vit);
-
         }
 
       ++vit;
@@ -34,12 +34,19 @@ namespace ns3 {
 
 
 class MobilityModel;
+class TraceFadingData;
 
 
 /**
  * \ingroup lte
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace is either a text file with one row of samples in dB per
+ * RB, or a binary file made by ConvertTextTrace (see the
+ * fading-trace-convert utility), which is memory-mapped instead of
+ * parsed.  Either way, the samples are kept in linear scale and shared
+ * by all the models using the same trace.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -66,6 +73,36 @@ public:
   */
   int64_t AssignStreams (int64_t stream);
 
+  /// Magic at the start of a binary trace ("NS3FADNG")
+  static const char BINARY_MAGIC[8];
+  /// Current version of the binary trace format
+  static const uint32_t BINARY_VERSION = 1;
+
+  /**
+   * Header at the start of a binary trace.  The header is followed by
+   * rbNum rows of samplesNum doubles in linear scale, in host byte order.
+   */
+  struct BinaryHeader
+  {
+    char magic[8];       //!< BINARY_MAGIC
+    uint32_t version;    //!< BINARY_VERSION
+    uint32_t headerSize; //!< sizeof (BinaryHeader)
+    uint32_t rbNum;      //!< number of rows
+    uint32_t samplesNum; //!< number of samples per row
+  };
+
+  /**
+   * Convert a text trace to the binary format.
+   *
+   * \param textFile the name of the text trace
+   * \param binaryFile the name of the binary trace to write
+   * \param rbNum the number of RB of the trace
+   * \param samplesNum the number of samples per RB
+   * \returns true on success
+   */
+  static bool ConvertTextTrace (std::string textFile, std::string binaryFile,
+                                uint32_t rbNum, uint32_t samplesNum);
+
   
 private:
   /**
@@ -99,20 +136,9 @@ private:
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap;
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile;
   
-  FadingTrace m_fadingTrace;
+  Ptr<TraceFadingData> m_fadingTrace; //!< the shared samples, in linear scale
 
   
   Time m_traceLength;
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/lte-interference.h>
+#include <ns3/lte-chunk-processor.h>
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteCoalescedInterferenceTest");
+
+/**
+ * Check the SINR computed by LteInterference, with and without the
+ * coalescing of the signals ending at the same time.
+ */
+class LteCoalescedInterferenceTestCase : public TestCase
+{
+public:
+  /**
+   * \param coalesceSignals the CoalesceSignals attribute
+   */
+  LteCoalescedInterferenceTestCase (bool coalesceSignals);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param rbPower the power of each RB, the other RBs are silent
+   * \returns a PSD
+   */
+  Ptr<SpectrumValue> CreatePsd (std::map<uint32_t, double> rbPower);
+
+  bool m_coalesceSignals; //!< the CoalesceSignals attribute
+  Ptr<SpectrumModel> m_model; //!< the spectrum model of the PSDs
+};
+
+LteCoalescedInterferenceTestCase::LteCoalescedInterferenceTestCase (bool coalesceSignals)
+  : TestCase (coalesceSignals ? "Coalesced signals" : "Signal by signal"),
+    m_coalesceSignals (coalesceSignals)
+{
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      freqs.push_back (2.12e9 + 180e3 * i);
+    }
+  m_model = Create<SpectrumModel> (freqs);
+}
+
+Ptr<SpectrumValue>
+LteCoalescedInterferenceTestCase::CreatePsd (std::map<uint32_t, double> rbPower)
+{
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (m_model);
+  for (std::map<uint32_t, double>::iterator it = rbPower.begin (); it != rbPower.end (); ++it)
+    {
+      (*psd)[it->first] = it->second;
+    }
+  return psd;
+}
+
+void
+LteCoalescedInterferenceTestCase::DoRun (void)
+{
+  Ptr<LteInterference> interference = CreateObject<LteInterference> ();
+  interference->SetAttribute ("CoalesceSignals", BooleanValue (m_coalesceSignals));
+  Ptr<LteChunkProcessor> processor = Create<LteChunkProcessor> ();
+  LteSpectrumValueCatcher catcher;
+  processor->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &catcher));
+  interference->AddSinrChunkProcessor (processor);
+
+  Ptr<SpectrumValue> noise = Create<SpectrumValue> (m_model);
+  (*noise) = 1e-20;
+  interference->SetNoisePowerSpectralDensity (noise);
+
+  std::map<uint32_t, double> power;
+  power[0] = 1e-19;
+  power[1] = 1e-19;
+  power[2] = 1e-19;
+  power[3] = 1e-19;
+  Ptr<SpectrumValue> a = CreatePsd (power);
+  power.clear ();
+  power[1] = 1e-18;
+  Ptr<SpectrumValue> b = CreatePsd (power);
+  power.clear ();
+  power[2] = 2e-18;
+  Ptr<SpectrumValue> c = CreatePsd (power);
+  power.clear ();
+  power[0] = 5e-19;
+  Ptr<SpectrumValue> d = CreatePsd (power);
+  power.clear ();
+  power[0] = 1e-17;
+  power[1] = 1e-17;
+  Ptr<SpectrumValue> s = CreatePsd (power);
+
+  // b, c and d end together at 1 ms, although d starts later
+  Simulator::Schedule (Seconds (0), &LteInterference::AddSignal, interference, a, Seconds (0.002));
+  Simulator::Schedule (Seconds (0), &LteInterference::AddSignal, interference, b, Seconds (0.001));
+  Simulator::Schedule (Seconds (0), &LteInterference::AddSignal, interference, c, Seconds (0.001));
+  Simulator::Schedule (Seconds (0.0005), &LteInterference::AddSignal, interference, s, Seconds (0.001));
+  Simulator::Schedule (Seconds (0.0005), &LteInterference::StartRx, interference, s);
+  Simulator::Schedule (Seconds (0.0005), &LteInterference::AddSignal, interference, d, Seconds (0.0005));
+  Simulator::Schedule (Seconds (0.0015), &LteInterference::EndRx, interference);
+  Simulator::Stop (Seconds (0.0016));
+  Simulator::Run ();
+
+  Ptr<SpectrumValue> sinr = catcher.GetValue ();
+  NS_TEST_ASSERT_MSG_NE (sinr, 0, "No SINR reported");
+  // a, b and d interfere over the first half of the reception, a only over the second half
+  double expected0 = (1e-17 / 6.1e-19 + 1e-17 / 1.1e-19) / 2;
+  double expected1 = (1e-17 / 1.11e-18 + 1e-17 / 1.1e-19) / 2;
+  NS_TEST_EXPECT_MSG_EQ_TOL ((*sinr)[0], expected0, expected0 * 1e-9, "Wrong SINR of RB 0");
+  NS_TEST_EXPECT_MSG_EQ_TOL ((*sinr)[1], expected1, expected1 * 1e-9, "Wrong SINR of RB 1");
+  NS_TEST_EXPECT_MSG_EQ ((*sinr)[2], 0, "Wrong SINR of RB 2");
+  NS_TEST_EXPECT_MSG_EQ ((*sinr)[3], 0, "Wrong SINR of RB 3");
+
+  // the signals pending when the noise is set are forgotten
+  Simulator::Schedule (Seconds (0.0025), &LteInterference::AddSignal, interference, b, Seconds (0.001));
+  Simulator::Schedule (Seconds (0.003), &LteInterference::SetNoisePowerSpectralDensity, interference, noise);
+  Simulator::Schedule (Seconds (0.003), &LteInterference::AddSignal, interference, s, Seconds (0.001));
+  Simulator::Schedule (Seconds (0.003), &LteInterference::StartRx, interference, s);
+  Simulator::Schedule (Seconds (0.004), &LteInterference::EndRx, interference);
+  Simulator::Stop (Seconds (0.0041));
+  Simulator::Run ();
+
+  sinr = catcher.GetValue ();
+  NS_TEST_EXPECT_MSG_EQ_TOL ((*sinr)[0], 1e3, 1e-6, "Wrong SINR of RB 0 after the reset");
+  NS_TEST_EXPECT_MSG_EQ_TOL ((*sinr)[1], 1e3, 1e-6, "Wrong SINR of RB 1 after the reset");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Test suite for the coalescing of the signals in LteInterference
+ */
+class LteCoalescedInterferenceTestSuite : public TestSuite
+{
+public:
+  LteCoalescedInterferenceTestSuite ();
+};
+
+LteCoalescedInterferenceTestSuite::LteCoalescedInterferenceTestSuite ()
+  : TestSuite ("lte-coalesced-interference", UNIT)
+{
+  AddTestCase (new LteCoalescedInterferenceTestCase (false), TestCase::QUICK);
+  AddTestCase (new LteCoalescedInterferenceTestCase (true), TestCase::QUICK);
+}
+
+static LteCoalescedInterferenceTestSuite lteCoalescedInterferenceTestSuite;
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/ff-mac-scheduler-ue-store.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteFfMacSchedulerUeStoreTest");
+
+/**
+ * Check the RNTI to index mapping and the selection of the best UE of
+ * a RBG of FfMacSchedulerUeStore.
+ */
+class LteFfMacSchedulerUeStoreTestCase : public TestCase
+{
+public:
+  LteFfMacSchedulerUeStoreTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteFfMacSchedulerUeStoreTestCase::LteFfMacSchedulerUeStoreTestCase ()
+  : TestCase ("RNTI mapping and best UE selection")
+{
+}
+
+void
+LteFfMacSchedulerUeStoreTestCase::DoRun (void)
+{
+  FfMacSchedulerUeStore store;
+  store.Clear (3);
+  uint16_t rntis[] = {2, 5, 7, 40};
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      uint32_t ue = store.AddUe (rntis[i]);
+      NS_TEST_ASSERT_MSG_EQ (ue, i, "Wrong index of RNTI " << rntis[i]);
+    }
+  store.ResetMetrics ();
+  NS_TEST_ASSERT_MSG_EQ (store.GetNUes (), 4, "Wrong number of UEs");
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (store.GetIndex (rntis[i]), (int32_t) i, "Wrong index of RNTI " << rntis[i]);
+      NS_TEST_EXPECT_MSG_EQ (store.GetRnti (i), rntis[i], "Wrong RNTI of UE " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (store.GetIndex (1), -1, "Index of a missing RNTI");
+  NS_TEST_EXPECT_MSG_EQ (store.GetIndex (6), -1, "Index of a missing RNTI");
+  NS_TEST_EXPECT_MSG_EQ (store.GetIndex (41), -1, "Index of a missing RNTI");
+
+  store.SetMetric (0, 1, 2.0);
+  store.SetMetric (0, 2, 3.0);
+  store.SetMetric (0, 3, 3.0);
+  store.SetMetric (1, 0, -1.0);
+  store.SetMetric (2, 3, 0.5);
+  NS_TEST_EXPECT_MSG_EQ (store.GetBestUe (0), 2, "Ties not broken in RNTI order");
+  NS_TEST_EXPECT_MSG_EQ (store.GetBestUe (1), -1, "UE selected with a negative metric");
+  NS_TEST_EXPECT_MSG_EQ (store.GetBestUe (2), 3, "Wrong UE selected");
+
+  // a new TTI starts from scratch
+  store.Clear (3);
+  store.AddUe (7);
+  store.ResetMetrics ();
+  NS_TEST_EXPECT_MSG_EQ (store.GetIndex (7), 0, "Wrong index after clearing the store");
+  NS_TEST_EXPECT_MSG_EQ (store.GetIndex (2), -1, "UE not removed");
+  NS_TEST_EXPECT_MSG_EQ (store.GetBestUe (0), -1, "Metric not reset");
+  NS_TEST_EXPECT_MSG_EQ (store.IsEligible (0), false, "New UE eligible");
+}
+
+/**
+ * Test suite for FfMacSchedulerUeStore
+ */
+class LteFfMacSchedulerUeStoreTestSuite : public TestSuite
+{
+public:
+  LteFfMacSchedulerUeStoreTestSuite ();
+};
+
+LteFfMacSchedulerUeStoreTestSuite::LteFfMacSchedulerUeStoreTestSuite ()
+  : TestSuite ("lte-ff-mac-scheduler-ue-store", UNIT)
+{
+  AddTestCase (new LteFfMacSchedulerUeStoreTestCase, TestCase::QUICK);
+}
+
+static LteFfMacSchedulerUeStoreTestSuite lteFfMacSchedulerUeStoreTestSuite;
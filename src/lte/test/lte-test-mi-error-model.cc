@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/lte-mi-error-model.h>
+#include <ns3/spectrum-value.h>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteMiErrorModelTest");
+
+/**
+ * Check that the batched evaluation of the TBs of a subframe gives the
+ * same stats as the evaluation of each TB on its own.
+ */
+class LteMiErrorModelBatchTestCase : public TestCase
+{
+public:
+  LteMiErrorModelBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteMiErrorModelBatchTestCase::LteMiErrorModelBatchTestCase ()
+  : TestCase ("Batched and single TB decodification stats")
+{
+}
+
+void
+LteMiErrorModelBatchTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 25; i++)
+    {
+      freqs.push_back (2.12e9 + 180e3 * i);
+    }
+  SpectrumValue sinr (Create<SpectrumModel> (freqs));
+  for (uint32_t i = 0; i < 25; i++)
+    {
+      // from -6 dB to 30 dB
+      sinr[i] = std::pow (10, (-6 + 1.5 * i) / 10);
+    }
+
+  HarqProcessInfoList_t noHistory;
+  HarqProcessInfoList_t history;
+  HarqProcessInfoElement_t element;
+  element.m_mi = 0.4;
+  element.m_rv = 0;
+  element.m_infoBits = 1024;
+  element.m_codeBits = 4000;
+  history.push_back (element);
+
+  // TBs of all the modulations, one of them spanning several CBs
+  uint8_t mcs[] = {2, 9, 12, 16, 20, 28, 5, 14};
+  uint16_t size[] = {40, 200, 300, 500, 1500, 2200, 100, 300};
+  std::vector<std::vector<int> > maps (8);
+  std::vector<TbDecodificationInfo_t> tbs;
+  for (uint32_t tb = 0; tb < 8; tb++)
+    {
+      for (int rb = tb; rb < 25; rb += 2 + tb % 3)
+        {
+          maps[tb].push_back (rb);
+        }
+      TbDecodificationInfo_t info;
+      info.map = &maps[tb];
+      info.size = size[tb];
+      info.mcs = mcs[tb];
+      info.miHistory = (tb >= 6 ? &history : &noHistory);
+      tbs.push_back (info);
+    }
+
+  std::vector<TbStats_t> stats;
+  LteMiErrorModel::GetTbDecodificationStats (sinr, tbs, stats);
+  NS_TEST_ASSERT_MSG_EQ (stats.size (), tbs.size (), "Wrong number of stats");
+  for (uint32_t tb = 0; tb < tbs.size (); tb++)
+    {
+      TbStats_t single = LteMiErrorModel::GetTbDecodificationStats (sinr, maps[tb], size[tb], mcs[tb], *tbs[tb].miHistory);
+      double mib = LteMiErrorModel::Mib (sinr, maps[tb], mcs[tb]);
+      NS_TEST_EXPECT_MSG_EQ (stats[tb].mi, single.mi, "Different MI of TB " << tb);
+      NS_TEST_EXPECT_MSG_EQ (stats[tb].tbler, single.tbler, "Different TBLER of TB " << tb);
+      NS_TEST_EXPECT_MSG_EQ (stats[tb].mi, mib, "Different MIB of TB " << tb);
+      NS_TEST_EXPECT_MSG_EQ (((stats[tb].tbler >= 0) && (stats[tb].tbler <= 1)), true, "TBLER out of range for TB " << tb);
+    }
+
+  // the MI of a map is the mean of the MI of its RBs
+  std::vector<int> high (1, 24);
+  std::vector<int> low (1, 0);
+  std::vector<int> both;
+  both.push_back (0);
+  both.push_back (24);
+  double miHigh = LteMiErrorModel::Mib (sinr, high, 2);
+  double miLow = LteMiErrorModel::Mib (sinr, low, 2);
+  double miBoth = LteMiErrorModel::Mib (sinr, both, 2);
+  NS_TEST_EXPECT_MSG_EQ (miHigh, 1, "MI of QPSK at 30 dB is not saturated");
+  NS_TEST_EXPECT_MSG_EQ_TOL (miBoth, (miHigh + miLow) / 2, 1e-12, "Wrong mean MI");
+
+  // a low MCS at a high SINR is always decoded, a high MCS at a low SINR never
+  TbStats_t good = LteMiErrorModel::GetTbDecodificationStats (sinr, high, 20, 0, noHistory);
+  TbStats_t bad = LteMiErrorModel::GetTbDecodificationStats (sinr, low, 100, 28, noHistory);
+  NS_TEST_EXPECT_MSG_LT (good.tbler, 1e-6, "TB of MCS 0 lost at 30 dB");
+  NS_TEST_EXPECT_MSG_GT (bad.tbler, 1 - 1e-6, "TB of MCS 28 decoded at -6 dB");
+}
+
+/**
+ * Test suite for LteMiErrorModel
+ */
+class LteMiErrorModelTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelTestSuite ();
+};
+
+LteMiErrorModelTestSuite::LteMiErrorModelTestSuite ()
+  : TestSuite ("lte-mi-error-model", UNIT)
+{
+  AddTestCase (new LteMiErrorModelBatchTestCase, TestCase::QUICK);
+}
+
+static LteMiErrorModelTestSuite lteMiErrorModelTestSuite;
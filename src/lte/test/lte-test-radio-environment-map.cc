@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/lte-helper.h>
+#include <ns3/radio-environment-map-helper.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/node-container.h>
+#include <ns3/spectrum-channel.h>
+#include <ns3/net-device-container.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/string.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRadioEnvironmentMapTest");
+
+/**
+ * Check that a direct Radio Environment Map, computed in one or more
+ * threads and saved as a binary grid, matches the map made by
+ * listening to the control channel.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  LteRadioEnvironmentMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Generate a map of two eNBs.
+   *
+   * \param fileName the output file
+   * \param direct the Direct attribute
+   * \param numThreads the NumThreads attribute
+   * \param binary the BinaryOutput attribute
+   */
+  void Generate (std::string fileName, bool direct, uint32_t numThreads, bool binary);
+
+  /**
+   * \param fileName a binary map
+   * \returns the SINR of the points
+   */
+  std::vector<double> ReadBinary (std::string fileName);
+
+  static const uint32_t RES = 6; //!< number of points along each axis
+};
+
+const uint32_t LteRadioEnvironmentMapTestCase::RES;
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase ()
+  : TestCase ("Direct and binary Radio Environment Maps")
+{
+}
+
+void
+LteRadioEnvironmentMapTestCase::Generate (std::string fileName, bool direct, uint32_t numThreads, bool binary)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  NodeContainer enbNodes;
+  enbNodes.Create (2);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 10));
+  positions->Add (Vector (600, 100, 10));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (enbNodes);
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+
+  Ptr<LteEnbPhy> enbPhy = enbDevs.Get (0)->GetObject<LteEnbNetDevice> ()->GetPhy ();
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << enbPhy->GetDownlinkSpectrumPhy ()->GetChannel ()->GetId ();
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue (channelPath.str ()));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (800.0));
+  remHelper->SetAttribute ("YMin", DoubleValue (-300.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (300.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (RES));
+  remHelper->SetAttribute ("YRes", UintegerValue (RES));
+  remHelper->SetAttribute ("Direct", BooleanValue (direct));
+  remHelper->SetAttribute ("NumThreads", UintegerValue (numThreads));
+  remHelper->SetAttribute ("BinaryOutput", BooleanValue (binary));
+  remHelper->Install ();
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+std::vector<double>
+LteRadioEnvironmentMapTestCase::ReadBinary (std::string fileName)
+{
+  std::vector<double> sinr;
+  std::ifstream is (fileName.c_str (), std::ios::in | std::ios::binary);
+  RadioEnvironmentMapHelper::BinaryHeader header;
+  is.read (reinterpret_cast<char *> (&header), sizeof (header));
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (header.magic, RadioEnvironmentMapHelper::BINARY_MAGIC, 8), 0, "Wrong magic");
+  NS_TEST_EXPECT_MSG_EQ (header.headerSize, sizeof (header), "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.xRes, RES, "Wrong x resolution");
+  NS_TEST_EXPECT_MSG_EQ (header.yRes, RES, "Wrong y resolution");
+  NS_TEST_EXPECT_MSG_EQ_TOL (header.xMax, 800.0, 1e-9, "Wrong x max");
+  sinr.resize (header.xRes * header.yRes);
+  is.read (reinterpret_cast<char *> (&sinr[0]), sizeof (double) * sinr.size ());
+  NS_TEST_EXPECT_MSG_EQ (is.good (), true, "Truncated map");
+  return sinr;
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  std::string textFile = CreateTempDirFilename ("rem.out");
+  std::string eventBinaryFile = CreateTempDirFilename ("rem-event.bin");
+  std::string directFile = CreateTempDirFilename ("rem-direct.bin");
+  std::string parallelFile = CreateTempDirFilename ("rem-parallel.bin");
+  Generate (textFile, false, 1, false);
+  Generate (eventBinaryFile, false, 1, true);
+  Generate (directFile, true, 1, true);
+  Generate (parallelFile, true, 4, true);
+
+  std::vector<double> reference;
+  std::ifstream is (textFile.c_str ());
+  double x, y, z, sinr;
+  while (is >> x >> y >> z >> sinr)
+    {
+      reference.push_back (sinr);
+    }
+  NS_TEST_ASSERT_MSG_EQ (reference.size (), RES * RES, "Wrong number of points in the text map");
+
+  std::vector<double> eventBinary = ReadBinary (eventBinaryFile);
+  std::vector<double> direct = ReadBinary (directFile);
+  std::vector<double> parallel = ReadBinary (parallelFile);
+  NS_TEST_ASSERT_MSG_EQ (direct.size (), RES * RES, "Wrong number of points in the direct map");
+  NS_TEST_ASSERT_MSG_EQ (eventBinary.size (), RES * RES, "Wrong number of points in the binary map");
+  for (uint32_t i = 0; i < RES * RES; ++i)
+    {
+      // the text map has 6 significant digits
+      NS_TEST_EXPECT_MSG_EQ_TOL (eventBinary[i], reference[i], reference[i] * 1e-5, "Wrong SINR at point " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (direct[i], eventBinary[i], eventBinary[i] * 1e-9, "Wrong direct SINR at point " << i);
+      NS_TEST_EXPECT_MSG_EQ (parallel[i], direct[i], "Wrong parallel SINR at point " << i);
+    }
+}
+
+/**
+ * Test suite for RadioEnvironmentMapHelper
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase, TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite lteRadioEnvironmentMapTestSuite;
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/trace-fading-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/nstime.h>
+#include <fstream>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTraceFadingTest");
+
+/**
+ * Check that a binary fading trace made by ConvertTextTrace gives the
+ * same fading as the text trace it was made from.
+ */
+class LteTraceFadingTestCase : public TestCase
+{
+public:
+  LteTraceFadingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param fileName the trace file name
+   * \returns an initialized fading model using the trace
+   */
+  Ptr<TraceFadingLossModel> CreateModel (std::string fileName);
+
+  static const uint32_t RB_NUM = 4;       //!< number of RB of the trace
+  static const uint32_t SAMPLES_NUM = 20; //!< number of samples per RB
+};
+
+LteTraceFadingTestCase::LteTraceFadingTestCase ()
+  : TestCase ("Binary and text fading traces")
+{
+}
+
+Ptr<TraceFadingLossModel>
+LteTraceFadingTestCase::CreateModel (std::string fileName)
+{
+  Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (fileName));
+  model->SetAttribute ("RbNum", UintegerValue (RB_NUM));
+  model->SetAttribute ("SamplesNum", UintegerValue (SAMPLES_NUM));
+  model->SetAttribute ("TraceLength", TimeValue (MilliSeconds (SAMPLES_NUM)));
+  model->SetAttribute ("WindowSize", TimeValue (MilliSeconds (5)));
+  model->AssignStreams (1);
+  model->Initialize ();
+  return model;
+}
+
+void
+LteTraceFadingTestCase::DoRun (void)
+{
+  std::string textFile = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFile = CreateTempDirFilename ("fading-trace.bin");
+  std::ofstream os (textFile.c_str ());
+  for (uint32_t i = 0; i < RB_NUM; i++)
+    {
+      for (uint32_t j = 0; j < SAMPLES_NUM; j++)
+        {
+          os << -0.5 * j + i << " ";
+        }
+      os << std::endl;
+    }
+  os.close ();
+
+  NS_TEST_ASSERT_MSG_EQ (TraceFadingLossModel::ConvertTextTrace (textFile, binaryFile, RB_NUM, SAMPLES_NUM + 1),
+                         false, "Converted a trace with missing samples");
+  NS_TEST_ASSERT_MSG_EQ (TraceFadingLossModel::ConvertTextTrace (textFile, binaryFile, RB_NUM, SAMPLES_NUM),
+                         true, "Can't convert the trace");
+
+  Ptr<TraceFadingLossModel> text = CreateModel (textFile);
+  Ptr<TraceFadingLossModel> binary = CreateModel (binaryFile);
+  // a second model using the same trace shares the mapped samples
+  Ptr<TraceFadingLossModel> binary2 = CreateModel (binaryFile);
+
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < RB_NUM; i++)
+    {
+      freqs.push_back (2.1e9 + 180e3 * i);
+    }
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (Create<SpectrumModel> (freqs));
+  (*txPsd)[0] = 1e-3;
+  (*txPsd)[1] = 2e-3;
+  (*txPsd)[2] = 0;
+  (*txPsd)[3] = 4e-3;
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+
+  Ptr<SpectrumValue> textRx = text->CalcRxPowerSpectralDensity (txPsd, a, b);
+  Ptr<SpectrumValue> binaryRx = binary->CalcRxPowerSpectralDensity (txPsd, a, b);
+  Ptr<SpectrumValue> binary2Rx = binary2->CalcRxPowerSpectralDensity (txPsd, a, b);
+  NS_TEST_ASSERT_MSG_EQ ((*textRx)[2], 0, "Fading applied to an unused RB");
+  for (uint32_t i = 0; i < RB_NUM; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*binaryRx)[i], (*textRx)[i], 1e-15, "Different fading of RB " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*binary2Rx)[i], (*textRx)[i], 1e-15, "Different fading of RB " << i);
+    }
+  // the fading of the RBs of a sample differ by 1 dB
+  double ratio = ((*textRx)[1] / (*txPsd)[1]) / ((*textRx)[0] / (*txPsd)[0]);
+  NS_TEST_ASSERT_MSG_EQ_TOL (ratio, std::pow (10, 0.1), 1e-12, "Wrong fading");
+  double fading = 10 * std::log10 ((*textRx)[0] / (*txPsd)[0]);
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::fmod (-fading * 2 + 0.5, 1), 0.5, 1e-9, "Fading is not a sample of the trace");
+}
+
+/**
+ * Test suite for the binary fading traces of TraceFadingLossModel
+ */
+class LteTraceFadingTestSuite : public TestSuite
+{
+public:
+  LteTraceFadingTestSuite ();
+};
+
+LteTraceFadingTestSuite::LteTraceFadingTestSuite ()
+  : TestSuite ("lte-trace-fading", UNIT)
+{
+  AddTestCase (new LteTraceFadingTestCase, TestCase::QUICK);
+}
+
+static LteTraceFadingTestSuite lteTraceFadingTestSuite;
@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/lte-helper.h>
+#include <ns3/lte-tti-driver.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-ue-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-ue-phy.h>
+#include <ns3/radio-bearer-stats-calculator.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/boolean.h>
+#include <ns3/string.h>
+#include <ns3/nstime.h>
+#include <ns3/config.h>
+#include <ns3/lte-common.h>
+#include <cstdlib>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTtiDriverTest");
+
+/**
+ * Check that the subframes started by a LteTtiDriver give the same
+ * results as the subframes scheduled by each PHY, in a scenario of two
+ * interfering cells, and that they start in the context of the node of
+ * each PHY.
+ */
+class LteTtiDriverTestCase : public TestCase
+{
+public:
+  LteTtiDriverTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario.
+   *
+   * \param useTtiDriver the UseTtiDriver attribute of LteHelper
+   * \param dlRxData the DL bytes received by each UE
+   * \param ulRxData the UL bytes received from each UE
+   */
+  void Simulate (bool useTtiDriver, std::vector<uint64_t>& dlRxData, std::vector<uint64_t>& ulRxData);
+
+  /**
+   * Check the context of a DL transmission of an eNB PHY.
+   *
+   * \param context the trace context, giving the node of the eNB
+   * \param params the parameters of the transmission
+   */
+  void DlPhyTransmission (std::string context, PhyTransmissionStatParameters params);
+
+  uint32_t m_dlTransmissions; //!< the number of DL transmissions
+  uint32_t m_wrongContexts; //!< the number of DL transmissions in the context of another node
+};
+
+LteTtiDriverTestCase::LteTtiDriverTestCase ()
+  : TestCase ("Subframes started by a LteTtiDriver")
+{
+}
+
+void
+LteTtiDriverTestCase::DlPhyTransmission (std::string context, PhyTransmissionStatParameters params)
+{
+  // the context is /NodeList/<id>/DeviceList/...
+  uint32_t nodeId = std::atoi (context.substr (std::string ("/NodeList/").size ()).c_str ());
+  m_dlTransmissions++;
+  if (Simulator::GetContext () != nodeId)
+    {
+      NS_LOG_ERROR ("DL transmission of node " << nodeId << " in context " << Simulator::GetContext ());
+      m_wrongContexts++;
+    }
+}
+
+void
+LteTtiDriverTestCase::Simulate (bool useTtiDriver, std::vector<uint64_t>& dlRxData, std::vector<uint64_t>& ulRxData)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("UseTtiDriver", BooleanValue (useTtiDriver));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (2);
+  ueNodes.Create (4);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 0));
+  positions->Add (Vector (1000, 0, 0));
+  positions->Add (Vector (100, 0, 0));
+  positions->Add (Vector (400, 0, 0));
+  positions->Add (Vector (700, 0, 0));
+  positions->Add (Vector (1200, 0, 0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  stream += lteHelper->AssignStreams (ueDevs, stream);
+  lteHelper->Attach (ueDevs.Get (0), enbDevs.Get (0));
+  lteHelper->Attach (ueDevs.Get (1), enbDevs.Get (0));
+  lteHelper->Attach (ueDevs.Get (2), enbDevs.Get (1));
+  lteHelper->Attach (ueDevs.Get (3), enbDevs.Get (1));
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  Ptr<LteTtiDriver> driver = enbDevs.Get (0)->GetObject<LteEnbNetDevice> ()->GetPhy ()->GetTtiDriver ();
+  NS_TEST_ASSERT_MSG_EQ ((driver != 0), useTtiDriver, "Wrong driver of the eNB PHY");
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      Ptr<LteTtiDriver> ueDriver = ueDevs.Get (i)->GetObject<LteUeNetDevice> ()->GetPhy ()->GetTtiDriver ();
+      NS_TEST_ASSERT_MSG_EQ (ueDriver, driver, "UE " << i << " not driven by the driver of the eNBs");
+    }
+
+  lteHelper->EnableRlcTraces ();
+  Ptr<RadioBearerStatsCalculator> rlcStats = lteHelper->GetRlcStats ();
+  rlcStats->SetAttribute ("StartTime", TimeValue (Seconds (0.1)));
+  rlcStats->SetAttribute ("EpochDuration", TimeValue (Seconds (0.2)));
+  rlcStats->SetAttribute ("DlRlcOutputFilename", StringValue (CreateTempDirFilename ("DlRlcStats.txt")));
+  rlcStats->SetAttribute ("UlRlcOutputFilename", StringValue (CreateTempDirFilename ("UlRlcStats.txt")));
+
+  m_dlTransmissions = 0;
+  m_wrongContexts = 0;
+  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/DlPhyTransmission",
+                   MakeCallback (&LteTtiDriverTestCase::DlPhyTransmission, this));
+
+  Simulator::Stop (Seconds (0.3 - 0.000001));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_GT (m_dlTransmissions, 0, "No DL transmission");
+  NS_TEST_EXPECT_MSG_EQ (m_wrongContexts, 0, "DL transmissions out of the context of the eNB");
+
+  if (useTtiDriver)
+    {
+      NS_TEST_EXPECT_MSG_EQ (driver->GetNPhys (), 6, "Wrong number of PHYs driven");
+    }
+
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      uint64_t imsi = ueDevs.Get (i)->GetObject<LteUeNetDevice> ()->GetImsi ();
+      dlRxData.push_back (rlcStats->GetDlRxData (imsi, 3));
+      ulRxData.push_back (rlcStats->GetUlRxData (imsi, 3));
+      NS_LOG_INFO ("driver " << useTtiDriver << " imsi " << imsi << " DL " << dlRxData.back () << " UL " << ulRxData.back ());
+    }
+
+  Simulator::Destroy ();
+
+  if (useTtiDriver)
+    {
+      NS_TEST_EXPECT_MSG_EQ (driver->GetNPhys (), 0, "PHYs not removed when disposed");
+    }
+}
+
+void
+LteTtiDriverTestCase::DoRun (void)
+{
+  std::vector<uint64_t> dlRxData;
+  std::vector<uint64_t> ulRxData;
+  Simulate (false, dlRxData, ulRxData);
+  std::vector<uint64_t> drivenDlRxData;
+  std::vector<uint64_t> drivenUlRxData;
+  Simulate (true, drivenDlRxData, drivenUlRxData);
+
+  for (uint32_t i = 0; i < dlRxData.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_GT (dlRxData[i], 0, "No DL data received by UE " << i);
+      NS_TEST_EXPECT_MSG_GT (ulRxData[i], 0, "No UL data received from UE " << i);
+      NS_TEST_EXPECT_MSG_EQ (drivenDlRxData[i], dlRxData[i], "Different DL data received by UE " << i);
+      NS_TEST_EXPECT_MSG_EQ (drivenUlRxData[i], ulRxData[i], "Different UL data received from UE " << i);
+    }
+}
+
+/**
+ * Test suite for LteTtiDriver
+ */
+class LteTtiDriverTestSuite : public TestSuite
+{
+public:
+  LteTtiDriverTestSuite ();
+};
+
+LteTtiDriverTestSuite::LteTtiDriverTestSuite ()
+  : TestSuite ("lte-tti-driver", SYSTEM)
+{
+  AddTestCase (new LteTtiDriverTestCase, TestCase::QUICK);
+}
+
+static LteTtiDriverTestSuite lteTtiDriverTestSuite;
@@ -1020,6 +1020,101 @@ MeasurementReportTestCase::DoRun (void)
   packet = 0;
 }
 
+// --------------------------- CLASS Asn1SerializationReuseTestCase -----------------------------
+/**
+ * Check the octets of a header serialized several times, which reuses
+ * the serialization of the header
+ */
+class Asn1SerializationReuseTestCase : public RrcHeaderTestCase
+{
+public:
+  Asn1SerializationReuseTestCase ();
+  virtual void DoRun (void);
+};
+
+Asn1SerializationReuseTestCase::Asn1SerializationReuseTestCase () : RrcHeaderTestCase ("Testing the reuse of a serialization")
+{
+}
+
+void
+Asn1SerializationReuseTestCase::DoRun (void)
+{
+  NS_LOG_DEBUG ("============= Asn1SerializationReuseTestCase ===========");
+
+  LteRrcSap::RrcConnectionRequest msg;
+  msg.ueIdentity = 0x83fecafecaULL;
+  RrcConnectionRequestHeader source;
+  source.SetMessage (msg);
+  packet = Create<Packet> ();
+  packet->AddHeader (source);
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet), "48 3f ec af ec a6 ", "Wrong encoding");
+
+  // a new message in the same header replaces the previous encoding
+  msg.ueIdentity = 0x0102030405ULL;
+  source.SetMessage (msg);
+  packet = Create<Packet> ();
+  packet->AddHeader (source);
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet), "40 10 20 30 40 56 ", "Wrong encoding after a new message");
+
+  RrcConnectionRequestHeader destination;
+  packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (destination.GetMmec (), std::bitset<8> (0x01), "Different m_mmec!");
+  NS_TEST_ASSERT_MSG_EQ (destination.GetMtmsi (), std::bitset<32> (0x02030405), "Different m_mTmsi!");
+
+  packet = 0;
+}
+
+// --------------------------- CLASS RrcUlDcchMessageTestCase -----------------------------
+/**
+ * Check the round trip of a RrcUlDcchMessage serialized on its own,
+ * as done for the message type discrimination
+ */
+class RrcUlDcchMessageTestCase : public RrcHeaderTestCase
+{
+public:
+  RrcUlDcchMessageTestCase ();
+  virtual void DoRun (void);
+};
+
+RrcUlDcchMessageTestCase::RrcUlDcchMessageTestCase () : RrcHeaderTestCase ("Testing RrcUlDcchMessageTestCase")
+{
+}
+
+void
+RrcUlDcchMessageTestCase::DoRun (void)
+{
+  NS_LOG_DEBUG ("============= RrcUlDcchMessageTestCase ===========");
+
+  LteRrcSap::RrcConnectionReconfigurationCompleted msg;
+  msg.rrcTransactionIdentifier = 2;
+  RrcConnectionReconfigurationCompleteHeader header;
+  header.SetMessage (msg);
+  packet = Create<Packet> ();
+  packet->AddHeader (header);
+
+  // discriminate the message type
+  RrcUlDcchMessage source;
+  packet->RemoveHeader (source);
+  NS_TEST_ASSERT_MSG_EQ (source.GetMessageType (), 2, "Wrong message type of the RrcConnectionReconfigurationComplete");
+
+  // Add header
+  packet = Create<Packet> ();
+  packet->AddHeader (source);
+
+  // Log serialized packet contents
+  TestUtils::LogPacketContents (packet);
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet), "10 ", "Wrong encoding");
+
+  // remove header
+  RrcUlDcchMessage destination;
+  packet->RemoveHeader (destination);
+
+  // Check that the destination and source headers contain the same values
+  NS_TEST_ASSERT_MSG_EQ (destination.GetMessageType (), source.GetMessageType (), "Different message type!");
+
+  packet = 0;
+}
+
 // --------------------------- CLASS Asn1EncodingSuite -----------------------------
 class Asn1EncodingSuite : public TestSuite
 {
@@ -1042,6 +1137,8 @@ Asn1EncodingSuite::Asn1EncodingSuite ()
   AddTestCase (new RrcConnectionReestablishmentCompleteTestCase (), TestCase::QUICK);
   AddTestCase (new RrcConnectionRejectTestCase (), TestCase::QUICK);
   AddTestCase (new MeasurementReportTestCase (), TestCase::QUICK);
+  AddTestCase (new Asn1SerializationReuseTestCase (), TestCase::QUICK);
+  AddTestCase (new RrcUlDcchMessageTestCase (), TestCase::QUICK);
 }
 
 Asn1EncodingSuite asn1EncodingSuite;
@@ -20,6 +20,7 @@
 #include "distributed-simulator-impl.h"
 #include "granted-time-window-mpi-interface.h"
 #include "mpi-interface.h"
+#include "shared-memory-interface.h"
 
 #include "ns3/simulator.h"
 #include "ns3/scheduler.h"
@@ -93,17 +94,18 @@ DistributedSimulatorImpl::DistributedSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
 
-#ifdef NS3_MPI
+#ifndef NS3_MPI
+  if (!SharedMemoryInterface::IsActive ())
+    {
+      NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+    }
+#endif
   m_myId = MpiInterface::GetSystemId ();
   m_systemCount = MpiInterface::GetSize ();
 
   // Allocate the LBTS message buffer
   m_pLBTS = new LbtsMessage[m_systemCount];
   m_grantedTime = Seconds (0);
-#else
-  NS_UNUSED (m_systemCount);
-  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
-#endif
 
   m_stop = false;
   m_globalFinished = false;
@@ -165,7 +167,6 @@ DistributedSimulatorImpl::CalculateLookAhead (void)
 {
   NS_LOG_FUNCTION (this);
 
-#ifdef NS3_MPI
   if (MpiInterface::GetSize () <= 1)
     {
       m_lookAhead = Seconds (0);
@@ -262,7 +263,18 @@ DistributedSimulatorImpl::CalculateLookAhead (void)
       sendbuf  = m_lookAhead.GetInteger ();
     }
 
-  MPI_Allreduce (&sendbuf, &recvbuf, 1, MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+  if (SharedMemoryInterface::IsActive ())
+    {
+      recvbuf = SharedMemoryInterface::AllReduceMax (sendbuf);
+    }
+  else
+    {
+#ifdef NS3_MPI
+      MPI_Allreduce (&sendbuf, &recvbuf, 1, MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+#else
+      recvbuf = sendbuf;
+#endif
+    }
 
   /* For nodes that did not compute a lookahead use max from ranks
    * that did compute a value.  An edge case occurs if all nodes have
@@ -275,10 +287,6 @@ DistributedSimulatorImpl::CalculateLookAhead (void)
       m_lookAhead = Time (recvbuf);
       m_grantedTime = m_lookAhead;
     }
-
-#else
-  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
-#endif
 }
 
 void
@@ -370,7 +378,6 @@ DistributedSimulatorImpl::Run (void)
 {
   NS_LOG_FUNCTION (this);
 
-#ifdef NS3_MPI
   CalculateLookAhead ();
   m_stop = false;
   while (!m_globalFinished)
@@ -386,17 +393,31 @@ DistributedSimulatorImpl::Run (void)
         {
           // Can't process next event, calculate a new LBTS
           // First receive any pending messages
-          GrantedTimeWindowMpiInterface::ReceiveMessages ();
-          // reset next time
-          nextTime = Next ();
-          // And check for send completes
-          GrantedTimeWindowMpiInterface::TestSendComplete ();
-          // Finally calculate the lbts
-          LbtsMessage lMsg (GrantedTimeWindowMpiInterface::GetRxCount (), GrantedTimeWindowMpiInterface::GetTxCount (), 
-                            m_myId, IsLocalFinished (), nextTime);
-          m_pLBTS[m_myId] = lMsg;
-          MPI_Allgather (&lMsg, sizeof (LbtsMessage), MPI_BYTE, m_pLBTS,
-                         sizeof (LbtsMessage), MPI_BYTE, MPI_COMM_WORLD);
+          if (SharedMemoryInterface::IsActive ())
+            {
+              SharedMemoryInterface::ReceiveMessages ();
+              nextTime = Next ();
+              LbtsMessage lMsg (SharedMemoryInterface::GetRxCount (), SharedMemoryInterface::GetTxCount (),
+                                m_myId, IsLocalFinished (), nextTime);
+              m_pLBTS[m_myId] = lMsg;
+              SharedMemoryInterface::AllGather (&lMsg, m_pLBTS, sizeof (LbtsMessage));
+            }
+          else
+            {
+#ifdef NS3_MPI
+              GrantedTimeWindowMpiInterface::ReceiveMessages ();
+              // reset next time
+              nextTime = Next ();
+              // And check for send completes
+              GrantedTimeWindowMpiInterface::TestSendComplete ();
+              // Finally calculate the lbts
+              LbtsMessage lMsg (GrantedTimeWindowMpiInterface::GetRxCount (), GrantedTimeWindowMpiInterface::GetTxCount (), 
+                                m_myId, IsLocalFinished (), nextTime);
+              m_pLBTS[m_myId] = lMsg;
+              MPI_Allgather (&lMsg, sizeof (LbtsMessage), MPI_BYTE, m_pLBTS,
+                             sizeof (LbtsMessage), MPI_BYTE, MPI_COMM_WORLD);
+#endif
+            }
           Time smallestTime = m_pLBTS[0].GetSmallestTime ();
           // The totRx and totTx counts insure there are no transient
           // messages;  If totRx != totTx, there are transients,
@@ -443,9 +464,6 @@ DistributedSimulatorImpl::Run (void)
   // If the simulator stopped naturally by lack of events, make a
   // consistency test to check that we didn't lose any events along the way.
   NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
-#else
-  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
-#endif
 }
 
 uint32_t DistributedSimulatorImpl::GetSystemId () const
@@ -643,4 +661,10 @@ DistributedSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+void
+DistributedSimulatorImpl::SetContext (uint32_t context)
+{
+  m_currentContext = context;
+}
+
 } // namespace ns3
@@ -27,6 +27,7 @@
 
 #include "null-message-mpi-interface.h"
 #include "granted-time-window-mpi-interface.h"
+#include "shared-memory-interface.h"
 
 namespace ns3 {
 
@@ -108,6 +109,21 @@ MpiInterface::Enable (int* pargc, char*** pargv)
   g_parallelCommunicationInterface->Enable (pargc, pargv);
 }
 
+void
+MpiInterface::EnableSharedMemory (uint32_t size)
+{
+  StringValue simulationTypeValue;
+  if (GlobalValue::GetValueByNameFailSafe ("SimulatorImplementationType", simulationTypeValue)
+      && simulationTypeValue.Get () != "ns3::DistributedSimulatorImpl")
+    {
+      NS_LOG_WARN ("The shared memory interface only supports the granted time window algorithm; setting type to ns3::DistributedSimulatorImpl");
+    }
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue ("ns3::DistributedSimulatorImpl"));
+  g_parallelCommunicationInterface = new SharedMemoryInterface (size);
+  g_parallelCommunicationInterface->Enable (0, 0);
+}
+
 void
 MpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t node, uint32_t dev)
 {
@@ -80,6 +80,17 @@ public:
    * Enable is invoked.
    */
   static void Enable (int* pargc, char*** pargv);
+  /**
+   * \param size number of parallel tasks
+   *
+   * \brief Sets up a shared memory communication interface, for
+   * running the distributed simulator on a single host without MPI.
+   *
+   * The calling process forks \pname{size} - 1 copies of itself, one
+   * per task; each returns from this call with its own system id.
+   * SimulatorImplementationType is set to ns3::DistributedSimulatorImpl.
+   */
+  static void EnableSharedMemory (uint32_t size);
   /**
    * Terminates the parallel environment.
    * This function must be called after Destroy ()
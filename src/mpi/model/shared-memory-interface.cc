@@ -0,0 +1,387 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "shared-memory-interface.h"
+#include "mpi-receiver.h"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SharedMemoryInterface");
+
+/*
+ * Layout of the shared memory region:
+ *
+ *   offset 0                  barrier count
+ *   offset CACHE_LINE         barrier sense
+ *   offset 2 * CACHE_LINE     int64_t reduce[size]
+ *   then                      gather[size][GATHER_SLOT_SIZE]
+ *   then                      rings[size * size]
+ *
+ * Each ring is made of the consumer index (head) and the producer
+ * index (tail), each on its own cache line, followed by RING_SIZE
+ * bytes of records.  A record is a uint32_t payload length, padding
+ * up to 8 bytes, and the payload (rx time, node, device, serialized
+ * packet), the whole being rounded up to 8 bytes.  A length of
+ * RING_WRAP tells the consumer to skip to the start of the ring.
+ */
+namespace {
+const uint32_t CACHE_LINE = 64;         //!< Alignment of the shared variables
+const uint32_t RING_HEADER = 2 * CACHE_LINE; //!< Size of the ring indexes
+const uint32_t RECORD_HEADER = 8;       //!< Size of the record length field
+const uint32_t RECORD_META = 16;        //!< Size of rx time, node and device
+const uint32_t RING_WRAP = 0xffffffff;  //!< Marker for the end of the ring
+
+/**
+ * \param [in] n A size.
+ * \param [in] align A power of two.
+ * \returns \pname{n} rounded up to a multiple of \pname{align}.
+ */
+inline uint64_t
+Align (uint64_t n, uint64_t align)
+{
+  return (n + align - 1) & ~(align - 1);
+}
+
+/**
+ * \param [in] size The number of tasks.
+ * \returns The offset of the first ring in the shared region.
+ */
+inline uint64_t
+GetRingsOffset (uint32_t size)
+{
+  uint64_t offset = 2 * CACHE_LINE + size * sizeof (int64_t);
+  offset = Align (offset, CACHE_LINE);
+  offset += size * SharedMemoryInterface::GATHER_SLOT_SIZE;
+  return Align (offset, CACHE_LINE);
+}
+} // unnamed namespace
+
+uint32_t         SharedMemoryInterface::m_sid = 0;
+uint32_t         SharedMemoryInterface::m_size = 1;
+bool             SharedMemoryInterface::m_enabled = false;
+uint32_t         SharedMemoryInterface::m_rxCount = 0;
+uint32_t         SharedMemoryInterface::m_txCount = 0;
+uint8_t*         SharedMemoryInterface::m_region = 0;
+uint64_t         SharedMemoryInterface::m_regionSize = 0;
+uint32_t         SharedMemoryInterface::m_localSense = 0;
+std::vector<int> SharedMemoryInterface::m_children;
+
+SharedMemoryInterface::SharedMemoryInterface (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (size >= 1);
+  m_size = size;
+}
+
+void
+SharedMemoryInterface::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+SharedMemoryInterface::GetSystemId ()
+{
+  return m_sid;
+}
+
+uint32_t
+SharedMemoryInterface::GetSize ()
+{
+  return m_size;
+}
+
+bool
+SharedMemoryInterface::IsEnabled ()
+{
+  return m_enabled;
+}
+
+bool
+SharedMemoryInterface::IsActive ()
+{
+  return m_enabled;
+}
+
+uint32_t
+SharedMemoryInterface::GetRxCount ()
+{
+  return m_rxCount;
+}
+
+uint32_t
+SharedMemoryInterface::GetTxCount ()
+{
+  return m_txCount;
+}
+
+uint8_t *
+SharedMemoryInterface::GetRing (uint32_t src, uint32_t dst)
+{
+  uint64_t ring = src * m_size + dst;
+  return m_region + GetRingsOffset (m_size) + ring * (RING_HEADER + RING_SIZE);
+}
+
+void
+SharedMemoryInterface::Enable (int* pargc, char*** pargv)
+{
+  NS_LOG_FUNCTION (this << pargc << pargv);
+  NS_ASSERT (!m_enabled);
+
+  m_regionSize = GetRingsOffset (m_size)
+    + static_cast<uint64_t> (m_size) * m_size * (RING_HEADER + RING_SIZE);
+  // Anonymous shared pages are only backed once touched, so unused
+  // rings cost address space only.
+  void *region = mmap (0, m_regionSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (region == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("Cannot map " << m_regionSize << " bytes of shared memory: "
+                      << std::strerror (errno));
+    }
+  m_region = static_cast<uint8_t *> (region);
+  m_sid = 0;
+  m_localSense = 0;
+  m_children.clear ();
+
+  for (uint32_t task = 1; task < m_size; ++task)
+    {
+      // Do not let the children print the output buffered so far again.
+      std::cout.flush ();
+      std::cerr.flush ();
+      std::fflush (0);
+      pid_t pid = fork ();
+      if (pid == -1)
+        {
+          NS_FATAL_ERROR ("Cannot fork task " << task << ": " << std::strerror (errno));
+        }
+      if (pid == 0)
+        {
+          m_sid = task;
+          m_children.clear ();
+          break;
+        }
+      m_children.push_back (pid);
+    }
+  m_enabled = true;
+}
+
+void
+SharedMemoryInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
+  NS_ASSERT (m_enabled);
+
+  uint32_t serializedSize = p->GetSerializedSize ();
+  uint32_t length = RECORD_META + serializedSize;
+  uint64_t recordSize = Align (RECORD_HEADER + length, 8);
+  NS_ABORT_MSG_IF (recordSize > RING_SIZE / 2, "Packet too large for the shared memory ring");
+
+  uint32_t dst = NodeList::GetNode (node)->GetSystemId ();
+  uint8_t *ring = GetRing (m_sid, dst);
+  uint64_t *head = reinterpret_cast<uint64_t *> (ring);
+  uint64_t *tail = reinterpret_cast<uint64_t *> (ring + CACHE_LINE);
+  uint8_t *data = ring + RING_HEADER;
+
+  uint64_t t = *tail; // only this task writes it
+  uint64_t pos = t % RING_SIZE;
+  uint64_t contiguous = RING_SIZE - pos;
+  uint64_t needed = contiguous < recordSize ? contiguous + recordSize : recordSize;
+
+  // Back pressure: wait for the receiver to make room, draining our
+  // own rings meanwhile so that two tasks sending to each other
+  // cannot deadlock.
+  while (RING_SIZE - (t - __atomic_load_n (head, __ATOMIC_ACQUIRE)) < needed)
+    {
+      ReceiveMessages ();
+      sched_yield ();
+    }
+
+  if (contiguous < recordSize)
+    {
+      *reinterpret_cast<uint32_t *> (data + pos) = RING_WRAP;
+      t += contiguous;
+      pos = 0;
+    }
+  uint8_t *record = data + pos;
+  *reinterpret_cast<uint32_t *> (record) = length;
+  uint8_t *payload = record + RECORD_HEADER;
+  *reinterpret_cast<uint64_t *> (payload) = rxTime.GetInteger ();
+  *reinterpret_cast<uint32_t *> (payload + 8) = node;
+  *reinterpret_cast<uint32_t *> (payload + 12) = dev;
+  p->Serialize (payload + RECORD_META, serializedSize);
+
+  __atomic_store_n (tail, t + recordSize, __ATOMIC_RELEASE);
+  m_txCount++;
+}
+
+void
+SharedMemoryInterface::ReceiveMessages ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  for (uint32_t src = 0; src < m_size; ++src)
+    {
+      if (src == m_sid)
+        {
+          continue;
+        }
+      uint8_t *ring = GetRing (src, m_sid);
+      uint64_t *head = reinterpret_cast<uint64_t *> (ring);
+      uint64_t *tail = reinterpret_cast<uint64_t *> (ring + CACHE_LINE);
+      uint8_t *data = ring + RING_HEADER;
+
+      uint64_t h = *head; // only this task writes it
+      uint64_t end = __atomic_load_n (tail, __ATOMIC_ACQUIRE);
+      while (h != end)
+        {
+          uint64_t pos = h % RING_SIZE;
+          uint32_t length = *reinterpret_cast<uint32_t *> (data + pos);
+          if (length == RING_WRAP)
+            {
+              h += RING_SIZE - pos;
+              continue;
+            }
+          uint8_t *payload = data + pos + RECORD_HEADER;
+          Time rxTime (*reinterpret_cast<uint64_t *> (payload));
+          uint32_t node = *reinterpret_cast<uint32_t *> (payload + 8);
+          uint32_t dev = *reinterpret_cast<uint32_t *> (payload + 12);
+          Ptr<Packet> p = Create<Packet> (payload + RECORD_META, length - RECORD_META, true);
+          h += Align (RECORD_HEADER + length, 8);
+          // Hand the slot back before scheduling, the packet owns a copy.
+          __atomic_store_n (head, h, __ATOMIC_RELEASE);
+          m_rxCount++;
+
+          // Find the correct node/device to schedule receive event
+          Ptr<Node> pNode = NodeList::GetNode (node);
+          Ptr<MpiReceiver> pMpiRec = 0;
+          uint32_t nDevices = pNode->GetNDevices ();
+          for (uint32_t i = 0; i < nDevices; ++i)
+            {
+              Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
+              if (pThisDev->GetIfIndex () == dev)
+                {
+                  pMpiRec = pThisDev->GetObject<MpiReceiver> ();
+                  break;
+                }
+            }
+          NS_ASSERT (pNode && pMpiRec);
+
+          Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
+                                          &MpiReceiver::Receive, pMpiRec, p);
+        }
+      __atomic_store_n (head, h, __ATOMIC_RELEASE);
+    }
+}
+
+void
+SharedMemoryInterface::Barrier ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  uint32_t *count = reinterpret_cast<uint32_t *> (m_region);
+  uint32_t *sense = reinterpret_cast<uint32_t *> (m_region + CACHE_LINE);
+  m_localSense ^= 1;
+  if (__atomic_add_fetch (count, 1, __ATOMIC_ACQ_REL) == m_size)
+    {
+      __atomic_store_n (count, 0, __ATOMIC_RELAXED);
+      __atomic_store_n (sense, m_localSense, __ATOMIC_RELEASE);
+      return;
+    }
+  while (__atomic_load_n (sense, __ATOMIC_ACQUIRE) != m_localSense)
+    {
+      // A task blocked on a full ring towards us cannot reach the
+      // barrier until we drain it.
+      ReceiveMessages ();
+      sched_yield ();
+    }
+}
+
+void
+SharedMemoryInterface::AllGather (const void *send, void *recv, uint32_t size)
+{
+  NS_LOG_FUNCTION (send << recv << size);
+  NS_ASSERT (size <= GATHER_SLOT_SIZE);
+  uint8_t *gather = m_region + Align (2 * CACHE_LINE + m_size * sizeof (int64_t), CACHE_LINE);
+  std::memcpy (gather + m_sid * GATHER_SLOT_SIZE, send, size);
+  Barrier ();
+  for (uint32_t i = 0; i < m_size; ++i)
+    {
+      std::memcpy (static_cast<uint8_t *> (recv) + i * size, gather + i * GATHER_SLOT_SIZE, size);
+    }
+  // Nobody may overwrite its slot before everybody has read it.
+  Barrier ();
+}
+
+int64_t
+SharedMemoryInterface::AllReduceMax (int64_t value)
+{
+  NS_LOG_FUNCTION (value);
+  int64_t *reduce = reinterpret_cast<int64_t *> (m_region + 2 * CACHE_LINE);
+  reduce[m_sid] = value;
+  Barrier ();
+  int64_t result = reduce[0];
+  for (uint32_t i = 1; i < m_size; ++i)
+    {
+      if (reduce[i] > result)
+        {
+          result = reduce[i];
+        }
+    }
+  Barrier ();
+  return result;
+}
+
+void
+SharedMemoryInterface::Disable ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (!m_enabled)
+    {
+      NS_FATAL_ERROR ("Cannot disable the shared memory interface without enabling it first");
+    }
+  Barrier ();
+  for (std::vector<int>::const_iterator i = m_children.begin (); i != m_children.end (); ++i)
+    {
+      int status;
+      while (waitpid (*i, &status, 0) == -1 && errno == EINTR)
+        {
+        }
+    }
+  m_children.clear ();
+  munmap (m_region, m_regionSize);
+  m_region = 0;
+  m_enabled = false;
+}
+
+} // namespace ns3
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef NS3_SHARED_MEMORY_INTERFACE_H
+#define NS3_SHARED_MEMORY_INTERFACE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+
+#include "parallel-communication-interface.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Parallel communication interface for tasks running on one host.
+ *
+ * This interface lets the DistributedSimulatorImpl (granted time window)
+ * run without an MPI installation when all the tasks are on the same
+ * machine.  Enable forks the tasks from the calling process, after
+ * creating an anonymous shared memory region which holds:
+ *
+ *   - one lock-free single producer, single consumer ring per ordered
+ *     pair of tasks; packets are serialized straight into the ring
+ *     of the destination task, and
+ *   - the buffers and the sense-reversing barrier used for the
+ *     AllGather and AllReduceMax collectives of the synchronization
+ *     algorithm.
+ *
+ * The calling process becomes task 0.  Since the tasks do not share
+ * an address space, packets still have to be serialized once, but the
+ * extra copies and the MPI progress engine are avoided.
+ *
+ * Use MpiInterface::EnableSharedMemory to select this interface.  The
+ * NullMessageSimulatorImpl is not supported.
+ */
+class SharedMemoryInterface : public ParallelCommunicationInterface
+{
+public:
+  /**
+   * \param size The number of tasks to run.
+   */
+  SharedMemoryInterface (uint32_t size);
+
+  virtual void Destroy ();
+  virtual uint32_t GetSystemId ();
+  virtual uint32_t GetSize ();
+  virtual bool IsEnabled ();
+  virtual void Enable (int* pargc, char*** pargv);
+  virtual void Disable ();
+  virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+
+  /**
+   * \returns true if the shared memory interface is the one in use.
+   */
+  static bool IsActive ();
+  /**
+   * Poll the rings of this task and schedule the packets received.
+   */
+  static void ReceiveMessages ();
+  /**
+   * \returns the number of packets received by this task.
+   */
+  static uint32_t GetRxCount ();
+  /**
+   * \returns the number of packets sent by this task.
+   */
+  static uint32_t GetTxCount ();
+  /**
+   * Gather a fixed size record from every task.
+   *
+   * \param [in] send The record of this task.
+   * \param [out] recv The records of all the tasks, in task order.
+   * \param [in] size The size of one record, at most GATHER_SLOT_SIZE.
+   */
+  static void AllGather (const void *send, void *recv, uint32_t size);
+  /**
+   * \param [in] value The value contributed by this task.
+   * \returns the maximum of the values contributed by all the tasks.
+   */
+  static int64_t AllReduceMax (int64_t value);
+
+  /** Maximum size of a record exchanged with AllGather. */
+  static const uint32_t GATHER_SLOT_SIZE = 128;
+  /** Capacity, in bytes, of each inter-task ring. */
+  static const uint32_t RING_SIZE = 512 * 1024;
+
+private:
+  /** Wait until all the tasks have reached the barrier. */
+  static void Barrier ();
+  /**
+   * \param [in] src The sending task.
+   * \param [in] dst The receiving task.
+   * \returns the ring from \pname{src} to \pname{dst}.
+   */
+  static uint8_t *GetRing (uint32_t src, uint32_t dst);
+
+  static uint32_t m_sid;          //!< This task
+  static uint32_t m_size;         //!< Number of tasks
+  static bool     m_enabled;      //!< Whether the tasks have been started
+  static uint32_t m_rxCount;      //!< Packets received by this task
+  static uint32_t m_txCount;      //!< Packets sent by this task
+  static uint8_t *m_region;       //!< The shared memory region
+  static uint64_t m_regionSize;   //!< Size of the shared memory region
+  static uint32_t m_localSense;   //!< Barrier sense of this task
+  static std::vector<int> m_children; //!< Process ids of the other tasks, in task 0
+};
+
+} // namespace ns3
+
+#endif /* NS3_SHARED_MEMORY_INTERFACE_H */
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/shared-memory-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+
+#include <unistd.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup mpi
+ * \brief Check the collectives of the SharedMemoryInterface
+ *
+ * The tasks are forked by the test.  The tasks other than 0 can't
+ * report failures to the test framework, so each task counts the
+ * checks it failed, and task 0 collects the counts with AllReduceMax
+ * before the children exit.
+ */
+class SharedMemoryCollectivesTestCase : public TestCase
+{
+public:
+  SharedMemoryCollectivesTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Record exchanged with AllGather
+  struct Record
+  {
+    uint32_t systemId; //!< the task sending the record
+    int64_t value;     //!< a value depending on the task
+  };
+};
+
+SharedMemoryCollectivesTestCase::SharedMemoryCollectivesTestCase ()
+  : TestCase ("AllGather and AllReduceMax over forked tasks")
+{
+}
+
+void
+SharedMemoryCollectivesTestCase::DoRun (void)
+{
+  const uint32_t size = 3;
+  MpiInterface::EnableSharedMemory (size);
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  int64_t failures = 0;
+
+  if (MpiInterface::GetSize () != size || !SharedMemoryInterface::IsActive ())
+    {
+      failures++;
+    }
+
+  // several rounds, to reuse the gather slots and the barrier
+  for (uint32_t round = 0; round < 3; round++)
+    {
+      Record send;
+      send.systemId = systemId;
+      send.value = -1000 * static_cast<int64_t> (round) + systemId;
+      Record recv[size];
+      SharedMemoryInterface::AllGather (&send, recv, sizeof (Record));
+      for (uint32_t i = 0; i < size; i++)
+        {
+          if (recv[i].systemId != i
+              || recv[i].value != -1000 * static_cast<int64_t> (round) + i)
+            {
+              failures++;
+            }
+        }
+
+      // the maximum is contributed by a different task in each round
+      int64_t value = (systemId == round) ? 7 : -5 - static_cast<int64_t> (systemId);
+      if (SharedMemoryInterface::AllReduceMax (value) != 7)
+        {
+          failures++;
+        }
+    }
+
+  int64_t maxFailures = SharedMemoryInterface::AllReduceMax (failures);
+  MpiInterface::Disable ();
+  if (systemId != 0)
+    {
+      // the forked tasks must not run the rest of the test runner
+      _exit (0);
+    }
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+
+  NS_TEST_EXPECT_MSG_EQ (failures, 0, "Wrong collectives in task 0");
+  NS_TEST_EXPECT_MSG_EQ (maxFailures, 0, "Wrong collectives in another task");
+  NS_TEST_EXPECT_MSG_EQ (MpiInterface::IsEnabled (), false, "Interface still enabled");
+}
+
+/**
+ * \ingroup mpi
+ * \brief Test suite for the SharedMemoryInterface
+ */
+class SharedMemoryInterfaceTestSuite : public TestSuite
+{
+public:
+  SharedMemoryInterfaceTestSuite ();
+};
+
+SharedMemoryInterfaceTestSuite::SharedMemoryInterfaceTestSuite ()
+  : TestSuite ("mpi-shared-memory", UNIT)
+{
+  AddTestCase (new SharedMemoryCollectivesTestCase, TestCase::QUICK);
+}
+
+static SharedMemoryInterfaceTestSuite g_sharedMemoryInterfaceTestSuite;
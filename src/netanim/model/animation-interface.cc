@@ -50,6 +50,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/energy-source-container.h"
+#include "ns3/binary-trace-helper.h"
 
 namespace ns3 {
 
@@ -78,7 +79,16 @@ AnimationInterface::AnimationInterface (const std::string fn)
     m_routingStopTime (Seconds (0)), 
     m_routingFileName (""),
     m_routingPollInterval (Seconds (5)), 
-    m_trackPackets (true)
+    m_trackPackets (true),
+    m_packetSampling (1),
+    m_mobilityThreshold (0),
+    m_linkSummaryInterval (Seconds (0)),
+    m_binaryContext (0),
+    m_binaryP (0),
+    m_binaryPRef (0),
+    m_binaryWpr (0),
+    m_binaryLs (0),
+    m_binaryNu (0)
 {
   initialized = true;
   StartAnimation ();
@@ -252,6 +262,85 @@ AnimationInterface::EnablePacketMetadata (bool enable)
      }
 }
 
+void
+AnimationInterface::SetPacketSampling (uint32_t oneInN)
+{
+  m_packetSampling = oneInN;
+}
+
+void
+AnimationInterface::EnableLinkSummaries (Time interval)
+{
+  NS_ASSERT (interval.IsStrictlyPositive ());
+  m_linkSummaryInterval = interval;
+}
+
+void
+AnimationInterface::SetMobilityThreshold (double distance)
+{
+  m_mobilityThreshold = distance;
+}
+
+void
+AnimationInterface::EnableBinaryOutput (std::string fileName)
+{
+  NS_ASSERT_MSG (!m_binary, "EnableBinaryOutput already used once");
+  m_binary = CreateObject<BinaryTraceRecorder> ();
+  BinaryTraceFormat::Field p[] = {
+    { "fId", BinaryTraceFormat::UINT32 },
+    { "tId", BinaryTraceFormat::UINT32 },
+    { "fbTx", BinaryTraceFormat::DOUBLE },
+    { "lbTx", BinaryTraceFormat::DOUBLE },
+    { "fbRx", BinaryTraceFormat::DOUBLE },
+    { "lbRx", BinaryTraceFormat::DOUBLE }
+  };
+  BinaryTraceFormat::Field pr[] = {
+    { "uId", BinaryTraceFormat::UINT64 },
+    { "fId", BinaryTraceFormat::UINT32 },
+    { "fbTx", BinaryTraceFormat::DOUBLE }
+  };
+  BinaryTraceFormat::Field wpr[] = {
+    { "uId", BinaryTraceFormat::UINT64 },
+    { "tId", BinaryTraceFormat::UINT32 },
+    { "fbRx", BinaryTraceFormat::DOUBLE },
+    { "lbRx", BinaryTraceFormat::DOUBLE }
+  };
+  BinaryTraceFormat::Field ls[] = {
+    { "fId", BinaryTraceFormat::UINT32 },
+    { "tId", BinaryTraceFormat::UINT32 },
+    { "start", BinaryTraceFormat::TIME },
+    { "duration", BinaryTraceFormat::TIME },
+    { "n", BinaryTraceFormat::UINT32 },
+    { "b", BinaryTraceFormat::UINT64 }
+  };
+  BinaryTraceFormat::Field nu[] = {
+    { "id", BinaryTraceFormat::UINT32 },
+    { "x", BinaryTraceFormat::DOUBLE },
+    { "y", BinaryTraceFormat::DOUBLE }
+  };
+  BinaryTraceFormat::Schema schema;
+  schema.name = "anim.p";
+  schema.fields.assign (p, p + sizeof (p) / sizeof (p[0]));
+  m_binaryP = m_binary->AddSchema (schema);
+  schema.name = "anim.pr";
+  schema.fields.assign (pr, pr + sizeof (pr) / sizeof (pr[0]));
+  m_binaryPRef = m_binary->AddSchema (schema);
+  schema.name = "anim.wpr";
+  schema.fields.assign (wpr, wpr + sizeof (wpr) / sizeof (wpr[0]));
+  m_binaryWpr = m_binary->AddSchema (schema);
+  schema.name = "anim.ls";
+  schema.fields.assign (ls, ls + sizeof (ls) / sizeof (ls[0]));
+  m_binaryLs = m_binary->AddSchema (schema);
+  schema.name = "anim.nu";
+  schema.fields.assign (nu, nu + sizeof (nu) / sizeof (nu[0]));
+  m_binaryNu = m_binary->AddSchema (schema);
+  m_binaryContext = m_binary->AddContext (m_outputFileName);
+  if (!m_binary->Open (fileName))
+    {
+      NS_FATAL_ERROR ("Unable to open output file:" << fileName.c_str ());
+    }
+}
+
 bool 
 AnimationInterface::IsInitialized ()
 {
@@ -411,6 +500,10 @@ AnimationInterface::MobilityCourseChangeTrace (Ptr <const MobilityModel> mobilit
     {
       v = mobility->GetPosition ();
     }
+  if (m_mobilityThreshold > 0 && !NodeHasMoved (n, v))
+    {
+      return;
+    }
   UpdatePosition (n, v);
   WriteXmlUpdateNodePosition (n->GetId (), v.x, v.y);
 }
@@ -418,6 +511,19 @@ AnimationInterface::MobilityCourseChangeTrace (Ptr <const MobilityModel> mobilit
 bool 
 AnimationInterface::NodeHasMoved (Ptr <Node> n, Vector newLocation)
 {
+  if (m_mobilityThreshold > 0)
+    {
+      // Compare with the last position written rather than the last one
+      // seen, so that slow movements add up to an update
+      std::map <uint32_t, Vector>::const_iterator it = m_writtenLocation.find (n->GetId ());
+      if (it == m_writtenLocation.end ())
+        {
+          return true;
+        }
+      double dx = newLocation.x - it->second.x;
+      double dy = newLocation.y - it->second.y;
+      return dx * dx + dy * dy >= m_mobilityThreshold * m_mobilityThreshold;
+    }
   Vector oldLocation = GetPosition (n);
   if ((ceil (oldLocation.x) == ceil (newLocation.x)) &&
     (ceil (oldLocation.y) == ceil (newLocation.y)))
@@ -750,6 +856,11 @@ AnimationInterface::DevTxTrace (std::string context,
   double lbTx = (now + txTime).GetSeconds ();
   double fbRx = (now + rxTime - txTime).GetSeconds ();
   double lbRx = (now + rxTime).GetSeconds ();
+  CountLinkPacket (tx->GetNode ()->GetId (), rx->GetNode ()->GetId (), p->GetSize ());
+  if (!IsPacketSampled (p->GetUid ()))
+    {
+      return;
+    }
   CheckMaxPktsPerTraceFile ();
   WriteXmlP ("p", 
              tx->GetNode ()->GetId (), 
@@ -1076,6 +1187,7 @@ AnimationInterface::CsmaPhyRxEndTrace (std::string context, Ptr<const Packet> p)
   AnimPacketInfo& pktInfo = m_pendingCsmaPackets[animUid];
   UpdatePosition (n);
   pktInfo.ProcessRxBegin (ndev, Simulator::Now ().GetSeconds ());
+  CountLinkPacket (pktInfo.m_txnd->GetNode ()->GetId (), n->GetId (), p->GetSize ());
   NS_LOG_INFO ("CsmaPhyRxEndTrace for packet:" << animUid);
   NS_LOG_INFO ("CsmaPhyRxEndTrace for packet:" << animUid << " complete");
   OutputCsmaPacket (p, pktInfo);
@@ -1107,6 +1219,10 @@ AnimationInterface::CsmaMacRxTrace (std::string context,
 void
 AnimationInterface::OutputWirelessPacketTxInfo (Ptr<const Packet> p, AnimPacketInfo &pktInfo, uint64_t animUid)
 {
+  if (!IsPacketSampled (animUid))
+    {
+      return;
+    }
   CheckMaxPktsPerTraceFile ();
   uint32_t nodeId = 0;
   if (pktInfo.m_txnd)
@@ -1120,14 +1236,24 @@ AnimationInterface::OutputWirelessPacketTxInfo (Ptr<const Packet> p, AnimPacketI
 void 
 AnimationInterface::OutputWirelessPacketRxInfo (Ptr<const Packet> p, AnimPacketInfo & pktInfo, uint64_t animUid)
 {
-  CheckMaxPktsPerTraceFile ();
   uint32_t rxId = pktInfo.m_rxnd->GetNode ()->GetId ();
+  CountLinkPacket (pktInfo.m_txnd ? pktInfo.m_txnd->GetNode ()->GetId () : pktInfo.m_txNodeId,
+                   rxId, p->GetSize ());
+  if (!IsPacketSampled (animUid))
+    {
+      return;
+    }
+  CheckMaxPktsPerTraceFile ();
   WriteXmlP (animUid, "wpr", rxId, pktInfo.m_fbRx, pktInfo.m_lbRx);
 }
 
 void 
 AnimationInterface::OutputCsmaPacket (Ptr<const Packet> p, AnimPacketInfo &pktInfo)
 {
+  if (!IsPacketSampled (p->GetUid ()))
+    {
+      return;
+    }
   CheckMaxPktsPerTraceFile ();
   NS_ASSERT (pktInfo.m_txnd);
   uint32_t nodeId = pktInfo.m_txnd->GetNode ()->GetId ();
@@ -1266,6 +1392,8 @@ AnimationInterface::StopAnimation (bool onlyAnimation)
 {
   m_started = false;
   NS_LOG_INFO ("Stopping Animation");
+  // The last window may be shorter than the interval
+  WriteLinkSummaries ();
   ResetAnimWriteCallback ();
   if (m_f) 
     {
@@ -1278,6 +1406,11 @@ AnimationInterface::StopAnimation (bool onlyAnimation)
     {
       return;
     }
+  if (m_binary)
+    {
+      m_binary->Close ();
+      m_binary = 0;
+    }
   if (m_routingF)
     {
       WriteXmlClose ("anim", true);
@@ -1706,7 +1839,7 @@ AnimationInterface::CheckMaxPktsPerTraceFile ()
 {
   // Start a new trace file if the current packet count exceeded nax packets per file
   ++m_currentPktCount;
-  if (m_currentPktCount <= m_maxPktsPerFile)
+  if (m_currentPktCount <= m_maxPktsPerFile || m_binary)
     {
       return;
     }
@@ -1714,6 +1847,48 @@ AnimationInterface::CheckMaxPktsPerTraceFile ()
   StopAnimation (true);
 }
 
+bool
+AnimationInterface::IsPacketSampled (uint64_t id) const
+{
+  return m_packetSampling != 0 && id % m_packetSampling == 0;
+}
+
+void
+AnimationInterface::CountLinkPacket (uint32_t fromId, uint32_t toId, uint32_t bytes)
+{
+  if (m_linkSummaryInterval.IsZero ())
+    {
+      return;
+    }
+  if (m_linkSummaries.empty ())
+    {
+      // Windows are aligned on multiples of the interval, and only
+      // scheduled while packets are seen
+      int64_t interval = m_linkSummaryInterval.GetTimeStep ();
+      int64_t now = Simulator::Now ().GetTimeStep ();
+      m_linkSummaryEnd = TimeStep ((now / interval + 1) * interval);
+      Simulator::Schedule (m_linkSummaryEnd - Simulator::Now (), &AnimationInterface::WriteLinkSummaries, this);
+    }
+  LinkSummary &summary = m_linkSummaries[std::make_pair (fromId, toId)];
+  summary.packets++;
+  summary.bytes += bytes;
+}
+
+void
+AnimationInterface::WriteLinkSummaries ()
+{
+  if (m_linkSummaries.empty ())
+    {
+      return;
+    }
+  Time start = m_linkSummaryEnd - m_linkSummaryInterval;
+  for (LinkSummaryMap::const_iterator i = m_linkSummaries.begin (); i != m_linkSummaries.end (); ++i)
+    {
+      WriteXmlLinkSummary (i->first.first, i->first.second, start, m_linkSummaryInterval, i->second);
+    }
+  m_linkSummaries.clear ();
+}
+
 std::string 
 AnimationInterface::GetNetAnimVersion ()
 {
@@ -2086,6 +2261,7 @@ AnimationInterface::WriteXmlClose (std::string name, bool routing)
 void 
 AnimationInterface::WriteXmlNode (uint32_t id, uint32_t sysId, double locX, double locY)
 {
+  m_writtenLocation[id] = Vector (locX, locY, 0);
   AnimXmlElement element ("node");
   element.AddAttribute ("id", id);
   element.AddAttribute ("sysId", sysId);
@@ -2178,6 +2354,15 @@ AnimationInterface::WriteXmlRp (uint32_t nodeId, std::string destination, Ipv4Ro
 void 
 AnimationInterface::WriteXmlPRef (uint64_t animUid, uint32_t fId, double fbTx, std::string metaInfo)
 {
+  if (m_binary)
+    {
+      uint8_t *r = m_binary->Reserve (m_binaryPRef, m_binaryContext);
+      r = BinaryTraceField<uint64_t>::Write (r, animUid);
+      r = BinaryTraceField<uint32_t>::Write (r, fId);
+      BinaryTraceField<double>::Write (r, fbTx);
+      m_binary->Commit ();
+      return;
+    }
   AnimXmlElement element ("pr");
   element.AddAttribute ("uId", animUid);
   element.AddAttribute ("fId", fId);
@@ -2193,6 +2378,16 @@ AnimationInterface::WriteXmlPRef (uint64_t animUid, uint32_t fId, double fbTx, s
 void 
 AnimationInterface::WriteXmlP (uint64_t animUid, std::string pktType, uint32_t tId, double fbRx, double lbRx)
 {
+  if (m_binary)
+    {
+      uint8_t *r = m_binary->Reserve (m_binaryWpr, m_binaryContext);
+      r = BinaryTraceField<uint64_t>::Write (r, animUid);
+      r = BinaryTraceField<uint32_t>::Write (r, tId);
+      r = BinaryTraceField<double>::Write (r, fbRx);
+      BinaryTraceField<double>::Write (r, lbRx);
+      m_binary->Commit ();
+      return;
+    }
   AnimXmlElement element (pktType);
   element.AddAttribute ("uId", animUid);
   element.AddAttribute ("tId", tId);
@@ -2206,6 +2401,18 @@ void
 AnimationInterface::WriteXmlP (std::string pktType, uint32_t fId, double fbTx, double lbTx, 
                                                    uint32_t tId, double fbRx, double lbRx, std::string metaInfo)
 {
+  if (m_binary)
+    {
+      uint8_t *r = m_binary->Reserve (m_binaryP, m_binaryContext);
+      r = BinaryTraceField<uint32_t>::Write (r, fId);
+      r = BinaryTraceField<uint32_t>::Write (r, tId);
+      r = BinaryTraceField<double>::Write (r, fbTx);
+      r = BinaryTraceField<double>::Write (r, lbTx);
+      r = BinaryTraceField<double>::Write (r, fbRx);
+      BinaryTraceField<double>::Write (r, lbRx);
+      m_binary->Commit ();
+      return;
+    }
   AnimXmlElement element (pktType);
   element.AddAttribute ("fId", fId);
   element.AddAttribute ("fbTx", fbTx);
@@ -2221,6 +2428,32 @@ AnimationInterface::WriteXmlP (std::string pktType, uint32_t fId, double fbTx, d
   WriteN (element.GetElementString (),  m_f);
 }
 
+void
+AnimationInterface::WriteXmlLinkSummary (uint32_t fId, uint32_t tId, Time start, Time duration, LinkSummary summary)
+{
+  if (m_binary)
+    {
+      uint8_t *r = m_binary->Reserve (m_binaryLs, m_binaryContext);
+      r = BinaryTraceField<uint32_t>::Write (r, fId);
+      r = BinaryTraceField<uint32_t>::Write (r, tId);
+      r = BinaryTraceField<Time>::Write (r, start);
+      r = BinaryTraceField<Time>::Write (r, duration);
+      r = BinaryTraceField<uint32_t>::Write (r, summary.packets);
+      BinaryTraceField<uint64_t>::Write (r, summary.bytes);
+      m_binary->Commit ();
+      return;
+    }
+  AnimXmlElement element ("ls");
+  element.AddAttribute ("fId", fId);
+  element.AddAttribute ("tId", tId);
+  element.AddAttribute ("t", start.GetSeconds ());
+  element.AddAttribute ("d", duration.GetSeconds ());
+  element.AddAttribute ("n", summary.packets);
+  element.AddAttribute ("b", summary.bytes);
+  element.CloseElement ();
+  WriteN (element.GetElementString (), m_f);
+}
+
 void 
 AnimationInterface::WriteXmlAddNodeCounter (uint32_t nodeCounterId, std::string counterName, CounterType counterType)
 {
@@ -2270,6 +2503,19 @@ AnimationInterface::WriteXmlUpdateNodeSize (uint32_t nodeId, double width, doubl
 void 
 AnimationInterface::WriteXmlUpdateNodePosition (uint32_t nodeId, double x, double y)
 {
+  if (m_mobilityThreshold > 0)
+    {
+      m_writtenLocation[nodeId] = Vector (x, y, 0);
+    }
+  if (m_binary)
+    {
+      uint8_t *r = m_binary->Reserve (m_binaryNu, m_binaryContext);
+      r = BinaryTraceField<uint32_t>::Write (r, nodeId);
+      r = BinaryTraceField<double>::Write (r, x);
+      BinaryTraceField<double>::Write (r, y);
+      m_binary->Commit ();
+      return;
+    }
   AnimXmlElement element ("nu");
   element.AddAttribute ("p", "p");
   element.AddAttribute ("t", Simulator::Now ().GetSeconds ());
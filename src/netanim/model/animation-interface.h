@@ -43,6 +43,7 @@
 #include "ns3/rectangle.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-l3-protocol.h"
+#include "ns3/binary-trace.h"
 
 namespace ns3 {
 
@@ -384,6 +385,65 @@ public:
    */
   void EnablePacketMetadata (bool enable = true);
 
+  /**
+   *
+   * \brief Write only one packet in n to the trace file
+   * \param oneInN 1 writes every packet (the default), 0 writes no packet
+   *
+   * Wireless packets are chosen by their animation id, so that the
+   * transmission and the receptions of a packet are all written or all
+   * skipped.  The skipped packets are still counted by the link summaries.
+   *
+   * \returns none
+   */
+  void SetPacketSampling (uint32_t oneInN);
+
+  /**
+   *
+   * \brief Summarize the packets of each link per time window
+   * \param interval The length of the windows
+   *
+   * At the end of each window, one "ls" element is written for each
+   * (transmitter, receiver) node pair which carried packets during the
+   * window, with the number of packets (n) and bytes (b) received.
+   * Windows are aligned on multiples of the interval.  Combined with
+   * SetPacketSampling (0), the size of the trace file no longer grows
+   * with the number of packets.
+   *
+   * \returns none
+   */
+  void EnableLinkSummaries (Time interval);
+
+  /**
+   *
+   * \brief Write node positions only on significant movement
+   * \param distance The distance, in meters, a node must move from its
+   *        last written position before a new position is written
+   *
+   * Applies to both the course changes and the periodic mobility poll.
+   * The default, 0, writes every course change and every poll where the
+   * node moved to another 1 meter cell.
+   *
+   * \returns none
+   */
+  void SetMobilityThreshold (double distance);
+
+  /**
+   *
+   * \brief Write packets, link summaries and positions to a binary file
+   * \param fileName The binary trace file
+   *
+   * The XML trace file keeps the topology, descriptions and counters.
+   * The per-event elements are recorded instead by a BinaryTraceRecorder,
+   * one record per element, with schemas "anim.p" (fId, tId, fbTx, lbTx,
+   * fbRx, lbRx), "anim.pr" (uId, fId, fbTx), "anim.wpr" (uId, tId, fbRx,
+   * lbRx), "anim.ls" (fId, tId, start, duration, n, b) and "anim.nu"
+   * (id, x, y).  Use the binary-trace-decode utility to read it.
+   *
+   * \returns none
+   */
+  void EnableBinaryOutput (std::string fileName);
+
   /**
    *
    * \brief Get trace file packet count (This used only for testing)
@@ -510,6 +570,13 @@ private:
   typedef std::map <uint32_t, double> EnergyFractionMap;
   typedef std::vector <Ipv4RoutePathElement> Ipv4RoutePathElements;
 
+  typedef struct
+    {
+      uint32_t packets;
+      uint64_t bytes;
+    } LinkSummary;
+  typedef std::map <std::pair <uint32_t, uint32_t>, LinkSummary> LinkSummaryMap;
+
 
   // Node Counters
   typedef std::map <uint32_t, uint64_t> NodeCounterMap64;
@@ -563,6 +630,23 @@ private:
   Time m_wifiPhyCountersPollInterval;
   static Rectangle * userBoundary;
   bool m_trackPackets;
+  uint32_t m_packetSampling;
+  double m_mobilityThreshold;
+  std::map <uint32_t, Vector> m_writtenLocation; // Last position written, with a mobility threshold
+
+  // Link summaries
+  Time m_linkSummaryInterval;
+  Time m_linkSummaryEnd;
+  LinkSummaryMap m_linkSummaries;
+
+  // Binary output
+  Ptr<BinaryTraceRecorder> m_binary;
+  uint32_t m_binaryContext;
+  uint16_t m_binaryP;
+  uint16_t m_binaryPRef;
+  uint16_t m_binaryWpr;
+  uint16_t m_binaryLs;
+  uint16_t m_binaryNu;
 
   // Counter ID
   uint32_t m_remainingEnergyCounterId;
@@ -640,6 +724,9 @@ private:
   void AddToIpv4AddressNodeIdTable (std::string, uint32_t);
   bool IsInTimeWindow ();
   void CheckMaxPktsPerTraceFile ();
+  bool IsPacketSampled (uint64_t id) const;
+  void CountLinkPacket (uint32_t fromId, uint32_t toId, uint32_t bytes);
+  void WriteLinkSummaries ();
 
   void TrackWifiPhyCounters ();
   void TrackWifiMacCounters ();
@@ -774,6 +861,7 @@ private:
                                  std::string metaInfo = ""); 
   void WriteXmlP (uint64_t animUid, std::string pktType, uint32_t fId, double fbTx, double lbTx);
   void WriteXmlPRef (uint64_t animUid, uint32_t fId, double fbTx, std::string metaInfo = "");
+  void WriteXmlLinkSummary (uint32_t fId, uint32_t tId, Time start, Time duration, LinkSummary summary);
   void WriteXmlClose (std::string name, bool routing = false);
   void WriteXmlNonP2pLinkProperties (uint32_t id, std::string ipv4Address, std::string channelType);
   void WriteXmlRouting (uint32_t id, std::string routingInfo);
@@ -18,6 +18,8 @@
  */
 
 #include <iostream>
+#include <cstdio>
+#include <vector>
 #include "unistd.h"
 
 #include "ns3/core-module.h"
@@ -61,6 +63,9 @@ private:
   virtual void
   PrepareNetwork () = 0;
 
+  virtual void
+  ConfigureAnimation ();
+
   virtual void
   CheckLogic () = 0;
 
@@ -86,6 +91,7 @@ AbstractAnimationInterfaceTestCase::DoRun (void)
   PrepareNetwork ();
 
   m_anim = new AnimationInterface (m_traceFileName);
+  ConfigureAnimation ();
 
   Simulator::Run ();
   CheckLogic ();
@@ -93,6 +99,11 @@ AbstractAnimationInterfaceTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+void
+AbstractAnimationInterfaceTestCase::ConfigureAnimation ()
+{
+}
+
 void
 AbstractAnimationInterfaceTestCase::CheckFileExistence ()
 {
@@ -228,6 +239,112 @@ AnimationRemainingEnergyTestCase::CheckLogic (void)
                             "Wrong remaining energy value was traced");
 }
 
+class AnimationLinkSummaryTestCase : public AbstractAnimationInterfaceTestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  AnimationLinkSummaryTestCase ();
+
+private:
+
+  virtual void
+  PrepareNetwork ();
+
+  virtual void
+  ConfigureAnimation ();
+
+  virtual void
+  CheckLogic ();
+
+  static void
+  WriteCallback (const char * str);
+
+  static std::vector<std::string> m_summaries;
+};
+
+std::vector<std::string> AnimationLinkSummaryTestCase::m_summaries;
+
+AnimationLinkSummaryTestCase::AnimationLinkSummaryTestCase () :
+  AbstractAnimationInterfaceTestCase ("Verify link summaries without packets")
+{
+}
+
+void
+AnimationLinkSummaryTestCase::PrepareNetwork (void)
+{
+  m_nodes.Create (2);
+  AnimationInterface::SetConstantPosition (m_nodes.Get (0), 0 , 10);
+  AnimationInterface::SetConstantPosition (m_nodes.Get (1), 1 , 10);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (m_nodes);
+
+  InternetStackHelper stack;
+  stack.Install (m_nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  UdpEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (m_nodes.Get (1));
+  serverApps.Start (Seconds (1.0));
+  serverApps.Stop (Seconds (10.0));
+
+  UdpEchoClientHelper echoClient (interfaces.GetAddress (1), 9);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (100));
+  echoClient.SetAttribute ("Interval", TimeValue (Seconds (1.0)));
+  echoClient.SetAttribute ("PacketSize", UintegerValue (1024));
+  ApplicationContainer clientApps = echoClient.Install (m_nodes.Get (0));
+  clientApps.Start (Seconds (2.0));
+  clientApps.Stop (Seconds (10.0));
+}
+
+void
+AnimationLinkSummaryTestCase::ConfigureAnimation (void)
+{
+  m_summaries.clear ();
+  m_anim->SetAnimWriteCallback (&AnimationLinkSummaryTestCase::WriteCallback);
+  m_anim->SetPacketSampling (0);
+  m_anim->EnableLinkSummaries (Seconds (5));
+}
+
+void
+AnimationLinkSummaryTestCase::WriteCallback (const char * str)
+{
+  if (std::string (str).compare (0, 4, "<ls ") == 0)
+    {
+      m_summaries.push_back (str);
+    }
+}
+
+void
+AnimationLinkSummaryTestCase::CheckLogic (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_anim->GetTracePktCount (), 0, "Expected no packet traced");
+  // One echo per second from 2 s to 9 s, in both directions
+  NS_TEST_ASSERT_MSG_EQ (m_summaries.size (), 4, "Expected two windows of two links");
+  uint32_t expected[] = { 3, 3, 5, 5 };
+  for (uint32_t i = 0; i < m_summaries.size (); i++)
+    {
+      uint32_t fId, tId, n;
+      double t, d, b;
+      int fields = sscanf (m_summaries[i].c_str (), "<ls fId=\"%u\" tId=\"%u\" t=\"%lf\" d=\"%lf\" n=\"%u\" b=\"%lf\"",
+                           &fId, &tId, &t, &d, &n, &b);
+      NS_TEST_ASSERT_MSG_EQ (fields, 6, "Malformed summary " << m_summaries[i]);
+      NS_TEST_EXPECT_MSG_EQ (fId, i % 2, "Wrong transmitter");
+      NS_TEST_EXPECT_MSG_EQ (tId, 1 - i % 2, "Wrong receiver");
+      NS_TEST_EXPECT_MSG_EQ (t, (i / 2) * 5, "Wrong window start");
+      NS_TEST_EXPECT_MSG_EQ (d, 5, "Wrong window length");
+      NS_TEST_EXPECT_MSG_EQ (n, expected[i], "Wrong packet count");
+      // 1024 bytes of payload, UDP, IPv4 and PPP headers
+      NS_TEST_EXPECT_MSG_EQ (b, expected[i] * 1054.0, "Wrong byte count");
+    }
+}
+
 static class AnimationInterfaceTestSuite : public TestSuite
 {
 public:
@@ -236,5 +353,6 @@ public:
   {
     AddTestCase (new AnimationInterfaceTestCase (), TestCase::QUICK);
     AddTestCase (new AnimationRemainingEnergyTestCase (), TestCase::QUICK);
+    AddTestCase (new AnimationLinkSummaryTestCase (), TestCase::QUICK);
   }
 } g_animationInterfaceTestSuite;
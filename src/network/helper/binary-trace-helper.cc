@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-helper.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceHelper");
+
+BinaryTraceHelper::BinaryTraceHelper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<BinaryTraceRecorder>
+BinaryTraceHelper::CreateRecorder (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  Ptr<BinaryTraceRecorder> recorder = CreateObject<BinaryTraceRecorder> ();
+  bool ok = recorder->Open (fileName);
+  NS_ABORT_MSG_UNLESS (ok, "BinaryTraceHelper::CreateRecorder(): Unable to open " << fileName);
+  m_recorder = recorder;
+  return recorder;
+}
+
+void
+BinaryTraceHelper::SetRecorder (Ptr<BinaryTraceRecorder> recorder)
+{
+  NS_LOG_FUNCTION (this << recorder);
+  m_recorder = recorder;
+}
+
+Ptr<BinaryTraceRecorder>
+BinaryTraceHelper::GetRecorder (void) const
+{
+  return m_recorder;
+}
+
+BinaryTraceFormat::Schema
+BinaryTraceHelper::MakeSchema (std::string name, std::string fieldNames,
+                               std::vector<std::string> &names)
+{
+  std::string::size_type start = 0;
+  while (start < fieldNames.size ())
+    {
+      std::string::size_type end = fieldNames.find (',', start);
+      if (end == std::string::npos)
+        {
+          end = fieldNames.size ();
+        }
+      std::string::size_type first = fieldNames.find_first_not_of (' ', start);
+      std::string::size_type last = fieldNames.find_last_not_of (' ', end - 1);
+      if (first < end && last != std::string::npos && last >= first)
+        {
+          names.push_back (fieldNames.substr (first, last - first + 1));
+        }
+      else
+        {
+          names.push_back ("");
+        }
+      start = end + 1;
+    }
+  BinaryTraceFormat::Schema schema;
+  schema.name = name;
+  return schema;
+}
+
+Config::MatchContainer
+BinaryTraceHelper::Match (std::string path, std::string &traceName)
+{
+  NS_LOG_FUNCTION (path);
+  std::string::size_type slash = path.rfind ('/');
+  NS_ABORT_MSG_IF (slash == std::string::npos || slash + 1 == path.size (),
+                   "BinaryTraceHelper::Connect(): no trace source name in " << path);
+  traceName = path.substr (slash + 1);
+  return Config::LookupMatches (path.substr (0, slash));
+}
+
+} // namespace ns3
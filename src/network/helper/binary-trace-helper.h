@@ -0,0 +1,642 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_HELPER_H
+#define BINARY_TRACE_HELPER_H
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/binary-trace.h"
+#include "ns3/callback.h"
+#include "ns3/config.h"
+#include "ns3/abort.h"
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ * \brief How a trace source argument of type T is recorded.
+ *
+ * Arguments of types without a specialization are not recorded.
+ */
+template <typename T>
+struct BinaryTraceField
+{
+  /// Field type
+  static const BinaryTraceFormat::FieldType TYPE = BinaryTraceFormat::NONE;
+  /**
+   * \param p where to write the field
+   * \returns p
+   */
+  static uint8_t * Write (uint8_t *p, T const &)
+  {
+    return p;
+  }
+};
+
+/**
+ * \ingroup network
+ * Record arguments of type \p type with a plain copy, as \p fieldType.
+ */
+#define BINARY_TRACE_FIELD_COPY(type, fieldType)                        \
+  template <>                                                           \
+  struct BinaryTraceField<type>                                         \
+  {                                                                     \
+    static const BinaryTraceFormat::FieldType TYPE = BinaryTraceFormat::fieldType; \
+    static uint8_t * Write (uint8_t *p, type const &v)                  \
+    {                                                                   \
+      std::memcpy (p, &v, sizeof (type));                               \
+      return p + sizeof (type);                                         \
+    }                                                                   \
+  }
+
+BINARY_TRACE_FIELD_COPY (bool, BOOL);
+BINARY_TRACE_FIELD_COPY (uint8_t, UINT8);
+BINARY_TRACE_FIELD_COPY (uint16_t, UINT16);
+BINARY_TRACE_FIELD_COPY (uint32_t, UINT32);
+BINARY_TRACE_FIELD_COPY (uint64_t, UINT64);
+BINARY_TRACE_FIELD_COPY (int32_t, INT32);
+BINARY_TRACE_FIELD_COPY (int64_t, INT64);
+BINARY_TRACE_FIELD_COPY (double, DOUBLE);
+
+/** Time is recorded in time steps. */
+template <>
+struct BinaryTraceField<Time>
+{
+  static const BinaryTraceFormat::FieldType TYPE = BinaryTraceFormat::TIME; //!< Field type
+  /**
+   * \param p where to write the field
+   * \param v the value
+   * \returns the end of the field
+   */
+  static uint8_t * Write (uint8_t *p, Time const &v)
+  {
+    int64_t ts = v.GetTimeStep ();
+    std::memcpy (p, &ts, 8);
+    return p + 8;
+  }
+};
+
+/** Mac48Address is recorded as its 6 bytes. */
+template <>
+struct BinaryTraceField<Mac48Address>
+{
+  static const BinaryTraceFormat::FieldType TYPE = BinaryTraceFormat::MAC48; //!< Field type
+  /**
+   * \param p where to write the field
+   * \param v the value
+   * \returns the end of the field
+   */
+  static uint8_t * Write (uint8_t *p, Mac48Address const &v)
+  {
+    v.CopyTo (p);
+    return p + 6;
+  }
+};
+
+/** Ipv4Address is recorded as a host order integer. */
+template <>
+struct BinaryTraceField<Ipv4Address>
+{
+  static const BinaryTraceFormat::FieldType TYPE = BinaryTraceFormat::IPV4; //!< Field type
+  /**
+   * \param p where to write the field
+   * \param v the value
+   * \returns the end of the field
+   */
+  static uint8_t * Write (uint8_t *p, Ipv4Address const &v)
+  {
+    uint32_t a = v.Get ();
+    std::memcpy (p, &a, 4);
+    return p + 4;
+  }
+};
+
+/** Packets are recorded as their uid and size, not their content. */
+template <>
+struct BinaryTraceField<Ptr<const Packet> >
+{
+  static const BinaryTraceFormat::FieldType TYPE = BinaryTraceFormat::PACKET; //!< Field type
+  /**
+   * \param p where to write the field
+   * \param v the value
+   * \returns the end of the field
+   */
+  static uint8_t * Write (uint8_t *p, Ptr<const Packet> const &v)
+  {
+    uint64_t uid = v->GetUid ();
+    uint32_t size = v->GetSize ();
+    std::memcpy (p, &uid, 8);
+    std::memcpy (p + 8, &size, 4);
+    return p + 12;
+  }
+};
+
+/** Packets are recorded as their uid and size, not their content. */
+template <>
+struct BinaryTraceField<Ptr<Packet> > : public BinaryTraceField<Ptr<const Packet> >
+{
+};
+
+/**
+ * \ingroup network
+ * \brief Trace sink recording its arguments with a BinaryTraceRecorder.
+ *
+ * One sink is connected to each matched trace source, so that the
+ * context is interned only once.  RecordN is the sink of a trace
+ * source with N arguments.
+ */
+template <typename T1, typename T2 = empty, typename T3 = empty, typename T4 = empty,
+          typename T5 = empty, typename T6 = empty, typename T7 = empty, typename T8 = empty>
+class BinaryTraceSink
+  : public SimpleRefCount<BinaryTraceSink<T1, T2, T3, T4, T5, T6, T7, T8> >
+{
+public:
+  /**
+   * \param recorder the recorder
+   * \param schema the schema of the records
+   * \param context the context id of the records
+   */
+  BinaryTraceSink (Ptr<BinaryTraceRecorder> recorder, uint16_t schema, uint32_t context)
+    : m_recorder (recorder),
+      m_schema (schema),
+      m_context (context)
+  {
+  }
+
+  /**
+   * \param a1 argument
+   */
+  void Record1 (T1 a1)
+  {
+    uint8_t *p = Begin ();
+    if (p != 0)
+      {
+        BinaryTraceField<T1>::Write (p, a1);
+        m_recorder->Commit ();
+      }
+  }
+  /**
+   * \param a1 argument
+   * \param a2 argument
+   */
+  void Record2 (T1 a1, T2 a2)
+  {
+    uint8_t *p = Begin ();
+    if (p != 0)
+      {
+        p = BinaryTraceField<T1>::Write (p, a1);
+        BinaryTraceField<T2>::Write (p, a2);
+        m_recorder->Commit ();
+      }
+  }
+  /**
+   * \param a1 argument
+   * \param a2 argument
+   * \param a3 argument
+   */
+  void Record3 (T1 a1, T2 a2, T3 a3)
+  {
+    uint8_t *p = Begin ();
+    if (p != 0)
+      {
+        p = BinaryTraceField<T1>::Write (p, a1);
+        p = BinaryTraceField<T2>::Write (p, a2);
+        BinaryTraceField<T3>::Write (p, a3);
+        m_recorder->Commit ();
+      }
+  }
+  /**
+   * \param a1 argument
+   * \param a2 argument
+   * \param a3 argument
+   * \param a4 argument
+   */
+  void Record4 (T1 a1, T2 a2, T3 a3, T4 a4)
+  {
+    uint8_t *p = Begin ();
+    if (p != 0)
+      {
+        p = BinaryTraceField<T1>::Write (p, a1);
+        p = BinaryTraceField<T2>::Write (p, a2);
+        p = BinaryTraceField<T3>::Write (p, a3);
+        BinaryTraceField<T4>::Write (p, a4);
+        m_recorder->Commit ();
+      }
+  }
+  /**
+   * \param a1 argument
+   * \param a2 argument
+   * \param a3 argument
+   * \param a4 argument
+   * \param a5 argument
+   */
+  void Record5 (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
+  {
+    uint8_t *p = Begin ();
+    if (p != 0)
+      {
+        p = BinaryTraceField<T1>::Write (p, a1);
+        p = BinaryTraceField<T2>::Write (p, a2);
+        p = BinaryTraceField<T3>::Write (p, a3);
+        p = BinaryTraceField<T4>::Write (p, a4);
+        BinaryTraceField<T5>::Write (p, a5);
+        m_recorder->Commit ();
+      }
+  }
+  /**
+   * \param a1 argument
+   * \param a2 argument
+   * \param a3 argument
+   * \param a4 argument
+   * \param a5 argument
+   * \param a6 argument
+   */
+  void Record6 (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6)
+  {
+    uint8_t *p = Begin ();
+    if (p != 0)
+      {
+        p = BinaryTraceField<T1>::Write (p, a1);
+        p = BinaryTraceField<T2>::Write (p, a2);
+        p = BinaryTraceField<T3>::Write (p, a3);
+        p = BinaryTraceField<T4>::Write (p, a4);
+        p = BinaryTraceField<T5>::Write (p, a5);
+        BinaryTraceField<T6>::Write (p, a6);
+        m_recorder->Commit ();
+      }
+  }
+  /**
+   * \param a1 argument
+   * \param a2 argument
+   * \param a3 argument
+   * \param a4 argument
+   * \param a5 argument
+   * \param a6 argument
+   * \param a7 argument
+   */
+  void Record7 (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7)
+  {
+    uint8_t *p = Begin ();
+    if (p != 0)
+      {
+        p = BinaryTraceField<T1>::Write (p, a1);
+        p = BinaryTraceField<T2>::Write (p, a2);
+        p = BinaryTraceField<T3>::Write (p, a3);
+        p = BinaryTraceField<T4>::Write (p, a4);
+        p = BinaryTraceField<T5>::Write (p, a5);
+        p = BinaryTraceField<T6>::Write (p, a6);
+        BinaryTraceField<T7>::Write (p, a7);
+        m_recorder->Commit ();
+      }
+  }
+  /**
+   * \param a1 argument
+   * \param a2 argument
+   * \param a3 argument
+   * \param a4 argument
+   * \param a5 argument
+   * \param a6 argument
+   * \param a7 argument
+   * \param a8 argument
+   */
+  void Record8 (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8)
+  {
+    uint8_t *p = Begin ();
+    if (p != 0)
+      {
+        p = BinaryTraceField<T1>::Write (p, a1);
+        p = BinaryTraceField<T2>::Write (p, a2);
+        p = BinaryTraceField<T3>::Write (p, a3);
+        p = BinaryTraceField<T4>::Write (p, a4);
+        p = BinaryTraceField<T5>::Write (p, a5);
+        p = BinaryTraceField<T6>::Write (p, a6);
+        p = BinaryTraceField<T7>::Write (p, a7);
+        BinaryTraceField<T8>::Write (p, a8);
+        m_recorder->Commit ();
+      }
+  }
+
+private:
+  /** \returns where to write the fields, or 0 if the recorder is closed */
+  uint8_t * Begin (void)
+  {
+    if (!m_recorder->IsOpen ())
+      {
+        return 0;
+      }
+    return m_recorder->Reserve (m_schema, m_context);
+  }
+
+  Ptr<BinaryTraceRecorder> m_recorder; //!< the recorder
+  uint16_t m_schema;                   //!< schema of the records
+  uint32_t m_context;                  //!< context id of the records
+};
+
+/**
+ * \ingroup network
+ * \brief Record trace sources into a binary trace file.
+ *
+ * Connect attaches a BinaryTraceSink to every trace source matching a
+ * configuration path, the last element of which is the trace source
+ * name, as with Config::ConnectWithoutContext.  The template arguments
+ * are the argument types of the trace source; the arguments of
+ * supported types (see BinaryTraceField) become the fields of a schema,
+ * named after a comma separated list:
+ *
+ * \code
+ *   BinaryTraceHelper helper;
+ *   helper.CreateRecorder ("wifi.btr");
+ *   helper.Connect<Ptr<const Packet> > ("/NodeList/[0-9]/DeviceList/0/$ns3::WifiNetDevice/Mac/MacTx",
+ *                                       "MacTx", "packet");
+ * \endcode
+ *
+ * The context of each record is the matched path, as would be passed
+ * to a sink connected with Config::Connect.
+ */
+class BinaryTraceHelper
+{
+public:
+  BinaryTraceHelper ();
+
+  /**
+   * Create and open a recorder for the following connections.
+   * \param fileName the file to write
+   * \returns the recorder
+   */
+  Ptr<BinaryTraceRecorder> CreateRecorder (std::string fileName);
+  /**
+   * \param recorder the recorder used by the following connections
+   */
+  void SetRecorder (Ptr<BinaryTraceRecorder> recorder);
+  /** \returns the recorder */
+  Ptr<BinaryTraceRecorder> GetRecorder (void) const;
+
+  /**
+   * \param path the path of the trace sources
+   * \param schema the name of the schema of the records
+   * \param fieldNames comma separated names of the arguments
+   * \returns the number of trace sources connected
+   */
+  template <typename T1>
+  uint32_t Connect (std::string path, std::string schema, std::string fieldNames);
+  /** \copydoc Connect(std::string,std::string,std::string) */
+  template <typename T1, typename T2>
+  uint32_t Connect (std::string path, std::string schema, std::string fieldNames);
+  /** \copydoc Connect(std::string,std::string,std::string) */
+  template <typename T1, typename T2, typename T3>
+  uint32_t Connect (std::string path, std::string schema, std::string fieldNames);
+  /** \copydoc Connect(std::string,std::string,std::string) */
+  template <typename T1, typename T2, typename T3, typename T4>
+  uint32_t Connect (std::string path, std::string schema, std::string fieldNames);
+  /** \copydoc Connect(std::string,std::string,std::string) */
+  template <typename T1, typename T2, typename T3, typename T4, typename T5>
+  uint32_t Connect (std::string path, std::string schema, std::string fieldNames);
+  /** \copydoc Connect(std::string,std::string,std::string) */
+  template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+  uint32_t Connect (std::string path, std::string schema, std::string fieldNames);
+  /** \copydoc Connect(std::string,std::string,std::string) */
+  template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6,
+            typename T7>
+  uint32_t Connect (std::string path, std::string schema, std::string fieldNames);
+  /** \copydoc Connect(std::string,std::string,std::string) */
+  template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6,
+            typename T7, typename T8>
+  uint32_t Connect (std::string path, std::string schema, std::string fieldNames);
+
+private:
+  /**
+   * Append the field of the next argument to a schema.
+   * \param schema the schema
+   * \param names the argument names
+   * \param index the argument index, incremented
+   */
+  template <typename T>
+  static void AddField (BinaryTraceFormat::Schema &schema,
+                        const std::vector<std::string> &names, uint32_t &index);
+  /**
+   * \param name the schema name
+   * \param fieldNames comma separated names of the arguments
+   * \param names the split names
+   * \returns an empty schema
+   */
+  static BinaryTraceFormat::Schema MakeSchema (std::string name, std::string fieldNames,
+                                               std::vector<std::string> &names);
+  /**
+   * Connect a sink of type SINK to each trace source matching path.
+   * \param path the path of the trace sources
+   * \param schema the schema of the records
+   * \param record the RecordN method of the sink
+   * \returns the number of trace sources connected
+   */
+  template <typename SINK, typename MEM_PTR>
+  uint32_t DoConnect (std::string path, const BinaryTraceFormat::Schema &schema, MEM_PTR record);
+  /**
+   * \param path the path of the trace sources
+   * \param traceName the name of the trace source
+   * \returns the objects with the trace sources
+   */
+  static Config::MatchContainer Match (std::string path, std::string &traceName);
+
+  Ptr<BinaryTraceRecorder> m_recorder; //!< the recorder
+};
+
+} // namespace ns3
+
+/***************************************************************
+ *  Implementation of the templates declared above.
+ ***************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+void
+BinaryTraceHelper::AddField (BinaryTraceFormat::Schema &schema,
+                             const std::vector<std::string> &names, uint32_t &index)
+{
+  BinaryTraceFormat::Field field;
+  field.type = BinaryTraceField<T>::TYPE;
+  if (index < names.size ())
+    {
+      field.name = names[index];
+    }
+  else
+    {
+      std::ostringstream oss;
+      oss << "arg" << index;
+      field.name = oss.str ();
+    }
+  index++;
+  if (field.type != BinaryTraceFormat::NONE)
+    {
+      schema.fields.push_back (field);
+    }
+}
+
+template <typename SINK, typename MEM_PTR>
+uint32_t
+BinaryTraceHelper::DoConnect (std::string path, const BinaryTraceFormat::Schema &schema, MEM_PTR record)
+{
+  NS_ABORT_MSG_IF (m_recorder == 0, "BinaryTraceHelper::Connect(): no recorder");
+  uint16_t id = m_recorder->AddSchema (schema);
+  std::string traceName;
+  Config::MatchContainer matches = Match (path, traceName);
+  for (uint32_t i = 0; i < matches.GetN (); i++)
+    {
+      uint32_t context = m_recorder->AddContext (matches.GetMatchedPath (i) + traceName);
+      Ptr<SINK> sink = Create<SINK> (m_recorder, id, context);
+      bool ok = matches.Get (i)->TraceConnectWithoutContext (traceName, MakeCallback (record, sink));
+      NS_ABORT_MSG_UNLESS (ok, "Can't connect to trace source \"" << traceName
+                           << "\" of " << matches.GetMatchedPath (i));
+    }
+  return matches.GetN ();
+}
+
+template <typename T1>
+uint32_t
+BinaryTraceHelper::Connect (std::string path, std::string schemaName, std::string fieldNames)
+{
+  std::vector<std::string> names;
+  BinaryTraceFormat::Schema schema = MakeSchema (schemaName, fieldNames, names);
+  uint32_t index = 0;
+  AddField<T1> (schema, names, index);
+  typedef BinaryTraceSink<T1> Sink;
+  return DoConnect<Sink> (path, schema, &Sink::Record1);
+}
+
+template <typename T1, typename T2>
+uint32_t
+BinaryTraceHelper::Connect (std::string path, std::string schemaName, std::string fieldNames)
+{
+  std::vector<std::string> names;
+  BinaryTraceFormat::Schema schema = MakeSchema (schemaName, fieldNames, names);
+  uint32_t index = 0;
+  AddField<T1> (schema, names, index);
+  AddField<T2> (schema, names, index);
+  typedef BinaryTraceSink<T1, T2> Sink;
+  return DoConnect<Sink> (path, schema, &Sink::Record2);
+}
+
+template <typename T1, typename T2, typename T3>
+uint32_t
+BinaryTraceHelper::Connect (std::string path, std::string schemaName, std::string fieldNames)
+{
+  std::vector<std::string> names;
+  BinaryTraceFormat::Schema schema = MakeSchema (schemaName, fieldNames, names);
+  uint32_t index = 0;
+  AddField<T1> (schema, names, index);
+  AddField<T2> (schema, names, index);
+  AddField<T3> (schema, names, index);
+  typedef BinaryTraceSink<T1, T2, T3> Sink;
+  return DoConnect<Sink> (path, schema, &Sink::Record3);
+}
+
+template <typename T1, typename T2, typename T3, typename T4>
+uint32_t
+BinaryTraceHelper::Connect (std::string path, std::string schemaName, std::string fieldNames)
+{
+  std::vector<std::string> names;
+  BinaryTraceFormat::Schema schema = MakeSchema (schemaName, fieldNames, names);
+  uint32_t index = 0;
+  AddField<T1> (schema, names, index);
+  AddField<T2> (schema, names, index);
+  AddField<T3> (schema, names, index);
+  AddField<T4> (schema, names, index);
+  typedef BinaryTraceSink<T1, T2, T3, T4> Sink;
+  return DoConnect<Sink> (path, schema, &Sink::Record4);
+}
+
+template <typename T1, typename T2, typename T3, typename T4, typename T5>
+uint32_t
+BinaryTraceHelper::Connect (std::string path, std::string schemaName, std::string fieldNames)
+{
+  std::vector<std::string> names;
+  BinaryTraceFormat::Schema schema = MakeSchema (schemaName, fieldNames, names);
+  uint32_t index = 0;
+  AddField<T1> (schema, names, index);
+  AddField<T2> (schema, names, index);
+  AddField<T3> (schema, names, index);
+  AddField<T4> (schema, names, index);
+  AddField<T5> (schema, names, index);
+  typedef BinaryTraceSink<T1, T2, T3, T4, T5> Sink;
+  return DoConnect<Sink> (path, schema, &Sink::Record5);
+}
+
+template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+uint32_t
+BinaryTraceHelper::Connect (std::string path, std::string schemaName, std::string fieldNames)
+{
+  std::vector<std::string> names;
+  BinaryTraceFormat::Schema schema = MakeSchema (schemaName, fieldNames, names);
+  uint32_t index = 0;
+  AddField<T1> (schema, names, index);
+  AddField<T2> (schema, names, index);
+  AddField<T3> (schema, names, index);
+  AddField<T4> (schema, names, index);
+  AddField<T5> (schema, names, index);
+  AddField<T6> (schema, names, index);
+  typedef BinaryTraceSink<T1, T2, T3, T4, T5, T6> Sink;
+  return DoConnect<Sink> (path, schema, &Sink::Record6);
+}
+
+template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6,
+          typename T7>
+uint32_t
+BinaryTraceHelper::Connect (std::string path, std::string schemaName, std::string fieldNames)
+{
+  std::vector<std::string> names;
+  BinaryTraceFormat::Schema schema = MakeSchema (schemaName, fieldNames, names);
+  uint32_t index = 0;
+  AddField<T1> (schema, names, index);
+  AddField<T2> (schema, names, index);
+  AddField<T3> (schema, names, index);
+  AddField<T4> (schema, names, index);
+  AddField<T5> (schema, names, index);
+  AddField<T6> (schema, names, index);
+  AddField<T7> (schema, names, index);
+  typedef BinaryTraceSink<T1, T2, T3, T4, T5, T6, T7> Sink;
+  return DoConnect<Sink> (path, schema, &Sink::Record7);
+}
+
+template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6,
+          typename T7, typename T8>
+uint32_t
+BinaryTraceHelper::Connect (std::string path, std::string schemaName, std::string fieldNames)
+{
+  std::vector<std::string> names;
+  BinaryTraceFormat::Schema schema = MakeSchema (schemaName, fieldNames, names);
+  uint32_t index = 0;
+  AddField<T1> (schema, names, index);
+  AddField<T2> (schema, names, index);
+  AddField<T3> (schema, names, index);
+  AddField<T4> (schema, names, index);
+  AddField<T5> (schema, names, index);
+  AddField<T6> (schema, names, index);
+  AddField<T7> (schema, names, index);
+  AddField<T8> (schema, names, index);
+  typedef BinaryTraceSink<T1, T2, T3, T4, T5, T6, T7, T8> Sink;
+  return DoConnect<Sink> (path, schema, &Sink::Record8);
+}
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_HELPER_H */
@@ -358,10 +358,13 @@ ByteTagList::Allocate (uint32_t size)
       uint8_t *buffer = (uint8_t *)data;
       delete [] buffer;
     }
-  uint8_t *buffer = new uint8_t [std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4];
+  // Record the real capacity so that subsequent Add calls can append in
+  // place instead of reallocating for every tag.
+  uint32_t capacity = std::max (size, g_maxSize);
+  uint8_t *buffer = new uint8_t [capacity + sizeof (struct ByteTagListData) - 4];
   struct ByteTagListData *data = (struct ByteTagListData *)buffer;
   data->count = 1;
-  data->size = size;
+  data->size = capacity;
   data->dirty = 0;
   return data;
 }
@@ -34,6 +34,41 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
+namespace {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Free list of PacketTagList::TagData nodes.
+ *
+ * The free list is threaded through the TagData::next pointers, so
+ * recycling a node costs two pointer writes.  Like the Buffer free list,
+ * it must survive static destructors of packets that outlive it: once
+ * destroyed, freed nodes are simply deleted.
+ */
+static struct TagDataFreeList
+{
+  /** Destructor: release all the recycled nodes. */
+  ~TagDataFreeList ()
+  {
+    while (head != 0)
+      {
+        struct PacketTagList::TagData *next = head->next;
+        delete head;
+        head = next;
+      }
+    destroyed = true;
+  }
+  struct PacketTagList::TagData *head; //!< First recycled node
+  uint32_t size;                        //!< Number of recycled nodes
+  bool destroyed;                       //!< Static destructor has run
+} g_tagDataFreeList; //!< Recycled TagData nodes (zero-initialized storage)
+
+/** Maximum number of TagData nodes kept on the free list. */
+static const uint32_t TAG_DATA_FREE_LIST_SIZE = 4096;
+
+} // unnamed namespace
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -133,9 +168,8 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
       NS_ASSERT (cur != 0);
       NS_ASSERT (cur->count > 1);
       cur->count--;                       // unmerge cur
-      struct TagData * copy = new struct TagData ();
+      struct TagData * copy = CreateTagData ();
       copy->tid = cur->tid;
-      copy->count = 1;
       memcpy (copy->data, cur->data, TagData::MAX_SIZE);
       copy->next = cur->next;             // merge into tail
       copy->next->count++;                // mark new merge
@@ -176,8 +210,8 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
 
   if (preMerge)
     {
-      // found tid before first merge, so delete cur
-      delete cur;
+      // found tid before first merge, so recycle cur
+      FreeTagData (cur);
     }
   else
     {
@@ -225,9 +259,8 @@ PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
       // cur is always a merge at this point
       // need to copy, replace, and link past cur
       cur->count--;                     // unmerge cur
-      struct TagData * copy = new struct TagData ();
+      struct TagData * copy = CreateTagData ();
       copy->tid = tag.GetInstanceTypeId ();
-      copy->count = 1;
       tag.Serialize (TagBuffer (copy->data,
                                 copy->data + tag.GetSerializedSize ()));
       copy->next = cur->next;           // merge into tail
@@ -249,9 +282,7 @@ PacketTagList::Add (const Tag &tag) const
     {
       NS_ASSERT (cur->tid != tag.GetInstanceTypeId ());
     }
-  struct TagData * head = new struct TagData ();
-  head->count = 1;
-  head->next = 0;
+  struct TagData * head = CreateTagData ();
   head->tid = tag.GetInstanceTypeId ();
   head->next = m_next;
   NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
@@ -278,6 +309,40 @@ PacketTagList::Peek (Tag &tag) const
   return false;
 }
 
+struct PacketTagList::TagData *
+PacketTagList::CreateTagData (void)
+{
+  struct TagData *data = g_tagDataFreeList.head;
+  if (data != 0)
+    {
+      g_tagDataFreeList.head = data->next;
+      g_tagDataFreeList.size--;
+      // no stale tag of the previous owner
+      *data = TagData ();
+    }
+  else
+    {
+      data = new struct TagData ();
+    }
+  data->next = 0;
+  data->count = 1;
+  return data;
+}
+
+void
+PacketTagList::FreeTagData (struct TagData *data)
+{
+  if (g_tagDataFreeList.destroyed ||
+      g_tagDataFreeList.size >= TAG_DATA_FREE_LIST_SIZE)
+    {
+      delete data;
+      return;
+    }
+  data->next = g_tagDataFreeList.head;
+  g_tagDataFreeList.head = data;
+  g_tagDataFreeList.size++;
+}
+
 const struct PacketTagList::TagData *
 PacketTagList::Head (void) const
 {
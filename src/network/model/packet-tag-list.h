@@ -124,6 +124,12 @@ class Tag;
  * \n
  * Packet tags must serialize to a finite maximum size, see TagData
  *
+ * TagData nodes are recycled through a free list threaded on the
+ * TagData::next pointers (see #CreateTagData and #FreeTagData),
+ * so that adding and removing tags on the wifi and flow monitor
+ * fast paths does not hit the general purpose allocator once the
+ * free list has warmed up.
+ *
  * This documentation entitles the original author to a free beer.
  */
 class PacketTagList 
@@ -287,6 +293,19 @@ private:
    */
   bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
 
+  /**
+   * Get a TagData node, from the free list if possible.
+   *
+   * \returns A TagData with \c count set to 1 and \c next set to 0.
+   */
+  static struct TagData * CreateTagData (void);
+  /**
+   * Return a TagData node to the free list.
+   *
+   * \param [in] data The node to recycle; it must no longer be referenced.
+   */
+  static void FreeTagData (struct TagData * data);
+
   /**
    * Pointer to first \ref TagData on the list
    */
@@ -350,13 +369,13 @@ PacketTagList::RemoveAll (void)
         }
       if (prev != 0) 
         {
-	  delete prev;
+          FreeTagData (prev);
         }
       prev = cur;
     }
   if (prev != 0) 
     {
-      delete prev;
+      FreeTagData (prev);
     }
   m_next = 0;
 }
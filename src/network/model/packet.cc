@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/event-profiler.h"
 #include <string>
 #include <cstdarg>
 
@@ -127,6 +128,18 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+/**
+ * Count a Packet construction in the EventProfiler, if it is enabled.
+ */
+static inline void
+RecordPacketAllocation (void)
+{
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::RecordAllocation ("ns3::Packet");
+    }
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
@@ -140,6 +153,7 @@ Packet::Packet ()
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
     m_nixVector (0)
 {
+  RecordPacketAllocation ();
   m_globalUid++;
 }
 
@@ -149,6 +163,7 @@ Packet::Packet (const Packet &o)
     m_packetTagList (o.m_packetTagList),
     m_metadata (o.m_metadata)
 {
+  RecordPacketAllocation ();
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
 }
@@ -182,6 +197,7 @@ Packet::Packet (uint32_t size)
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
     m_nixVector (0)
 {
+  RecordPacketAllocation ();
   m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
@@ -191,6 +207,7 @@ Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
     m_metadata (0,0),
     m_nixVector (0)
 {
+  RecordPacketAllocation ();
   NS_ASSERT (magic);
   Deserialize (buffer, size);
 }
@@ -208,6 +225,7 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
     m_nixVector (0)
 {
+  RecordPacketAllocation ();
   m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
@@ -222,6 +240,7 @@ Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList,
     m_metadata (metadata),
     m_nixVector (0)
 {
+  RecordPacketAllocation ();
 }
 
 Ptr<Packet>
@@ -0,0 +1,322 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/binary-trace.h"
+#include "ns3/binary-trace-helper.h"
+#include "ns3/names.h"
+#include "ns3/simulator.h"
+#include "ns3/traced-callback.h"
+#include "ns3/uinteger.h"
+#include "ns3/test.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+
+#include <cstring>
+
+using namespace ns3;
+
+/// A structure without a binary trace field, skipped by the sinks
+struct BinaryTraceOpaque
+{
+  uint32_t value; //!< Not recorded
+};
+
+/**
+ * An object with trace sources for the binary trace tests.
+ */
+class BinaryTraceTestObject : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param p packet
+   * \param n counter
+   * \param x value
+   */
+  void FireTx (Ptr<const Packet> p, uint32_t n, double x)
+  {
+    m_tx (p, n, x);
+  }
+  /**
+   * \param a address
+   * \param o skipped argument
+   * \param t time
+   */
+  void FireRx (Mac48Address a, BinaryTraceOpaque o, Time t)
+  {
+    m_rx (a, o, t);
+  }
+
+private:
+  TracedCallback<Ptr<const Packet>, uint32_t, double> m_tx;       //!< trace source
+  TracedCallback<Mac48Address, BinaryTraceOpaque, Time> m_rx;     //!< trace source
+};
+
+TypeId
+BinaryTraceTestObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BinaryTraceTestObject")
+    .SetParent<Object> ()
+    .AddTraceSource ("Tx", "A packet, a counter and a value",
+                     MakeTraceSourceAccessor (&BinaryTraceTestObject::m_tx),
+                     "ns3::BinaryTraceTestObject::TxCallback")
+    .AddTraceSource ("Rx", "An address, an opaque value and a time",
+                     MakeTraceSourceAccessor (&BinaryTraceTestObject::m_rx),
+                     "ns3::BinaryTraceTestObject::RxCallback")
+  ;
+  return tid;
+}
+
+/**
+ * Record trace sources through the helper, with a ring small enough to
+ * wrap around many times, and read the records back.
+ */
+class BinaryTraceHelperTestCase : public TestCase
+{
+public:
+  BinaryTraceHelperTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Fire the trace sources
+   * \param i event number
+   */
+  void Fire (uint32_t i);
+
+  Ptr<BinaryTraceTestObject> m_a; //!< first traced object
+  Ptr<BinaryTraceTestObject> m_b; //!< second traced object
+};
+
+BinaryTraceHelperTestCase::BinaryTraceHelperTestCase ()
+  : TestCase ("Record trace sources with BinaryTraceHelper and read them back")
+{
+}
+
+void
+BinaryTraceHelperTestCase::Fire (uint32_t i)
+{
+  m_a->FireTx (Create<Packet> (i % 1500), i, i * 0.5);
+  BinaryTraceOpaque o;
+  o.value = i;
+  m_b->FireRx (Mac48Address ("00:00:00:00:00:07"), o, MicroSeconds (i));
+  if (i % 2 == 0)
+    {
+      m_b->FireTx (Create<Packet> (10), i, -1.0);
+    }
+}
+
+void
+BinaryTraceHelperTestCase::DoRun (void)
+{
+  const uint32_t nEvents = 20000;
+  std::string fileName = CreateTempDirFilename ("helper.btr");
+  m_a = CreateObject<BinaryTraceTestObject> ();
+  m_b = CreateObject<BinaryTraceTestObject> ();
+  Names::Add ("BinaryTraceA", m_a);
+  Names::Add ("BinaryTraceB", m_b);
+
+  Ptr<BinaryTraceRecorder> recorder = CreateObject<BinaryTraceRecorder> ();
+  recorder->SetAttribute ("RingSize", UintegerValue (1 << 17));
+  NS_TEST_ASSERT_MSG_EQ (recorder->Open (fileName), true, "Can't open " << fileName);
+
+  BinaryTraceHelper helper;
+  helper.SetRecorder (recorder);
+  uint32_t n = helper.Connect<Ptr<const Packet>, uint32_t, double> ("/Names/BinaryTraceA/Tx", "Tx", "packet, n, x");
+  NS_TEST_EXPECT_MSG_EQ (n, 1, "Wrong number of trace sources connected");
+  n = helper.Connect<Ptr<const Packet>, uint32_t, double> ("/Names/BinaryTraceB/Tx", "Tx", "packet, n, x");
+  NS_TEST_EXPECT_MSG_EQ (n, 1, "Wrong number of trace sources connected");
+  n = helper.Connect<Mac48Address, BinaryTraceOpaque, Time> ("/Names/BinaryTraceB/Rx", "Rx", "from,opaque,t");
+  NS_TEST_EXPECT_MSG_EQ (n, 1, "Wrong number of trace sources connected");
+
+  for (uint32_t i = 0; i < nEvents; i++)
+    {
+      Simulator::Schedule (NanoSeconds (i), &BinaryTraceHelperTestCase::Fire, this, i);
+    }
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (recorder->GetNRecords (), 2 * nEvents + nEvents / 2, "Wrong number of records");
+  recorder->Close ();
+  Simulator::Destroy ();
+  Names::Clear ();
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (fileName), true, "Can't read " << fileName);
+  NS_TEST_EXPECT_MSG_EQ (reader.GetNRecords (), 2 * nEvents + nEvents / 2, "Wrong number of records");
+
+  BinaryTraceReader::Record record;
+  uint32_t nTx = 0;
+  uint32_t nRx = 0;
+  uint32_t nTxB = 0;
+  bool ordered = true;
+  bool values = true;
+  while (reader.Next (record))
+    {
+      const BinaryTraceFormat::Schema &schema = reader.GetSchema (record.schema);
+      std::string context = reader.GetContext (record.context);
+      if (schema.name == "Rx")
+        {
+          NS_TEST_ASSERT_MSG_EQ (schema.fields.size (), 2, "The opaque argument should be skipped");
+          NS_TEST_EXPECT_MSG_EQ (schema.fields[1].name, "t", "Wrong field name");
+          NS_TEST_EXPECT_MSG_EQ (context, "/Names/BinaryTraceB/Rx", "Wrong context");
+          ordered = ordered && record.time == NanoSeconds (nRx);
+          values = values && reader.FormatField (record, 0) == "00:00:00:00:00:07";
+          int64_t t;
+          std::memcpy (&t, record.data + 6, sizeof (t));
+          values = values && t == MicroSeconds (nRx).GetTimeStep ();
+          nRx++;
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_EQ (schema.name, "Tx", "Unknown schema");
+      NS_TEST_ASSERT_MSG_EQ (schema.fields.size (), 3, "Wrong number of fields");
+      NS_TEST_EXPECT_MSG_EQ (schema.fields[2].name, "x", "Wrong field name");
+      uint32_t counter;
+      double x;
+      std::memcpy (&counter, record.data + 12, sizeof (counter));
+      std::memcpy (&x, record.data + 16, sizeof (x));
+      if (context == "/Names/BinaryTraceA/Tx")
+        {
+          ordered = ordered && counter == nTx;
+          values = values && x == nTx * 0.5;
+          std::ostringstream oss;
+          oss << ":" << nTx % 1500;
+          std::string packet = reader.FormatField (record, 0);
+          values = values && packet.substr (packet.find (':')) == oss.str ();
+          nTx++;
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (context, "/Names/BinaryTraceB/Tx", "Wrong context");
+          ordered = ordered && counter == 2 * nTxB;
+          values = values && x == -1.0;
+          nTxB++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (nTx, nEvents, "Missing Tx records");
+  NS_TEST_EXPECT_MSG_EQ (nRx, nEvents, "Missing Rx records");
+  NS_TEST_EXPECT_MSG_EQ (nTxB, nEvents / 2, "Missing Tx records");
+  NS_TEST_EXPECT_MSG_EQ (ordered, true, "Records out of order");
+  NS_TEST_EXPECT_MSG_EQ (values, true, "Wrong record values");
+  m_a = 0;
+  m_b = 0;
+}
+
+#ifdef HAVE_PTHREAD_H
+
+/**
+ * Record from several threads at once and check that the records of
+ * each thread are complete and in order.
+ */
+class BinaryTraceThreadsTestCase : public TestCase
+{
+public:
+  BinaryTraceThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** Record from the calling thread */
+  void Produce (void);
+
+  Ptr<BinaryTraceRecorder> m_recorder; //!< the recorder
+  uint16_t m_schema;                   //!< the schema of the records
+};
+
+static const uint32_t N_THREADS = 4;          //!< Number of recording threads
+static const uint32_t N_THREAD_RECORDS = 50000; //!< Number of records per thread
+
+BinaryTraceThreadsTestCase::BinaryTraceThreadsTestCase ()
+  : TestCase ("Record from several threads")
+{
+}
+
+void
+BinaryTraceThreadsTestCase::Produce (void)
+{
+  uint32_t context = m_recorder->AddContext ("thread");
+  for (uint32_t i = 0; i < N_THREAD_RECORDS; i++)
+    {
+      uint8_t *p = m_recorder->Reserve (m_schema, context);
+      std::memcpy (p, &i, sizeof (i));
+      m_recorder->Commit ();
+    }
+}
+
+void
+BinaryTraceThreadsTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("threads.btr");
+  m_recorder = CreateObject<BinaryTraceRecorder> ();
+  m_recorder->SetAttribute ("RingSize", UintegerValue (1 << 17));
+  m_recorder->SetAttribute ("FlushInterval", UintegerValue (1));
+  BinaryTraceFormat::Schema schema;
+  schema.name = "Counter";
+  BinaryTraceFormat::Field field;
+  field.name = "i";
+  field.type = BinaryTraceFormat::UINT32;
+  schema.fields.push_back (field);
+  m_schema = m_recorder->AddSchema (schema);
+  NS_TEST_ASSERT_MSG_EQ (m_recorder->Open (fileName), true, "Can't open " << fileName);
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&BinaryTraceThreadsTestCase::Produce, this)));
+      threads.back ()->Start ();
+    }
+  for (uint32_t i = 0; i < N_THREADS; i++)
+    {
+      threads[i]->Join ();
+    }
+  m_recorder->Close ();
+  m_recorder = 0;
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (fileName), true, "Can't read " << fileName);
+  NS_TEST_EXPECT_MSG_EQ (reader.GetNRecords (), N_THREADS * N_THREAD_RECORDS, "Wrong number of records");
+  std::map<uint32_t, uint32_t> next;
+  bool ordered = true;
+  BinaryTraceReader::Record record;
+  while (reader.Next (record))
+    {
+      uint32_t i;
+      std::memcpy (&i, record.data, sizeof (i));
+      ordered = ordered && next[record.thread] == i;
+      next[record.thread] = i + 1;
+    }
+  NS_TEST_EXPECT_MSG_EQ (next.size (), N_THREADS, "Wrong number of threads");
+  NS_TEST_EXPECT_MSG_EQ (ordered, true, "Records of a thread out of order");
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+static class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ()
+    : TestSuite ("binary-trace", UNIT)
+  {
+    AddTestCase (new BinaryTraceHelperTestCase, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+    AddTestCase (new BinaryTraceThreadsTestCase, TestCase::QUICK);
+#endif
+  }
+} g_binaryTraceTestSuite;
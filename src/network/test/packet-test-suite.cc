@@ -847,6 +847,64 @@ PacketTagListTest::DoRun (void)
     
 }
 
+//--------------------------------------
+class PacketTagListRecycleTest : public TestCase
+{
+public:
+  PacketTagListRecycleTest ();
+private:
+  void DoRun (void);
+};
+
+PacketTagListRecycleTest::PacketTagListRecycleTest ()
+  : TestCase ("PacketTagList node recycling")
+{
+}
+
+void
+PacketTagListRecycleTest::DoRun (void)
+{
+  ATestTag<19> big (3);
+  ATestTag<1> small (4);
+  ATestTag<2> other (5);
+
+  // the node of a removed tag goes back to the head of the free list
+  PacketTagList first;
+  first.Add (big);
+  const struct PacketTagList::TagData * node = first.Head ();
+  first.Remove (big);
+
+  PacketTagList ptl;
+  ptl.Add (small);
+  NS_TEST_ASSERT_MSG_EQ (ptl.Head (), node, "node not reused");
+  NS_TEST_EXPECT_MSG_EQ (ptl.Head ()->next, 0, "stale next pointer");
+  NS_TEST_EXPECT_MSG_EQ (ptl.Head ()->count, 1, "stale count");
+  // the small tag serializes to 2 bytes, the rest of the big one is gone
+  for (uint32_t i = small.GetSerializedSize (); i < PacketTagList::TagData::MAX_SIZE; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)ptl.Head ()->data[i], 0, "stale byte " << i);
+    }
+
+  // copy-on-write still protects the reused node
+  PacketTagList copy = ptl;
+  copy.Add (other);
+  ATestTag<1> replaced (6);
+  copy.Replace (replaced);
+  ATestTag<1> found;
+  NS_TEST_EXPECT_MSG_EQ (ptl.Peek (found), true, "tag lost by the original");
+  NS_TEST_EXPECT_MSG_EQ (found.GetData (), 4, "original changed by Replace");
+  NS_TEST_EXPECT_MSG_EQ (found.m_error, false, "original corrupted by Replace");
+  NS_TEST_EXPECT_MSG_EQ (copy.Peek (found), true, "tag lost by the copy");
+  NS_TEST_EXPECT_MSG_EQ (found.GetData (), 6, "copy not replaced");
+  copy.Remove (found);
+  NS_TEST_EXPECT_MSG_EQ (copy.Peek (found), false, "tag not removed from the copy");
+  NS_TEST_EXPECT_MSG_EQ (ptl.Peek (found), true, "original changed by Remove");
+  NS_TEST_EXPECT_MSG_EQ (found.GetData (), 4, "original changed by Remove");
+  ATestTag<2> otherFound;
+  NS_TEST_EXPECT_MSG_EQ (copy.Peek (otherFound), true, "other tag lost by the copy");
+  NS_TEST_EXPECT_MSG_EQ (ptl.Peek (otherFound), false, "other tag added to the original");
+}
+
 //-----------------------------------------------------------------------------
 class PacketTestSuite : public TestSuite
 {
@@ -859,6 +917,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketTagListRecycleTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite;
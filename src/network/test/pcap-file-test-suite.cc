@@ -1121,6 +1121,77 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that the asynchronous writer produces the same
+// file as the synchronous one, including when records are truncated,
+// larger than a buffer, or when all the buffers are in use.  It only uses
+// the known packets table, not known.pcap, and has a suite of its own.
+// ===========================================================================
+class AsyncWriteTestCase : public TestCase
+{
+public:
+  AsyncWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AsyncWriteTestCase::AsyncWriteTestCase ()
+  : TestCase ("Check that PcapFile::EnableAsyncWrite writes the same records")
+{
+}
+
+void
+AsyncWriteTestCase::DoRun (void)
+{
+  uint8_t data[2000];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i * 7;
+    }
+  uint32_t snapLens[] = { sizeof (data), N_PACKET_BYTES };
+  for (uint32_t s = 0; s < 2; ++s)
+    {
+      std::string syncName = CreateTempDirFilename ("sync.pcap");
+      std::string asyncName = CreateTempDirFilename ("async.pcap");
+      PcapFile f;
+      PcapFile g;
+
+      f.Open (syncName, std::ios::out);
+      f.Init (1, snapLens[s]);
+      g.Open (asyncName, std::ios::out);
+      g.Init (1, snapLens[s]);
+      // buffers smaller than some records, and only two of them
+      g.EnableAsyncWrite (64, 2);
+      NS_TEST_ASSERT_MSG_EQ (g.Fail (), false, "EnableAsyncWrite returns error");
+
+      // enough rounds for the writer thread to often free a buffer
+      // while the simulation thread is about to wait for one
+      for (uint32_t round = 0; round < 1000; ++round)
+        {
+          for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+            {
+              PacketEntry const & p = knownPackets[i];
+              f.Write (p.tsSec + round, p.tsUsec, data + round % 100, p.origLen);
+              g.Write (p.tsSec + round, p.tsUsec, data + round % 100, p.origLen);
+            }
+          if (round % 100 == 99)
+            {
+              g.Flush ();
+            }
+        }
+      g.Flush ();
+      NS_TEST_EXPECT_MSG_EQ (g.Fail (), false, "Asynchronous writes must not fail");
+      f.Close ();
+      g.Close ();
+
+      uint32_t sec (0), usec (0), packets (0);
+      bool diff = PcapFile::Diff (syncName, asyncName, sec, usec, packets, snapLens[s]);
+      NS_TEST_EXPECT_MSG_EQ (diff, false, "Asynchronous file differs from " << sec << "." << usec);
+      NS_TEST_EXPECT_MSG_EQ (packets, 1000 * N_KNOWN_PACKETS, "Wrong number of records");
+    }
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1141,3 +1212,17 @@ PcapFileTestSuite::PcapFileTestSuite ()
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
+
+class PcapFileAsyncTestSuite : public TestSuite
+{
+public:
+  PcapFileAsyncTestSuite ();
+};
+
+PcapFileAsyncTestSuite::PcapFileAsyncTestSuite ()
+  : TestSuite ("pcap-file-async", UNIT)
+{
+  AddTestCase (new AsyncWriteTestCase, TestCase::QUICK);
+}
+
+static PcapFileAsyncTestSuite pcapFileAsyncTestSuite;
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/radiotap-header.h"
+#include "ns3/packet.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * Check the layout of a radiotap header carrying DMG vendor fields and
+ * that it reads back unchanged.
+ */
+class RadiotapDmgTestCase : public TestCase
+{
+public:
+  RadiotapDmgTestCase ();
+  virtual void DoRun (void);
+};
+
+RadiotapDmgTestCase::RadiotapDmgTestCase ()
+  : TestCase ("Serialize and deserialize DMG radiotap fields")
+{
+}
+
+void
+RadiotapDmgTestCase::DoRun (void)
+{
+  RadiotapHeader plain;
+  plain.SetTsft (1234);
+  plain.SetFrameFlags (RadiotapHeader::FRAME_FLAG_FCS_INCLUDED);
+  NS_TEST_EXPECT_MSG_EQ (plain.GetSerializedSize (), 17, "Layout without vendor namespace changed");
+
+  RadiotapHeader header;
+  header.SetTsft (1234);
+  header.SetFrameFlags (RadiotapHeader::FRAME_FLAG_FCS_INCLUDED);
+  header.SetChannelFrequencyAndFlags (58320, RadiotapHeader::CHANNEL_FLAG_NONE);
+  header.SetAmpduStatus (7, RadiotapHeader::A_MPDU_STATUS_LAST_KNOWN, 0x5a);
+  header.SetDmgFields (RadiotapHeader::DMG_PHY_SC, 12);
+
+  // 12 bytes of bitmaps, TSFT aligned to 8, flags, channel aligned to 2,
+  // A-MPDU status aligned to 4, then the 8 bytes of vendor namespace.
+  NS_TEST_ASSERT_MSG_EQ (header.GetSerializedSize (), 48, "Wrong header length");
+
+  Ptr<Packet> p = Create<Packet> (10);
+  p->AddHeader (header);
+  uint8_t buf[48];
+  p->CopyData (buf, sizeof (buf));
+  NS_TEST_EXPECT_MSG_EQ (buf[2], 48, "Wrong length field");
+  NS_TEST_EXPECT_MSG_EQ ((buf[7] & 0xc0), 0xc0, "Vendor namespace and extension bits not set");
+  NS_TEST_EXPECT_MSG_EQ (buf[8], 1, "Wrong vendor bitmap");
+  NS_TEST_EXPECT_MSG_EQ (buf[16], (1234 & 0xff), "TSFT not aligned to 8 bytes");
+  NS_TEST_EXPECT_MSG_EQ (buf[24], RadiotapHeader::FRAME_FLAG_FCS_INCLUDED, "Wrong flags offset");
+  NS_TEST_EXPECT_MSG_EQ (buf[40], 0x4e, "Wrong OUI");
+  NS_TEST_EXPECT_MSG_EQ (buf[44], 2, "Wrong skip length");
+  NS_TEST_EXPECT_MSG_EQ (buf[46], RadiotapHeader::DMG_PHY_SC, "Wrong DMG PHY offset");
+  NS_TEST_EXPECT_MSG_EQ (buf[47], 12, "Wrong DMG MCS offset");
+
+  RadiotapHeader read;
+  p->RemoveHeader (read);
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 10, "Header not fully consumed");
+  NS_TEST_EXPECT_MSG_EQ (read.GetTsft (), 1234, "Wrong TSFT");
+  NS_TEST_EXPECT_MSG_EQ (read.GetChannelFrequency (), 58320, "Wrong frequency");
+  NS_TEST_EXPECT_MSG_EQ (read.GetAmpduStatusRef (), 7, "Wrong A-MPDU reference");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) read.GetDmgPhy (), RadiotapHeader::DMG_PHY_SC, "Wrong DMG PHY");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) read.GetDmgMcs (), 12, "Wrong DMG MCS");
+}
+
+static class RadiotapHeaderTestSuite : public TestSuite
+{
+public:
+  RadiotapHeaderTestSuite ()
+    : TestSuite ("radiotap-header", UNIT)
+  {
+    AddTestCase (new RadiotapDmgTestCase, TestCase::QUICK);
+  }
+} g_radiotapHeaderTestSuite;
@@ -0,0 +1,972 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace.h"
+#include "mac48-address.h"
+#include "ipv4-address.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTrace");
+
+NS_OBJECT_ENSURE_REGISTERED (BinaryTraceRecorder);
+
+const char BinaryTraceFormat::MAGIC[8] = { 'N', 'S', '3', 'B', 'T', 'R', 'C', 0 };
+const uint32_t BinaryTraceFormat::VERSION;
+const uint32_t BinaryTraceFormat::BLOCK_MAGIC;
+const uint16_t BinaryTraceFormat::SCHEMA_RECORD;
+const uint16_t BinaryTraceFormat::CONTEXT_RECORD;
+const uint16_t BinaryTraceFormat::FIRST_SCHEMA;
+const uint16_t BinaryTraceFormat::MAX_SCHEMAS;
+const uint32_t BinaryTraceFormat::MAX_RECORD_SIZE;
+
+/**
+ * \param size a size
+ * \returns size rounded up to a multiple of 8
+ */
+static uint32_t
+Align8 (uint32_t size)
+{
+  return (size + 7) & ~7U;
+}
+
+uint32_t
+BinaryTraceFormat::GetFieldSize (FieldType type)
+{
+  switch (type)
+    {
+    case BOOL:
+    case UINT8:
+      return 1;
+    case UINT16:
+      return 2;
+    case UINT32:
+    case INT32:
+    case IPV4:
+      return 4;
+    case MAC48:
+      return 6;
+    case UINT64:
+    case INT64:
+    case DOUBLE:
+    case TIME:
+      return 8;
+    case PACKET:
+      return 12;
+    default:
+      return 0;
+    }
+}
+
+const char *
+BinaryTraceFormat::GetTypeName (FieldType type)
+{
+  switch (type)
+    {
+    case BOOL:
+      return "bool";
+    case UINT8:
+      return "uint8";
+    case UINT16:
+      return "uint16";
+    case UINT32:
+      return "uint32";
+    case UINT64:
+      return "uint64";
+    case INT32:
+      return "int32";
+    case INT64:
+      return "int64";
+    case DOUBLE:
+      return "double";
+    case TIME:
+      return "time";
+    case MAC48:
+      return "mac48";
+    case IPV4:
+      return "ipv4";
+    case PACKET:
+      return "packet";
+    default:
+      return "none";
+    }
+}
+
+uint32_t
+BinaryTraceFormat::GetRecordSize (const Schema &schema)
+{
+  uint32_t size = sizeof (RecordHeader);
+  for (std::vector<Field>::const_iterator i = schema.fields.begin (); i != schema.fields.end (); ++i)
+    {
+      size += GetFieldSize (i->type);
+    }
+  return Align8 (size);
+}
+
+TypeId
+BinaryTraceRecorder::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BinaryTraceRecorder")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<BinaryTraceRecorder> ()
+    .AddAttribute ("RingSize",
+                   "The size in bytes of the ring buffer of each recording thread, "
+                   "rounded up to a power of two.",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&BinaryTraceRecorder::m_ringSize),
+                   MakeUintegerChecker<uint32_t> (1 << 17))
+    .AddAttribute ("FlushInterval",
+                   "The period, in milliseconds of wall-clock time, at which the "
+                   "writer thread drains the ring buffers to the file.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&BinaryTraceRecorder::m_flushInterval),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+BinaryTraceRecorder::BinaryTraceRecorder ()
+  : m_open (false)
+#ifdef HAVE_PTHREAD_H
+    ,
+    m_stop (false)
+#endif
+{
+  NS_LOG_FUNCTION (this);
+  BinaryTraceFormat::Schema reserved;
+  reserved.name = "schema";
+  m_schemas.push_back (reserved);
+  reserved.name = "context";
+  m_schemas.push_back (reserved);
+  std::memset (m_recordSize, 0, sizeof (m_recordSize));
+  m_contexts.push_back ("");
+  m_contextIds[""] = 0;
+}
+
+BinaryTraceRecorder::~BinaryTraceRecorder ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BinaryTraceRecorder::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  Object::DoDispose ();
+}
+
+bool
+BinaryTraceRecorder::Open (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  NS_ASSERT_MSG (!m_open, "BinaryTraceRecorder::Open(): already open");
+  m_file.open (fileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_file.is_open ())
+    {
+      return false;
+    }
+  BinaryTraceFormat::FileHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.magic, BinaryTraceFormat::MAGIC, sizeof (header.magic));
+  header.version = BinaryTraceFormat::VERSION;
+  header.headerSize = sizeof (header);
+  header.resolution = Time::GetResolution ();
+  m_file.write ((const char *)&header, sizeof (header));
+
+  uint32_t size = 1;
+  while (size < m_ringSize)
+    {
+      size <<= 1;
+    }
+  m_ringSize = size;
+#ifdef HAVE_PTHREAD_H
+  pthread_key_create (&m_ringKey, 0);
+  m_stop = false;
+#endif
+  m_open = true;
+
+  for (uint32_t i = BinaryTraceFormat::FIRST_SCHEMA; i < m_schemas.size (); i++)
+    {
+      WriteDefinition (BinaryTraceFormat::SCHEMA_RECORD, i, SerializeSchema (i));
+    }
+  for (uint32_t i = 1; i < m_contexts.size (); i++)
+    {
+      std::vector<uint8_t> payload (m_contexts[i].begin (), m_contexts[i].end ());
+      WriteDefinition (BinaryTraceFormat::CONTEXT_RECORD, i, payload);
+    }
+
+#ifdef HAVE_PTHREAD_H
+  m_thread = Create<SystemThread> (MakeCallback (&BinaryTraceRecorder::Run, this));
+  m_thread->Start ();
+#endif
+  return !m_file.fail ();
+}
+
+void
+BinaryTraceRecorder::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_open)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  m_ringsMutex.Lock ();
+  m_stop = true;
+  m_ringsMutex.Unlock ();
+  Kick ();
+  m_thread->Join ();
+  m_thread = 0;
+#endif
+  DrainAll ();
+  m_open = false;
+  m_file.close ();
+  for (std::vector<Ring *>::iterator i = m_rings.begin (); i != m_rings.end (); ++i)
+    {
+      delete [] (*i)->data;
+      delete *i;
+    }
+  m_rings.clear ();
+#ifdef HAVE_PTHREAD_H
+  pthread_key_delete (m_ringKey);
+#endif
+}
+
+bool
+BinaryTraceRecorder::IsOpen (void) const
+{
+  return m_open;
+}
+
+void
+BinaryTraceRecorder::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_open)
+    {
+      DrainAll ();
+    }
+}
+
+uint16_t
+BinaryTraceRecorder::AddSchema (const BinaryTraceFormat::Schema &schema)
+{
+  NS_LOG_FUNCTION (this << schema.name);
+  uint16_t id;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (m_ringsMutex);
+#endif
+    for (id = BinaryTraceFormat::FIRST_SCHEMA; id < m_schemas.size (); id++)
+      {
+        const BinaryTraceFormat::Schema &other = m_schemas[id];
+        if (other.name != schema.name)
+          {
+            continue;
+          }
+        bool same = other.fields.size () == schema.fields.size ();
+        for (uint32_t i = 0; same && i < schema.fields.size (); i++)
+          {
+            same = other.fields[i].name == schema.fields[i].name
+              && other.fields[i].type == schema.fields[i].type;
+          }
+        NS_ABORT_MSG_UNLESS (same, "Schema \"" << schema.name << "\" registered with different fields");
+        return id;
+      }
+    NS_ABORT_MSG_IF (m_schemas.size () >= BinaryTraceFormat::MAX_SCHEMAS, "Too many schemas");
+    uint32_t size = BinaryTraceFormat::GetRecordSize (schema);
+    NS_ABORT_MSG_IF (size > BinaryTraceFormat::MAX_RECORD_SIZE, "Records of \"" << schema.name << "\" are too large");
+    id = m_schemas.size ();
+    m_schemas.push_back (schema);
+    m_recordSize[id] = size;
+  }
+  if (m_open)
+    {
+      WriteDefinition (BinaryTraceFormat::SCHEMA_RECORD, id, SerializeSchema (id));
+    }
+  return id;
+}
+
+uint32_t
+BinaryTraceRecorder::AddContext (std::string context)
+{
+  NS_LOG_FUNCTION (this << context);
+  uint32_t id;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (m_ringsMutex);
+#endif
+    std::map<std::string, uint32_t>::const_iterator i = m_contextIds.find (context);
+    if (i != m_contextIds.end ())
+      {
+        return i->second;
+      }
+    id = m_contexts.size ();
+    m_contexts.push_back (context);
+    m_contextIds[context] = id;
+  }
+  if (m_open)
+    {
+      std::vector<uint8_t> payload (context.begin (), context.end ());
+      WriteDefinition (BinaryTraceFormat::CONTEXT_RECORD, id, payload);
+    }
+  return id;
+}
+
+const BinaryTraceFormat::Schema &
+BinaryTraceRecorder::GetSchema (uint16_t schema) const
+{
+  NS_ASSERT (schema < m_schemas.size ());
+  return m_schemas[schema];
+}
+
+uint64_t
+BinaryTraceRecorder::GetNRecords (void) const
+{
+  uint64_t n = 0;
+  for (std::vector<Ring *>::const_iterator i = m_rings.begin (); i != m_rings.end (); ++i)
+    {
+      n += __atomic_load_n (&(*i)->nRecords, __ATOMIC_RELAXED);
+    }
+  return n;
+}
+
+std::vector<uint8_t>
+BinaryTraceRecorder::SerializeSchema (uint16_t id) const
+{
+  // name, then for each field its type and name; strings are a
+  // 16-bit length followed by the characters.
+  const BinaryTraceFormat::Schema &schema = m_schemas[id];
+  std::vector<uint8_t> payload;
+  uint16_t n = schema.fields.size ();
+  payload.insert (payload.end (), (uint8_t *)&n, (uint8_t *)&n + 2);
+  uint16_t len = schema.name.size ();
+  payload.insert (payload.end (), (uint8_t *)&len, (uint8_t *)&len + 2);
+  payload.insert (payload.end (), schema.name.begin (), schema.name.end ());
+  for (std::vector<BinaryTraceFormat::Field>::const_iterator i = schema.fields.begin ();
+       i != schema.fields.end (); ++i)
+    {
+      payload.push_back (i->type);
+      len = i->name.size ();
+      payload.insert (payload.end (), (uint8_t *)&len, (uint8_t *)&len + 2);
+      payload.insert (payload.end (), i->name.begin (), i->name.end ());
+    }
+  return payload;
+}
+
+void
+BinaryTraceRecorder::WriteDefinition (uint16_t type, uint32_t id, const std::vector<uint8_t> &payload)
+{
+  NS_LOG_FUNCTION (this << type << id);
+  uint32_t size = Align8 (sizeof (BinaryTraceFormat::RecordHeader) + payload.size ());
+  NS_ABORT_MSG_IF (size > BinaryTraceFormat::MAX_RECORD_SIZE, "Definition too large");
+  Ring *ring = GetRing ();
+  uint8_t *p = ReserveRaw (ring, size);
+  std::memset (p, 0, size);
+  BinaryTraceFormat::RecordHeader header;
+  header.schema = type;
+  header.size = size;
+  header.context = id;
+  header.time = 0;
+  std::memcpy (p, &header, sizeof (header));
+  if (!payload.empty ())
+    {
+      std::memcpy (p + sizeof (header), &payload[0], payload.size ());
+    }
+  __atomic_store_n (&ring->tail, ring->pending, __ATOMIC_RELEASE);
+}
+
+BinaryTraceRecorder::Ring *
+BinaryTraceRecorder::GetRing (void)
+{
+  Ring *ring;
+#ifdef HAVE_PTHREAD_H
+  ring = (Ring *)pthread_getspecific (m_ringKey);
+  if (ring != 0)
+    {
+      return ring;
+    }
+#else
+  if (!m_rings.empty ())
+    {
+      return m_rings.front ();
+    }
+#endif
+  NS_LOG_FUNCTION (this);
+  ring = new Ring;
+  ring->data = new uint8_t[m_ringSize];
+  ring->head = 0;
+  ring->tail = 0;
+  ring->pending = 0;
+  ring->nRecords = 0;
+  ring->kicked = false;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (m_ringsMutex);
+#endif
+    ring->index = m_rings.size ();
+    m_rings.push_back (ring);
+  }
+#ifdef HAVE_PTHREAD_H
+  pthread_setspecific (m_ringKey, ring);
+#endif
+  return ring;
+}
+
+uint8_t *
+BinaryTraceRecorder::ReserveRaw (Ring *ring, uint32_t size)
+{
+  uint64_t t = ring->tail;
+  uint32_t offset = t & (m_ringSize - 1);
+  uint32_t skip = 0;
+  if (m_ringSize - offset < size)
+    {
+      // records never wrap: skip to the start of the ring
+      skip = m_ringSize - offset;
+    }
+  while (t + skip + size - __atomic_load_n (&ring->head, __ATOMIC_ACQUIRE) > m_ringSize)
+    {
+#ifdef HAVE_PTHREAD_H
+      Kick ();
+      m_drainedCondition.TimedWait (1000000);
+#else
+      Drain (ring);
+#endif
+    }
+  if (skip >= sizeof (BinaryTraceFormat::RecordHeader))
+    {
+      BinaryTraceFormat::RecordHeader pad;
+      pad.schema = BinaryTraceFormat::SCHEMA_RECORD;
+      pad.size = 0;
+      pad.context = 0;
+      pad.time = 0;
+      std::memcpy (ring->data + offset, &pad, sizeof (pad));
+    }
+  ring->pending = t + skip + size;
+  return ring->data + ((t + skip) & (m_ringSize - 1));
+}
+
+uint8_t *
+BinaryTraceRecorder::Reserve (uint16_t schema, uint32_t context)
+{
+  NS_ASSERT_MSG (m_open, "BinaryTraceRecorder::Reserve(): file not open");
+  NS_ASSERT (schema >= BinaryTraceFormat::FIRST_SCHEMA && schema < m_schemas.size ());
+  uint32_t size = m_recordSize[schema];
+  Ring *ring = GetRing ();
+  uint8_t *p = ReserveRaw (ring, size);
+  BinaryTraceFormat::RecordHeader header;
+  header.schema = schema;
+  header.size = size;
+  header.context = context;
+  header.time = Simulator::Now ().GetTimeStep ();
+  // clear the padding so that files are reproducible
+  std::memset (p + size - 8, 0, 8);
+  std::memcpy (p, &header, sizeof (header));
+  return p + sizeof (header);
+}
+
+void
+BinaryTraceRecorder::Commit (void)
+{
+  Ring *ring = GetRing ();
+  __atomic_store_n (&ring->nRecords, ring->nRecords + 1, __ATOMIC_RELAXED);
+  __atomic_store_n (&ring->tail, ring->pending, __ATOMIC_RELEASE);
+#ifdef HAVE_PTHREAD_H
+  if (ring->pending - __atomic_load_n (&ring->head, __ATOMIC_RELAXED) > m_ringSize / 2
+      && !__atomic_exchange_n (&ring->kicked, true, __ATOMIC_ACQ_REL))
+    {
+      Kick ();
+    }
+#endif
+}
+
+void
+BinaryTraceRecorder::DrainAll (void)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection drain (m_drainMutex);
+  m_ringsMutex.Lock ();
+  std::vector<Ring *> rings = m_rings;
+  m_ringsMutex.Unlock ();
+#else
+  std::vector<Ring *> &rings = m_rings;
+#endif
+  for (std::vector<Ring *>::iterator i = rings.begin (); i != rings.end (); ++i)
+    {
+      Drain (*i);
+    }
+  m_file.flush ();
+}
+
+void
+BinaryTraceRecorder::Drain (Ring *ring)
+{
+  uint64_t head = ring->head;
+  uint64_t tail = __atomic_load_n (&ring->tail, __ATOMIC_ACQUIRE);
+  if (head == tail)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << ring->index << head << tail);
+  uint32_t mask = m_ringSize - 1;
+
+  // Find the contiguous runs of records between the wrap-around
+  // padding: there is at most one in a lap.
+  uint64_t runs[2][2];
+  uint32_t nRuns = 0;
+  uint64_t start = head;
+  uint64_t p = head;
+  while (p != tail)
+    {
+      uint32_t offset = p & mask;
+      bool pad = m_ringSize - offset < sizeof (BinaryTraceFormat::RecordHeader);
+      if (!pad)
+        {
+          BinaryTraceFormat::RecordHeader header;
+          std::memcpy (&header, ring->data + offset, sizeof (header));
+          pad = header.size == 0;
+          if (!pad)
+            {
+              p += header.size;
+              continue;
+            }
+        }
+      if (p != start)
+        {
+          NS_ASSERT (nRuns < 2);
+          runs[nRuns][0] = start;
+          runs[nRuns][1] = p;
+          nRuns++;
+        }
+      p += m_ringSize - offset;
+      start = p;
+    }
+  if (p != start)
+    {
+      NS_ASSERT (nRuns < 2);
+      runs[nRuns][0] = start;
+      runs[nRuns][1] = p;
+      nRuns++;
+    }
+
+  BinaryTraceFormat::BlockHeader block;
+  block.magic = BinaryTraceFormat::BLOCK_MAGIC;
+  block.size = 0;
+  block.thread = ring->index;
+  block.reserved = 0;
+  for (uint32_t i = 0; i < nRuns; i++)
+    {
+      block.size += runs[i][1] - runs[i][0];
+    }
+  if (block.size > 0)
+    {
+      m_file.write ((const char *)&block, sizeof (block));
+      for (uint32_t i = 0; i < nRuns; i++)
+        {
+          m_file.write ((const char *)ring->data + (runs[i][0] & mask), runs[i][1] - runs[i][0]);
+        }
+    }
+  __atomic_store_n (&ring->head, tail, __ATOMIC_RELEASE);
+  __atomic_store_n (&ring->kicked, false, __ATOMIC_RELEASE);
+}
+
+#ifdef HAVE_PTHREAD_H
+
+void
+BinaryTraceRecorder::Kick (void)
+{
+  m_kickCondition.SetCondition (true);
+  m_kickCondition.Signal ();
+}
+
+void
+BinaryTraceRecorder::Run (void)
+{
+  // SystemCondition forgets a signal sent before a wait starts, so
+  // always wait with a timeout.
+  while (true)
+    {
+      m_kickCondition.TimedWait (uint64_t (m_flushInterval) * 1000000);
+      m_ringsMutex.Lock ();
+      bool stop = m_stop;
+      m_ringsMutex.Unlock ();
+      DrainAll ();
+      m_drainedCondition.SetCondition (true);
+      m_drainedCondition.Broadcast ();
+      if (stop)
+        {
+          return;
+        }
+    }
+}
+
+#else /* HAVE_PTHREAD_H */
+
+void
+BinaryTraceRecorder::Kick (void)
+{
+}
+
+void
+BinaryTraceRecorder::Run (void)
+{
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_data (0),
+    m_size (0),
+    m_block (0),
+    m_record (0),
+    m_nRecords (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceReader::~BinaryTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+BinaryTraceReader::Open (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  Close ();
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || st.st_size < (off_t)sizeof (BinaryTraceFormat::FileHeader))
+    {
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      return false;
+    }
+  m_data = (const uint8_t *)data;
+  m_size = st.st_size;
+
+  const BinaryTraceFormat::FileHeader *header = (const BinaryTraceFormat::FileHeader *)m_data;
+  if (std::memcmp (header->magic, BinaryTraceFormat::MAGIC, sizeof (header->magic)) != 0
+      || header->version != BinaryTraceFormat::VERSION
+      || header->headerSize != sizeof (BinaryTraceFormat::FileHeader))
+    {
+      Close ();
+      return false;
+    }
+
+  // First pass: check the structure and collect the definitions.
+  uint64_t block = sizeof (BinaryTraceFormat::FileHeader);
+  while (block + sizeof (BinaryTraceFormat::BlockHeader) <= m_size)
+    {
+      BinaryTraceFormat::BlockHeader bh;
+      std::memcpy (&bh, m_data + block, sizeof (bh));
+      uint64_t end = block + sizeof (bh) + bh.size;
+      if (bh.magic != BinaryTraceFormat::BLOCK_MAGIC || end > m_size)
+        {
+          Close ();
+          return false;
+        }
+      uint64_t record = block + sizeof (bh);
+      while (record < end)
+        {
+          const BinaryTraceFormat::RecordHeader *rh = (const BinaryTraceFormat::RecordHeader *)(m_data + record);
+          if (rh->size < sizeof (BinaryTraceFormat::RecordHeader) || record + rh->size > end)
+            {
+              Close ();
+              return false;
+            }
+          if (rh->schema < BinaryTraceFormat::FIRST_SCHEMA)
+            {
+              if (!ReadDefinition (rh))
+                {
+                  Close ();
+                  return false;
+                }
+            }
+          else
+            {
+              m_nRecords++;
+            }
+          record += rh->size;
+        }
+      block = end;
+    }
+  Rewind ();
+  return true;
+}
+
+bool
+BinaryTraceReader::ReadDefinition (const BinaryTraceFormat::RecordHeader *header)
+{
+  const uint8_t *p = (const uint8_t *)(header + 1);
+  const uint8_t *end = (const uint8_t *)header + header->size;
+  if (header->schema == BinaryTraceFormat::CONTEXT_RECORD)
+    {
+      // the string fills the record up to the zero padding
+      const uint8_t *last = end;
+      while (last > p && last[-1] == 0)
+        {
+          last--;
+        }
+      m_contexts[header->context] = std::string ((const char *)p, last - p);
+      return true;
+    }
+  uint16_t n, len;
+  if (end - p < 4)
+    {
+      return false;
+    }
+  std::memcpy (&n, p, 2);
+  std::memcpy (&len, p + 2, 2);
+  p += 4;
+  if (end - p < len)
+    {
+      return false;
+    }
+  BinaryTraceFormat::Schema schema;
+  schema.name = std::string ((const char *)p, len);
+  p += len;
+  std::vector<uint32_t> offsets;
+  uint32_t offset = 0;
+  for (uint16_t i = 0; i < n; i++)
+    {
+      if (end - p < 3)
+        {
+          return false;
+        }
+      BinaryTraceFormat::Field field;
+      field.type = (BinaryTraceFormat::FieldType)p[0];
+      std::memcpy (&len, p + 1, 2);
+      p += 3;
+      if (end - p < len)
+        {
+          return false;
+        }
+      field.name = std::string ((const char *)p, len);
+      p += len;
+      schema.fields.push_back (field);
+      offsets.push_back (offset);
+      offset += BinaryTraceFormat::GetFieldSize (field.type);
+    }
+  m_schemas[header->context] = schema;
+  m_offsets[header->context] = offsets;
+  return true;
+}
+
+void
+BinaryTraceReader::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      munmap ((void *)m_data, m_size);
+    }
+  m_data = 0;
+  m_size = 0;
+  m_nRecords = 0;
+  m_schemas.clear ();
+  m_offsets.clear ();
+  m_contexts.clear ();
+}
+
+void
+BinaryTraceReader::Rewind (void)
+{
+  m_block = sizeof (BinaryTraceFormat::FileHeader);
+  m_record = m_block + sizeof (BinaryTraceFormat::BlockHeader);
+}
+
+bool
+BinaryTraceReader::Next (Record &record)
+{
+  while (m_data != 0 && m_block + sizeof (BinaryTraceFormat::BlockHeader) <= m_size)
+    {
+      BinaryTraceFormat::BlockHeader bh;
+      std::memcpy (&bh, m_data + m_block, sizeof (bh));
+      uint64_t end = m_block + sizeof (bh) + bh.size;
+      if (m_record >= end)
+        {
+          m_block = end;
+          m_record = m_block + sizeof (bh);
+          continue;
+        }
+      BinaryTraceFormat::RecordHeader rh;
+      std::memcpy (&rh, m_data + m_record, sizeof (rh));
+      const uint8_t *data = m_data + m_record + sizeof (rh);
+      m_record += rh.size;
+      if (rh.schema < BinaryTraceFormat::FIRST_SCHEMA)
+        {
+          continue;
+        }
+      record.schema = rh.schema;
+      record.context = rh.context;
+      record.thread = bh.thread;
+      record.time = TimeStep (rh.time);
+      record.data = data;
+      return true;
+    }
+  return false;
+}
+
+bool
+BinaryTraceReader::HasSchema (uint16_t schema) const
+{
+  return m_schemas.find (schema) != m_schemas.end ();
+}
+
+const BinaryTraceFormat::Schema &
+BinaryTraceReader::GetSchema (uint16_t schema) const
+{
+  std::map<uint16_t, BinaryTraceFormat::Schema>::const_iterator i = m_schemas.find (schema);
+  NS_ASSERT_MSG (i != m_schemas.end (), "Schema " << schema << " not defined");
+  return i->second;
+}
+
+std::string
+BinaryTraceReader::GetContext (uint32_t context) const
+{
+  std::map<uint32_t, std::string>::const_iterator i = m_contexts.find (context);
+  if (i == m_contexts.end ())
+    {
+      return "";
+    }
+  return i->second;
+}
+
+uint64_t
+BinaryTraceReader::GetNRecords (void) const
+{
+  return m_nRecords;
+}
+
+std::string
+BinaryTraceReader::FormatField (const Record &record, uint32_t field) const
+{
+  const BinaryTraceFormat::Schema &schema = GetSchema (record.schema);
+  NS_ASSERT (field < schema.fields.size ());
+  const uint8_t *p = record.data + m_offsets.find (record.schema)->second[field];
+  std::ostringstream oss;
+  switch (schema.fields[field].type)
+    {
+    case BinaryTraceFormat::BOOL:
+      oss << (p[0] ? "true" : "false");
+      break;
+    case BinaryTraceFormat::UINT8:
+      oss << (uint32_t)p[0];
+      break;
+    case BinaryTraceFormat::UINT16:
+      {
+        uint16_t v;
+        std::memcpy (&v, p, sizeof (v));
+        oss << v;
+      }
+      break;
+    case BinaryTraceFormat::UINT32:
+      {
+        uint32_t v;
+        std::memcpy (&v, p, sizeof (v));
+        oss << v;
+      }
+      break;
+    case BinaryTraceFormat::UINT64:
+      {
+        uint64_t v;
+        std::memcpy (&v, p, sizeof (v));
+        oss << v;
+      }
+      break;
+    case BinaryTraceFormat::INT32:
+      {
+        int32_t v;
+        std::memcpy (&v, p, sizeof (v));
+        oss << v;
+      }
+      break;
+    case BinaryTraceFormat::INT64:
+      {
+        int64_t v;
+        std::memcpy (&v, p, sizeof (v));
+        oss << v;
+      }
+      break;
+    case BinaryTraceFormat::DOUBLE:
+      {
+        double v;
+        std::memcpy (&v, p, sizeof (v));
+        oss << v;
+      }
+      break;
+    case BinaryTraceFormat::TIME:
+      {
+        int64_t v;
+        std::memcpy (&v, p, sizeof (v));
+        oss << TimeStep (v).GetSeconds ();
+      }
+      break;
+    case BinaryTraceFormat::MAC48:
+      {
+        Mac48Address address;
+        address.CopyFrom (p);
+        oss << address;
+      }
+      break;
+    case BinaryTraceFormat::IPV4:
+      {
+        uint32_t v;
+        std::memcpy (&v, p, sizeof (v));
+        oss << Ipv4Address (v);
+      }
+      break;
+    case BinaryTraceFormat::PACKET:
+      {
+        uint64_t uid;
+        uint32_t size;
+        std::memcpy (&uid, p, sizeof (uid));
+        std::memcpy (&size, p + 8, sizeof (size));
+        oss << uid << ":" << size;
+      }
+      break;
+    default:
+      break;
+    }
+  return oss.str ();
+}
+
+} // namespace ns3
@@ -0,0 +1,391 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_H
+#define BINARY_TRACE_H
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ * \brief Layout of the files written by BinaryTraceRecorder.
+ *
+ * A trace file starts with a FileHeader, followed by blocks.  Each
+ * block is a BlockHeader followed by records written by the same
+ * thread, in the order they were recorded.  Blocks of different
+ * threads are interleaved, so the file is only sorted by time within a
+ * thread.
+ *
+ * A record is a RecordHeader followed by the fields of its schema,
+ * packed without alignment, and padded to a multiple of 8 bytes.  Two
+ * schemas are reserved: SCHEMA_RECORD defines a schema and
+ * CONTEXT_RECORD an interned context string.  A definition always
+ * precedes its first use in the records of a thread, but may be in a
+ * later block than a use from another thread.  Values are in host
+ * byte order.
+ */
+struct BinaryTraceFormat
+{
+  /// File magic
+  static const char MAGIC[8];
+  /// Current format version
+  static const uint32_t VERSION = 1;
+  /// Block magic ("BTBK")
+  static const uint32_t BLOCK_MAGIC = 0x4b425442;
+  /// Schema of the records defining a schema
+  static const uint16_t SCHEMA_RECORD = 0;
+  /// Schema of the records defining a context
+  static const uint16_t CONTEXT_RECORD = 1;
+  /// First schema available to users
+  static const uint16_t FIRST_SCHEMA = 2;
+  /// Maximum number of schemas in a file
+  static const uint16_t MAX_SCHEMAS = 1024;
+  /// Maximum size of a record, header included
+  static const uint32_t MAX_RECORD_SIZE = 0xfff8;
+
+  /// Type of a record field
+  enum FieldType
+  {
+    NONE = 0, //!< Not recorded
+    BOOL,     //!< 1 byte
+    UINT8,    //!< 1 byte
+    UINT16,   //!< 2 bytes
+    UINT32,   //!< 4 bytes
+    UINT64,   //!< 8 bytes
+    INT32,    //!< 4 bytes
+    INT64,    //!< 8 bytes
+    DOUBLE,   //!< 8 bytes
+    TIME,     //!< 8 bytes, in time steps
+    MAC48,    //!< 6 bytes
+    IPV4,     //!< 4 bytes, host order
+    PACKET    //!< 8 bytes of packet uid then 4 bytes of packet size
+  };
+
+  /// Header at the start of a trace file
+  struct FileHeader
+  {
+    char magic[8];       //!< MAGIC
+    uint32_t version;    //!< VERSION
+    uint32_t headerSize; //!< sizeof (FileHeader)
+    int64_t resolution;  //!< Time::GetResolution of the simulation
+  };
+
+  /// Header at the start of a block
+  struct BlockHeader
+  {
+    uint32_t magic;     //!< BLOCK_MAGIC
+    uint32_t size;      //!< Size of the records following the header
+    uint32_t thread;    //!< Index of the thread which wrote the records
+    uint32_t reserved;  //!< Zero
+  };
+
+  /// Header at the start of a record
+  struct RecordHeader
+  {
+    uint16_t schema;  //!< Schema of the record
+    uint16_t size;    //!< Size of the record, header included
+    uint32_t context; //!< Context of the record, or defined id
+    int64_t time;     //!< Simulation time, in time steps
+  };
+
+  /// A named field of a schema
+  struct Field
+  {
+    std::string name; //!< Field name
+    FieldType type;   //!< Field type
+  };
+
+  /// A named list of fields
+  struct Schema
+  {
+    std::string name;          //!< Schema name
+    std::vector<Field> fields; //!< Fields, in record order
+  };
+
+  /**
+   * \param type a field type
+   * \returns the number of bytes used by the field in a record
+   */
+  static uint32_t GetFieldSize (FieldType type);
+  /**
+   * \param type a field type
+   * \returns the name of the type
+   */
+  static const char * GetTypeName (FieldType type);
+  /**
+   * \param schema a schema
+   * \returns the size of its records, header and padding included
+   */
+  static uint32_t GetRecordSize (const Schema &schema);
+};
+
+/**
+ * \ingroup network
+ * \brief Record typed trace events into a binary file.
+ *
+ * Formatting trace events as text is usually much slower than the
+ * simulation code firing them.  The recorder instead copies the raw
+ * fields of each event, as described by a schema registered with
+ * AddSchema, into a ring buffer owned by the calling thread.  Context
+ * strings are interned once with AddContext and recorded as a 32-bit
+ * id.
+ *
+ * Recording does not take any lock: each thread has its own single
+ * producer, single consumer ring, and a background thread drains the
+ * rings to the file every FlushInterval, or earlier when a ring is half
+ * full.  When a ring is full, the recording thread waits for it to be
+ * drained.  Without pthread support the rings are drained
+ * synchronously when full.
+ *
+ * The records are usually written by the sinks of BinaryTraceHelper.
+ * The files can be read with BinaryTraceReader or the
+ * binary-trace-decode utility.
+ */
+class BinaryTraceRecorder : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  BinaryTraceRecorder ();
+  virtual ~BinaryTraceRecorder ();
+
+  /**
+   * Create the file, write the definitions registered so far and start
+   * the writer thread.
+   *
+   * \param fileName the file to write
+   * \returns false if the file can't be created
+   */
+  bool Open (std::string fileName);
+  /** Write the pending records and close the file. */
+  void Close (void);
+  /** Wait until all the records committed so far are written. */
+  void Flush (void);
+  /** \returns true if the file is open */
+  bool IsOpen (void) const;
+
+  /**
+   * Register a schema.  Registering the same name and fields again
+   * returns the same id.
+   *
+   * \param schema the schema
+   * \returns the id of the schema
+   */
+  uint16_t AddSchema (const BinaryTraceFormat::Schema &schema);
+  /**
+   * \param context a context string
+   * \returns the id of the string, the same for equal strings
+   */
+  uint32_t AddContext (std::string context);
+  /**
+   * \param schema a schema id
+   * \returns the fields of the schema
+   */
+  const BinaryTraceFormat::Schema & GetSchema (uint16_t schema) const;
+
+  /**
+   * Start a record in the ring of the calling thread.  The record
+   * becomes visible to the writer thread with Commit.
+   *
+   * \param schema the schema of the record
+   * \param context the context id of the record
+   * \returns where to write the fields of the record
+   */
+  uint8_t * Reserve (uint16_t schema, uint32_t context);
+  /** Publish the record started by the last Reserve of this thread. */
+  void Commit (void);
+
+  /** \returns the number of records committed */
+  uint64_t GetNRecords (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// A single producer, single consumer ring of records
+  struct Ring
+  {
+    uint8_t *data;     //!< the records
+    uint64_t head;     //!< position of the first record not written yet
+    uint64_t tail;     //!< position after the last committed record
+    uint64_t pending;  //!< position after the reserved record
+    uint64_t nRecords; //!< records committed
+    uint32_t index;    //!< index of the ring, written in block headers
+    bool kicked;       //!< the writer thread was asked to drain the ring
+  };
+
+  /** \returns the ring of the calling thread, created on first use */
+  Ring * GetRing (void);
+  /**
+   * Reserve room for a record in a ring, waiting for the writer if needed.
+   * \param ring the ring
+   * \param size the size of the record
+   * \returns the start of the record
+   */
+  uint8_t * ReserveRaw (Ring *ring, uint32_t size);
+  /**
+   * Record a schema or context definition.
+   * \param type SCHEMA_RECORD or CONTEXT_RECORD
+   * \param id the id defined
+   * \param payload the serialized definition
+   */
+  void WriteDefinition (uint16_t type, uint32_t id, const std::vector<uint8_t> &payload);
+  /**
+   * \param id a schema id
+   * \returns the serialized schema definition
+   */
+  std::vector<uint8_t> SerializeSchema (uint16_t id) const;
+  /** Write the committed records of every ring to the file. */
+  void DrainAll (void);
+  /**
+   * Write the committed records of a ring to the file.
+   * \param ring the ring
+   */
+  void Drain (Ring *ring);
+  /** Ask the writer thread to drain the rings now. */
+  void Kick (void);
+  /** Writer thread body. */
+  void Run (void);
+
+  uint32_t m_ringSize;       //!< size of each ring, a power of two
+  uint32_t m_flushInterval;  //!< period of the writer thread, in ms
+  std::ofstream m_file;      //!< the file
+  bool m_open;               //!< the file is open
+  std::vector<BinaryTraceFormat::Schema> m_schemas; //!< schemas by id
+  uint32_t m_recordSize[BinaryTraceFormat::MAX_SCHEMAS]; //!< record sizes by schema id
+  std::map<std::string, uint32_t> m_contextIds; //!< interned contexts
+  std::vector<std::string> m_contexts;          //!< contexts by id
+  std::vector<Ring *> m_rings; //!< all the rings
+#ifdef HAVE_PTHREAD_H
+  pthread_key_t m_ringKey;     //!< ring of each thread
+  bool m_stop;                 //!< ask the writer thread to exit
+  SystemMutex m_ringsMutex;    //!< protects m_rings and the definitions
+  SystemMutex m_drainMutex;    //!< held while writing to the file
+  SystemCondition m_kickCondition;    //!< a ring needs draining, or m_stop
+  SystemCondition m_drainedCondition; //!< rings were drained
+  Ptr<SystemThread> m_thread;  //!< the writer thread
+#endif
+};
+
+/**
+ * \ingroup network
+ * \brief Memory-mapped reader for the files written by BinaryTraceRecorder.
+ *
+ * Open collects the schema and context definitions of the whole file,
+ * then Next returns the data records in file order.
+ */
+class BinaryTraceReader
+{
+public:
+  /// A data record; the fields point into the mapped file
+  struct Record
+  {
+    uint16_t schema;     //!< Schema id
+    uint32_t context;    //!< Context id
+    uint32_t thread;     //!< Index of the recording thread
+    Time time;           //!< Simulation time of the record
+    const uint8_t *data; //!< Packed fields
+  };
+
+  BinaryTraceReader ();
+  ~BinaryTraceReader ();
+
+  /**
+   * \param fileName the file to read
+   * \returns true if the file could be mapped and is well formed
+   */
+  bool Open (std::string fileName);
+  /** Unmap the file */
+  void Close (void);
+  /** Restart from the first record */
+  void Rewind (void);
+  /**
+   * \param record the next data record
+   * \returns false at the end of the file
+   */
+  bool Next (Record &record);
+
+  /**
+   * \param schema a schema id
+   * \returns true if the schema is defined in the file
+   */
+  bool HasSchema (uint16_t schema) const;
+  /**
+   * \param schema a schema id
+   * \returns the schema
+   */
+  const BinaryTraceFormat::Schema & GetSchema (uint16_t schema) const;
+  /**
+   * \param context a context id
+   * \returns the context string, empty if not defined
+   */
+  std::string GetContext (uint32_t context) const;
+  /** \returns the number of data records in the file */
+  uint64_t GetNRecords (void) const;
+
+  /**
+   * \param record a record
+   * \param field the index of a field of its schema
+   * \returns the field as text
+   */
+  std::string FormatField (const Record &record, uint32_t field) const;
+
+private:
+  /// Defined and not implemented to avoid misuse
+  BinaryTraceReader (const BinaryTraceReader &);
+  /// Defined and not implemented to avoid misuse
+  /// \returns
+  BinaryTraceReader & operator = (const BinaryTraceReader &);
+
+  /**
+   * Read a definition record.
+   * \param header the record header
+   * \returns false if the definition is malformed
+   */
+  bool ReadDefinition (const BinaryTraceFormat::RecordHeader *header);
+
+  const uint8_t *m_data;  //!< the mapped file
+  uint64_t m_size;        //!< size of the mapped file
+  uint64_t m_block;       //!< offset of the current block
+  uint64_t m_record;      //!< offset of the next record
+  uint64_t m_nRecords;    //!< number of data records
+  std::map<uint16_t, BinaryTraceFormat::Schema> m_schemas; //!< schemas by id
+  std::map<uint16_t, std::vector<uint32_t> > m_offsets;    //!< field offsets by schema id
+  std::map<uint32_t, std::string> m_contexts;              //!< contexts by id
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_H */
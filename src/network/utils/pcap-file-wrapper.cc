@@ -18,6 +18,7 @@
 
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -40,6 +41,17 @@ PcapFileWrapper::GetTypeId (void)
                    UintegerValue (PcapFile::SNAPLEN_DEFAULT),
                    MakeUintegerAccessor (&PcapFileWrapper::m_snapLen),
                    MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("AsyncWrite",
+                   "Serialize the packets into memory buffers written to the file "
+                   "by a background thread (cf. PcapFile::EnableAsyncWrite)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AsyncBufferSize",
+                   "Size of each of the asynchronous write buffers",
+                   UintegerValue (PcapFile::ASYNC_BUFFER_SIZE_DEFAULT),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_asyncBufferSize),
+                   MakeUintegerChecker<uint32_t> (4096))
   ;
   return tid;
 }
@@ -107,6 +119,10 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
     {
       m_file.Init (dataLinkType, m_snapLen, tzCorrection);
     } 
+  if (m_asyncWrite && !m_file.Fail ())
+    {
+      m_file.EnableAsyncWrite (m_asyncBufferSize);
+    }
 }
 
 void
@@ -215,6 +215,8 @@ public:
 private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
+  bool m_asyncWrite; //!< write through a background thread
+  uint32_t m_asyncBufferSize; //!< size of the asynchronous write buffers
 };
 
 } // namespace ns3
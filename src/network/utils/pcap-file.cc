@@ -20,6 +20,8 @@
 
 #include <iostream>
 #include <cstring>
+#include <list>
+#include <algorithm>
 #include "ns3/assert.h"
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
@@ -29,6 +31,13 @@
 #include "pcap-file.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#include "ns3/callback.h"
+#endif
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
 // adding any ns-3 specific constructs such as Packet to this file.
@@ -47,9 +56,314 @@ const uint32_t NS_SWAPPED_MAGIC = 0xd43cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
 
+const uint32_t PcapFile::ASYNC_BUFFER_SIZE_DEFAULT;
+const uint32_t PcapFile::ASYNC_BUFFER_COUNT_DEFAULT;
+
+/**
+ * \brief Buffers pcap records and writes them from a background thread.
+ *
+ * The simulation thread fills the current chunk; full chunks are
+ * queued to the writer thread, which returns them to the free list
+ * once written.  At most a fixed number of chunks exist, so a
+ * simulation producing records faster than the disk absorbs them
+ * eventually waits in Reserve.
+ */
+class PcapAsyncWriter
+{
+public:
+  /**
+   * \param file the file to write to
+   * \param chunkSize size of each chunk
+   * \param nChunks maximum number of chunks
+   */
+  PcapAsyncWriter (std::fstream *file, uint32_t chunkSize, uint32_t nChunks);
+  /** Write the pending records and stop the thread. */
+  ~PcapAsyncWriter ();
+
+  /**
+   * \param size the size of the record
+   * \returns room for the record in the current chunk
+   */
+  uint8_t * Reserve (uint32_t size);
+  /** Wait until all the records reserved so far are written. */
+  void Flush (void);
+  /** \returns true if a write failed */
+  bool HasFailed (void);
+
+private:
+  /** A buffer of records */
+  struct Chunk
+  {
+    uint8_t *data;     //!< the records
+    uint32_t capacity; //!< size of data
+    uint32_t used;     //!< bytes used in data
+  };
+
+  /** Queue the current chunk and get a free one. */
+  void Submit (void);
+  /**
+   * Write a chunk to the file.
+   * \param chunk the chunk
+   */
+  void WriteChunk (Chunk *chunk);
+  /** Writer thread body. */
+  void Run (void);
+#ifdef HAVE_PTHREAD_H
+  /**
+   * Wait until a condition is set, or for at most 1 ms.
+   * \param condition the condition, cleared under m_mutex by the caller
+   */
+  static void WaitFor (SystemCondition &condition);
+#endif
+
+  std::fstream *m_file;      //!< the file
+  uint32_t m_chunkSize;      //!< size of the chunks
+  uint32_t m_maxChunks;      //!< maximum number of chunks
+  uint32_t m_nChunks;        //!< number of chunks allocated
+  Chunk *m_current;          //!< chunk being filled
+  bool m_failed;             //!< a write failed
+#ifdef HAVE_PTHREAD_H
+  std::list<Chunk *> m_full; //!< chunks waiting to be written
+  std::list<Chunk *> m_free; //!< chunks available
+  uint32_t m_writing;        //!< chunks being written
+  bool m_stop;               //!< ask the thread to exit
+  SystemMutex m_mutex;       //!< protects the lists, m_writing, m_stop and m_failed
+  SystemCondition m_fullCondition; //!< m_full is not empty, or m_stop
+  SystemCondition m_freeCondition; //!< a chunk was written
+  Ptr<SystemThread> m_thread;      //!< the writer thread
+#endif
+};
+
+PcapAsyncWriter::PcapAsyncWriter (std::fstream *file, uint32_t chunkSize, uint32_t nChunks)
+  : m_file (file),
+    m_chunkSize (chunkSize),
+    m_maxChunks (std::max (nChunks, 2U)),
+    m_nChunks (1),
+    m_failed (false)
+#ifdef HAVE_PTHREAD_H
+    ,
+    m_writing (0),
+    m_stop (false)
+#endif
+{
+  NS_LOG_FUNCTION (this << file << chunkSize << nChunks);
+  m_current = new Chunk;
+  m_current->data = new uint8_t[m_chunkSize];
+  m_current->capacity = m_chunkSize;
+  m_current->used = 0;
+#ifdef HAVE_PTHREAD_H
+  m_thread = Create<SystemThread> (MakeCallback (&PcapAsyncWriter::Run, this));
+  m_thread->Start ();
+#endif
+}
+
+PcapAsyncWriter::~PcapAsyncWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  m_mutex.Lock ();
+  m_stop = true;
+  m_mutex.Unlock ();
+  m_fullCondition.SetCondition (true);
+  m_fullCondition.Signal ();
+  m_thread->Join ();
+  m_thread = 0;
+  for (std::list<Chunk *>::iterator i = m_free.begin (); i != m_free.end (); ++i)
+    {
+      delete [] (*i)->data;
+      delete *i;
+    }
+#endif
+  delete [] m_current->data;
+  delete m_current;
+}
+
+uint8_t *
+PcapAsyncWriter::Reserve (uint32_t size)
+{
+  if (m_current->capacity - m_current->used < size)
+    {
+      Submit ();
+      if (m_current->capacity < size)
+        {
+          // a record larger than a chunk gets a chunk of its own
+          delete [] m_current->data;
+          m_current->data = new uint8_t[size];
+          m_current->capacity = size;
+        }
+    }
+  uint8_t *p = m_current->data + m_current->used;
+  m_current->used += size;
+  return p;
+}
+
+void
+PcapAsyncWriter::WriteChunk (Chunk *chunk)
+{
+  m_file->write ((const char *)chunk->data, chunk->used);
+  chunk->used = 0;
+  if (chunk->capacity != m_chunkSize)
+    {
+      delete [] chunk->data;
+      chunk->data = new uint8_t[m_chunkSize];
+      chunk->capacity = m_chunkSize;
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+
+void
+PcapAsyncWriter::WaitFor (SystemCondition &condition)
+{
+  // SystemCondition::Wait clears the condition before it blocks, and
+  // would forget a signal sent since the caller cleared it under
+  // m_mutex.  TimedWait keeps it, and the timeout is a safety net: the
+  // callers check their state again in any case.
+  condition.TimedWait (1000000);
+}
+
+void
+PcapAsyncWriter::Submit (void)
+{
+  if (m_current->used == 0)
+    {
+      return;
+    }
+  m_mutex.Lock ();
+  m_full.push_back (m_current);
+  m_current = 0;
+  if (!m_free.empty ())
+    {
+      m_current = m_free.front ();
+      m_free.pop_front ();
+    }
+  else if (m_nChunks < m_maxChunks)
+    {
+      m_nChunks++;
+      m_mutex.Unlock ();
+      m_current = new Chunk;
+      m_current->data = new uint8_t[m_chunkSize];
+      m_current->capacity = m_chunkSize;
+      m_current->used = 0;
+      m_mutex.Lock ();
+    }
+  m_mutex.Unlock ();
+  m_fullCondition.SetCondition (true);
+  m_fullCondition.Signal ();
+
+  // Backpressure: all the chunks are queued, wait for the thread.
+  while (m_current == 0)
+    {
+      m_mutex.Lock ();
+      if (!m_free.empty ())
+        {
+          m_current = m_free.front ();
+          m_free.pop_front ();
+          m_mutex.Unlock ();
+          break;
+        }
+      m_freeCondition.SetCondition (false);
+      m_mutex.Unlock ();
+      WaitFor (m_freeCondition);
+    }
+}
+
+void
+PcapAsyncWriter::Flush (void)
+{
+  Submit ();
+  while (true)
+    {
+      m_mutex.Lock ();
+      if (m_full.empty () && m_writing == 0)
+        {
+          m_mutex.Unlock ();
+          break;
+        }
+      m_freeCondition.SetCondition (false);
+      m_mutex.Unlock ();
+      WaitFor (m_freeCondition);
+    }
+  m_file->flush ();
+}
+
+bool
+PcapAsyncWriter::HasFailed (void)
+{
+  // The stream state can only be read while the thread is not writing.
+  CriticalSection cs (m_mutex);
+  return m_failed || (m_writing == 0 && m_file->fail ());
+}
+
+void
+PcapAsyncWriter::Run (void)
+{
+  while (true)
+    {
+      m_mutex.Lock ();
+      if (m_full.empty ())
+        {
+          if (m_stop)
+            {
+              m_mutex.Unlock ();
+              return;
+            }
+          m_fullCondition.SetCondition (false);
+          m_mutex.Unlock ();
+          WaitFor (m_fullCondition);
+          continue;
+        }
+      Chunk *chunk = m_full.front ();
+      m_full.pop_front ();
+      m_writing++;
+      m_mutex.Unlock ();
+
+      WriteChunk (chunk);
+      bool failed = m_file->fail ();
+
+      m_mutex.Lock ();
+      m_free.push_back (chunk);
+      m_writing--;
+      m_failed = m_failed || failed;
+      m_mutex.Unlock ();
+      m_freeCondition.SetCondition (true);
+      m_freeCondition.Signal ();
+    }
+}
+
+#else /* HAVE_PTHREAD_H */
+
+void
+PcapAsyncWriter::Submit (void)
+{
+  WriteChunk (m_current);
+}
+
+void
+PcapAsyncWriter::Flush (void)
+{
+  Submit ();
+  m_file->flush ();
+}
+
+bool
+PcapAsyncWriter::HasFailed (void)
+{
+  return m_file->fail ();
+}
+
+void
+PcapAsyncWriter::Run (void)
+{
+}
+
+#endif /* HAVE_PTHREAD_H */
+
 PcapFile::PcapFile ()
   : m_file (),
-    m_swapMode (false)
+    m_swapMode (false),
+    m_async (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file);
@@ -67,6 +381,10 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_async)
+    {
+      return m_async->HasFailed ();
+    }
   return m_file.fail ();
 }
 bool 
@@ -87,6 +405,8 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  delete m_async;
+  m_async = 0;
   m_file.close ();
 }
 
@@ -402,10 +722,67 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   return inclLen;
 }
 
+void
+PcapFile::EnableAsyncWrite (uint32_t bufferSize, uint32_t nBuffers)
+{
+  NS_LOG_FUNCTION (this << bufferSize << nBuffers);
+  NS_ASSERT (m_file.good ());
+  if (m_async == 0)
+    {
+      m_file.flush ();
+      m_async = new PcapAsyncWriter (&m_file, bufferSize, nBuffers);
+    }
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_async)
+    {
+      m_async->Flush ();
+    }
+  else
+    {
+      m_file.flush ();
+    }
+}
+
+uint8_t *
+PcapFile::ReserveRecord (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t *inclLen)
+{
+  *inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+
+  PcapRecordHeader header;
+  header.m_tsSec = tsSec;
+  header.m_tsUsec = tsUsec;
+  header.m_inclLen = *inclLen;
+  header.m_origLen = totalLen;
+
+  if (m_swapMode)
+    {
+      Swap (&header, &header);
+    }
+
+  uint8_t *p = m_async->Reserve (16 + *inclLen);
+  std::memcpy (p, &header.m_tsSec, 4);
+  std::memcpy (p + 4, &header.m_tsUsec, 4);
+  std::memcpy (p + 8, &header.m_inclLen, 4);
+  std::memcpy (p + 12, &header.m_origLen, 4);
+  return p + 16;
+}
+
 void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
+  if (m_async)
+    {
+      uint32_t inclLen;
+      uint8_t *p = ReserveRecord (tsSec, tsUsec, totalLen, &inclLen);
+      std::memcpy (p, data, inclLen);
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
   m_file.write ((const char *)data, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
@@ -415,6 +792,13 @@ void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
+  if (m_async)
+    {
+      uint32_t inclLen;
+      uint8_t *data = ReserveRecord (tsSec, tsUsec, p->GetSize (), &inclLen);
+      p->CopyData (data, inclLen);
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
@@ -426,11 +810,22 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &header << p);
   uint32_t headerSize = header.GetSerializedSize ();
   uint32_t totalSize = headerSize + p->GetSize ();
-  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
 
   Buffer headerBuffer;
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
+
+  if (m_async)
+    {
+      uint32_t inclLen;
+      uint8_t *data = ReserveRecord (tsSec, tsUsec, totalSize, &inclLen);
+      uint32_t toCopy = std::min (headerSize, inclLen);
+      headerBuffer.CopyData (data, toCopy);
+      p->CopyData (data + toCopy, inclLen - toCopy);
+      return;
+    }
+
+  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
   uint32_t toCopy = std::min (headerSize, inclLen);
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
@@ -30,6 +30,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class PcapAsyncWriter;
 
 
 /**
@@ -44,6 +45,8 @@ class PcapFile
 public:
   static const int32_t  ZONE_DEFAULT    = 0;           /**< Time zone offset for current location */
   static const uint32_t SNAPLEN_DEFAULT = 65535;       /**< Default value for maximum octets to save per packet */
+  static const uint32_t ASYNC_BUFFER_SIZE_DEFAULT = 1 << 20; /**< Default size of the asynchronous write buffers */
+  static const uint32_t ASYNC_BUFFER_COUNT_DEFAULT = 4;      /**< Default number of asynchronous write buffers */
 
 public:
   PcapFile ();
@@ -118,6 +121,31 @@ public:
              int32_t timeZoneCorrection = ZONE_DEFAULT,
              bool swapMode = false);
 
+  /**
+   * \brief Hand the packet records to a background writer thread.
+   *
+   * Once enabled, the Write methods only serialize the records into
+   * large memory buffers; full buffers are queued to a thread which
+   * writes them to the file.  When all the buffers are queued, Write
+   * waits for the thread to release one, so memory use stays bounded.
+   * The records are written in order.  Without thread support, the
+   * buffers are written synchronously when they are full, which still
+   * saves a stream write per record.
+   *
+   * This must be called after Init, on a file opened for writing.
+   * Close, Flush and the destructor wait for the pending records.
+   *
+   * \param bufferSize size of each buffer, in bytes
+   * \param nBuffers maximum number of buffers
+   */
+  void EnableAsyncWrite (uint32_t bufferSize = ASYNC_BUFFER_SIZE_DEFAULT,
+                         uint32_t nBuffers = ASYNC_BUFFER_COUNT_DEFAULT);
+
+  /**
+   * \brief Wait until all the records written so far are in the file.
+   */
+  void Flush (void);
+
   /**
    * \brief Write next packet to file
    * 
@@ -348,6 +376,19 @@ private:
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
 
+  /**
+   * \brief Reserve room for a packet record in the asynchronous buffers
+   *
+   * The packet header is written, the caller fills in the packet data.
+   *
+   * \param tsSec Time stamp (seconds part)
+   * \param tsUsec Time stamp (microseconds part)
+   * \param totalLen total packet length
+   * \param inclLen the length of the packet data to write
+   * \returns where to write the packet data
+   */
+  uint8_t * ReserveRecord (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t *inclLen);
+
   /**
    * \brief Read and verify a Pcap file header
    */
@@ -357,6 +398,7 @@ private:
   std::fstream   m_file;        //!< file stream
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
+  PcapAsyncWriter *m_async;     //!< background writer, if enabled
 };
 
 } // namespace ns3
@@ -33,6 +33,8 @@ NS_OBJECT_ENSURE_REGISTERED (RadiotapHeader);
 RadiotapHeader::RadiotapHeader ()
   : m_length (8),
     m_present (0),
+    m_vendorPresent (0),
+    m_tsftPad (0),
     m_tsft (0),
     m_flags (FRAME_FLAG_NONE),
     m_rate (0),
@@ -49,7 +51,10 @@ RadiotapHeader::RadiotapHeader ()
     m_vhtBandwidth (0),
     m_vhtCoding (0),
     m_vhtGroupId (0),
-    m_vhtPartialAid (0)
+    m_vhtPartialAid (0),
+    m_vendorPad (0),
+    m_dmgPhy (0),
+    m_dmgMcs (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -87,6 +92,10 @@ RadiotapHeader::Serialize (Buffer::Iterator start) const
   start.WriteU8 (0); // pad field
   start.WriteU16 (m_length); // entire length of radiotap data + header
   start.WriteU32 (m_present); // bits describing which fields follow header
+  if (m_present & RADIOTAP_EXT) // bit 31
+    {
+      start.WriteU32 (m_vendorPresent); // bits of the vendor namespace
+    }
 
   //
   // Time Synchronization Function Timer (when the first bit of the MPDU
@@ -94,6 +103,7 @@ RadiotapHeader::Serialize (Buffer::Iterator start) const
   //
   if (m_present & RADIOTAP_TSFT) // bit 0
     {
+      start.WriteU8 (0, m_tsftPad);
       start.WriteU64 (m_tsft);
     }
 
@@ -257,6 +267,21 @@ RadiotapHeader::Serialize (Buffer::Iterator start) const
       start.WriteU8 (m_vhtGroupId);
       start.WriteU16 (m_vhtPartialAid);
     }
+
+  //
+  // Vendor namespace, followed by the DMG vendor data.
+  //
+  if (m_present & RADIOTAP_VENDOR_NAMESPACE) // bit 30
+    {
+      start.WriteU8 (0, m_vendorPad);
+      start.WriteU8 (DMG_VENDOR_OUI & 0xff);
+      start.WriteU8 ((DMG_VENDOR_OUI >> 8) & 0xff);
+      start.WriteU8 ((DMG_VENDOR_OUI >> 16) & 0xff);
+      start.WriteU8 (DMG_VENDOR_SUBNS);
+      start.WriteU16 (DMG_VENDOR_DATA_LENGTH);
+      start.WriteU8 (m_dmgPhy);
+      start.WriteU8 (m_dmgMcs);
+    }
 }
 
 uint32_t
@@ -273,13 +298,30 @@ RadiotapHeader::Deserialize (Buffer::Iterator start)
 
   uint32_t bytesRead = 8;
 
+  m_vendorPresent = 0;
+  if (m_present & RADIOTAP_EXT) // bit 31
+    {
+      // the first extended bitmap is the one of our vendor namespace;
+      // any further one is skipped.
+      uint32_t present = start.ReadU32 ();
+      m_vendorPresent = present;
+      bytesRead += 4;
+      while (present & RADIOTAP_EXT)
+        {
+          present = start.ReadU32 ();
+          bytesRead += 4;
+        }
+    }
+
   //
   // Time Synchronization Function Timer (when the first bit of the MPDU arrived at the MAC)
   //
   if (m_present & RADIOTAP_TSFT) // bit 0
     {
+      m_tsftPad = ((8 - bytesRead % 8) % 8);
+      start.Next (m_tsftPad);
       m_tsft = start.ReadU64 ();
-      bytesRead += 8;
+      bytesRead += (8 + m_tsftPad);
     }
 
   //
@@ -472,6 +514,33 @@ RadiotapHeader::Deserialize (Buffer::Iterator start)
       bytesRead += (12 + m_vhtPad);
     }
 
+  //
+  // Vendor namespace, followed by the vendor data.
+  //
+  if (m_present & RADIOTAP_VENDOR_NAMESPACE) // bit 30
+    {
+      m_vendorPad = ((2 - bytesRead % 2) % 2);
+      start.Next (m_vendorPad);
+      uint32_t oui = start.ReadU8 ();
+      oui |= start.ReadU8 () << 8;
+      oui |= start.ReadU8 () << 16;
+      uint8_t subns = start.ReadU8 ();
+      uint16_t skipLength = start.ReadU16 ();
+      bytesRead += (6 + m_vendorPad);
+      if (oui == DMG_VENDOR_OUI && subns == DMG_VENDOR_SUBNS
+          && (m_vendorPresent & DMG_VENDOR_PRESENT) && skipLength >= DMG_VENDOR_DATA_LENGTH)
+        {
+          m_dmgPhy = start.ReadU8 ();
+          m_dmgMcs = start.ReadU8 ();
+          start.Next (skipLength - DMG_VENDOR_DATA_LENGTH);
+        }
+      else
+        {
+          start.Next (skipLength);
+        }
+      bytesRead += skipLength;
+    }
+
   NS_ASSERT_MSG (m_length == bytesRead, "RadiotapHeader::Deserialize(): expected and actual lengths inconsistent");
   return bytesRead;
 }
@@ -500,7 +569,9 @@ RadiotapHeader::Print (std::ostream &os) const
      << " vhtMcsNss for user 4=" << m_vhtMcsNss[3]
      << " vhtCoding=" << m_vhtCoding
      << " vhtGroupId=" << m_vhtGroupId
-     << " vhtPartialAid=" << m_vhtPartialAid;
+     << " vhtPartialAid=" << m_vhtPartialAid
+     << " dmgPhy=" << (uint16_t) m_dmgPhy
+     << " dmgMcs=" << (uint16_t) m_dmgMcs;
 }
 
 void
@@ -512,7 +583,7 @@ RadiotapHeader::SetTsft (uint64_t value)
   if (!(m_present & RADIOTAP_TSFT))
     {
       m_present |= RADIOTAP_TSFT;
-      m_length += 8;
+      UpdateLength ();
     }
 
   NS_LOG_LOGIC (this << " m_length=" << m_length << " m_present=0x" << std::hex << m_present << std::dec);
@@ -534,7 +605,7 @@ RadiotapHeader::SetFrameFlags (uint8_t flags)
   if (!(m_present & RADIOTAP_FLAGS))
     {
       m_present |= RADIOTAP_FLAGS;
-      m_length += 1;
+      UpdateLength ();
     }
 
   NS_LOG_LOGIC (this << " m_length=" << m_length << " m_present=0x" << std::hex << m_present << std::dec);
@@ -556,7 +627,7 @@ RadiotapHeader::SetRate (uint8_t rate)
   if (!(m_present & RADIOTAP_RATE))
     {
       m_present |= RADIOTAP_RATE;
-      m_length += 1;
+      UpdateLength ();
     }
 
   NS_LOG_LOGIC (this << " m_length=" << m_length << " m_present=0x" << std::hex << m_present << std::dec);
@@ -578,9 +649,8 @@ RadiotapHeader::SetChannelFrequencyAndFlags (uint16_t frequency, uint16_t flags)
 
   if (!(m_present & RADIOTAP_CHANNEL))
     {
-      m_channelPad = ((2 - m_length % 2) % 2);
       m_present |= RADIOTAP_CHANNEL;
-      m_length += (4 + m_channelPad);
+      UpdateLength ();
     }
 
   NS_LOG_LOGIC (this << " m_length=" << m_length << " m_present=0x" << std::hex << m_present << std::dec);
@@ -608,7 +678,7 @@ RadiotapHeader::SetAntennaSignalPower (double signal)
   if (!(m_present & RADIOTAP_DBM_ANTSIGNAL))
     {
       m_present |= RADIOTAP_DBM_ANTSIGNAL;
-      m_length += 1;
+      UpdateLength ();
     }
   if (signal > 127)
     {
@@ -641,7 +711,7 @@ RadiotapHeader::SetAntennaNoisePower (double noise)
   if (!(m_present & RADIOTAP_DBM_ANTNOISE))
     {
       m_present |= RADIOTAP_DBM_ANTNOISE;
-      m_length += 1;
+      UpdateLength ();
     }
   if (noise > 127.0)
     {
@@ -676,7 +746,7 @@ RadiotapHeader::SetMcsFields (uint8_t known, uint8_t flags, uint8_t mcs)
   if (!(m_present & RADIOTAP_MCS))
     {
       m_present |= RADIOTAP_MCS;
-      m_length += 3;
+      UpdateLength ();
     }
 
   NS_LOG_LOGIC (this << " m_length=" << m_length << " m_present=0x" << std::hex << m_present << std::dec);
@@ -712,9 +782,8 @@ RadiotapHeader::SetAmpduStatus (uint32_t referenceNumber, uint16_t flags, uint8_
   m_ampduStatusCRC = crc;
   if (!(m_present & RADIOTAP_AMPDU_STATUS))
     {
-      m_ampduStatusPad = ((4 - m_length % 4) % 4);
       m_present |= RADIOTAP_AMPDU_STATUS;
-      m_length += (8 + m_ampduStatusPad);
+      UpdateLength ();
     }
 
   NS_LOG_LOGIC (this << " m_length=" << m_length << " m_present=0x" << std::hex << m_present << std::dec);
@@ -750,9 +819,8 @@ RadiotapHeader::SetVhtFields (uint16_t known, uint8_t flags, uint8_t bandwidth,
   m_vhtPartialAid = partial_aid;
   if (!(m_present & RADIOTAP_VHT))
     {
-      m_vhtPad = ((2 - m_length % 2) % 2);
       m_present |= RADIOTAP_VHT;
-      m_length += (12 + m_vhtPad);
+      UpdateLength ();
     }
 
   NS_LOG_LOGIC (this << " m_length=" << m_length << " m_present=0x" << std::hex << m_present << std::dec);
@@ -828,4 +896,91 @@ RadiotapHeader::GetVhtPartialAid () const
   return m_vhtPartialAid;
 }
 
+void
+RadiotapHeader::SetDmgFields (uint8_t phy, uint8_t mcs)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (phy) << static_cast<uint32_t> (mcs));
+  m_dmgPhy = phy;
+  m_dmgMcs = mcs;
+  if (!(m_present & RADIOTAP_VENDOR_NAMESPACE))
+    {
+      m_present |= (RADIOTAP_VENDOR_NAMESPACE | RADIOTAP_EXT);
+      m_vendorPresent = DMG_VENDOR_PRESENT;
+      // the extended bitmap moves every field which is already set
+      UpdateLength ();
+    }
+
+  NS_LOG_LOGIC (this << " m_length=" << m_length << " m_present=0x" << std::hex << m_present << std::dec);
+}
+
+uint8_t
+RadiotapHeader::GetDmgPhy () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_dmgPhy;
+}
+
+uint8_t
+RadiotapHeader::GetDmgMcs () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_dmgMcs;
+}
+
+void
+RadiotapHeader::UpdateLength (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_length = 8;
+  if (m_present & RADIOTAP_EXT)
+    {
+      m_length += 4;
+    }
+  if (m_present & RADIOTAP_TSFT)
+    {
+      m_tsftPad = ((8 - m_length % 8) % 8);
+      m_length += (8 + m_tsftPad);
+    }
+  if (m_present & RADIOTAP_FLAGS)
+    {
+      m_length += 1;
+    }
+  if (m_present & RADIOTAP_RATE)
+    {
+      m_length += 1;
+    }
+  if (m_present & RADIOTAP_CHANNEL)
+    {
+      m_channelPad = ((2 - m_length % 2) % 2);
+      m_length += (4 + m_channelPad);
+    }
+  if (m_present & RADIOTAP_DBM_ANTSIGNAL)
+    {
+      m_length += 1;
+    }
+  if (m_present & RADIOTAP_DBM_ANTNOISE)
+    {
+      m_length += 1;
+    }
+  if (m_present & RADIOTAP_MCS)
+    {
+      m_length += 3;
+    }
+  if (m_present & RADIOTAP_AMPDU_STATUS)
+    {
+      m_ampduStatusPad = ((4 - m_length % 4) % 4);
+      m_length += (8 + m_ampduStatusPad);
+    }
+  if (m_present & RADIOTAP_VHT)
+    {
+      m_vhtPad = ((2 - m_length % 2) % 2);
+      m_length += (12 + m_vhtPad);
+    }
+  if (m_present & RADIOTAP_VENDOR_NAMESPACE)
+    {
+      m_vendorPad = ((2 - m_length % 2) % 2);
+      m_length += (6 + DMG_VENDOR_DATA_LENGTH + m_vendorPad);
+    }
+}
+
 } // namespace ns3
@@ -408,8 +408,50 @@ public:
    */
   uint8_t GetVhtPartialAid (void) const;
 
+  enum
+  {
+    DMG_PHY_CONTROL = 0, /**< DMG control PHY */
+    DMG_PHY_SC      = 1, /**< DMG single carrier PHY */
+    DMG_PHY_OFDM    = 2, /**< DMG OFDM PHY */
+    DMG_PHY_LP_SC   = 3  /**< DMG low power single carrier PHY */
+  };
+
+  /**
+   * @brief Set the DMG (IEEE 802.11ad) fields
+   *
+   * Radiotap does not define a DMG field, so the PHY type and MCS index are
+   * carried in a vendor namespace (OUI 4e:53:33, sub namespace 0) that
+   * follows the standard fields.  Readers which do not know this namespace
+   * skip it using its skip_length.
+   *
+   * @param phy The DMG PHY type (one of the DMG_PHY_* values).
+   * @param mcs The DMG MCS index.
+   */
+  void SetDmgFields (uint8_t phy, uint8_t mcs);
+
+  /**
+   * @brief Get the DMG PHY type.
+   *
+   * @returns The DMG PHY type.
+   */
+  uint8_t GetDmgPhy (void) const;
+  /**
+   * @brief Get the DMG MCS index.
+   *
+   * @returns The DMG MCS index.
+   */
+  uint8_t GetDmgMcs (void) const;
+
 
 private:
+  /**
+   * @brief Recompute the padding of every field and the header length.
+   *
+   * Called whenever a field is added, so that fields may be set in any
+   * order and the extended presence bitmap can move the fields already set.
+   */
+  void UpdateLength (void);
+
   enum
   {
     RADIOTAP_TSFT              = 0x00000001,
@@ -430,12 +472,23 @@ private:
     RADIOTAP_MCS               = 0x00080000,
     RADIOTAP_AMPDU_STATUS      = 0x00100000,
     RADIOTAP_VHT               = 0x00200000,
-    RADIOTAP_EXT               = 0x10000000
+    RADIOTAP_VENDOR_NAMESPACE  = 0x40000000,
+    RADIOTAP_EXT               = 0x80000000
+  };
+
+  enum
+  {
+    DMG_VENDOR_OUI          = 0x33534e, /**< locally administered OUI 4e:53:33 ("NS3"), little endian */
+    DMG_VENDOR_SUBNS        = 0,        /**< sub namespace of the DMG fields */
+    DMG_VENDOR_DATA_LENGTH  = 2,        /**< length of the DMG vendor data */
+    DMG_VENDOR_PRESENT      = 0x00000001 /**< vendor bitmap bit of the DMG fields */
   };
 
   uint16_t m_length;        //!< entire length of radiotap data + header
   uint32_t m_present;       //!< bits describing which fields follow header
 
+  uint32_t m_vendorPresent; //!< vendor namespace presence bitmap
+  uint8_t m_tsftPad;        //!< TSFT padding.
   uint64_t m_tsft;          //!< Time Synchronization Function Timer (when the first bit of the MPDU arrived at the MAC)
   uint8_t m_flags;          //!< Properties of transmitted and received frames.
   uint8_t m_rate;           //!< TX/RX data rate in units of 500 kbps
@@ -462,6 +515,10 @@ private:
   uint8_t m_vhtCoding;      //!< VHT coding field.
   uint8_t m_vhtGroupId;     //!< VHT group_id field.
   uint16_t m_vhtPartialAid; //!< VHT partial_aid field.
+
+  uint8_t m_vendorPad;      //!< Vendor namespace padding.
+  uint8_t m_dmgPhy;         //!< DMG PHY type.
+  uint8_t m_dmgMcs;         //!< DMG MCS index.
 };
 
 } // namespace ns3
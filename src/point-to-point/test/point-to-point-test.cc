@@ -23,6 +23,15 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/shared-memory-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+
+#include <unistd.h>
 
 using namespace ns3;
 
@@ -93,6 +102,130 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for PointToPointRemoteChannel
+ *
+ * It forks two tasks with the shared memory parallel communication
+ * interface, each owning one end of a link; each task sends one packet
+ * to the other, and task 0 gathers what each task received.
+ */
+class PointToPointRemoteChannelTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointRemoteChannelTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send one packet to the other end of a link
+   *
+   * \param device NetDevice to send from
+   * \param size the size of the packet
+   */
+  void SendOnePacket (Ptr<NetDevice> device, uint32_t size);
+
+  /**
+   * \brief Record a packet received
+   *
+   * \param device the receiving NetDevice
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \param to the receiver address
+   * \param type the packet type
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType type);
+
+  /// What a task received, gathered by task 0
+  struct Record
+  {
+    uint32_t rxPackets; //!< the number of packets received
+    uint32_t rxBytes;   //!< the size of the last packet received
+    int64_t rxTime;     //!< the time of the last reception, in ns
+  };
+
+  Record m_record; //!< what this task received
+};
+
+PointToPointRemoteChannelTest::PointToPointRemoteChannelTest ()
+  : TestCase ("PointToPointRemoteChannel over the shared memory interface")
+{
+}
+
+void
+PointToPointRemoteChannelTest::SendOnePacket (Ptr<NetDevice> device, uint32_t size)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+void
+PointToPointRemoteChannelTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                         const Address &from, const Address &to, NetDevice::PacketType type)
+{
+  m_record.rxPackets++;
+  m_record.rxBytes = packet->GetSize ();
+  m_record.rxTime = Simulator::Now ().GetNanoSeconds ();
+}
+
+void
+PointToPointRemoteChannelTest::DoRun (void)
+{
+  MpiInterface::EnableSharedMemory (2);
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  m_record.rxPackets = 0;
+  m_record.rxBytes = 0;
+  m_record.rxTime = 0;
+
+  // all the tasks build the whole topology
+  Ptr<Node> a = CreateObject<Node> (0);
+  Ptr<Node> b = CreateObject<Node> (1);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer devices = p2p.Install (a, b);
+
+  Ptr<Node> local = (systemId == 0) ? a : b;
+  Ptr<NetDevice> localDevice = devices.Get (systemId);
+  local->RegisterProtocolHandler (MakeCallback (&PointToPointRemoteChannelTest::Receive, this),
+                                  0x800, localDevice);
+  Simulator::ScheduleWithContext (local->GetId (), Seconds (1.0),
+                                  &PointToPointRemoteChannelTest::SendOnePacket, this,
+                                  localDevice, 100 + systemId);
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  Record records[2];
+  SharedMemoryInterface::AllGather (&m_record, records, sizeof (Record));
+  Simulator::Destroy ();
+  MpiInterface::Disable ();
+  if (systemId != 0)
+    {
+      // the forked task must not run the rest of the test runner
+      _exit (0);
+    }
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+
+  // each task receives the packet of the other one, after its
+  // transmission with the 2 bytes PPP header at 1 Mbps and the 10 ms delay
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      uint32_t size = 101 - i;
+      int64_t rxTime = (Seconds (1.0) + MicroSeconds ((size + 2) * 8) + MilliSeconds (10)).GetNanoSeconds ();
+      NS_TEST_EXPECT_MSG_EQ (records[i].rxPackets, 1, "Wrong number of packets received by task " << i);
+      NS_TEST_EXPECT_MSG_EQ (records[i].rxBytes, size, "Wrong packet received by task " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (records[i].rxTime, rxTime, 1, "Wrong reception time in task " << i);
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -109,6 +242,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointRemoteChannelTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
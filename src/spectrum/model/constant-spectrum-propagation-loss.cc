@@ -100,5 +100,19 @@ ConstantSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
   return rxPsd;
 }
 
+bool
+ConstantSpectrumPropagationLossModel::DoIsFrequencyFlat (void) const
+{
+  return true;
+}
+
+double
+ConstantSpectrumPropagationLossModel::DoGetFlatGain (Ptr<const MobilityModel> a,
+                                                     Ptr<const MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this);
+  return 1 / m_lossLinear;
+}
+
 
 }  // namespace ns3
@@ -37,6 +37,9 @@ public:
   virtual Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const;
+  virtual bool DoIsFrequencyFlat (void) const;
+  virtual double DoGetFlatGain (Ptr<const MobilityModel> a,
+                                Ptr<const MobilityModel> b) const;
 
   void SetLossDb (double lossDb);
   double GetLossDb () const;
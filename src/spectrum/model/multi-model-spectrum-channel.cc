@@ -26,6 +26,7 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -76,6 +77,7 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_numDevices (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -89,6 +91,19 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  for (PathsByMobility::iterator it = m_pathsByMobility.begin (); it != m_pathsByMobility.end (); ++it)
+    {
+      ConstCast<MobilityModel> (it->first)->TraceDisconnectWithoutContext ("CourseChange",
+                                                                            MakeCallback (&MultiModelSpectrumChannel::NotifyCourseChange, this));
+    }
+  m_pathsByMobility.clear ();
+  for (PathsByAntenna::iterator it = m_pathsByAntenna.begin (); it != m_pathsByAntenna.end (); ++it)
+    {
+      ConstCast<AntennaModel> (it->first)->TraceDisconnectWithoutContext ("PatternChange",
+                                                                           MakeCallback (&MultiModelSpectrumChannel::NotifyPatternChange, this));
+    }
+  m_pathsByAntenna.clear ();
+  m_pathLossCache.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -113,6 +128,21 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("PathLossCache",
+                   "If true, the antenna gains, propagation loss, "
+                   "propagation delay and the gain of a frequency-flat "
+                   "SpectrumPropagationLossModel between two nodes with "
+                   "a zero velocity are computed once, and computed again only "
+                   "after one of the nodes changes course or one of the "
+                   "antennas fires its PatternChange trace. Only enable "
+                   "it when the PropagationLossModel, the "
+                   "PropagationDelayModel and a frequency-flat "
+                   "SpectrumPropagationLossModel are deterministic, and when "
+                   "the antennas reconfigured during the simulation "
+                   "fire PatternChange.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_pathLossCacheEnabled),
+                   MakeBooleanChecker ())
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -255,6 +285,9 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 
   Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  // the gain of a frequency-flat SpectrumPropagationLossModel is applied
+  // with the path loss, instead of shaping the PSD of each receiver
+  bool flatSpectrumLoss = m_spectrumPropagationLoss != 0 && m_spectrumPropagationLoss->IsFrequencyFlat ();
   SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
   NS_LOG_LOGIC (" txSpectrumModelUid " << txSpectrumModelUid);
 
@@ -299,54 +332,78 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
             {
               NS_LOG_LOGIC (" copying signal parameters " << txParams);
               Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
               Time delay = MicroSeconds (0);
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
               if (txMobility && receiverMobility)
                 {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  PathId pathId (txParams->txPhy, *rxPhyIterator);
+                  PathLossCacheEntry path;
+                  path.txMobility = txMobility;
+                  path.rxMobility = receiverMobility;
+                  path.txAntenna = rxParams->txAntenna;
+                  path.rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
+                  if (!m_pathLossCacheEnabled || !LookupPathLoss (pathId, path))
                     {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
+                      double pathLossDb = 0;
+                      if (rxParams->txAntenna != 0)
+                        {
+                          Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+                          double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                          NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+                          pathLossDb -= txAntennaGain;
+                        }
+                      if (path.rxAntenna != 0)
+                        {
+                          Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+                          double rxAntennaGain = path.rxAntenna->GetGainDb (rxAngles);
+                          NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+                          pathLossDb -= rxAntennaGain;
+                        }
+                      if (m_propagationLoss)
+                        {
+                          double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+                          NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+                          pathLossDb -= propagationGainDb;
+                        }
+                      path.pathLossDb = pathLossDb;
+                      path.flatGain = 1;
+                      if (flatSpectrumLoss)
+                        {
+                          path.flatGain = m_spectrumPropagationLoss->GetFlatGain (txMobility, receiverMobility);
+                        }
+                      path.delay = delay;
+                      if (m_propagationDelay)
+                        {
+                          path.delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+                        }
+                      if (m_pathLossCacheEnabled)
+                        {
+                          StorePathLoss (pathId, path);
+                        }
                     }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
+                  NS_LOG_LOGIC ("total pathLoss = " << path.pathLossDb << " dB");
+                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, path.pathLossDb);
+                  if (path.pathLossDb > m_maxLossDb)
                     {
                       // beyond range
                       continue;
                     }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
+                  double pathGainLinear = std::pow (10.0, (-path.pathLossDb) / 10.0) * path.flatGain;
+                  // scale while copying, instead of copying and then scaling
+                  rxParams->psd = Create<SpectrumValue> (convertedTxPowerSpectrum->GetSpectrumModel ());
+                  Scale (*(rxParams->psd), *convertedTxPowerSpectrum, pathGainLinear);
 
-                  if (m_spectrumPropagationLoss)
+                  if (m_spectrumPropagationLoss && !flatSpectrumLoss)
                     {
                       rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
                     }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
+                  delay = path.delay;
+                }
+              else
+                {
+                  rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
                 }
 
               Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
@@ -370,6 +427,101 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 }
 
+bool
+MultiModelSpectrumChannel::LookupPathLoss (const PathId &id, PathLossCacheEntry &entry) const
+{
+  PathLossCache::const_iterator it = m_pathLossCache.find (id);
+  if (it == m_pathLossCache.end ()
+      || it->second.txMobility != entry.txMobility
+      || it->second.rxMobility != entry.rxMobility
+      || it->second.txAntenna != entry.txAntenna
+      || it->second.rxAntenna != entry.rxAntenna)
+    {
+      return false;
+    }
+  entry.pathLossDb = it->second.pathLossDb;
+  entry.flatGain = it->second.flatGain;
+  entry.delay = it->second.delay;
+  return true;
+}
+
+void
+MultiModelSpectrumChannel::StorePathLoss (const PathId &id, const PathLossCacheEntry &entry)
+{
+  NS_LOG_FUNCTION (this << id.first << id.second << entry.pathLossDb);
+  Vector txVelocity = entry.txMobility->GetVelocity ();
+  Vector rxVelocity = entry.rxMobility->GetVelocity ();
+  if (txVelocity.x != 0 || txVelocity.y != 0 || txVelocity.z != 0
+      || rxVelocity.x != 0 || rxVelocity.y != 0 || rxVelocity.z != 0)
+    {
+      // moving nodes do not always notify a course change
+      return;
+    }
+  Ptr<const MobilityModel> mobility[2] = { entry.txMobility, entry.rxMobility };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      PathsByMobility::iterator it = m_pathsByMobility.find (mobility[i]);
+      if (it == m_pathsByMobility.end ())
+        {
+          ConstCast<MobilityModel> (mobility[i])->TraceConnectWithoutContext ("CourseChange",
+                                                                               MakeCallback (&MultiModelSpectrumChannel::NotifyCourseChange, this));
+          it = m_pathsByMobility.insert (std::make_pair (mobility[i], std::set<PathId> ())).first;
+        }
+      it->second.insert (id);
+    }
+  Ptr<const AntennaModel> antenna[2] = { entry.txAntenna, entry.rxAntenna };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      if (antenna[i] == 0)
+        {
+          continue;
+        }
+      PathsByAntenna::iterator it = m_pathsByAntenna.find (antenna[i]);
+      if (it == m_pathsByAntenna.end ())
+        {
+          ConstCast<AntennaModel> (antenna[i])->TraceConnectWithoutContext ("PatternChange",
+                                                                             MakeCallback (&MultiModelSpectrumChannel::NotifyPatternChange, this));
+          it = m_pathsByAntenna.insert (std::make_pair (antenna[i], std::set<PathId> ())).first;
+        }
+      it->second.insert (id);
+    }
+  m_pathLossCache[id] = entry;
+}
+
+void
+MultiModelSpectrumChannel::NotifyCourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  PathsByMobility::iterator it = m_pathsByMobility.find (mobility);
+  if (it != m_pathsByMobility.end ())
+    {
+      // keep the entry, the trace is still connected
+      ForgetPaths (it->second);
+    }
+}
+
+void
+MultiModelSpectrumChannel::NotifyPatternChange (Ptr<const AntennaModel> antenna)
+{
+  NS_LOG_FUNCTION (this << antenna);
+  PathsByAntenna::iterator it = m_pathsByAntenna.find (antenna);
+  if (it != m_pathsByAntenna.end ())
+    {
+      // keep the entry, the trace is still connected
+      ForgetPaths (it->second);
+    }
+}
+
+void
+MultiModelSpectrumChannel::ForgetPaths (std::set<PathId> &paths)
+{
+  for (std::set<PathId>::const_iterator pathIt = paths.begin (); pathIt != paths.end (); ++pathIt)
+    {
+      m_pathLossCache.erase (*pathIt);
+    }
+  paths.clear ();
+}
+
 void
 MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
@@ -450,5 +602,12 @@ MultiModelSpectrumChannel::GetSpectrumPropagationLossModel (void)
   return m_spectrumPropagationLoss;
 }
 
+Ptr<PropagationLossModel>
+MultiModelSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 
 } // namespace ns3
@@ -27,6 +27,9 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/mobility-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/nstime.h>
 #include <map>
 #include <set>
 
@@ -82,6 +85,19 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * When the PathLossCache attribute is true, the antenna gains,
+ * PropagationLossModel loss and propagation delay between a
+ * transmitter and a receiver which both have a zero velocity are
+ * computed once and reused until one of them fires its CourseChange
+ * trace, or until the antenna of one of them fires its PatternChange
+ * trace.  This is only correct when the PropagationLossModel and
+ * PropagationDelayModel are deterministic, and when the AntennaModel
+ * subclasses which can be reconfigured during the simulation call
+ * AntennaModel::NotifyPatternChange, as the antenna models of the
+ * antenna module do.  The
+ * SpectrumPropagationLossModel, usually a time-varying fading model,
+ * is always evaluated.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -104,6 +120,7 @@ public:
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
 
   virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
 
 
 protected:
@@ -132,6 +149,65 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /// the transmitter and the receiver of a path
+  typedef std::pair<Ptr<const SpectrumPhy>, Ptr<const SpectrumPhy> > PathId;
+
+  /// loss and delay of a path between static endpoints
+  struct PathLossCacheEntry
+  {
+    Ptr<const MobilityModel> txMobility; //!< mobility of the transmitter
+    Ptr<const MobilityModel> rxMobility; //!< mobility of the receiver
+    Ptr<AntennaModel> txAntenna;         //!< antenna of the transmitter
+    Ptr<AntennaModel> rxAntenna;         //!< antenna of the receiver
+    double pathLossDb;                   //!< total path loss, antenna gains included
+    double flatGain;                     //!< linear gain of a frequency-flat SpectrumPropagationLossModel
+    Time delay;                          //!< propagation delay
+  };
+
+  /// cached paths
+  typedef std::map<PathId, PathLossCacheEntry> PathLossCache;
+  /// paths cached for each mobility model
+  typedef std::map<Ptr<const MobilityModel>, std::set<PathId> > PathsByMobility;
+  /// paths cached for each antenna model
+  typedef std::map<Ptr<const AntennaModel>, std::set<PathId> > PathsByAntenna;
+
+  /**
+   * \param id the path
+   * \param entry the loss and delay of the path, valid if the
+   * mobility models and antennas of the path match its fields
+   * \returns true if the path loss of the path is cached
+   */
+  bool LookupPathLoss (const PathId &id, PathLossCacheEntry &entry) const;
+
+  /**
+   * Store the loss of a path, if both its endpoints are static.
+   *
+   * \param id the path
+   * \param entry the loss and delay of the path
+   */
+  void StorePathLoss (const PathId &id, const PathLossCacheEntry &entry);
+
+  /**
+   * Forget the paths of a mobility model which changed course.
+   *
+   * \param mobility the mobility model
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility);
+
+  /**
+   * Forget the paths of an antenna model whose pattern changed.
+   *
+   * \param antenna the antenna model
+   */
+  void NotifyPatternChange (Ptr<const AntennaModel> antenna);
+
+  /**
+   * Forget a set of paths.
+   *
+   * \param paths the paths, cleared
+   */
+  void ForgetPaths (std::set<PathId> &paths);
+
 
 
   /**
@@ -173,6 +249,11 @@ private:
 
   double m_maxLossDb;
 
+  bool m_pathLossCacheEnabled;         //!< whether path losses are cached
+  PathLossCache m_pathLossCache;       //!< the cached paths
+  PathsByMobility m_pathsByMobility;   //!< the cached paths of each mobility model
+  PathsByAntenna m_pathsByAntenna;     //!< the cached paths of each antenna model
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
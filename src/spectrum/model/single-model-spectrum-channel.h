@@ -62,6 +62,7 @@ public:
   typedef std::vector<Ptr<SpectrumPhy> > PhyList;
 
   virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
 
 private:
   virtual void DoDispose ();
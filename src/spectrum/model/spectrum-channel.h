@@ -64,6 +64,12 @@ public:
    */
   virtual void AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss) = 0;
 
+  /**
+   * \return the single-frequency propagation loss model used by
+   * the channel, or 0 if there is none
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void) = 0;
+
   /**
    * set the  propagation delay model to be used
    * \param delay Ptr to the propagation delay model to be used.
@@ -73,4 +73,37 @@ SpectrumPropagationLossModel::CalcRxPowerSpectralDensity (Ptr<const SpectrumValu
   return rxPsd;
 }
 
+bool
+SpectrumPropagationLossModel::IsFrequencyFlat (void) const
+{
+  return DoIsFrequencyFlat () && (m_next == 0 || m_next->DoIsFrequencyFlat ());
+}
+
+double
+SpectrumPropagationLossModel::GetFlatGain (Ptr<const MobilityModel> a,
+                                           Ptr<const MobilityModel> b) const
+{
+  NS_ASSERT (IsFrequencyFlat ());
+  double gain = DoGetFlatGain (a, b);
+  if (m_next != 0)
+    {
+      gain *= m_next->DoGetFlatGain (a, b);
+    }
+  return gain;
+}
+
+bool
+SpectrumPropagationLossModel::DoIsFrequencyFlat (void) const
+{
+  return false;
+}
+
+double
+SpectrumPropagationLossModel::DoGetFlatGain (Ptr<const MobilityModel> a,
+                                             Ptr<const MobilityModel> b) const
+{
+  NS_FATAL_ERROR ("SpectrumPropagationLossModel is not frequency-flat");
+  return 1;
+}
+
 } // namespace ns3
@@ -75,6 +75,26 @@ public:
                                                  Ptr<const MobilityModel> a,
                                                  Ptr<const MobilityModel> b) const;
 
+  /**
+   * @return true if CalcRxPowerSpectralDensity scales all the
+   * frequencies of the PSD by the same gain, given by GetFlatGain, for
+   * this instance and the next one
+   */
+  bool IsFrequencyFlat (void) const;
+
+  /**
+   * Get the gain applied to all the frequencies by
+   * CalcRxPowerSpectralDensity, for this instance and the next one.
+   * Only valid if IsFrequencyFlat returns true.
+   *
+   * @param a sender mobility
+   * @param b receiver mobility
+   *
+   * @return the linear gain
+   */
+  double GetFlatGain (Ptr<const MobilityModel> a,
+                      Ptr<const MobilityModel> b) const;
+
 protected:
   virtual void DoDispose ();
 
@@ -95,6 +115,22 @@ private:
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const = 0;
 
+  /**
+   * @return true if DoCalcRxPowerSpectralDensity scales all the
+   * frequencies by the same gain; false by default
+   */
+  virtual bool DoIsFrequencyFlat (void) const;
+
+  /**
+   * @param a sender mobility
+   * @param b receiver mobility
+   *
+   * @return the linear gain applied to all the frequencies by
+   * DoCalcRxPowerSpectralDensity, if DoIsFrequencyFlat returns true
+   */
+  virtual double DoGetFlatGain (Ptr<const MobilityModel> a,
+                                Ptr<const MobilityModel> b) const;
+
   Ptr<SpectrumPropagationLossModel> m_next;
 };
 
@@ -497,6 +497,43 @@ public:
    */
   friend double Integral (const SpectrumValue&  arg);
 
+  /**
+   * Fused kernel computing result = a * x without temporaries.  Like
+   * the other kernels below, it adopts the model of its operands if
+   * result has another model, so that a SpectrumValue (possibly
+   * default constructed) reused across calls is allocated only once.
+   * The kernels use AVX2 when the processor supports it.
+   *
+   * @param result the result, which may be x
+   * @param x the operand
+   * @param a the factor
+   */
+  friend void Scale (SpectrumValue& result, const SpectrumValue& x, double a);
+
+  /**
+   * Fused kernel computing result += a * x without temporaries.
+   *
+   * @param result the accumulator, with the model of x or empty
+   * @param x the operand
+   * @param a the factor
+   */
+  friend void AddScaled (SpectrumValue& result, const SpectrumValue& x, double a);
+
+  /**
+   * Fused kernel computing, in a single pass,
+   * interference = allSignals - signal + noise and
+   * sinr = signal / interference.
+   *
+   * @param sinr the SINR
+   * @param interference the interference plus noise
+   * @param signal the PSD of the received signal
+   * @param allSignals the PSD of all the signals, the received one included
+   * @param noise the PSD of the noise
+   */
+  friend void ComputeSinr (SpectrumValue& sinr, SpectrumValue& interference,
+                           const SpectrumValue& signal, const SpectrumValue& allSignals,
+                           const SpectrumValue& noise);
+
   /**
    *
    * @return a Ptr to a copy of this instance
@@ -531,6 +568,12 @@ private:
   void Log10 ();
   void Log2 ();
   void Log ();
+  /**
+   * Adopt the model and size of x, keeping the values if they match.
+   *
+   * @param x the model
+   */
+  void Conform (const SpectrumValue& x);
 
   Ptr<const SpectrumModel> m_spectrumModel;
 
@@ -558,6 +601,11 @@ SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
+void Scale (SpectrumValue& result, const SpectrumValue& x, double a);
+void AddScaled (SpectrumValue& result, const SpectrumValue& x, double a);
+void ComputeSinr (SpectrumValue& sinr, SpectrumValue& interference,
+                  const SpectrumValue& signal, const SpectrumValue& allSignals,
+                  const SpectrumValue& noise);
 
 
 } // namespace ns3
@@ -20,9 +20,14 @@
 
 
 #include "wifi-spectrum-value-helper.h"
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <map>
 
 namespace ns3 {
 
+NS_LOG_COMPONENT_DEFINE ("WifiSpectrumValueHelper");
+
 
 static Ptr<SpectrumModel> g_WifiSpectrumModel5Mhz;
 
@@ -34,6 +39,108 @@ WifiSpectrumValue5MhzFactory::~WifiSpectrumValue5MhzFactory ()
 {
 }
 
+/// key of the channel spectrum models
+struct WifiSpectrumModelId
+{
+  /**
+   * \param f the center frequency in MHz
+   * \param w the channel width in MHz
+   * \param b the number of bands within the channel
+   */
+  WifiSpectrumModelId (double f, uint32_t w, uint32_t b);
+  double centerFrequency;   //!< center frequency in MHz
+  uint32_t channelWidth;    //!< channel width in MHz
+  uint32_t bandsPerChannel; //!< number of bands within the channel
+};
+
+WifiSpectrumModelId::WifiSpectrumModelId (double f, uint32_t w, uint32_t b)
+  : centerFrequency (f),
+    channelWidth (w),
+    bandsPerChannel (b)
+{
+}
+
+/**
+ * \param a the first key
+ * \param b the second key
+ * \returns true if a is before b
+ */
+bool
+operator < (const WifiSpectrumModelId& a, const WifiSpectrumModelId& b)
+{
+  if (a.centerFrequency != b.centerFrequency)
+    {
+      return a.centerFrequency < b.centerFrequency;
+    }
+  if (a.channelWidth != b.channelWidth)
+    {
+      return a.channelWidth < b.channelWidth;
+    }
+  return a.bandsPerChannel < b.bandsPerChannel;
+}
+
+/// the channel spectrum models created so far
+static std::map<WifiSpectrumModelId, Ptr<SpectrumModel> > g_wifiSpectrumModelMap;
+
+Ptr<SpectrumModel>
+WifiSpectrumValueHelper::GetChannelSpectrumModel (double centerFrequency,
+                                                  uint32_t channelWidth,
+                                                  uint32_t bandsPerChannel)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << bandsPerChannel);
+  NS_ASSERT_MSG (bandsPerChannel >= 2 && bandsPerChannel % 2 == 0,
+                 "the number of bands per channel must be even");
+  WifiSpectrumModelId key (centerFrequency, channelWidth, bandsPerChannel);
+  std::map<WifiSpectrumModelId, Ptr<SpectrumModel> >::iterator it = g_wifiSpectrumModelMap.find (key);
+  if (it != g_wifiSpectrumModelMap.end ())
+    {
+      return it->second;
+    }
+  double bandWidth = channelWidth * 1e6 / bandsPerChannel;
+  double start = centerFrequency * 1e6 - 1.5 * channelWidth * 1e6;
+  Bands bands;
+  for (uint32_t i = 0; i < 3 * bandsPerChannel; i++)
+    {
+      BandInfo bi;
+      bi.fl = start + i * bandWidth;
+      bi.fh = start + (i + 1) * bandWidth;
+      bi.fc = (bi.fl + bi.fh) / 2;
+      bands.push_back (bi);
+    }
+  Ptr<SpectrumModel> ret = Create<SpectrumModel> (bands);
+  NS_LOG_LOGIC ("created SpectrumModel::GetUid () == " << ret->GetUid ());
+  g_wifiSpectrumModelMap.insert (std::make_pair (key, ret));
+  return ret;
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateChannelTxPowerSpectralDensity (Ptr<const SpectrumModel> model,
+                                                              uint32_t channelWidth,
+                                                              double txPower)
+{
+  NS_LOG_FUNCTION (model << channelWidth << txPower);
+  uint32_t n = model->GetNumBands () / 3;
+  NS_ASSERT (n * 3 == model->GetNumBands ());
+  // -28 dBr and -40 dBr, or -17 dBr and -22 dBr for DMG
+  double inner = channelWidth == 2160 ? 0.019953 : 0.0015849;
+  double outer = channelWidth == 2160 ? 0.0063096 : 1e-4;
+  double txPowerDensity = txPower / (channelWidth * 1e6);
+
+  Ptr<SpectrumValue> txPsd = Create <SpectrumValue> (model);
+  for (uint32_t i = 0; i < n / 2; i++)
+    {
+      (*txPsd)[i] = txPowerDensity * outer;
+      (*txPsd)[n / 2 + i] = txPowerDensity * inner;
+      (*txPsd)[2 * n + i] = txPowerDensity * inner;
+      (*txPsd)[5 * n / 2 + i] = txPowerDensity * outer;
+    }
+  for (uint32_t i = n; i < 2 * n; i++)
+    {
+      (*txPsd)[i] = txPowerDensity;
+    }
+  return txPsd;
+}
+
 static class WifiSpectrumModel5MhzInitializer
 {
 public:
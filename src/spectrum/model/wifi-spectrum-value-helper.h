@@ -68,6 +68,41 @@ public:
    */
   virtual Ptr<SpectrumValue> CreateRfFilter (uint32_t channel) = 0;
 
+  /**
+   * Return the SpectrumModel of a wifi channel of any width, from the
+   * 5 MHz channels up to the 2160 MHz 802.11ad (DMG) channels.  The
+   * model spans the channel and one channel width on each side of
+   * it, with a resolution of channelWidth / bandsPerChannel, so that
+   * the PSD of a wide channel is as short as the PSD of a narrow one.
+   * The in-channel bands are bands [bandsPerChannel, 2 * bandsPerChannel).
+   * Models are shared by all the callers asking for the same channel.
+   *
+   * \param centerFrequency the center frequency of the channel in MHz
+   * \param channelWidth the width of the channel in MHz
+   * \param bandsPerChannel the number of bands within the channel (even)
+   * \return the SpectrumModel of the channel
+   */
+  static Ptr<SpectrumModel> GetChannelSpectrumModel (double centerFrequency,
+                                                     uint32_t channelWidth,
+                                                     uint32_t bandsPerChannel);
+
+  /**
+   * Create the TX PSD of a wifi channel on a model returned by
+   * GetChannelSpectrumModel.  The power is spread evenly over the
+   * channel, and the adjacent bands follow a coarse transmit spectrum
+   * mask: -28 dBr then -40 dBr over each half channel width (IEEE
+   * Std. 802.11-2012, 18.3.9.3), or -17 dBr then -22 dBr for the DMG
+   * channels (IEEE Std. 802.11ad-2012, 21.3.2).
+   *
+   * \param model the SpectrumModel of the channel
+   * \param channelWidth the width of the channel in MHz
+   * \param txPower the total TX power in W within the channel
+   * \return the TX PSD
+   */
+  static Ptr<SpectrumValue> CreateChannelTxPowerSpectralDensity (Ptr<const SpectrumModel> model,
+                                                                 uint32_t channelWidth,
+                                                                 double txPower);
+
 };
 
 
@@ -0,0 +1,346 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/cosine-antenna-model.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-spectrum-propagation-loss.h>
+#include <ns3/double.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MultiModelSpectrumChannelTest");
+
+/**
+ * A propagation loss model with a constant loss, which counts its calls
+ */
+class CountingPropagationLossModel : public PropagationLossModel
+{
+public:
+  CountingPropagationLossModel ()
+    : m_calls (0)
+  {
+  }
+
+  uint32_t m_calls; //!< number of calls
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const
+  {
+    const_cast<CountingPropagationLossModel *> (this)->m_calls++;
+    return txPowerDbm - 50;
+  }
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    return 0;
+  }
+};
+
+/**
+ * A frequency-flat spectrum propagation loss model which counts its calls
+ */
+class CountingSpectrumPropagationLossModel : public ConstantSpectrumPropagationLossModel
+{
+public:
+  CountingSpectrumPropagationLossModel ()
+    : m_psdCalls (0),
+      m_gainCalls (0)
+  {
+  }
+
+  virtual Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                           Ptr<const MobilityModel> a,
+                                                           Ptr<const MobilityModel> b) const
+  {
+    const_cast<CountingSpectrumPropagationLossModel *> (this)->m_psdCalls++;
+    return ConstantSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (txPsd, a, b);
+  }
+  virtual double DoGetFlatGain (Ptr<const MobilityModel> a,
+                                Ptr<const MobilityModel> b) const
+  {
+    const_cast<CountingSpectrumPropagationLossModel *> (this)->m_gainCalls++;
+    return ConstantSpectrumPropagationLossModel::DoGetFlatGain (a, b);
+  }
+
+  uint32_t m_psdCalls;  //!< number of PSDs shaped
+  uint32_t m_gainCalls; //!< number of flat gains computed
+};
+
+/**
+ * A SpectrumPhy which records the power of the last signal received
+ */
+class PathLossTestPhy : public SpectrumPhy
+{
+public:
+  /// \param model the spectrum model of the receiver
+  PathLossTestPhy (Ptr<const SpectrumModel> model)
+    : m_model (model),
+      m_rxPower (0)
+  {
+  }
+
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return m_model;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    m_rxPower = (*params->psd)[0];
+  }
+
+  Ptr<const SpectrumModel> m_model; //!< the spectrum model
+  Ptr<MobilityModel> m_mobility;    //!< the mobility model
+  double m_rxPower;                 //!< PSD of the last signal received
+};
+
+/**
+ * Check that MultiModelSpectrumChannel caches the path loss between
+ * static nodes and forgets it when a node changes course or an antenna
+ * is steered.
+ */
+class PathLossCacheTestCase : public TestCase
+{
+public:
+  /// \param cache whether the PathLossCache attribute is set
+  PathLossCacheTestCase (bool cache);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param channel the channel
+   * \param tx the transmitter
+   * \param rx the receiver
+   * \param txAntenna the antenna of the transmitter, if any
+   * \returns the PSD received
+   */
+  double Send (Ptr<MultiModelSpectrumChannel> channel, Ptr<SpectrumPhy> tx, Ptr<PathLossTestPhy> rx,
+               Ptr<AntennaModel> txAntenna = 0);
+
+  bool m_cache; //!< whether the PathLossCache attribute is set
+};
+
+PathLossCacheTestCase::PathLossCacheTestCase (bool cache)
+  : TestCase (cache ? "Path loss cache enabled" : "Path loss cache disabled"),
+    m_cache (cache)
+{
+}
+
+double
+PathLossCacheTestCase::Send (Ptr<MultiModelSpectrumChannel> channel, Ptr<SpectrumPhy> tx, Ptr<PathLossTestPhy> rx,
+                             Ptr<AntennaModel> txAntenna)
+{
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->duration = MicroSeconds (10);
+  params->txPhy = tx;
+  params->txAntenna = txAntenna;
+  params->psd = Create<SpectrumValue> (rx->m_model);
+  (*params->psd)[0] = 1e-3;
+  (*params->psd)[1] = 2e-3;
+  rx->m_rxPower = 0;
+  channel->StartTx (params);
+  Simulator::Run ();
+  return rx->m_rxPower;
+}
+
+void
+PathLossCacheTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  freqs.push_back (2.4e9);
+  freqs.push_back (2.41e9);
+  Ptr<const SpectrumModel> model = Create<SpectrumModel> (freqs);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("PathLossCache", BooleanValue (m_cache));
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  channel->AddPropagationLossModel (loss);
+
+  Ptr<PathLossTestPhy> a = CreateObject<PathLossTestPhy> (model);
+  Ptr<PathLossTestPhy> b = CreateObject<PathLossTestPhy> (model);
+  Ptr<ConstantPositionMobilityModel> aMobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> bMobility = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetMobility (aMobility);
+  b->SetMobility (bMobility);
+  channel->AddRx (a);
+  channel->AddRx (b);
+
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      double rxPsd = Send (channel, a, b);
+      NS_TEST_EXPECT_MSG_EQ_TOL (rxPsd, 1e-8, 1e-20, "Wrong received PSD");
+    }
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, (m_cache ? 1 : 3), "Wrong number of path loss computations");
+
+  Send (channel, b, a);
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, (m_cache ? 2 : 4), "Reverse path not computed");
+
+  // a course change invalidates the paths of the node
+  bMobility->SetPosition (Vector (10, 0, 0));
+  Send (channel, a, b);
+  Send (channel, b, a);
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, (m_cache ? 4 : 6), "Paths not computed after a course change");
+  Send (channel, a, b);
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, (m_cache ? 4 : 7), "Wrong number of path loss computations");
+
+  // steering an antenna invalidates the paths of the antenna
+  Ptr<CosineAntennaModel> antenna = CreateObject<CosineAntennaModel> ();
+  double boresightPsd = Send (channel, a, b, antenna);
+  NS_TEST_EXPECT_MSG_EQ_TOL (boresightPsd, 1e-8, 1e-20, "Wrong received PSD at the boresight");
+  antenna->SetOrientation (90);
+  double steeredPsd = Send (channel, a, b, antenna);
+  NS_TEST_EXPECT_MSG_LT (steeredPsd, boresightPsd / 2, "Gain of the steered antenna not computed again");
+  double rxPsd = Send (channel, a, b, antenna);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPsd, steeredPsd, 1e-20, "Wrong received PSD");
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, (m_cache ? 6 : 10), "Paths not computed after steering the antenna");
+
+  // moving nodes are never cached
+  Ptr<ConstantVelocityMobilityModel> cMobility = CreateObject<ConstantVelocityMobilityModel> ();
+  cMobility->SetVelocity (Vector (1, 0, 0));
+  Ptr<PathLossTestPhy> c = CreateObject<PathLossTestPhy> (model);
+  c->SetMobility (cMobility);
+  channel->AddRx (c);
+  uint32_t calls = loss->m_calls;
+  Send (channel, c, a);
+  Send (channel, c, a);
+  // each transmission of c reaches a and b
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, calls + 4, "Path of a moving node cached");
+
+  channel->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that MultiModelSpectrumChannel applies the gain of a
+ * frequency-flat SpectrumPropagationLossModel with the path loss, and
+ * caches it with the path loss.
+ */
+class FlatSpectrumLossTestCase : public TestCase
+{
+public:
+  /// \param cache whether the PathLossCache attribute is set
+  FlatSpectrumLossTestCase (bool cache);
+
+private:
+  virtual void DoRun (void);
+
+  bool m_cache; //!< whether the PathLossCache attribute is set
+};
+
+FlatSpectrumLossTestCase::FlatSpectrumLossTestCase (bool cache)
+  : TestCase (cache ? "Frequency-flat spectrum loss, path loss cache enabled"
+              : "Frequency-flat spectrum loss, path loss cache disabled"),
+    m_cache (cache)
+{
+}
+
+void
+FlatSpectrumLossTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  freqs.push_back (2.4e9);
+  freqs.push_back (2.41e9);
+  Ptr<const SpectrumModel> model = Create<SpectrumModel> (freqs);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("PathLossCache", BooleanValue (m_cache));
+  channel->AddPropagationLossModel (CreateObject<CountingPropagationLossModel> ());
+  Ptr<CountingSpectrumPropagationLossModel> loss = CreateObject<CountingSpectrumPropagationLossModel> ();
+  loss->SetAttribute ("Loss", DoubleValue (10));
+  NS_TEST_ASSERT_MSG_EQ (loss->IsFrequencyFlat (), true, "Constant loss not frequency-flat");
+  channel->AddSpectrumPropagationLossModel (loss);
+
+  Ptr<PathLossTestPhy> a = CreateObject<PathLossTestPhy> (model);
+  Ptr<PathLossTestPhy> b = CreateObject<PathLossTestPhy> (model);
+  a->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  b->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  channel->AddRx (a);
+  channel->AddRx (b);
+
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+      params->duration = MicroSeconds (10);
+      params->txPhy = a;
+      params->psd = Create<SpectrumValue> (model);
+      (*params->psd)[0] = 1e-3;
+      (*params->psd)[1] = 2e-3;
+      channel->StartTx (params);
+      Simulator::Run ();
+      // 50 dB of path loss and 10 dB of spectrum loss
+      double rxPsd = b->m_rxPower;
+      NS_TEST_EXPECT_MSG_EQ_TOL (rxPsd, 1e-9, 1e-21, "Wrong received PSD");
+    }
+  NS_TEST_EXPECT_MSG_EQ (loss->m_psdCalls, 0, "PSD of a frequency-flat loss shaped");
+  NS_TEST_EXPECT_MSG_EQ (loss->m_gainCalls, (m_cache ? 1 : 3), "Wrong number of flat gain computations");
+
+  channel->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * Test suite for MultiModelSpectrumChannel
+ */
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelTestSuite ();
+};
+
+MultiModelSpectrumChannelTestSuite::MultiModelSpectrumChannelTestSuite ()
+  : TestSuite ("multi-model-spectrum-channel", UNIT)
+{
+  AddTestCase (new PathLossCacheTestCase (true), TestCase::QUICK);
+  AddTestCase (new PathLossCacheTestCase (false), TestCase::QUICK);
+  AddTestCase (new FlatSpectrumLossTestCase (true), TestCase::QUICK);
+  AddTestCase (new FlatSpectrumLossTestCase (false), TestCase::QUICK);
+}
+
+static MultiModelSpectrumChannelTestSuite multiModelSpectrumChannelTestSuite;
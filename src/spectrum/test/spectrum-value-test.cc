@@ -241,6 +241,20 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   tv1rs3 = v1 >> 3;
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
+  // fused kernels, into default constructed and reused values
+  SpectrumValue tv9c, tv3c, sinr, interf;
+  Scale (tv9c, v1, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv9c, v9, "Scale (tv9c, v1, doubleValue)"), TestCase::QUICK);
+  Scale (tv3c, v1, 1);
+  AddScaled (tv3c, v2, 1);
+  AddTestCase (new SpectrumValueTestCase (tv3c, v3, "AddScaled (tv3c, v2, 1)"), TestCase::QUICK);
+  Scale (tv9c, v2, 1);
+  Scale (tv9c, tv9c, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv9c, v2 * doubleValue, "Scale (tv9c, tv9c, doubleValue)"), TestCase::QUICK);
+  ComputeSinr (sinr, interf, v1, v3, v7);
+  AddTestCase (new SpectrumValueTestCase (interf, v3 - v1 + v7, "ComputeSinr interference"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (sinr, v1 / (v3 - v1 + v7), "ComputeSinr SINR"), TestCase::QUICK);
+
 
 }
 
@@ -0,0 +1,466 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "quantile-sketch.h"
+#include "ns3/double.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QuantileSketch");
+
+NS_OBJECT_ENSURE_REGISTERED (QuantileCalculator);
+
+QuantileSketch::QuantileSketch ()
+{
+  Init (0.01, 2048);
+}
+
+QuantileSketch::QuantileSketch (double relativeAccuracy, uint32_t maxBuckets)
+{
+  Init (relativeAccuracy, maxBuckets);
+}
+
+void
+QuantileSketch::Init (double relativeAccuracy, uint32_t maxBuckets)
+{
+  NS_ASSERT_MSG (relativeAccuracy > 0 && relativeAccuracy < 1,
+                 "QuantileSketch: relative accuracy must be in (0, 1)");
+  double gamma = (1 + relativeAccuracy) / (1 - relativeAccuracy);
+  m_accuracy = relativeAccuracy;
+  m_multiplier = 1 / std::log (gamma);
+  m_maxBuckets = std::max (maxBuckets, 1U);
+  m_positive.offset = 0;
+  m_negative.offset = 0;
+  m_zeroCount = 0;
+  m_count = 0;
+  m_sum = 0;
+  m_min = 0;
+  m_max = 0;
+}
+
+int32_t
+QuantileSketch::GetIndex (double value) const
+{
+  return (int32_t) std::ceil (std::log (value) * m_multiplier);
+}
+
+double
+QuantileSketch::GetValue (int32_t index) const
+{
+  // the value with the same relative distance to both bucket bounds
+  return std::exp (index / m_multiplier) * (1 - m_accuracy);
+}
+
+void
+QuantileSketch::AddToStore (Store &store, int32_t index, uint64_t count)
+{
+  if (store.counts.empty ())
+    {
+      store.counts.assign (1, 0);
+      store.offset = index;
+    }
+  else if (index < store.offset)
+    {
+      // never grow past the limit on the low side: fold into the
+      // lowest bucket kept instead.
+      int32_t high = store.offset + (int32_t) store.counts.size () - 1;
+      int32_t low = std::max (index, high - (int32_t) m_maxBuckets + 1);
+      if (low < store.offset)
+        {
+          store.counts.insert (store.counts.begin (), store.offset - low, 0);
+          store.offset = low;
+        }
+      index = std::max (index, store.offset);
+    }
+  else if (index >= store.offset + (int32_t) store.counts.size ())
+    {
+      store.counts.resize (index - store.offset + 1, 0);
+      if (store.counts.size () > m_maxBuckets)
+        {
+          // collapse the lowest buckets
+          uint32_t n = store.counts.size () - m_maxBuckets;
+          uint64_t folded = 0;
+          for (uint32_t i = 0; i < n; i++)
+            {
+              folded += store.counts[i];
+            }
+          store.counts.erase (store.counts.begin (), store.counts.begin () + n);
+          store.counts[0] += folded;
+          store.offset += n;
+        }
+    }
+  store.counts[index - store.offset] += count;
+}
+
+void
+QuantileSketch::Add (double value)
+{
+  Add (value, 1);
+}
+
+void
+QuantileSketch::Add (double value, uint64_t count)
+{
+  if (count == 0)
+    {
+      return;
+    }
+  if (value > 0)
+    {
+      AddToStore (m_positive, GetIndex (value), count);
+    }
+  else if (value < 0)
+    {
+      AddToStore (m_negative, GetIndex (-value), count);
+    }
+  else
+    {
+      m_zeroCount += count;
+    }
+  if (m_count == 0)
+    {
+      m_min = value;
+      m_max = value;
+    }
+  else
+    {
+      m_min = std::min (m_min, value);
+      m_max = std::max (m_max, value);
+    }
+  m_count += count;
+  m_sum += value * count;
+}
+
+void
+QuantileSketch::Merge (const QuantileSketch &other)
+{
+  NS_ASSERT_MSG (other.m_multiplier == m_multiplier,
+                 "QuantileSketch::Merge(): sketches with different accuracies");
+  if (other.m_count == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < other.m_positive.counts.size (); i++)
+    {
+      if (other.m_positive.counts[i] > 0)
+        {
+          AddToStore (m_positive, other.m_positive.offset + i, other.m_positive.counts[i]);
+        }
+    }
+  for (uint32_t i = 0; i < other.m_negative.counts.size (); i++)
+    {
+      if (other.m_negative.counts[i] > 0)
+        {
+          AddToStore (m_negative, other.m_negative.offset + i, other.m_negative.counts[i]);
+        }
+    }
+  m_zeroCount += other.m_zeroCount;
+  if (m_count == 0)
+    {
+      m_min = other.m_min;
+      m_max = other.m_max;
+    }
+  else
+    {
+      m_min = std::min (m_min, other.m_min);
+      m_max = std::max (m_max, other.m_max);
+    }
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+}
+
+void
+QuantileSketch::Clear (void)
+{
+  m_positive.counts.clear ();
+  m_negative.counts.clear ();
+  m_zeroCount = 0;
+  m_count = 0;
+  m_sum = 0;
+  m_min = 0;
+  m_max = 0;
+}
+
+double
+QuantileSketch::GetQuantile (double q) const
+{
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  q = std::min (std::max (q, 0.0), 1.0);
+  uint64_t rank = (uint64_t) (q * (m_count - 1));
+  uint64_t n = 0;
+  double value = m_max;
+  bool found = false;
+  for (uint32_t i = m_negative.counts.size (); i > 0 && !found; i--)
+    {
+      n += m_negative.counts[i - 1];
+      if (n > rank)
+        {
+          value = -GetValue (m_negative.offset + i - 1);
+          found = true;
+        }
+    }
+  n += m_zeroCount;
+  if (!found && n > rank)
+    {
+      value = 0;
+      found = true;
+    }
+  for (uint32_t i = 0; i < m_positive.counts.size () && !found; i++)
+    {
+      n += m_positive.counts[i];
+      if (n > rank)
+        {
+          value = GetValue (m_positive.offset + i);
+          found = true;
+        }
+    }
+  return std::min (std::max (value, m_min), m_max);
+}
+
+uint64_t
+QuantileSketch::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+QuantileSketch::GetSum (void) const
+{
+  return m_sum;
+}
+
+double
+QuantileSketch::GetMin (void) const
+{
+  return m_min;
+}
+
+double
+QuantileSketch::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+QuantileSketch::GetMean (void) const
+{
+  return m_count ? m_sum / m_count : 0;
+}
+
+double
+QuantileSketch::GetRelativeAccuracy (void) const
+{
+  return m_accuracy;
+}
+
+uint32_t
+QuantileSketch::GetNBuckets (void) const
+{
+  return m_positive.counts.size () + m_negative.counts.size ();
+}
+
+void
+QuantileSketch::SerializeToXmlStream (std::ostream &os, int indent, std::string elementName) const
+{
+  for (int i = 0; i < indent; i++)
+    {
+      os << ' ';
+    }
+  os << "<" << elementName
+     << " count=\"" << m_count << "\""
+     << " relativeAccuracy=\"" << m_accuracy << "\"";
+  if (m_count > 0)
+    {
+      os << " min=\"" << m_min << "\""
+         << " max=\"" << m_max << "\""
+         << " p50=\"" << GetQuantile (0.5) << "\""
+         << " p90=\"" << GetQuantile (0.9) << "\""
+         << " p99=\"" << GetQuantile (0.99) << "\""
+         << " p999=\"" << GetQuantile (0.999) << "\"";
+    }
+  os << " />\n";
+}
+
+
+TypeId
+QuantileCalculator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::QuantileCalculator")
+    .SetParent<DataCalculator> ()
+    .SetGroupName ("Stats")
+    .AddConstructor<QuantileCalculator> ()
+    .AddAttribute ("RelativeAccuracy",
+                   "The maximum relative error of the estimated quantiles.  "
+                   "Changing it forgets the values added so far.",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&QuantileCalculator::SetRelativeAccuracy,
+                                       &QuantileCalculator::GetRelativeAccuracy),
+                   MakeDoubleChecker<double> (1e-6, 0.5))
+  ;
+  return tid;
+}
+
+QuantileCalculator::QuantileCalculator ()
+  : m_squareTotal (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+QuantileCalculator::~QuantileCalculator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+QuantileCalculator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  DataCalculator::DoDispose ();
+}
+
+void
+QuantileCalculator::SetRelativeAccuracy (double accuracy)
+{
+  NS_LOG_FUNCTION (this << accuracy);
+  m_sketch = QuantileSketch (accuracy);
+  m_squareTotal = 0;
+}
+
+double
+QuantileCalculator::GetRelativeAccuracy (void) const
+{
+  return m_sketch.GetRelativeAccuracy ();
+}
+
+void
+QuantileCalculator::Update (const double value)
+{
+  NS_LOG_FUNCTION (this << value);
+  if (m_enabled)
+    {
+      m_sketch.Add (value);
+      m_squareTotal += value * value;
+    }
+}
+
+void
+QuantileCalculator::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sketch.Clear ();
+  m_squareTotal = 0;
+}
+
+void
+QuantileCalculator::Merge (const QuantileCalculator &other)
+{
+  NS_LOG_FUNCTION (this << &other);
+  m_sketch.Merge (other.m_sketch);
+  m_squareTotal += other.m_squareTotal;
+}
+
+double
+QuantileCalculator::GetQuantile (double q) const
+{
+  return m_sketch.GetQuantile (q);
+}
+
+const QuantileSketch &
+QuantileCalculator::GetSketch (void) const
+{
+  return m_sketch;
+}
+
+void
+QuantileCalculator::Output (DataOutputCallback &callback) const
+{
+  NS_LOG_FUNCTION (this << &callback);
+  callback.OutputSingleton (m_context, m_key + "-count", (uint32_t) m_sketch.GetCount ());
+  if (m_sketch.GetCount () > 0)
+    {
+      callback.OutputSingleton (m_context, m_key + "-min", m_sketch.GetMin ());
+      callback.OutputSingleton (m_context, m_key + "-max", m_sketch.GetMax ());
+      callback.OutputSingleton (m_context, m_key + "-average", m_sketch.GetMean ());
+      callback.OutputSingleton (m_context, m_key + "-p50", m_sketch.GetQuantile (0.5));
+      callback.OutputSingleton (m_context, m_key + "-p90", m_sketch.GetQuantile (0.9));
+      callback.OutputSingleton (m_context, m_key + "-p99", m_sketch.GetQuantile (0.99));
+      callback.OutputSingleton (m_context, m_key + "-p99.9", m_sketch.GetQuantile (0.999));
+    }
+}
+
+long
+QuantileCalculator::getCount () const
+{
+  return m_sketch.GetCount ();
+}
+
+double
+QuantileCalculator::getSum () const
+{
+  return m_sketch.GetSum ();
+}
+
+double
+QuantileCalculator::getSqrSum () const
+{
+  return m_squareTotal;
+}
+
+double
+QuantileCalculator::getMin () const
+{
+  return m_sketch.GetMin ();
+}
+
+double
+QuantileCalculator::getMax () const
+{
+  return m_sketch.GetMax ();
+}
+
+double
+QuantileCalculator::getMean () const
+{
+  return m_sketch.GetMean ();
+}
+
+double
+QuantileCalculator::getVariance () const
+{
+  uint64_t n = m_sketch.GetCount ();
+  if (n < 2)
+    {
+      return 0;
+    }
+  double mean = m_sketch.GetMean ();
+  return std::max (0.0, (m_squareTotal - n * mean * mean) / (n - 1));
+}
+
+double
+QuantileCalculator::getStddev () const
+{
+  return std::sqrt (getVariance ());
+}
+
+} // namespace ns3
@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "data-calculator.h"
+#include "data-output-interface.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup stats
+ * \brief Streaming quantile estimator with bounded relative error.
+ *
+ * Values are counted in logarithmic buckets: bucket i holds the
+ * values in \f$(\gamma^{i-1}, \gamma^i]\f$, with
+ * \f$\gamma = (1 + \alpha) / (1 - \alpha)\f$, so that any quantile is
+ * estimated within a relative error \f$\alpha\f$ of a value of the
+ * sample.  Negative values use a mirrored set of buckets and zeros
+ * are counted apart.
+ *
+ * The number of buckets only depends on the range of the values, not
+ * on their number: with 1% accuracy, values from 1 ns to 100 s need
+ * about 1300 buckets.  Past MaxBuckets, the lowest buckets are merged,
+ * which only degrades the accuracy of the lowest quantiles.
+ *
+ * Two sketches with the same accuracy can be merged exactly, e.g. to
+ * combine the delays of several flows or of several runs.
+ */
+class QuantileSketch
+{
+public:
+  /** Create a sketch with 1% relative accuracy and 2048 buckets per sign. */
+  QuantileSketch ();
+  /**
+   * \param relativeAccuracy the relative accuracy \f$\alpha\f$, in (0, 1)
+   * \param maxBuckets the maximum number of buckets per sign
+   */
+  QuantileSketch (double relativeAccuracy, uint32_t maxBuckets = 2048);
+
+  /**
+   * \param value a sample
+   */
+  void Add (double value);
+  /**
+   * \param value a sample
+   * \param count the number of times it was observed
+   */
+  void Add (double value, uint64_t count);
+  /**
+   * Add all the samples of another sketch.
+   * \param other a sketch with the same relative accuracy
+   */
+  void Merge (const QuantileSketch &other);
+  /** Forget all the samples. */
+  void Clear (void);
+
+  /**
+   * \param q the quantile, in [0, 1]
+   * \returns the estimated value, or 0 if the sketch is empty
+   */
+  double GetQuantile (double q) const;
+  /** \returns the number of samples */
+  uint64_t GetCount (void) const;
+  /** \returns the sum of the samples */
+  double GetSum (void) const;
+  /** \returns the smallest sample */
+  double GetMin (void) const;
+  /** \returns the largest sample */
+  double GetMax (void) const;
+  /** \returns the mean of the samples */
+  double GetMean (void) const;
+  /** \returns the relative accuracy */
+  double GetRelativeAccuracy (void) const;
+  /** \returns the number of buckets in use */
+  uint32_t GetNBuckets (void) const;
+
+  /**
+   * Serialize the count, extrema and the 50th, 90th, 99th and 99.9th
+   * percentiles as an XML element.
+   * \param os the output stream
+   * \param indent the number of spaces before the element
+   * \param elementName the element name
+   */
+  void SerializeToXmlStream (std::ostream &os, int indent, std::string elementName) const;
+
+private:
+  /// Buckets of one sign
+  struct Store
+  {
+    std::vector<uint64_t> counts; //!< counts, from the lowest bucket
+    int32_t offset;               //!< index of counts[0]
+  };
+
+  /**
+   * \param relativeAccuracy the relative accuracy
+   * \param maxBuckets the maximum number of buckets per sign
+   */
+  void Init (double relativeAccuracy, uint32_t maxBuckets);
+  /**
+   * \param store the store
+   * \param index the bucket index
+   * \param count the count to add
+   */
+  void AddToStore (Store &store, int32_t index, uint64_t count);
+  /**
+   * \param value a strictly positive value
+   * \returns the index of its bucket
+   */
+  int32_t GetIndex (double value) const;
+  /**
+   * \param index a bucket index
+   * \returns the value representing the bucket
+   */
+  double GetValue (int32_t index) const;
+
+  double m_accuracy;     //!< relative accuracy
+  double m_multiplier;   //!< 1 / ln (gamma)
+  uint32_t m_maxBuckets; //!< maximum number of buckets per store
+  Store m_positive;      //!< buckets of the positive values
+  Store m_negative;      //!< buckets of the absolute negative values
+  uint64_t m_zeroCount;  //!< number of zero samples
+  uint64_t m_count;      //!< number of samples
+  double m_sum;          //!< sum of the samples
+  double m_min;          //!< smallest sample
+  double m_max;          //!< largest sample
+};
+
+/**
+ * \ingroup stats
+ * \class QuantileCalculator
+ * \brief Estimate the percentiles of a series of values.
+ *
+ * Outputs the count, minimum, maximum and mean, and the 50th, 90th,
+ * 99th and 99.9th percentiles estimated by a QuantileSketch.
+ */
+class QuantileCalculator : public DataCalculator,
+                           public StatisticalSummary
+{
+public:
+  QuantileCalculator ();
+  virtual ~QuantileCalculator ();
+
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param value the value to add
+   */
+  void Update (const double value);
+  /** Forget all the values. */
+  void Reset (void);
+  /**
+   * \param q the quantile, in [0, 1]
+   * \returns the estimated value
+   */
+  double GetQuantile (double q) const;
+  /** \returns the sketch of the values */
+  const QuantileSketch & GetSketch (void) const;
+  /**
+   * Add the values of another calculator.
+   * \param other a calculator with the same relative accuracy
+   */
+  void Merge (const QuantileCalculator &other);
+
+  /**
+   * Outputs the data based on the provided callback
+   * \param callback
+   */
+  virtual void Output (DataOutputCallback &callback) const;
+
+  long getCount () const;
+  double getSum () const;
+  double getSqrSum () const;
+  double getMin () const;
+  double getMax () const;
+  double getMean () const;
+  double getStddev () const;
+  double getVariance () const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param accuracy the relative accuracy of the sketch
+   */
+  void SetRelativeAccuracy (double accuracy);
+  /** \returns the relative accuracy of the sketch */
+  double GetRelativeAccuracy (void) const;
+
+  QuantileSketch m_sketch; //!< the values
+  double m_squareTotal;    //!< sum of the squares of the values
+};
+
+} // namespace ns3
+
+#endif /* QUANTILE_SKETCH_H */
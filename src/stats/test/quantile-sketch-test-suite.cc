@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/quantile-sketch.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Compare the estimated quantiles with the exact ones.
+// ===========================================================================
+class QuantileSketchAccuracyTestCase : public TestCase
+{
+public:
+  QuantileSketchAccuracyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+QuantileSketchAccuracyTestCase::QuantileSketchAccuracyTestCase ()
+  : TestCase ("Quantiles are within the relative accuracy")
+{
+}
+
+void
+QuantileSketchAccuracyTestCase::DoRun (void)
+{
+  const double accuracy = 0.01;
+  Ptr<ExponentialRandomVariable> exp = CreateObject<ExponentialRandomVariable> ();
+  exp->SetStream (1);
+  exp->SetAttribute ("Mean", DoubleValue (0.002));
+  exp->SetAttribute ("Bound", DoubleValue (0));
+
+  QuantileSketch sketch (accuracy);
+  std::vector<double> values;
+  for (uint32_t i = 0; i < 100000; i++)
+    {
+      // a long tail, some zeros and some negative values
+      double v = exp->GetValue ();
+      if (i % 97 == 0)
+        {
+          v = 0;
+        }
+      else if (i % 13 == 0)
+        {
+          v = -v;
+        }
+      sketch.Add (v);
+      values.push_back (v);
+    }
+  std::sort (values.begin (), values.end ());
+
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetCount (), values.size (), "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (sketch.GetMin (), values.front (), "Wrong minimum");
+  NS_TEST_EXPECT_MSG_EQ (sketch.GetMax (), values.back (), "Wrong maximum");
+  double qs[] = { 0, 0.01, 0.05, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 0.9999, 1 };
+  for (uint32_t i = 0; i < sizeof (qs) / sizeof (qs[0]); i++)
+    {
+      double exact = values[(uint32_t) (qs[i] * (values.size () - 1))];
+      double estimate = sketch.GetQuantile (qs[i]);
+      NS_TEST_EXPECT_MSG_EQ_TOL (estimate, exact, std::fabs (exact) * accuracy + 1e-15,
+                                 "Quantile " << qs[i] << " out of the accuracy bound");
+    }
+}
+
+// ===========================================================================
+// Merging sketches gives the same result as adding all the values to one.
+// ===========================================================================
+class QuantileSketchMergeTestCase : public TestCase
+{
+public:
+  QuantileSketchMergeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+QuantileSketchMergeTestCase::QuantileSketchMergeTestCase ()
+  : TestCase ("Merged sketches equal a single sketch")
+{
+}
+
+void
+QuantileSketchMergeTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable> ();
+  u->SetStream (2);
+  QuantileSketch all;
+  QuantileSketch parts[3];
+  for (uint32_t i = 0; i < 30000; i++)
+    {
+      // each part covers a different range
+      double v = std::pow (10, u->GetValue (-6 + 2 * (i % 3), -2 + 2 * (i % 3)));
+      all.Add (v);
+      parts[i % 3].Add (v);
+    }
+  QuantileSketch merged;
+  merged.Merge (parts[2]);
+  merged.Merge (parts[0]);
+  merged.Merge (parts[1]);
+  NS_TEST_EXPECT_MSG_EQ (merged.GetCount (), all.GetCount (), "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (merged.GetMin (), all.GetMin (), "Wrong minimum");
+  NS_TEST_EXPECT_MSG_EQ (merged.GetMax (), all.GetMax (), "Wrong maximum");
+  NS_TEST_EXPECT_MSG_EQ (merged.GetNBuckets (), all.GetNBuckets (), "Wrong number of buckets");
+  for (double q = 0; q <= 1; q += 0.05)
+    {
+      NS_TEST_EXPECT_MSG_EQ (merged.GetQuantile (q), all.GetQuantile (q), "Quantile " << q << " differs");
+    }
+}
+
+// ===========================================================================
+// The number of buckets is bounded, and the high quantiles stay accurate.
+// ===========================================================================
+class QuantileSketchBoundedTestCase : public TestCase
+{
+public:
+  QuantileSketchBoundedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+QuantileSketchBoundedTestCase::QuantileSketchBoundedTestCase ()
+  : TestCase ("The number of buckets is bounded")
+{
+}
+
+void
+QuantileSketchBoundedTestCase::DoRun (void)
+{
+  const uint32_t maxBuckets = 100;
+  QuantileSketch sketch (0.01, maxBuckets);
+  std::vector<double> values;
+  for (int32_t e = -300; e <= 300; e++)
+    {
+      // alternate small and large values so that both sides grow
+      double v = std::pow (1.1, e % 2 ? e : -e);
+      sketch.Add (v);
+      values.push_back (v);
+    }
+  std::sort (values.begin (), values.end ());
+  NS_TEST_EXPECT_MSG_EQ ((sketch.GetNBuckets () <= maxBuckets), true, "Too many buckets");
+  double exact = values[(uint32_t) (0.99 * (values.size () - 1))];
+  NS_TEST_EXPECT_MSG_EQ_TOL (sketch.GetQuantile (0.99), exact, exact * 0.01, "Wrong 99th percentile");
+  NS_TEST_EXPECT_MSG_EQ (sketch.GetMin (), values.front (), "Wrong minimum");
+  NS_TEST_EXPECT_MSG_EQ (sketch.GetCount (), values.size (), "Wrong count");
+}
+
+// ===========================================================================
+// QuantileCalculator
+// ===========================================================================
+class QuantileCalculatorTestCase : public TestCase
+{
+public:
+  QuantileCalculatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+QuantileCalculatorTestCase::QuantileCalculatorTestCase ()
+  : TestCase ("QuantileCalculator statistics")
+{
+}
+
+void
+QuantileCalculatorTestCase::DoRun (void)
+{
+  Ptr<QuantileCalculator> calculator = CreateObject<QuantileCalculator> ();
+  calculator->SetAttribute ("RelativeAccuracy", DoubleValue (0.001));
+  for (uint32_t i = 1; i <= 1000; i++)
+    {
+      calculator->Update (i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (calculator->getCount (), 1000, "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ_TOL (calculator->getMean (), 500.5, 1e-9, "Wrong mean");
+  NS_TEST_EXPECT_MSG_EQ_TOL (calculator->getVariance (), 1000.0 * 1001 / 12, 1e-6, "Wrong variance");
+  NS_TEST_EXPECT_MSG_EQ_TOL (calculator->GetQuantile (0.5), 500, 0.5, "Wrong median");
+  NS_TEST_EXPECT_MSG_EQ_TOL (calculator->GetQuantile (0.99), 990, 1, "Wrong 99th percentile");
+  calculator->Reset ();
+  NS_TEST_EXPECT_MSG_EQ (calculator->getCount (), 0, "Reset failed");
+}
+
+class QuantileSketchTestSuite : public TestSuite
+{
+public:
+  QuantileSketchTestSuite ();
+};
+
+QuantileSketchTestSuite::QuantileSketchTestSuite ()
+  : TestSuite ("quantile-sketch", UNIT)
+{
+  AddTestCase (new QuantileSketchAccuracyTestCase, TestCase::QUICK);
+  AddTestCase (new QuantileSketchMergeTestCase, TestCase::QUICK);
+  AddTestCase (new QuantileSketchBoundedTestCase, TestCase::QUICK);
+  AddTestCase (new QuantileCalculatorTestCase, TestCase::QUICK);
+}
+
+static QuantileSketchTestSuite quantileSketchTestSuite;
@@ -174,6 +174,25 @@ WifiHelper::EnableLogComponents (void)
   LogComponentEnable ("YansWifiPhy", LOG_LEVEL_ALL);
 }
 
+void
+WifiHelper::EnableMacStats (NetDeviceContainer c, Time interval)
+{
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice> (*i);
+      if (wifi)
+        {
+          Ptr<RegularWifiMac> rmac = DynamicCast<RegularWifiMac> (wifi->GetMac ());
+          if (rmac)
+            {
+              Ptr<WifiMacStats> stats = CreateObject<WifiMacStats> ();
+              stats->SetAttribute ("Interval", TimeValue (interval));
+              rmac->SetStats (stats);
+            }
+        }
+    }
+}
+
 int64_t
 WifiHelper::AssignStreams (NetDeviceContainer c, int64_t stream)
 {
@@ -29,6 +29,7 @@
 #include "ns3/node-container.h"
 #include "ns3/net-device-container.h"
 #include "ns3/wifi-phy-standard.h"
+#include "ns3/nstime.h"
 #include "ns3/trace-helper.h"
 
 namespace ns3 {
@@ -199,6 +200,18 @@ public:
    */
   static void EnableLogComponents (void);
 
+  /**
+   * Attach a WifiMacStats object to the MAC of each device in
+   * container c.  The counters can then be sampled with a
+   * WifiMacStatsProbe connected to
+   * "/NodeList/[i]/DeviceList/[j]/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/Stats/Window".
+   * The Install() method should have previously been called by the user.
+   *
+   * \param c NetDeviceContainer of the set of net devices
+   * \param interval the length of the windows reported by the stats
+   */
+  static void EnableMacStats (NetDeviceContainer c, Time interval);
+
   /**
   * Assign a fixed random variable stream number to the random variables
   * used by the Phy and Mac aspects of the Wifi models.  Each device in
@@ -182,7 +182,8 @@ YansWifiChannelHelper::AssignStreams (Ptr<YansWifiChannel> c, int64_t stream)
 
 YansWifiPhyHelper::YansWifiPhyHelper ()
   : m_channel (0),
-    m_pcapDlt (PcapHelper::DLT_IEEE802_11)
+    m_pcapDlt (PcapHelper::DLT_IEEE802_11),
+    m_pcapSnapLen (std::numeric_limits<uint32_t>::max ())
 {
   m_phy.SetTypeId ("ns3::YansWifiPhy");
 }
@@ -273,7 +274,6 @@ PcapSniffTxEvent (
       }
     case PcapHelper::DLT_IEEE802_11_RADIO:
       {
-        Ptr<Packet> p = packet->Copy ();
         RadiotapHeader header;
         uint8_t frameFlags = RadiotapHeader::FRAME_FLAG_NONE;
         header.SetTsft (Simulator::Now ().GetMicroSeconds ());
@@ -292,35 +292,53 @@ PcapSniffTxEvent (
           }
 
         header.SetFrameFlags (frameFlags);
-        header.SetRate (rate);
+
+        //DMG (802.11ad) rates do not fit the 500 kbps rate field
+        WifiModulationClass modClass = txVector.GetMode ().GetModulationClass ();
+        bool dmg = (modClass == WIFI_MOD_CLASS_VHT_SC || modClass == WIFI_MOD_CLASS_VHT_OFDM);
+        if (!dmg)
+          {
+            header.SetRate (rate);
+          }
 
         uint16_t channelFlags = 0;
-        switch (rate)
+        if (dmg)
           {
-          case 2:  //1Mbps
-          case 4:  //2Mbps
-          case 10: //5Mbps
-          case 22: //11Mbps
-            channelFlags |= RadiotapHeader::CHANNEL_FLAG_CCK;
-            break;
-
-          default:
-            channelFlags |= RadiotapHeader::CHANNEL_FLAG_OFDM;
-            break;
+            if (modClass == WIFI_MOD_CLASS_VHT_OFDM)
+              {
+                channelFlags |= RadiotapHeader::CHANNEL_FLAG_OFDM;
+              }
+          }
+        else
+          {
+            switch (rate)
+              {
+              case 2:  //1Mbps
+              case 4:  //2Mbps
+              case 10: //5Mbps
+              case 22: //11Mbps
+                channelFlags |= RadiotapHeader::CHANNEL_FLAG_CCK;
+                break;
+
+              default:
+                channelFlags |= RadiotapHeader::CHANNEL_FLAG_OFDM;
+                break;
+              }
           }
 
+        //Radiotap has no 60 GHz spectrum flag: the band follows from the frequency
         if (channelFreqMhz < 2500)
           {
             channelFlags |= RadiotapHeader::CHANNEL_FLAG_SPECTRUM_2GHZ;
           }
-        else
+        else if (channelFreqMhz < 50000)
           {
             channelFlags |= RadiotapHeader::CHANNEL_FLAG_SPECTRUM_5GHZ;
           }
 
         header.SetChannelFrequencyAndFlags (channelFreqMhz, channelFlags);
 
-        if (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF || preamble == WIFI_PREAMBLE_NONE)
+        if (!dmg && (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF || preamble == WIFI_PREAMBLE_NONE))
           {
             uint8_t mcsRate = 0;
             uint8_t mcsKnown = RadiotapHeader::MCS_KNOWN_NONE;
@@ -376,9 +394,9 @@ PcapSniffTxEvent (
             /* For PCAP file, MPDU Delimiter and Padding should be removed by the MAC Driver */
             AmpduSubframeHeader hdr;
             uint32_t extractedLength;
-            p->RemoveHeader (hdr);
+            packet->PeekHeader (hdr);
             extractedLength = hdr.GetLength ();
-            p = p->CreateFragment (0, static_cast<uint32_t> (extractedLength));
+            packet = packet->CreateFragment (hdr.GetSerializedSize (), static_cast<uint32_t> (extractedLength));
             if (aMpdu.packetType == 2 || (hdr.GetEof () == true && hdr.GetLength () > 0))
               {
                 ampduStatusFlags |= RadiotapHeader::A_MPDU_STATUS_LAST;
@@ -386,7 +404,7 @@ PcapSniffTxEvent (
             header.SetAmpduStatus (aMpdu.referenceNumber, ampduStatusFlags, hdr.GetCrc ());
           }
 
-        if (preamble == WIFI_PREAMBLE_VHT)
+        if (!dmg && preamble == WIFI_PREAMBLE_VHT)
           {
             uint16_t vhtKnown = RadiotapHeader::VHT_KNOWN_NONE;
             uint8_t vhtFlags = RadiotapHeader::VHT_FLAGS_NONE;
@@ -432,8 +450,15 @@ PcapSniffTxEvent (
             header.SetVhtFields (vhtKnown, vhtFlags, vhtBandwidth, vhtMcsNss, vhtCoding, vhtGroupId, vhtPartialAid);
           }
 
-        p->AddHeader (header);
-        file->Write (Simulator::Now (), p);
+        if (dmg)
+          {
+            uint8_t dmgPhy = (modClass == WIFI_MOD_CLASS_VHT_OFDM) ? RadiotapHeader::DMG_PHY_OFDM : RadiotapHeader::DMG_PHY_SC;
+            header.SetDmgFields (dmgPhy, txVector.GetMode ().GetMcsValue ());
+          }
+
+        // Write the header and the packet separately, so that the
+        // packet is neither copied nor serialized beyond the snaplen.
+        file->Write (Simulator::Now (), header, packet);
         return;
       }
     default:
@@ -467,7 +492,6 @@ PcapSniffRxEvent (
       }
     case PcapHelper::DLT_IEEE802_11_RADIO:
       {
-        Ptr<Packet> p = packet->Copy ();
         RadiotapHeader header;
         uint8_t frameFlags = RadiotapHeader::FRAME_FLAG_NONE;
         header.SetTsft (Simulator::Now ().GetMicroSeconds ());
@@ -486,28 +510,46 @@ PcapSniffRxEvent (
           }
 
         header.SetFrameFlags (frameFlags);
-        header.SetRate (rate);
+
+        //DMG (802.11ad) rates do not fit the 500 kbps rate field
+        WifiModulationClass modClass = txVector.GetMode ().GetModulationClass ();
+        bool dmg = (modClass == WIFI_MOD_CLASS_VHT_SC || modClass == WIFI_MOD_CLASS_VHT_OFDM);
+        if (!dmg)
+          {
+            header.SetRate (rate);
+          }
 
         uint16_t channelFlags = 0;
-        switch (rate)
+        if (dmg)
+          {
+            if (modClass == WIFI_MOD_CLASS_VHT_OFDM)
+              {
+                channelFlags |= RadiotapHeader::CHANNEL_FLAG_OFDM;
+              }
+          }
+        else
           {
-          case 2:  //1Mbps
-          case 4:  //2Mbps
-          case 10: //5Mbps
-          case 22: //11Mbps
-            channelFlags |= RadiotapHeader::CHANNEL_FLAG_CCK;
-            break;
-
-          default:
-            channelFlags |= RadiotapHeader::CHANNEL_FLAG_OFDM;
-            break;
+            switch (rate)
+              {
+              case 2:  //1Mbps
+              case 4:  //2Mbps
+              case 10: //5Mbps
+              case 22: //11Mbps
+                channelFlags |= RadiotapHeader::CHANNEL_FLAG_CCK;
+                break;
+
+              default:
+                channelFlags |= RadiotapHeader::CHANNEL_FLAG_OFDM;
+                break;
+              }
           }
 
+        //Radiotap has no 60 GHz spectrum flag: the band follows from the frequency
         if (channelFreqMhz < 2500)
           {
             channelFlags |= RadiotapHeader::CHANNEL_FLAG_SPECTRUM_2GHZ;
           }
-        else
+        else if (channelFreqMhz < 50000)
           {
             channelFlags |= RadiotapHeader::CHANNEL_FLAG_SPECTRUM_5GHZ;
           }
@@ -517,7 +559,7 @@ PcapSniffRxEvent (
         header.SetAntennaSignalPower (signalNoise.signal);
         header.SetAntennaNoisePower (signalNoise.noise);
 
-        if (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF || preamble == WIFI_PREAMBLE_NONE)
+        if (!dmg && (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF || preamble == WIFI_PREAMBLE_NONE))
           {
             uint8_t mcsRate = 0;
             uint8_t mcsKnown = RadiotapHeader::MCS_KNOWN_NONE;
@@ -573,9 +615,9 @@ PcapSniffRxEvent (
             /* For PCAP file, MPDU Delimiter and Padding should be removed by the MAC Driver */
             AmpduSubframeHeader hdr;
             uint32_t extractedLength;
-            p->RemoveHeader (hdr);
+            packet->PeekHeader (hdr);
             extractedLength = hdr.GetLength ();
-            p = p->CreateFragment (0, static_cast<uint32_t> (extractedLength));
+            packet = packet->CreateFragment (hdr.GetSerializedSize (), static_cast<uint32_t> (extractedLength));
             if (aMpdu.packetType == 2 || (hdr.GetEof () == true && hdr.GetLength () > 0))
               {
                 ampduStatusFlags |= RadiotapHeader::A_MPDU_STATUS_LAST;
@@ -583,7 +625,7 @@ PcapSniffRxEvent (
             header.SetAmpduStatus (aMpdu.referenceNumber, ampduStatusFlags, hdr.GetCrc ());
           }
 
-        if (preamble == WIFI_PREAMBLE_VHT)
+        if (!dmg && preamble == WIFI_PREAMBLE_VHT)
           {
             uint16_t vhtKnown = RadiotapHeader::VHT_KNOWN_NONE;
             uint8_t vhtFlags = RadiotapHeader::VHT_FLAGS_NONE;
@@ -629,8 +671,15 @@ PcapSniffRxEvent (
             header.SetVhtFields (vhtKnown, vhtFlags, vhtBandwidth, vhtMcsNss, vhtCoding, vhtGroupId, vhtPartialAid);
           }
 
-        p->AddHeader (header);
-        file->Write (Simulator::Now (), p);
+        if (dmg)
+          {
+            uint8_t dmgPhy = (modClass == WIFI_MOD_CLASS_VHT_OFDM) ? RadiotapHeader::DMG_PHY_OFDM : RadiotapHeader::DMG_PHY_SC;
+            header.SetDmgFields (dmgPhy, txVector.GetMode ().GetMcsValue ());
+          }
+
+        // Write the header and the packet separately, so that the
+        // packet is neither copied nor serialized beyond the snaplen.
+        file->Write (Simulator::Now (), header, packet);
         return;
       }
     default:
@@ -663,6 +712,18 @@ YansWifiPhyHelper::GetPcapDataLinkType (void) const
   return m_pcapDlt;
 }
 
+void
+YansWifiPhyHelper::SetPcapSnapLen (uint32_t snapLen)
+{
+  m_pcapSnapLen = snapLen;
+}
+
+uint32_t
+YansWifiPhyHelper::GetPcapSnapLen (void) const
+{
+  return m_pcapSnapLen;
+}
+
 void
 YansWifiPhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
@@ -691,7 +752,7 @@ YansWifiPhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bo
       filename = pcapHelper.GetFilenameFromDevice (prefix, device);
     }
 
-  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, m_pcapDlt);
+  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, m_pcapDlt, m_pcapSnapLen);
 
   phy->TraceConnectWithoutContext ("MonitorSnifferTx", MakeBoundCallback (&PcapSniffTxEvent, file));
   phy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeBoundCallback (&PcapSniffRxEvent, file));
@@ -255,6 +255,26 @@ public:
    */
   uint32_t GetPcapDataLinkType (void) const;
 
+  /**
+   * Set the maximum number of bytes of each frame saved in the PCAP
+   * traces.  Longer frames, such as large A-MSDUs, are truncated and
+   * only the saved bytes are copied.  This function has to be called
+   * before EnablePcap().  By default, the "CaptureSize" attribute of
+   * ns3::PcapFileWrapper is used.
+   *
+   * @param snapLen The maximum number of bytes saved per frame
+   */
+  void SetPcapSnapLen (uint32_t snapLen);
+
+  /**
+   * @returns The maximum number of bytes saved per frame in the PCAP traces
+   */
+  uint32_t GetPcapSnapLen (void) const;
+
+protected:
+  ObjectFactory m_phy;            //!< PHY object factory
+  ObjectFactory m_errorRateModel; //!< error rate model factory
+
 private:
   /**
    * \param node the node on which we wish to create a wifi PHY
@@ -297,10 +317,9 @@ private:
                                     Ptr<NetDevice> nd,
                                     bool explicitFilename);
 
-  ObjectFactory m_phy;
-  ObjectFactory m_errorRateModel;
   Ptr<YansWifiChannel> m_channel;
   uint32_t m_pcapDlt;
+  uint32_t m_pcapSnapLen;
 };
 
 } //namespace ns3
@@ -162,6 +162,20 @@ InterferenceHelper::Add (uint32_t size, WifiTxVector txVector,
   return event;
 }
 
+void
+InterferenceHelper::AddForeignSignal (Time duration, double rxPowerW)
+{
+  // the event is never received, so its size, TXVECTOR and preamble
+  // do not matter
+  Ptr<InterferenceHelper::Event> event;
+  event = Create<InterferenceHelper::Event> (0,
+                                             WifiTxVector (),
+                                             WIFI_PREAMBLE_NONE,
+                                             duration,
+                                             rxPowerW);
+  AppendEvent (event);
+}
+
 
 void
 InterferenceHelper::SetNoiseFigure (double value)
@@ -183,6 +183,15 @@ private:
                                       enum WifiPreamble preamble,
                                       Time duration, double rxPower);
 
+  /**
+   * Add a signal which is not a wifi frame for this PHY (e.g. an LTE
+   * transmission) to interference helper: it only adds to the noise.
+   *
+   * \param duration the duration of the signal
+   * \param rxPower receive power (W)
+   */
+  void AddForeignSignal (Time duration, double rxPower);
+
   /**
    * Calculate the SNIR at the start of the plcp payload and accumulate
    * all SNIR changes in the snir vector.
@@ -436,6 +436,7 @@ MacLow::DoDispose (void)
       m_phyMacLowListener = 0;
     }
   m_mpduAggregator = 0;
+  m_stats = 0;
   m_sentMpdus = 0;
   m_aggregateQueue = 0;
   m_ampdu = false;
@@ -1082,6 +1083,11 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiTxVector txVector, Wifi
     {
       m_stationManager->ReportRxOk (hdr.GetAddr2 (), &hdr,
                                     rxSnr, txVector.GetMode ());
+      if (m_stats != 0 && hdr.IsData ())
+        {
+          WifiMacTrailer fcs;
+          m_stats->NotifyRx (hdr.GetAddr2 (), packet->GetSize () - fcs.GetSerializedSize ());
+        }
       if (hdr.IsQosData () && ReceiveMpdu (packet, hdr))
         {
           /* From section 9.10.4 in IEEE 802.11:
@@ -1597,6 +1603,14 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr,
                 ", seq=0x" << std::hex << m_currentHdr.GetSequenceControl () << std::dec);
   if (!m_ampdu || hdr->IsRts ())
     {
+      if (m_stats != 0 && hdr->IsData () && !hdr->GetAddr1 ().IsGroup ())
+        {
+          WifiMacTrailer fcs;
+          m_stats->NotifyTx (hdr->GetAddr1 (),
+                             packet->GetSize () - hdr->GetSize () - fcs.GetSerializedSize (),
+                             hdr->IsRetry (),
+                             m_phy->CalculateTxDuration (packet->GetSize (), txVector, preamble, m_phy->GetFrequency (), 0, 0));
+        }
       m_phy->SendPacket (packet, txVector, preamble, 0, 0);
     }
   else
@@ -1609,6 +1623,9 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr,
       bool vhtSingleMpdu = false;
       bool last = false;
       uint8_t packetType = 0;
+      uint32_t nMpdus = queueSize;
+      uint32_t ampduSize = 0;
+      WifiPreamble firstPreamble = preamble;
 
       if (queueSize == 1)
         {
@@ -1636,6 +1653,11 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr,
               packetType = 2;
             }
           m_mpduAggregator->AddHeaderAndPad (newPacket, last, vhtSingleMpdu);
+          if (m_stats != 0)
+            {
+              m_stats->NotifyTx (newHdr.GetAddr1 (), dequeuedPacket->GetSize (), newHdr.IsRetry (), Seconds (0));
+              ampduSize += newPacket->GetSize ();
+            }
 
           ampdutag.SetNoOfMpdus (queueSize);
           newPacket->AddPacketTag (ampdutag);
@@ -1663,6 +1685,21 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr,
           preamble = WIFI_PREAMBLE_NONE;
         }
       m_mpduReferenceNumber += 1;  // this variable is allowed to overflow
+      if (m_stats != 0)
+        {
+          // the PHY sends the subframes as a single PSDU
+          m_stats->NotifyTxAmpdu (hdr->GetAddr1 (), nMpdus,
+                                  m_phy->CalculateTxDuration (ampduSize, txVector, firstPreamble, m_phy->GetFrequency (), 0, 0));
+        }
+    }
+}
+
+void
+MacLow::NotifyStatsTxFailed (void)
+{
+  if (m_stats != 0 && m_currentHdr.IsData ())
+    {
+      m_stats->NotifyTxFailed (m_currentHdr.GetAddr1 ());
     }
 }
 
@@ -1702,6 +1739,7 @@ MacLow::NormalAckTimeout (void)
   /// we should restart a new ack timeout now until the expected
   /// end of rx if there was a rx start before now.
   m_stationManager->ReportDataFailed (m_currentHdr.GetAddr1 (), &m_currentHdr);
+  NotifyStatsTxFailed ();
   MacLowTransmissionListener *listener = m_listener;
   m_listener = 0;
   m_sentMpdus = 0;
@@ -1720,6 +1758,7 @@ MacLow::FastAckTimeout (void)
   if (m_phy->IsStateIdle ())
     {
       NS_LOG_DEBUG ("fast Ack idle missed");
+      NotifyStatsTxFailed ();
       listener->MissedAck ();
     }
   else
@@ -1735,6 +1774,7 @@ MacLow::BlockAckTimeout (void)
   NS_LOG_DEBUG ("block ack timeout");
 
   m_stationManager->ReportDataFailed (m_currentHdr.GetAddr1 (), &m_currentHdr);
+  NotifyStatsTxFailed ();
   MacLowTransmissionListener *listener = m_listener;
   m_listener = 0;
   m_sentMpdus = 0;
@@ -1753,6 +1793,7 @@ MacLow::SuperFastAckTimeout ()
   if (m_phy->IsStateIdle ())
     {
       NS_LOG_DEBUG ("super fast Ack failed");
+      NotifyStatsTxFailed ();
       listener->MissedAck ();
     }
   else
@@ -2713,6 +2754,18 @@ MacLow::GetMpduAggregator (void)
   return m_mpduAggregator;
 }
 
+void
+MacLow::SetStats (Ptr<WifiMacStats> stats)
+{
+  m_stats = stats;
+}
+
+Ptr<WifiMacStats>
+MacLow::GetStats (void) const
+{
+  return m_stats;
+}
+
 void
 MacLow::DeaggregateAmpduAndReceive (Ptr<Packet> aggregatedPacket, double rxSnr, WifiTxVector txVector, WifiPreamble preamble)
 {
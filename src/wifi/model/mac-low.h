@@ -44,6 +44,7 @@
 #include "wifi-tx-vector.h"
 #include "mpdu-aggregator.h"
 #include "msdu-aggregator.h"
+#include "wifi-mac-stats.h"
 
 class TwoLevelAggregationTest;
 
@@ -534,6 +535,16 @@ public:
    * \return the attached MpduAggregator
    */
   Ptr<MpduAggregator> GetMpduAggregator (void);
+  /**
+   * Set up the counters updated for each data frame sent or received.
+   *
+   * \param stats the counters, or 0 to disable them
+   */
+  void SetStats (Ptr<WifiMacStats> stats);
+  /**
+   * \return the attached WifiMacStats, or 0
+   */
+  Ptr<WifiMacStats> GetStats (void) const;
   /**
    * Set MAC address of this MacLow.
    *
@@ -895,6 +906,11 @@ private:
    * \param mpduReferenceNumber
    */
   void SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, WifiPreamble preamble, uint8_t packetType, uint32_t mpduReferenceNumber);
+  /**
+   * Count a data transmission of the current packet that was not
+   * acknowledged, if the stats are enabled.
+   */
+  void NotifyStatsTxFailed (void);
   /**
    * Return a TXVECTOR for the RTS frame given the destination.
    * The function consults WifiRemoteStationManager, which controls the rate
@@ -1323,6 +1339,7 @@ private:
   EventId m_waitRifsEvent;              //!< Wait for RIFS event
 
   Ptr<MpduAggregator> m_mpduAggregator; //!<
+  Ptr<WifiMacStats> m_stats;            //!< Per-peer counters, or 0
 
   Ptr<Packet> m_currentPacket;              //!< Current packet transmitted/to be transmitted
   WifiMacHeader m_currentHdr;               //!< Header of the current packet
@@ -136,6 +136,19 @@ RegularWifiMac::GetWifiRemoteStationManager () const
   return m_stationManager;
 }
 
+void
+RegularWifiMac::SetStats (Ptr<WifiMacStats> stats)
+{
+  NS_LOG_FUNCTION (this << stats);
+  m_low->SetStats (stats);
+}
+
+Ptr<WifiMacStats>
+RegularWifiMac::GetStats (void) const
+{
+  return m_low->GetStats ();
+}
+
 void
 RegularWifiMac::SetupEdcaQueue (enum AcIndex ac)
 {
@@ -708,6 +721,12 @@ RegularWifiMac::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&RegularWifiMac::GetBKQueue),
                    MakePointerChecker<EdcaTxopN> ())
+    .AddAttribute ("Stats",
+                   "The per-peer counters updated by the MAC, if any.",
+                   PointerValue (),
+                   MakePointerAccessor (&RegularWifiMac::SetStats,
+                                        &RegularWifiMac::GetStats),
+                   MakePointerChecker<WifiMacStats> ())
     .AddTraceSource ("TxOkHeader",
                      "The header of successfully transmitted packet",
                      MakeTraceSourceAccessor (&RegularWifiMac::m_txOkCallback),
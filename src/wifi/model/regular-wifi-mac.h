@@ -27,6 +27,7 @@
 #include "wifi-remote-station-manager.h"
 #include "ssid.h"
 #include "qos-utils.h"
+#include "wifi-mac-stats.h"
 #include <map>
 
 namespace ns3 {
@@ -205,6 +206,14 @@ public:
    * \return the station manager attached to this MAC.
    */
   virtual Ptr<WifiRemoteStationManager> GetWifiRemoteStationManager (void) const;
+  /**
+   * \param stats the per-peer counters to update, or 0 to disable them
+   */
+  void SetStats (Ptr<WifiMacStats> stats);
+  /**
+   * \return the per-peer counters of this MAC, or 0
+   */
+  Ptr<WifiMacStats> GetStats (void) const;
 
   /**
    * This type defines the callback of a higher layer that a
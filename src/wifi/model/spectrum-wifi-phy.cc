@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spectrum-wifi-phy.h"
+#include "wifi-spectrum-phy-interface.h"
+#include "wifi-spectrum-signal-parameters.h"
+#include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumWifiPhy");
+
+NS_OBJECT_ENSURE_REGISTERED (SpectrumWifiPhy);
+
+TypeId
+SpectrumWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SpectrumWifiPhy")
+    .SetParent<YansWifiPhy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<SpectrumWifiPhy> ()
+    .AddAttribute ("BandsPerChannel",
+                   "The number of bands of the SpectrumModel within the channel, "
+                   "whatever the channel width.  The model also has this number "
+                   "of bands on each side of the channel, for the transmit "
+                   "spectrum mask.  Must be even and set before the channel.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&SpectrumWifiPhy::m_bandsPerChannel),
+                   MakeUintegerChecker<uint32_t> (2))
+  ;
+  return tid;
+}
+
+SpectrumWifiPhy::SpectrumWifiPhy ()
+  : m_centerFrequency (0),
+    m_channelWidth (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_antenna = CreateObject<IsotropicAntennaModel> ();
+  m_wifiSpectrumPhyInterface = CreateObject<WifiSpectrumPhyInterface> ();
+  m_wifiSpectrumPhyInterface->SetSpectrumWifiPhy (this);
+}
+
+SpectrumWifiPhy::~SpectrumWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SpectrumWifiPhy::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_channel = 0;
+  m_wifiSpectrumPhyInterface->Dispose ();
+  m_wifiSpectrumPhyInterface = 0;
+  m_antenna = 0;
+  m_rxSpectrumModel = 0;
+  m_txMask = 0;
+  YansWifiPhy::DoDispose ();
+}
+
+void
+SpectrumWifiPhy::SetChannel (Ptr<SpectrumChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  m_channel = channel;
+  m_rxSpectrumModel = 0;
+  UpdateSpectrumModel ();
+}
+
+Ptr<SpectrumChannel>
+SpectrumWifiPhy::GetSpectrumChannel (void) const
+{
+  return m_channel;
+}
+
+Ptr<Channel>
+SpectrumWifiPhy::GetChannel (void) const
+{
+  return m_channel;
+}
+
+Ptr<WifiSpectrumPhyInterface>
+SpectrumWifiPhy::GetSpectrumPhy (void) const
+{
+  return m_wifiSpectrumPhyInterface;
+}
+
+void
+SpectrumWifiPhy::SetAntenna (Ptr<AntennaModel> antenna)
+{
+  m_antenna = antenna;
+}
+
+Ptr<AntennaModel>
+SpectrumWifiPhy::GetRxAntenna (void) const
+{
+  return m_antenna;
+}
+
+Ptr<const SpectrumModel>
+SpectrumWifiPhy::GetRxSpectrumModel (void) const
+{
+  return m_rxSpectrumModel;
+}
+
+void
+SpectrumWifiPhy::SetChannelNumber (uint16_t id)
+{
+  YansWifiPhy::SetChannelNumber (id);
+  UpdateSpectrumModel ();
+}
+
+void
+SpectrumWifiPhy::SetChannelWidth (uint32_t channelwidth)
+{
+  YansWifiPhy::SetChannelWidth (channelwidth);
+  UpdateSpectrumModel ();
+}
+
+void
+SpectrumWifiPhy::ConfigureStandard (enum WifiPhyStandard standard)
+{
+  YansWifiPhy::ConfigureStandard (standard);
+  UpdateSpectrumModel ();
+}
+
+void
+SpectrumWifiPhy::UpdateSpectrumModel (void)
+{
+  if (m_channel == 0)
+    {
+      // the model is only needed once attached
+      return;
+    }
+  double centerFrequency = GetChannelFrequencyMhz ();
+  uint32_t channelWidth = GetChannelWidth ();
+  if (m_rxSpectrumModel != 0 && centerFrequency == m_centerFrequency
+      && channelWidth == m_channelWidth)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << centerFrequency << channelWidth);
+  m_centerFrequency = centerFrequency;
+  m_channelWidth = channelWidth;
+  m_rxSpectrumModel = WifiSpectrumValueHelper::GetChannelSpectrumModel (centerFrequency, channelWidth, m_bandsPerChannel);
+  m_txMask = WifiSpectrumValueHelper::CreateChannelTxPowerSpectralDensity (m_rxSpectrumModel, channelWidth, 1.0);
+  // the channel converts the signals to the model of the receivers
+  // it knows of
+  m_channel->AddRx (m_wifiSpectrumPhyInterface);
+}
+
+void
+SpectrumWifiPhy::Transmit (Ptr<const Packet> packet, double txPowerDbm,
+                           WifiTxVector txVector, WifiPreamble preamble,
+                           struct mpduInfo aMpdu, Time txDuration)
+{
+  NS_LOG_FUNCTION (this << packet << txPowerDbm << txDuration);
+  NS_ASSERT_MSG (m_channel != 0, "SpectrumWifiPhy is not attached to a channel");
+  Ptr<WifiSpectrumSignalParameters> txParams = Create<WifiSpectrumSignalParameters> ();
+  txParams->duration = txDuration;
+  txParams->psd = Create<SpectrumValue> ();
+  Scale (*txParams->psd, *m_txMask, std::pow (10.0, (txPowerDbm - 30) / 10.0));
+  txParams->txPhy = m_wifiSpectrumPhyInterface;
+  txParams->txAntenna = m_antenna;
+  txParams->packet = packet;
+  txParams->txVector = txVector;
+  txParams->preamble = preamble;
+  txParams->aMpdu = aMpdu;
+  txParams->centerFrequency = m_centerFrequency;
+  txParams->channelWidth = m_channelWidth;
+  m_channel->StartTx (txParams);
+}
+
+void
+SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+  NS_ASSERT_MSG (params->psd->GetSpectrumModelUid () == m_rxSpectrumModel->GetUid (),
+                 "the SpectrumWifiPhy needs a MultiModelSpectrumChannel");
+  // the bands within the channel all have the same width
+  double rxPowerDensity = 0;
+  for (uint32_t i = m_bandsPerChannel; i < 2 * m_bandsPerChannel; i++)
+    {
+      rxPowerDensity += (*params->psd)[i];
+    }
+  double rxPowerW = rxPowerDensity * m_channelWidth * 1e6 / m_bandsPerChannel;
+  if (rxPowerW <= 0)
+    {
+      NS_LOG_DEBUG ("no power within the channel");
+      return;
+    }
+  double rxPowerDbm = 10 * std::log10 (rxPowerW) + 30;
+
+  Ptr<WifiSpectrumSignalParameters> wifiParams = DynamicCast<WifiSpectrumSignalParameters> (params);
+  if (wifiParams == 0 || wifiParams->centerFrequency != m_centerFrequency
+      || wifiParams->channelWidth != m_channelWidth)
+    {
+      NS_LOG_DEBUG ("interference from another channel or technology (power=" << rxPowerDbm << "dBm)");
+      StartReceiveInterference (rxPowerDbm, params->duration);
+      return;
+    }
+  StartReceivePreambleAndHeader (wifiParams->packet->Copy (), rxPowerDbm,
+                                 wifiParams->txVector, wifiParams->preamble,
+                                 wifiParams->aMpdu, params->duration);
+}
+
+} // namespace ns3
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPECTRUM_WIFI_PHY_H
+#define SPECTRUM_WIFI_PHY_H
+
+#include "yans-wifi-phy.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/spectrum-model.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/antenna-model.h"
+
+namespace ns3 {
+
+class WifiSpectrumPhyInterface;
+
+/**
+ * \brief 802.11 PHY layer model attached to a SpectrumChannel
+ * \ingroup wifi
+ *
+ * This PHY receives and decodes frames like the YansWifiPhy, but
+ * sends them on a SpectrumChannel (usually a MultiModelSpectrumChannel)
+ * as a power spectral density over its channel, so that wifi can
+ * share the channel with other technologies such as LTE.  The
+ * received power is the power of the received PSD within the channel
+ * of the PHY.  Wifi frames sent on the same channel are received;
+ * the other signals (wifi frames of overlapping channels, or frames
+ * of other technologies) are interference.
+ *
+ * All the channels, from 5 MHz to the 2160 MHz 802.11ad (DMG)
+ * channels, use a SpectrumModel with BandsPerChannel bands within the
+ * channel (see WifiSpectrumValueHelper::GetChannelSpectrumModel), so
+ * that the PSD, which the channel copies, converts and scales for
+ * every receiver of every frame, stays short.
+ */
+class SpectrumWifiPhy : public YansWifiPhy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  SpectrumWifiPhy ();
+  virtual ~SpectrumWifiPhy ();
+
+  /**
+   * Set the SpectrumChannel this SpectrumWifiPhy is to be connected to.
+   *
+   * \param channel the SpectrumChannel this SpectrumWifiPhy is to be connected to
+   */
+  void SetChannel (Ptr<SpectrumChannel> channel);
+  /**
+   * \return the SpectrumChannel this SpectrumWifiPhy is connected to
+   */
+  Ptr<SpectrumChannel> GetSpectrumChannel (void) const;
+  /**
+   * \return the SpectrumPhy registered with the channel
+   */
+  Ptr<WifiSpectrumPhyInterface> GetSpectrumPhy (void) const;
+  /**
+   * \param antenna the antenna used to send and receive, isotropic by default
+   */
+  void SetAntenna (Ptr<AntennaModel> antenna);
+  /**
+   * \return the antenna used to receive
+   */
+  Ptr<AntennaModel> GetRxAntenna (void) const;
+  /**
+   * \return the SpectrumModel of the current channel
+   */
+  Ptr<const SpectrumModel> GetRxSpectrumModel (void) const;
+  /**
+   * A signal arrives from the SpectrumChannel.
+   *
+   * \param params the parameters of the signal
+   */
+  void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  virtual Ptr<Channel> GetChannel (void) const;
+  virtual void SetChannelNumber (uint16_t id);
+  virtual void SetChannelWidth (uint32_t channelwidth);
+  virtual void ConfigureStandard (enum WifiPhyStandard standard);
+
+protected:
+  virtual void DoDispose (void);
+  virtual void Transmit (Ptr<const Packet> packet, double txPowerDbm,
+                         WifiTxVector txVector, WifiPreamble preamble,
+                         struct mpduInfo aMpdu, Time txDuration);
+
+private:
+  /**
+   * Update the SpectrumModel and the TX PSD after a change of channel,
+   * and register the new model with the SpectrumChannel.
+   */
+  void UpdateSpectrumModel (void);
+
+  Ptr<SpectrumChannel> m_channel;                       //!< the SpectrumChannel
+  Ptr<WifiSpectrumPhyInterface> m_wifiSpectrumPhyInterface; //!< the SpectrumPhy registered with the channel
+  Ptr<AntennaModel> m_antenna;                          //!< the antenna
+  uint32_t m_bandsPerChannel;                           //!< bands of the SpectrumModel within the channel
+  Ptr<const SpectrumModel> m_rxSpectrumModel;           //!< the SpectrumModel of the current channel
+  Ptr<const SpectrumValue> m_txMask;                    //!< the TX PSD for 1 W on the current channel
+  double m_centerFrequency;                             //!< center frequency of the model in MHz
+  uint32_t m_channelWidth;                              //!< channel width of the model in MHz
+};
+
+} // namespace ns3
+
+#endif /* SPECTRUM_WIFI_PHY_H */
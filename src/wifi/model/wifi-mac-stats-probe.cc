@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "wifi-mac-stats-probe.h"
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/trace-source-accessor.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WifiMacStatsProbe");
+
+NS_OBJECT_ENSURE_REGISTERED (WifiMacStatsProbe);
+
+TypeId
+WifiMacStatsProbe::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::WifiMacStatsProbe")
+    .SetParent<Probe> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<WifiMacStatsProbe> ()
+    .AddAttribute ("Peer",
+                   "The peer whose windows are reported.  "
+                   "The broadcast address selects the sum of all the peers.",
+                   Mac48AddressValue (Mac48Address::GetBroadcast ()),
+                   MakeMac48AddressAccessor (&WifiMacStatsProbe::m_peer),
+                   MakeMac48AddressChecker ())
+    .AddAttribute ("Metric",
+                   "The metric reported for each window.",
+                   EnumValue (TX_THROUGHPUT),
+                   MakeEnumAccessor (&WifiMacStatsProbe::m_metric),
+                   MakeEnumChecker (TX_THROUGHPUT, "TxThroughput",
+                                    RX_THROUGHPUT, "RxThroughput",
+                                    TX_MPDUS, "TxMpdus",
+                                    RX_MPDUS, "RxMpdus",
+                                    TX_RETRIES, "TxRetries",
+                                    TX_FAILED, "TxFailed",
+                                    AMPDU_SIZE, "AmpduSize",
+                                    AIRTIME, "Airtime"))
+    .AddTraceSource ( "Output",
+                      "The metric of each window that serves as output for this probe",
+                      MakeTraceSourceAccessor (&WifiMacStatsProbe::m_output),
+                      "ns3::TracedValueCallback::Double")
+  ;
+  return tid;
+}
+
+WifiMacStatsProbe::WifiMacStatsProbe ()
+  : m_value (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WifiMacStatsProbe::~WifiMacStatsProbe ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+double
+WifiMacStatsProbe::GetMetric (const WifiMacStats::Window &window) const
+{
+  switch (m_metric)
+    {
+    case TX_THROUGHPUT:
+      return window.GetTxThroughput ();
+    case RX_THROUGHPUT:
+      return window.GetRxThroughput ();
+    case TX_MPDUS:
+      return window.counters.txMpdus;
+    case RX_MPDUS:
+      return window.counters.rxMpdus;
+    case TX_RETRIES:
+      return window.counters.txRetries;
+    case TX_FAILED:
+      return window.counters.txFailed;
+    case AMPDU_SIZE:
+      return window.GetMeanAmpduSize ();
+    case AIRTIME:
+      return window.GetAirtimeFraction ();
+    }
+  return 0;
+}
+
+bool
+WifiMacStatsProbe::ConnectByObject (std::string traceSource, Ptr<Object> obj)
+{
+  NS_LOG_FUNCTION (this << traceSource << obj);
+  NS_LOG_DEBUG ("Name of probe (if any) in names database: " << Names::FindPath (obj));
+  bool connected = obj->TraceConnectWithoutContext (traceSource, MakeCallback (&ns3::WifiMacStatsProbe::TraceSink, this));
+  return connected;
+}
+
+void
+WifiMacStatsProbe::ConnectByPath (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  NS_LOG_DEBUG ("Name of probe to search for in config database: " << path);
+  Config::ConnectWithoutContext (path, MakeCallback (&ns3::WifiMacStatsProbe::TraceSink, this));
+}
+
+void
+WifiMacStatsProbe::TraceSink (const WifiMacStats::Window &window)
+{
+  NS_LOG_FUNCTION (this << window.peer);
+  if (IsEnabled () && window.peer == m_peer)
+    {
+      double value = GetMetric (window);
+      m_output (m_value, value);
+      m_value = value;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WIFI_MAC_STATS_PROBE_H
+#define WIFI_MAC_STATS_PROBE_H
+
+#include "ns3/probe.h"
+#include "ns3/traced-callback.h"
+#include "ns3/mac48-address.h"
+#include "wifi-mac-stats.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * This class is designed to probe the Window trace source of a
+ * WifiMacStats object.  It exports a trace source "Output" with the
+ * previous and the new value of the selected metric of the selected
+ * peer, like a DoubleProbe, so that it can be used with the
+ * FileHelper and the GnuplotHelper:
+ *
+ * \code
+ *   fileHelper.WriteProbe ("ns3::WifiMacStatsProbe",
+ *                          "/NodeList/0/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/Stats/Window",
+ *                          "Output");
+ * \endcode
+ *
+ * Unlike a DoubleProbe, a value is emitted at the end of every window,
+ * even if it did not change.
+ */
+class WifiMacStatsProbe : public Probe
+{
+public:
+  /// Metrics of a window
+  enum Metric
+  {
+    TX_THROUGHPUT,  //!< bit rate of the data sent, in bit/s
+    RX_THROUGHPUT,  //!< bit rate of the data received, in bit/s
+    TX_MPDUS,       //!< number of data frames sent
+    RX_MPDUS,       //!< number of data frames received
+    TX_RETRIES,     //!< number of data frames sent with the Retry bit
+    TX_FAILED,      //!< number of unacknowledged transmissions
+    AMPDU_SIZE,     //!< mean number of MPDUs per A-MPDU
+    AIRTIME         //!< fraction of the window spent sending data frames
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+  WifiMacStatsProbe ();
+  virtual ~WifiMacStatsProbe ();
+
+  /**
+   * \brief connect to a trace source attribute provided by a given object
+   *
+   * \param traceSource the name of the attribute TraceSource to connect to
+   * \param obj ns3::Object to connect to
+   * \return true if the trace source was successfully connected
+   */
+  virtual bool ConnectByObject (std::string traceSource, Ptr<Object> obj);
+
+  /**
+   * \brief connect to a trace source provided by a config path
+   *
+   * \param path Config path to bind to
+   *
+   * Note, if an invalid path is provided, the probe will not be connected
+   * to anything.
+   */
+  virtual void ConnectByPath (std::string path);
+
+  /**
+   * \param window the counters of a window
+   * \returns the selected metric of the window
+   */
+  double GetMetric (const WifiMacStats::Window &window) const;
+
+private:
+  /**
+   * \brief Method to connect to the Window trace source of WifiMacStats
+   *
+   * \param window the counters of a window
+   */
+  void TraceSink (const WifiMacStats::Window &window);
+
+  /// Traced Callback: the previous and the new value of the metric.
+  TracedCallback<double, double> m_output;
+
+  Mac48Address m_peer; //!< the peer reported, or broadcast for all the peers
+  Metric m_metric;     //!< the metric reported
+  double m_value;      //!< last value reported
+};
+
+} // namespace ns3
+
+#endif // WIFI_MAC_STATS_PROBE_H
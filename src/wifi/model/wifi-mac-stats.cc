@@ -0,0 +1,277 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "wifi-mac-stats.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WifiMacStats");
+
+NS_OBJECT_ENSURE_REGISTERED (WifiMacStats);
+
+/**
+ * \param a the counters at the end of a window
+ * \param b the counters at the start of the window
+ * \returns the counters of the window
+ */
+static WifiMacStats::Counters
+Subtract (const WifiMacStats::Counters &a, const WifiMacStats::Counters &b)
+{
+  WifiMacStats::Counters c;
+  c.txBytes = a.txBytes - b.txBytes;
+  c.rxBytes = a.rxBytes - b.rxBytes;
+  c.txMpdus = a.txMpdus - b.txMpdus;
+  c.rxMpdus = a.rxMpdus - b.rxMpdus;
+  c.txRetries = a.txRetries - b.txRetries;
+  c.txFailed = a.txFailed - b.txFailed;
+  c.txAmpdus = a.txAmpdus - b.txAmpdus;
+  c.txAmpduMpdus = a.txAmpduMpdus - b.txAmpduMpdus;
+  c.txAirtime = a.txAirtime - b.txAirtime;
+  return c;
+}
+
+/**
+ * \param a the counters to increase
+ * \param b the counters to add
+ */
+static void
+Accumulate (WifiMacStats::Counters &a, const WifiMacStats::Counters &b)
+{
+  a.txBytes += b.txBytes;
+  a.rxBytes += b.rxBytes;
+  a.txMpdus += b.txMpdus;
+  a.rxMpdus += b.rxMpdus;
+  a.txRetries += b.txRetries;
+  a.txFailed += b.txFailed;
+  a.txAmpdus += b.txAmpdus;
+  a.txAmpduMpdus += b.txAmpduMpdus;
+  a.txAirtime += b.txAirtime;
+}
+
+WifiMacStats::Counters::Counters ()
+  : txBytes (0),
+    rxBytes (0),
+    txMpdus (0),
+    rxMpdus (0),
+    txRetries (0),
+    txFailed (0),
+    txAmpdus (0),
+    txAmpduMpdus (0),
+    txAirtime (Seconds (0))
+{
+}
+
+double
+WifiMacStats::Window::GetTxThroughput (void) const
+{
+  return duration.IsStrictlyPositive () ? counters.txBytes * 8 / duration.GetSeconds () : 0;
+}
+
+double
+WifiMacStats::Window::GetRxThroughput (void) const
+{
+  return duration.IsStrictlyPositive () ? counters.rxBytes * 8 / duration.GetSeconds () : 0;
+}
+
+double
+WifiMacStats::Window::GetMeanAmpduSize (void) const
+{
+  return counters.txAmpdus ? (double) counters.txAmpduMpdus / counters.txAmpdus : 0;
+}
+
+double
+WifiMacStats::Window::GetAirtimeFraction (void) const
+{
+  return duration.IsStrictlyPositive () ? counters.txAirtime.GetSeconds () / duration.GetSeconds () : 0;
+}
+
+TypeId
+WifiMacStats::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WifiMacStats")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<WifiMacStats> ()
+    .AddAttribute ("Interval",
+                   "The length of the windows reported by the Window trace source.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&WifiMacStats::m_interval),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddTraceSource ("Window",
+                     "The counters of a peer, or of all the peers, "
+                     "accumulated during the last interval.",
+                     MakeTraceSourceAccessor (&WifiMacStats::m_windowTrace),
+                     "ns3::WifiMacStats::WindowTracedCallback")
+  ;
+  return tid;
+}
+
+WifiMacStats::WifiMacStats ()
+  : m_lastPeer (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WifiMacStats::~WifiMacStats ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+WifiMacStats::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_windowEvent.Cancel ();
+  m_peers.clear ();
+  m_lastPeer = 0;
+  Object::DoDispose ();
+}
+
+WifiMacStats::Counters &
+WifiMacStats::Lookup (Mac48Address peer)
+{
+  if (!m_windowEvent.IsRunning ())
+    {
+      m_windowStart = Simulator::Now ();
+      m_windowEvent = Simulator::Schedule (m_interval, &WifiMacStats::EndWindow, this);
+    }
+  // consecutive frames usually go to the same peer
+  if (m_lastPeer == 0 || m_lastAddress != peer)
+    {
+      Peers::iterator it = m_peers.find (peer);
+      if (it == m_peers.end ())
+        {
+          NS_LOG_DEBUG ("new peer " << peer);
+          Peer state;
+          state.active = false;
+          it = m_peers.insert (std::make_pair (peer, state)).first;
+        }
+      m_lastAddress = peer;
+      m_lastPeer = &it->second;
+    }
+  return m_lastPeer->total;
+}
+
+void
+WifiMacStats::NotifyTx (Mac48Address peer, uint32_t bytes, bool retry, Time airtime)
+{
+  Counters &counters = Lookup (peer);
+  counters.txBytes += bytes;
+  counters.txMpdus++;
+  if (retry)
+    {
+      counters.txRetries++;
+    }
+  counters.txAirtime += airtime;
+}
+
+void
+WifiMacStats::NotifyTxAmpdu (Mac48Address peer, uint32_t nMpdus, Time airtime)
+{
+  Counters &counters = Lookup (peer);
+  counters.txAmpdus++;
+  counters.txAmpduMpdus += nMpdus;
+  counters.txAirtime += airtime;
+}
+
+void
+WifiMacStats::NotifyTxFailed (Mac48Address peer)
+{
+  Lookup (peer).txFailed++;
+}
+
+void
+WifiMacStats::NotifyRx (Mac48Address peer, uint32_t bytes)
+{
+  Counters &counters = Lookup (peer);
+  counters.rxBytes += bytes;
+  counters.rxMpdus++;
+}
+
+void
+WifiMacStats::EndWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+  Window all;
+  all.peer = Mac48Address::GetBroadcast ();
+  all.start = m_windowStart;
+  all.duration = Simulator::Now () - m_windowStart;
+  bool reported = false;
+  bool busy = false;
+  for (Peers::iterator it = m_peers.begin (); it != m_peers.end (); ++it)
+    {
+      Peer &state = it->second;
+      Window window;
+      window.peer = it->first;
+      window.start = all.start;
+      window.duration = all.duration;
+      window.counters = Subtract (state.total, state.last);
+      state.last = state.total;
+      bool active = window.counters.txMpdus > 0 || window.counters.rxMpdus > 0
+        || window.counters.txFailed > 0;
+      // report one empty window after the traffic stops, so that
+      // the series drop back to zero
+      if (active || state.active)
+        {
+          m_windowTrace (window);
+          Accumulate (all.counters, window.counters);
+          reported = true;
+        }
+      state.active = active;
+      busy = busy || active;
+    }
+  if (reported)
+    {
+      m_windowTrace (all);
+    }
+  if (busy)
+    {
+      m_windowStart = Simulator::Now ();
+      m_windowEvent = Simulator::Schedule (m_interval, &WifiMacStats::EndWindow, this);
+    }
+}
+
+WifiMacStats::Counters
+WifiMacStats::GetCounters (Mac48Address peer) const
+{
+  Peers::const_iterator it = m_peers.find (peer);
+  if (it == m_peers.end ())
+    {
+      return Counters ();
+    }
+  return it->second.total;
+}
+
+WifiMacStats::Counters
+WifiMacStats::GetTotalCounters (void) const
+{
+  Counters total;
+  for (Peers::const_iterator it = m_peers.begin (); it != m_peers.end (); ++it)
+    {
+      Accumulate (total, it->second.total);
+    }
+  return total;
+}
+
+uint32_t
+WifiMacStats::GetNPeers (void) const
+{
+  return m_peers.size ();
+}
+
+} //namespace ns3
@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WIFI_MAC_STATS_H
+#define WIFI_MAC_STATS_H
+
+#include <map>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/mac48-address.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+/**
+ * \brief per-peer counters of a wifi MAC
+ * \ingroup wifi
+ *
+ * MacLow updates the counters of the peer of each individually
+ * addressed data frame it sends or receives, without calling any
+ * callback.  Every Interval, the counters accumulated during the
+ * interval are reported through the Window trace source, once per
+ * active peer and once for all the peers together (with the broadcast
+ * address as peer).  Windows are only scheduled while there is
+ * traffic, so an idle MAC costs no events.
+ *
+ * A WifiMacStatsProbe turns the windows into a series of doubles for
+ * the TimeSeriesAdaptor, FileHelper and GnuplotHelper.
+ */
+class WifiMacStats : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  WifiMacStats ();
+  virtual ~WifiMacStats ();
+
+  /// counters of a peer; bytes are MSDU (frame body) bytes
+  struct Counters
+  {
+    Counters ();
+
+    uint64_t txBytes;      //!< bytes of the data frames sent, retransmissions included
+    uint64_t rxBytes;      //!< bytes of the data frames received
+    uint32_t txMpdus;      //!< data frames sent
+    uint32_t rxMpdus;      //!< data frames received
+    uint32_t txRetries;    //!< data frames sent with the Retry bit set
+    uint32_t txFailed;     //!< data transmissions not acknowledged
+    uint32_t txAmpdus;     //!< A-MPDUs sent
+    uint32_t txAmpduMpdus; //!< data frames sent in A-MPDUs
+    Time txAirtime;        //!< time spent sending data frames
+  };
+
+  /// counters accumulated during one interval
+  struct Window
+  {
+    Mac48Address peer; //!< the peer, or the broadcast address for all the peers
+    Time start;        //!< start of the window
+    Time duration;     //!< length of the window
+    Counters counters; //!< counters of the window
+
+    /** \returns the bit rate of the data sent, in bit/s */
+    double GetTxThroughput (void) const;
+    /** \returns the bit rate of the data received, in bit/s */
+    double GetRxThroughput (void) const;
+    /** \returns the mean number of MPDUs per A-MPDU */
+    double GetMeanAmpduSize (void) const;
+    /** \returns the fraction of the window spent sending data frames */
+    double GetAirtimeFraction (void) const;
+  };
+
+  /**
+   * TracedCallback signature for windows.
+   *
+   * \param [in] window the counters of the window
+   */
+  typedef void (* WindowTracedCallback)(const Window &window);
+
+  /**
+   * \param peer the receiver of the data frame
+   * \param bytes the size of the frame body
+   * \param retry whether the Retry bit is set
+   * \param airtime the duration of the frame
+   */
+  void NotifyTx (Mac48Address peer, uint32_t bytes, bool retry, Time airtime);
+  /**
+   * The MPDUs of the A-MPDU are notified with NotifyTx and no airtime.
+   *
+   * \param peer the receiver of the A-MPDU
+   * \param nMpdus the number of MPDUs in the A-MPDU
+   * \param airtime the duration of the A-MPDU
+   */
+  void NotifyTxAmpdu (Mac48Address peer, uint32_t nMpdus, Time airtime);
+  /**
+   * \param peer the receiver of the unacknowledged transmission
+   */
+  void NotifyTxFailed (Mac48Address peer);
+  /**
+   * \param peer the transmitter of the data frame
+   * \param bytes the size of the frame body
+   */
+  void NotifyRx (Mac48Address peer, uint32_t bytes);
+
+  /**
+   * \param peer a peer
+   * \returns the counters of the peer since the start of the simulation
+   */
+  Counters GetCounters (Mac48Address peer) const;
+  /** \returns the counters of all the peers since the start of the simulation */
+  Counters GetTotalCounters (void) const;
+  /** \returns the number of peers seen */
+  uint32_t GetNPeers (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// counters and state of a peer
+  struct Peer
+  {
+    Counters total;  //!< counters since the start
+    Counters last;   //!< counters at the start of the window
+    bool active;     //!< whether the peer was reported in the last window
+  };
+  /// Container of the peers
+  typedef std::map<Mac48Address, Peer> Peers;
+
+  /**
+   * \param peer the peer address
+   * \returns the counters of the peer, starting a window if needed
+   */
+  Counters & Lookup (Mac48Address peer);
+  /** Report the window of each peer and start the next one if needed. */
+  void EndWindow (void);
+
+  Peers m_peers;              //!< the peers
+  Mac48Address m_lastAddress; //!< address of the last peer looked up
+  Peer *m_lastPeer;           //!< last peer looked up, or 0
+  Time m_interval;            //!< length of the windows
+  Time m_windowStart;         //!< start of the current window
+  EventId m_windowEvent;      //!< end of the current window
+
+  /// The windows
+  TracedCallback<const Window &> m_windowTrace;
+};
+
+} //namespace ns3
+
+#endif /* WIFI_MAC_STATS_H */
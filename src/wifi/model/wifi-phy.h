@@ -36,7 +36,7 @@
 
 namespace ns3 {
 
-class WifiChannel;
+class Channel;
 class NetDevice;
 
 struct signalNoiseDbm
@@ -541,11 +541,12 @@ public:
   virtual void ConfigureStandard (enum WifiPhyStandard standard) = 0;
 
   /**
-   * Return the WifiChannel this WifiPhy is connected to.
+   * Return the channel this WifiPhy is connected to: a WifiChannel,
+   * or a SpectrumChannel for the SpectrumWifiPhy.
    *
-   * \return the WifiChannel this WifiPhy is connected to
+   * \return the channel this WifiPhy is connected to
    */
-  virtual Ptr<WifiChannel> GetChannel (void) const = 0;
+  virtual Ptr<Channel> GetChannel (void) const = 0;
 
   /**
    * Return a WifiMode for DSSS at 1Mbps.
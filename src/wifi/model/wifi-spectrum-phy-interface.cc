@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "wifi-spectrum-phy-interface.h"
+#include "spectrum-wifi-phy.h"
+#include "ns3/net-device.h"
+#include "ns3/mobility-model.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WifiSpectrumPhyInterface");
+
+NS_OBJECT_ENSURE_REGISTERED (WifiSpectrumPhyInterface);
+
+TypeId
+WifiSpectrumPhyInterface::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WifiSpectrumPhyInterface")
+    .SetParent<SpectrumPhy> ()
+    .SetGroupName ("Wifi")
+  ;
+  return tid;
+}
+
+WifiSpectrumPhyInterface::WifiSpectrumPhyInterface ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WifiSpectrumPhyInterface::~WifiSpectrumPhyInterface ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+WifiSpectrumPhyInterface::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_spectrumWifiPhy = 0;
+  SpectrumPhy::DoDispose ();
+}
+
+void
+WifiSpectrumPhyInterface::SetSpectrumWifiPhy (Ptr<SpectrumWifiPhy> phy)
+{
+  m_spectrumWifiPhy = phy;
+}
+
+Ptr<NetDevice>
+WifiSpectrumPhyInterface::GetDevice () const
+{
+  return m_spectrumWifiPhy->GetDevice ();
+}
+
+void
+WifiSpectrumPhyInterface::SetDevice (Ptr<NetDevice> d)
+{
+  m_spectrumWifiPhy->SetDevice (d);
+}
+
+void
+WifiSpectrumPhyInterface::SetMobility (Ptr<MobilityModel> m)
+{
+  m_spectrumWifiPhy->SetMobility (m);
+}
+
+Ptr<MobilityModel>
+WifiSpectrumPhyInterface::GetMobility ()
+{
+  return m_spectrumWifiPhy->GetMobility ();
+}
+
+void
+WifiSpectrumPhyInterface::SetChannel (Ptr<SpectrumChannel> c)
+{
+  m_spectrumWifiPhy->SetChannel (c);
+}
+
+Ptr<const SpectrumModel>
+WifiSpectrumPhyInterface::GetRxSpectrumModel () const
+{
+  return m_spectrumWifiPhy->GetRxSpectrumModel ();
+}
+
+Ptr<AntennaModel>
+WifiSpectrumPhyInterface::GetRxAntenna ()
+{
+  return m_spectrumWifiPhy->GetRxAntenna ();
+}
+
+void
+WifiSpectrumPhyInterface::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_spectrumWifiPhy->StartRx (params);
+}
+
+} // namespace ns3
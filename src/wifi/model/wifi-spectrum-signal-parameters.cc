@@ -0,0 +1,56 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "wifi-spectrum-signal-parameters.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WifiSpectrumSignalParameters");
+
+WifiSpectrumSignalParameters::WifiSpectrumSignalParameters ()
+  : preamble (WIFI_PREAMBLE_NONE),
+    centerFrequency (0),
+    channelWidth (0)
+{
+  NS_LOG_FUNCTION (this);
+  aMpdu.packetType = 0;
+  aMpdu.referenceNumber = 0;
+}
+
+WifiSpectrumSignalParameters::WifiSpectrumSignalParameters (const WifiSpectrumSignalParameters& p)
+  : SpectrumSignalParameters (p),
+    packet (p.packet),
+    txVector (p.txVector),
+    preamble (p.preamble),
+    aMpdu (p.aMpdu),
+    centerFrequency (p.centerFrequency),
+    channelWidth (p.channelWidth)
+{
+  NS_LOG_FUNCTION (this << &p);
+}
+
+Ptr<SpectrumSignalParameters>
+WifiSpectrumSignalParameters::Copy ()
+{
+  NS_LOG_FUNCTION (this);
+  // the packet is not copied: every receiver copies it before use
+  Ptr<WifiSpectrumSignalParameters> wssp (new WifiSpectrumSignalParameters (*this), false);
+  return wssp;
+}
+
+} // namespace ns3
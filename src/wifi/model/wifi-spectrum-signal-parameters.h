@@ -0,0 +1,59 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef WIFI_SPECTRUM_SIGNAL_PARAMETERS_H
+#define WIFI_SPECTRUM_SIGNAL_PARAMETERS_H
+
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/packet.h"
+#include "wifi-phy.h"
+#include "wifi-tx-vector.h"
+#include "wifi-preamble.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * Signal parameters of a wifi frame sent by a SpectrumWifiPhy
+ */
+struct WifiSpectrumSignalParameters : public SpectrumSignalParameters
+{
+  // inherited from SpectrumSignalParameters
+  virtual Ptr<SpectrumSignalParameters> Copy ();
+
+  /**
+   * default constructor
+   */
+  WifiSpectrumSignalParameters ();
+
+  /**
+   * copy constructor
+   */
+  WifiSpectrumSignalParameters (const WifiSpectrumSignalParameters& p);
+
+  Ptr<const Packet> packet;  //!< the frame, shared by all the receivers
+  WifiTxVector txVector;     //!< the TXVECTOR of the frame
+  WifiPreamble preamble;     //!< the preamble of the frame
+  struct mpduInfo aMpdu;     //!< the A-MPDU type and reference number of the frame
+  double centerFrequency;    //!< the center frequency of the channel in MHz
+  uint32_t channelWidth;     //!< the width of the channel in MHz
+};
+
+} // namespace ns3
+
+#endif /* WIFI_SPECTRUM_SIGNAL_PARAMETERS_H */
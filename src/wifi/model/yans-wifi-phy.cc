@@ -40,6 +40,7 @@
 #include "ns3/node.h"
 #include "ampdu-tag.h"
 #include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -409,7 +410,7 @@ YansWifiPhy::CalculateSnr (WifiMode txMode, double ber) const
   return m_interference.GetErrorRateModel ()->CalculateSnr (txMode, ber);
 }
 
-Ptr<WifiChannel>
+Ptr<Channel>
 YansWifiPhy::GetChannel (void) const
 {
   return m_channel;
@@ -490,6 +491,12 @@ YansWifiPhy::GetChannelSwitchDelay (void) const
 double
 YansWifiPhy::GetChannelFrequencyMhz () const
 {
+  if (m_channelStartingFrequency >= 56000) //at 60 GHz
+    {
+      //DMG channels are 2160 MHz wide, channel 1 is centered at 58320 MHz
+      uint16_t channelNumber = std::max<uint16_t> (GetChannelNumber (), 1);
+      return 58320 + 2160 * (channelNumber - 1);
+    }
   return m_channelStartingFrequency + 5 * GetChannelNumber ();
 }
 
@@ -722,6 +729,23 @@ maybeCcaBusy:
     }
 }
 
+void
+YansWifiPhy::StartReceiveInterference (double rxPowerDbm, Time rxDuration)
+{
+  NS_LOG_FUNCTION (this << rxPowerDbm << rxDuration);
+  rxPowerDbm += m_rxGainDb;
+  m_interference.AddForeignSignal (rxDuration, DbmToW (rxPowerDbm));
+  if (m_state->IsStateSleep ())
+    {
+      return;
+    }
+  Time delayUntilCcaEnd = m_interference.GetEnergyDuration (m_ccaMode1ThresholdW);
+  if (!delayUntilCcaEnd.IsZero ())
+    {
+      m_state->SwitchMaybeToCcaBusy (delayUntilCcaEnd);
+    }
+}
+
 void
 YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
                                  WifiTxVector txVector,
@@ -792,7 +816,9 @@ YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, WifiPr
     }
   NotifyTxBegin (packet);
   uint32_t dataRate500KbpsUnits;
-  if (txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HT || txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_VHT)
+  WifiModulationClass modClass = txVector.GetMode ().GetModulationClass ();
+  if (modClass == WIFI_MOD_CLASS_HT || modClass == WIFI_MOD_CLASS_VHT
+      || modClass == WIFI_MOD_CLASS_VHT_SC || modClass == WIFI_MOD_CLASS_VHT_OFDM)
     {
       dataRate500KbpsUnits = 128 + txVector.GetMode ().GetMcsValue ();
     }
@@ -805,7 +831,15 @@ YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, WifiPr
   aMpdu.referenceNumber = mpduReferenceNumber;
   NotifyMonitorSniffTx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, preamble, txVector, aMpdu);
   m_state->SwitchToTx (txDuration, packet, GetPowerDbm (txVector.GetTxPowerLevel ()), txVector, preamble);
-  m_channel->Send (this, packet, GetPowerDbm (txVector.GetTxPowerLevel ()) + m_txGainDb, txVector, preamble, aMpdu, txDuration);
+  Transmit (packet, GetPowerDbm (txVector.GetTxPowerLevel ()) + m_txGainDb, txVector, preamble, aMpdu, txDuration);
+}
+
+void
+YansWifiPhy::Transmit (Ptr<const Packet> packet, double txPowerDbm,
+                       WifiTxVector txVector, WifiPreamble preamble,
+                       struct mpduInfo aMpdu, Time txDuration)
+{
+  m_channel->Send (this, packet, txPowerDbm, txVector, preamble, aMpdu, txDuration);
 }
 
 uint32_t
@@ -1210,7 +1244,9 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, struct
         {
           NotifyRxEnd (packet);
           uint32_t dataRate500KbpsUnits;
-          if ((event->GetPayloadMode ().GetModulationClass () == WIFI_MOD_CLASS_HT) || (event->GetPayloadMode ().GetModulationClass () == WIFI_MOD_CLASS_VHT))
+          WifiModulationClass modClass = event->GetPayloadMode ().GetModulationClass ();
+          if (modClass == WIFI_MOD_CLASS_HT || modClass == WIFI_MOD_CLASS_VHT
+              || modClass == WIFI_MOD_CLASS_VHT_SC || modClass == WIFI_MOD_CLASS_VHT_OFDM)
             {
               dataRate500KbpsUnits = 128 + event->GetPayloadMode ().GetMcsValue ();
             }
@@ -95,6 +95,7 @@ public:
   Time GetChannelSwitchDelay (void) const;
   /**
    * Return current center channel frequency in MHz.
+   * At 60 GHz this is the center of the 2160 MHz wide DMG channel.
    *
    * \return the current center channel frequency in MHz
    */
@@ -117,6 +118,15 @@ public:
                                       WifiPreamble preamble,
                                       struct mpduInfo aMpdu,
                                       Time rxDuration);
+  /**
+   * A signal which cannot be received (e.g. a frame of another
+   * technology or of an overlapping channel) has arrived: it is only
+   * accounted for as interference and for clear channel assessment.
+   *
+   * \param rxPowerDbm the receive power in dBm
+   * \param rxDuration the duration of the signal
+   */
+  void StartReceiveInterference (double rxPowerDbm, Time rxDuration);
   /**
    * Starting receiving the payload of a packet (i.e. the first bit of the packet has arrived).
    *
@@ -301,7 +311,7 @@ public:
   virtual bool IsModeSupported (WifiMode mode) const;
   virtual bool IsMcsSupported (WifiMode mcs);
   virtual double CalculateSnr (WifiMode txMode, double ber) const;
-  virtual Ptr<WifiChannel> GetChannel (void) const;
+  virtual Ptr<Channel> GetChannel (void) const;
 
   virtual void ConfigureStandard (enum WifiPhyStandard standard);
 
@@ -409,9 +419,26 @@ public:
   virtual uint8_t GetNMcs (void) const;
   virtual WifiMode GetMcs (uint8_t mcs) const;
 
+protected:
+  virtual void DoDispose (void);
+
+  /**
+   * Hand a frame over to the channel.  Subclasses attached to another
+   * kind of channel override this method.
+   *
+   * \param packet the packet to send
+   * \param txPowerDbm the transmission power in dBm, gain included
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the preamble of the packet
+   * \param aMpdu the A-MPDU type and reference number of the packet
+   * \param txDuration the duration of the transmission
+   */
+  virtual void Transmit (Ptr<const Packet> packet, double txPowerDbm,
+                         WifiTxVector txVector, WifiPreamble preamble,
+                         struct mpduInfo aMpdu, Time txDuration);
+
 private:
   virtual void DoInitialize (void);
-  virtual void DoDispose (void);
 
   /**
    * Configure YansWifiPhy with appropriate channel frequency and
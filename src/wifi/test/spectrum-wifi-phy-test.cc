@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-wifi-phy.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/spectrum-signal-parameters.h"
+
+using namespace ns3;
+
+/**
+ * Check the coarse channel spectrum models and the TX PSD.
+ */
+class WifiChannelSpectrumModelTestCase : public TestCase
+{
+public:
+  WifiChannelSpectrumModelTestCase ();
+  virtual ~WifiChannelSpectrumModelTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiChannelSpectrumModelTestCase::WifiChannelSpectrumModelTestCase ()
+  : TestCase ("Check the spectrum model and TX PSD of the DMG and legacy channels")
+{
+}
+
+void
+WifiChannelSpectrumModelTestCase::DoRun (void)
+{
+  // DMG channel 2
+  Ptr<SpectrumModel> dmg = WifiSpectrumValueHelper::GetChannelSpectrumModel (60480, 2160, 8);
+  NS_TEST_ASSERT_MSG_EQ (dmg->GetNumBands (), 24, "wrong number of bands");
+  NS_TEST_EXPECT_MSG_EQ_TOL (dmg->Begin ()->fl, 60480e6 - 3240e6, 1, "wrong lowest frequency");
+  NS_TEST_EXPECT_MSG_EQ_TOL (dmg->Begin ()->fh - dmg->Begin ()->fl, 270e6, 1, "wrong resolution");
+  NS_TEST_EXPECT_MSG_EQ (WifiSpectrumValueHelper::GetChannelSpectrumModel (60480, 2160, 8), dmg,
+                         "models of the same channel are not shared");
+  NS_TEST_EXPECT_MSG_NE (WifiSpectrumValueHelper::GetChannelSpectrumModel (58320, 2160, 8), dmg,
+                         "models of different channels are shared");
+
+  Ptr<SpectrumValue> psd = WifiSpectrumValueHelper::CreateChannelTxPowerSpectralDensity (dmg, 2160, 0.01);
+  double inBand = 0;
+  for (uint32_t i = 8; i < 16; i++)
+    {
+      inBand += (*psd)[i] * 270e6;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (inBand, 0.01, 1e-9, "wrong power within the channel");
+  NS_TEST_EXPECT_MSG_EQ_TOL ((*psd)[7] / (*psd)[8], 0.019953, 1e-6, "wrong DMG mask");
+  NS_TEST_EXPECT_MSG_EQ_TOL ((*psd)[0] / (*psd)[8], 0.0063096, 1e-7, "wrong DMG mask");
+
+  Ptr<SpectrumModel> legacy = WifiSpectrumValueHelper::GetChannelSpectrumModel (5180, 20, 8);
+  psd = WifiSpectrumValueHelper::CreateChannelTxPowerSpectralDensity (legacy, 20, 1);
+  NS_TEST_EXPECT_MSG_EQ_TOL (Integral (*psd), 1 + 2 * 0.5 * (0.0015849 + 1e-4), 1e-9, "wrong total power");
+}
+
+/**
+ * Two SpectrumWifiPhy on a MultiModelSpectrumChannel: a frame sent on
+ * the channel of the receiver is received, a frame sent on the adjacent
+ * channel and a signal of another technology are interference only.
+ */
+class SpectrumWifiPhyReceptionTestCase : public TestCase
+{
+public:
+  SpectrumWifiPhyReceptionTestCase ();
+  virtual ~SpectrumWifiPhyReceptionTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param channel the channel
+   * \param channelNumber the wifi channel number
+   * \returns a new 802.11a PHY
+   */
+  Ptr<SpectrumWifiPhy> CreatePhy (Ptr<SpectrumChannel> channel, uint16_t channelNumber);
+  /**
+   * \param phy the sender
+   */
+  void Send (Ptr<SpectrumWifiPhy> phy);
+  /**
+   * \param phy the receiver
+   * \param power the power of the signal in W
+   */
+  void SendForeignSignal (Ptr<SpectrumWifiPhy> phy, double power);
+  /**
+   * \param phy the receiver
+   * \param received the expected number of frames received
+   * \param ccaBusy whether the receiver is expected to be CCA busy
+   */
+  void Check (Ptr<SpectrumWifiPhy> phy, uint32_t received, bool ccaBusy);
+  /**
+   * Receive callback
+   * \param packet the packet
+   * \param snr the SNR
+   * \param txVector the TXVECTOR
+   * \param preamble the preamble
+   */
+  void Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+
+  uint32_t m_received; //!< number of frames received
+};
+
+SpectrumWifiPhyReceptionTestCase::SpectrumWifiPhyReceptionTestCase ()
+  : TestCase ("Check the reception of frames and the interference of other signals")
+{
+}
+
+Ptr<SpectrumWifiPhy>
+SpectrumWifiPhyReceptionTestCase::CreatePhy (Ptr<SpectrumChannel> channel, uint16_t channelNumber)
+{
+  Ptr<SpectrumWifiPhy> phy = CreateObject<SpectrumWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  phy->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  phy->SetChannel (channel);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  phy->SetChannelNumber (channelNumber);
+  phy->Initialize ();
+  return phy;
+}
+
+void
+SpectrumWifiPhyReceptionTestCase::Send (Ptr<SpectrumWifiPhy> phy)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+  txVector.SetTxPowerLevel (0);
+  txVector.SetChannelWidth (20);
+  txVector.SetNss (1);
+  phy->SendPacket (Create<Packet> (1000), txVector, WIFI_PREAMBLE_LONG, 0, 0);
+}
+
+void
+SpectrumWifiPhyReceptionTestCase::SendForeignSignal (Ptr<SpectrumWifiPhy> phy, double power)
+{
+  // a signal of another technology over the whole receiver model
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = Create<SpectrumValue> (phy->GetRxSpectrumModel ());
+  *params->psd = power / 60e6;
+  params->duration = MilliSeconds (1);
+  phy->StartRx (params);
+}
+
+void
+SpectrumWifiPhyReceptionTestCase::Check (Ptr<SpectrumWifiPhy> phy, uint32_t received, bool ccaBusy)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_received, received, "wrong number of frames received");
+  NS_TEST_EXPECT_MSG_EQ (phy->IsStateCcaBusy (), ccaBusy, "wrong CCA state");
+}
+
+void
+SpectrumWifiPhyReceptionTestCase::Receive (Ptr<Packet> packet, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_received++;
+}
+
+void
+SpectrumWifiPhyReceptionTestCase::DoRun (void)
+{
+  m_received = 0;
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  Ptr<SpectrumWifiPhy> tx = CreatePhy (channel, 36);
+  Ptr<SpectrumWifiPhy> adjacent = CreatePhy (channel, 40);
+  Ptr<SpectrumWifiPhy> rx = CreatePhy (channel, 36);
+  rx->SetReceiveOkCallback (MakeCallback (&SpectrumWifiPhyReceptionTestCase::Receive, this));
+
+  Simulator::Schedule (Seconds (1), &SpectrumWifiPhyReceptionTestCase::Send, this, tx);
+  Simulator::Schedule (Seconds (1.1), &SpectrumWifiPhyReceptionTestCase::Check, this, rx, 1, false);
+  // about 31 dB of adjacent channel rejection
+  Simulator::Schedule (Seconds (2), &SpectrumWifiPhyReceptionTestCase::Send, this, adjacent);
+  Simulator::Schedule (Seconds (2) + MicroSeconds (100), &SpectrumWifiPhyReceptionTestCase::Check, this, rx, 1, true);
+  Simulator::Schedule (Seconds (2.1), &SpectrumWifiPhyReceptionTestCase::Check, this, rx, 1, false);
+  Simulator::Schedule (Seconds (3), &SpectrumWifiPhyReceptionTestCase::SendForeignSignal, this, rx, 1e-9);
+  Simulator::Schedule (Seconds (3) + MicroSeconds (100), &SpectrumWifiPhyReceptionTestCase::Check, this, rx, 1, true);
+  Simulator::Schedule (Seconds (3) + MicroSeconds (1100), &SpectrumWifiPhyReceptionTestCase::Check, this, rx, 1, false);
+  // below the CCA threshold
+  Simulator::Schedule (Seconds (4), &SpectrumWifiPhyReceptionTestCase::SendForeignSignal, this, rx, 1e-14);
+  Simulator::Schedule (Seconds (4) + MicroSeconds (100), &SpectrumWifiPhyReceptionTestCase::Check, this, rx, 1, false);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  tx->Dispose ();
+  adjacent->Dispose ();
+  rx->Dispose ();
+}
+
+class SpectrumWifiPhyTestSuite : public TestSuite
+{
+public:
+  SpectrumWifiPhyTestSuite ();
+};
+
+SpectrumWifiPhyTestSuite::SpectrumWifiPhyTestSuite ()
+  : TestSuite ("spectrum-wifi-phy", UNIT)
+{
+  AddTestCase (new WifiChannelSpectrumModelTestCase, TestCase::QUICK);
+  AddTestCase (new SpectrumWifiPhyReceptionTestCase, TestCase::QUICK);
+}
+
+static SpectrumWifiPhyTestSuite spectrumWifiPhyTestSuite;
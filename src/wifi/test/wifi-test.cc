@@ -40,6 +40,9 @@
 #include "ns3/config.h"
 #include "ns3/boolean.h"
 #include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/wifi-mac-stats-probe.h"
 
 using namespace ns3;
 
@@ -622,6 +625,123 @@ Bug730TestCase::DoRun (void)
 }
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Check the per-peer counters of WifiMacStats and the windows reported
+ * through a WifiMacStatsProbe, for unicast packets between two ad hoc
+ * stations.
+ */
+class WifiMacStatsTestCase : public TestCase
+{
+public:
+  WifiMacStatsTestCase ();
+  virtual ~WifiMacStatsTestCase ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void SendOnePacket (Ptr<WifiNetDevice> from, Ptr<WifiNetDevice> to);
+  void ProbeOutput (double oldValue, double newValue);
+
+  double m_probeSum;
+  uint32_t m_probeCount;
+};
+
+WifiMacStatsTestCase::WifiMacStatsTestCase ()
+  : TestCase ("Test case for the WifiMacStats counters"),
+    m_probeSum (0),
+    m_probeCount (0)
+{
+}
+
+WifiMacStatsTestCase::~WifiMacStatsTestCase ()
+{
+}
+
+void
+WifiMacStatsTestCase::SendOnePacket (Ptr<WifiNetDevice> from, Ptr<WifiNetDevice> to)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  from->Send (p, to->GetAddress (), 1);
+}
+
+void
+WifiMacStatsTestCase::ProbeOutput (double oldValue, double newValue)
+{
+  m_probeSum += newValue;
+  m_probeCount++;
+}
+
+void
+WifiMacStatsTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  WifiHelper::EnableMacStats (devices, MilliSeconds (100));
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (5.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Ptr<WifiNetDevice> txDev = DynamicCast<WifiNetDevice> (devices.Get (0));
+  Ptr<WifiNetDevice> rxDev = DynamicCast<WifiNetDevice> (devices.Get (1));
+  Mac48Address txAddress = Mac48Address::ConvertFrom (txDev->GetAddress ());
+  Mac48Address rxAddress = Mac48Address::ConvertFrom (rxDev->GetAddress ());
+
+  Ptr<WifiMacStatsProbe> probe = CreateObject<WifiMacStatsProbe> ();
+  probe->SetAttribute ("Peer", Mac48AddressValue (rxAddress));
+  probe->SetAttribute ("Metric", EnumValue (WifiMacStatsProbe::TX_MPDUS));
+  probe->ConnectByPath ("/NodeList/0/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/Stats/Window");
+  probe->TraceConnectWithoutContext ("Output", MakeCallback (&WifiMacStatsTestCase::ProbeOutput, this));
+
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::Schedule (Seconds (1.0) + MilliSeconds (25 * i),
+                           &WifiMacStatsTestCase::SendOnePacket, this, txDev, rxDev);
+    }
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  Ptr<RegularWifiMac> txMac = DynamicCast<RegularWifiMac> (txDev->GetMac ());
+  Ptr<RegularWifiMac> rxMac = DynamicCast<RegularWifiMac> (rxDev->GetMac ());
+  WifiMacStats::Counters tx = txMac->GetStats ()->GetCounters (rxAddress);
+  WifiMacStats::Counters rx = rxMac->GetStats ()->GetCounters (txAddress);
+
+  Simulator::Destroy ();
+
+  // each MSDU carries an 8 byte LLC/SNAP header
+  NS_TEST_EXPECT_MSG_EQ (tx.txMpdus, 10, "Wrong number of data frames sent");
+  NS_TEST_EXPECT_MSG_EQ (tx.txBytes, 10 * 1008, "Wrong number of bytes sent");
+  NS_TEST_EXPECT_MSG_EQ (tx.txRetries, 0, "Unexpected retransmissions");
+  NS_TEST_EXPECT_MSG_EQ (tx.txFailed, 0, "Unexpected failed transmissions");
+  NS_TEST_EXPECT_MSG_EQ (tx.txAirtime, MicroSeconds (10 * 1408), "Wrong airtime");
+  NS_TEST_EXPECT_MSG_EQ (rx.rxMpdus, 10, "Wrong number of data frames received");
+  NS_TEST_EXPECT_MSG_EQ (rx.rxBytes, 10 * 1008, "Wrong number of bytes received");
+  NS_TEST_EXPECT_MSG_EQ (m_probeSum, 10, "The windows do not add up to the counters");
+  // 3 windows with traffic and one empty window
+  NS_TEST_EXPECT_MSG_EQ (m_probeCount, 4, "Wrong number of windows");
+}
+
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -637,6 +757,7 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); //Bug 555
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
+  AddTestCase (new WifiMacStatsTestCase, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Print the records of a BinaryTraceRecorder file, one line per
+// record.  The default text output looks like the ascii traces:
+//   <time> <context> <schema> <field>=<value> ...
+// With --csv, print the records of a single schema as CSV, with a
+// header line naming the fields.  --schemas lists the schemas.
+
+#include "ns3/command-line.h"
+#include "ns3/binary-trace.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string fileName;
+  std::string csv;
+  bool schemas = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Print a binary trace file as text or CSV.");
+  cmd.AddValue ("file", "The trace file to read", fileName);
+  cmd.AddValue ("csv", "Print the records of this schema as CSV", csv);
+  cmd.AddValue ("schemas", "List the schemas of the file", schemas);
+  cmd.Parse (argc, argv);
+
+  BinaryTraceReader reader;
+  if (fileName.empty () || !reader.Open (fileName))
+    {
+      std::cerr << "Can't read binary trace \"" << fileName << "\"" << std::endl;
+      exit (1);
+    }
+
+  if (schemas)
+    {
+      for (uint32_t id = BinaryTraceFormat::FIRST_SCHEMA; id < BinaryTraceFormat::MAX_SCHEMAS; id++)
+        {
+          if (!reader.HasSchema (id))
+            {
+              continue;
+            }
+          const BinaryTraceFormat::Schema &schema = reader.GetSchema (id);
+          std::cout << schema.name;
+          for (uint32_t i = 0; i < schema.fields.size (); i++)
+            {
+              std::cout << " " << schema.fields[i].name << ":"
+                        << BinaryTraceFormat::GetTypeName (schema.fields[i].type);
+            }
+          std::cout << std::endl;
+        }
+      return 0;
+    }
+
+  BinaryTraceReader::Record record;
+  if (!csv.empty ())
+    {
+      bool header = false;
+      while (reader.Next (record))
+        {
+          const BinaryTraceFormat::Schema &schema = reader.GetSchema (record.schema);
+          if (schema.name != csv)
+            {
+              continue;
+            }
+          if (!header)
+            {
+              std::cout << "time,context";
+              for (uint32_t i = 0; i < schema.fields.size (); i++)
+                {
+                  std::cout << "," << schema.fields[i].name;
+                }
+              std::cout << std::endl;
+              header = true;
+            }
+          std::cout << record.time.GetSeconds () << "," << reader.GetContext (record.context);
+          for (uint32_t i = 0; i < schema.fields.size (); i++)
+            {
+              std::cout << "," << reader.FormatField (record, i);
+            }
+          std::cout << std::endl;
+        }
+      return 0;
+    }
+
+  while (reader.Next (record))
+    {
+      const BinaryTraceFormat::Schema &schema = reader.GetSchema (record.schema);
+      std::cout << record.time.GetSeconds () << " " << reader.GetContext (record.context)
+                << " " << schema.name;
+      for (uint32_t i = 0; i < schema.fields.size (); i++)
+        {
+          std::cout << " " << schema.fields[i].name << "=" << reader.FormatField (record, i);
+        }
+      std::cout << std::endl;
+    }
+  return 0;
+}
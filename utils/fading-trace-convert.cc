@@ -0,0 +1,53 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert a text fading trace, as made by fading_trace_generator.m, to
+// the binary format that TraceFadingLossModel maps instead of parsing.
+
+#include "ns3/command-line.h"
+#include "ns3/trace-fading-loss-model.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  uint32_t rbNum = 100;
+  uint32_t samplesNum = 10000;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a text fading trace to the binary format.");
+  cmd.AddValue ("input", "The text trace to read", input);
+  cmd.AddValue ("output", "The binary trace to write", output);
+  cmd.AddValue ("rbNum", "The number of RB the trace is made of", rbNum);
+  cmd.AddValue ("samplesNum", "The number of samples per RB", samplesNum);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      std::cerr << "Both --input and --output are needed" << std::endl;
+      exit (1);
+    }
+  if (!TraceFadingLossModel::ConvertTextTrace (input, output, rbNum, samplesNum))
+    {
+      std::cerr << "Can't convert \"" << input << "\" to \"" << output << "\"" << std::endl;
+      exit (1);
+    }
+  return 0;
+}
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Print the content of a FlowStatsStreamWriter file as CSV, either one
+// line per flow and interval, or the totals per flow with --totals.
+// With --follow, keep polling the file for new blocks, which is handy
+// to watch a long simulation while it runs.
+
+#include "ns3/command-line.h"
+#include "ns3/flow-stats-stream.h"
+#include <iostream>
+#include <map>
+#include <stdlib.h> // for exit ()
+#include <unistd.h> // for sleep ()
+
+using namespace ns3;
+
+/// Totals of a flow over the whole file
+struct FlowTotals
+{
+  FlowTotals ()
+    : txPackets (0), rxPackets (0), lostPackets (0),
+      txBytes (0), rxBytes (0), delaySum (0)
+  {}
+  uint64_t txPackets;  //!< Transmitted packets
+  uint64_t rxPackets;  //!< Received packets
+  uint64_t lostPackets; //!< Lost packets
+  uint64_t txBytes;    //!< Transmitted bytes
+  uint64_t rxBytes;    //!< Received bytes
+  int64_t delaySum;    //!< Sum of the delays, in ns
+};
+
+int main (int argc, char *argv[])
+{
+  std::string fileName;
+  bool totals = false;
+  bool follow = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Print a flow statistics stream as CSV.");
+  cmd.AddValue ("file", "The stream file to read", fileName);
+  cmd.AddValue ("totals", "Print the totals per flow instead of the intervals", totals);
+  cmd.AddValue ("follow", "Keep reading the blocks appended to the file", follow);
+  cmd.Parse (argc, argv);
+
+  FlowStatsStreamReader reader;
+  if (fileName.empty () || !reader.Open (fileName))
+    {
+      std::cerr << "Can't read flow statistics stream \"" << fileName << "\"" << std::endl;
+      exit (1);
+    }
+
+  std::map<uint32_t, FlowTotals> flows;
+  if (!totals)
+    {
+      std::cout << "start,end,flowId,txPackets,rxPackets,lostPackets,txBytes,rxBytes,meanDelay" << std::endl;
+    }
+  uint32_t next = 0;
+  while (true)
+    {
+      for (; next < reader.GetNBlocks (); next++)
+        {
+          const FlowStatsStreamReader::Block &b = reader.GetBlock (next);
+          for (uint32_t i = 0; i < b.nFlows; i++)
+            {
+              if (totals)
+                {
+                  FlowTotals &t = flows[b.flowId[i]];
+                  t.txPackets += b.txPackets[i];
+                  t.rxPackets += b.rxPackets[i];
+                  t.lostPackets += b.lostPackets[i];
+                  t.txBytes += b.txBytes[i];
+                  t.rxBytes += b.rxBytes[i];
+                  t.delaySum += b.delaySum[i];
+                  continue;
+                }
+              std::cout << b.start.GetSeconds () << "," << b.end.GetSeconds () << ","
+                        << b.flowId[i] << "," << b.txPackets[i] << "," << b.rxPackets[i] << ","
+                        << b.lostPackets[i] << "," << b.txBytes[i] << "," << b.rxBytes[i] << ","
+                        << (b.rxPackets[i] ? b.delaySum[i] * 1e-9 / b.rxPackets[i] : 0.0)
+                        << std::endl;
+            }
+        }
+      if (!follow)
+        {
+          break;
+        }
+      sleep (1);
+      if (!reader.Refresh ())
+        {
+          break;
+        }
+    }
+
+  if (totals)
+    {
+      std::cout << "flowId,txPackets,rxPackets,lostPackets,txBytes,rxBytes,meanDelay" << std::endl;
+      for (std::map<uint32_t, FlowTotals>::const_iterator i = flows.begin (); i != flows.end (); ++i)
+        {
+          const FlowTotals &t = i->second;
+          std::cout << i->first << "," << t.txPackets << "," << t.rxPackets << ","
+                    << t.lostPackets << "," << t.txBytes << "," << t.rxBytes << ","
+                    << (t.rxPackets ? t.delaySum * 1e-9 / t.rxPackets : 0.0) << std::endl;
+        }
+    }
+  return 0;
+}